@@ -0,0 +1,108 @@
+/**
+ * @file   base64.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Throughput of the base64 encoder used to embed bitmap images.
+ *
+ * Usage: bench_base64 [megabytes [linesize]]
+ *
+ * Compares the block encoder of Tools::base64encode() against the former
+ * byte-by-byte stream encoder, and checks that both outputs are identical.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+// The encoder as it was before the block version (one get() per byte).
+void legacyEncode( std::istream & in, std::ostream & out, int linesize )
+{
+  static const char b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  unsigned char input[3];
+  char output[4];
+  int nbBlocks = 0;
+  while( in ) {
+    int len = 0;
+    for( int i = 0; i < 3; i++ ) {
+      input[i] = (unsigned char) in.get();
+      if( in ) {
+        len++;
+      } else {
+        input[i] = (unsigned char) 0;
+      }
+    }
+    if( len > 0 ) {
+      output[0] = (unsigned char) b64[ (int)(input[0] >> 2) ];
+      output[1] = (unsigned char) b64[ (int)(((input[0] & 0x03) << 4) | ((input[1] & 0xf0) >> 4)) ];
+      output[2] = (unsigned char) (len > 1 ? b64[ (int)(((input[1] & 0x0f) << 2) | ((input[2] & 0xc0) >> 6)) ] : '=');
+      output[3] = (unsigned char) (len > 2 ? b64[ (int)(input[2] & 0x3f) ] : '=');
+      out.write(output,4);
+      ++nbBlocks;
+    }
+    if( nbBlocks >= (linesize/4) || ! in ) {
+      if( nbBlocks > 0 ) out << "\r\n";
+      nbBlocks = 0;
+    }
+  }
+}
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+void report( const char * name, std::size_t bytes, double time )
+{
+  std::cout << name << "\t" << bytes << "\t" << time << "\t"
+            << ( bytes / ( 1024.0 * 1024.0 ) ) / time << std::endl;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t megabytes = ( argc > 1 ) ? std::atoi( argv[1] ) : 16;
+  const int linesize = ( argc > 2 ) ? std::atoi( argv[2] ) : 80;
+  std::vector<unsigned char> data( megabytes * 1024 * 1024 + 7 );
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < data.size(); ++i ) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<unsigned char>( seed >> 16 );
+  }
+  const std::string raw( data.begin(), data.end() );
+
+  std::cout << "encoder\tbytes\tseconds\tMiB/s" << std::endl;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::istringstream legacyIn( raw );
+  std::ostringstream legacyOut;
+  legacyEncode( legacyIn, legacyOut, linesize );
+  report( "legacy-stream", raw.size(), seconds( start ) );
+
+  start = std::chrono::steady_clock::now();
+  std::istringstream blockIn( raw );
+  std::ostringstream blockOut;
+  Tools::base64encode( blockIn, blockOut, linesize );
+  report( "block-stream", raw.size(), seconds( start ) );
+
+  std::vector<char> buffer( Tools::base64EncodedSize( data.size(), linesize ) );
+  start = std::chrono::steady_clock::now();
+  const std::size_t length = Tools::base64encode( &data[0], data.size(), &buffer[0], linesize );
+  report( "block-memory", raw.size(), seconds( start ) );
+
+  const std::string expected = legacyOut.str();
+  if ( blockOut.str() != expected || std::string( &buffer[0], length ) != expected ) {
+    std::cerr << "Error: encoders disagree." << std::endl;
+    return 1;
+  }
+  return 0;
+}
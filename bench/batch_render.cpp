@@ -0,0 +1,133 @@
+/**
+ * @file   batch_render.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Throughput of the BatchRenderer on many small boards.
+ *
+ * Usage: bench_batch_render [jobs [threads [budget_kib]]]
+ *
+ * Renders small "label" boards in all the formats, first one after the
+ * other with Board::save(), then with a BatchRenderer. Reports throughput,
+ * latencies and the peak of in-flight memory, and checks that every
+ * document rendered by the batch is identical to the serial one.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include "board/BatchRenderer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+const Board::Format formats[] = { Board::FormatEPS, Board::FormatFIG, Board::FormatSVG, Board::FormatTikZ };
+
+void buildLabel( Board & board, int index )
+{
+  board.setLineWidth( 0.5 );
+  board.drawRectangle( 0, 30, 60, 30 );
+  std::ostringstream text;
+  text << "Part #" << index;
+  board.setFont( Fonts::Helvetica, 10 );
+  board.drawText( 4, 20, text.str() );
+  for ( int i = 0; i < 40; ++i ) {
+    const double width = 0.3 + 0.3 * ( ( index * 7 + i * 13 ) % 4 );
+    board.fillRectangle( 4 + i * 1.3, 12, width, 10 );
+  }
+  board.setPenColor( Color::Red );
+  board.drawCircle( 52, 22, 4 + index % 3 );
+}
+
+// The creation date is the only part of an EPS file that may vary.
+std::string stripCreationDate( const std::string & document )
+{
+  const std::string::size_type start = document.find( "%%CreationDate:" );
+  if ( start == std::string::npos ) {
+    return document;
+  }
+  return document.substr( 0, start ) + document.substr( document.find( '\n', start ) + 1 );
+}
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const int jobs = ( argc > 1 ) ? std::atoi( argv[1] ) : 20000;
+  const std::size_t threads = ( argc > 2 ) ? std::atoi( argv[2] ) : 0;
+  const std::size_t budget = ( argc > 3 ) ? std::atoi( argv[3] ) * 1024 : 8 * 1024 * 1024;
+
+  const int labels = 64;
+  std::vector<Board> boards( labels );
+  for ( int i = 0; i < labels; ++i ) {
+    buildLabel( boards[i], i );
+  }
+
+  std::vector<std::string> expected( labels * 4 );
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::size_t serialBytes = 0;
+  for ( int job = 0; job < jobs; ++job ) {
+    std::ostringstream out;
+    boards[job % labels].save( out, formats[( job / labels ) % 4] );
+    serialBytes += out.str().size();
+    if ( job < labels * 4 ) {
+      expected[job] = stripCreationDate( out.str() );
+    }
+  }
+  const double serial = seconds( start );
+
+  std::atomic<int> mismatches( 0 );
+  std::mutex latenciesMutex;
+  std::vector<double> latencies;
+  latencies.reserve( jobs );
+  BatchRenderer renderer( threads, budget );
+  renderer.setListener( [&]( const BatchRenderer::JobReport & report ) {
+      std::lock_guard<std::mutex> lock( latenciesMutex );
+      latencies.push_back( report.latencySeconds );
+    } );
+  start = std::chrono::steady_clock::now();
+  for ( int job = 0; job < jobs; ++job ) {
+    const int reference = job % ( labels * 4 );
+    renderer.submit( boards[job % labels], formats[( job / labels ) % 4],
+                     [&, reference]( const std::string & document ) {
+                       if ( stripCreationDate( document ) != expected[reference] ) {
+                         ++mismatches;
+                       }
+                     } );
+  }
+  renderer.wait();
+  const double batch = seconds( start );
+  const BatchRenderer::Statistics stats = renderer.statistics();
+
+  std::sort( latencies.begin(), latencies.end() );
+  std::cout << "mode\tthreads\tjobs\tseconds\tjobs/s\tMiB/s\n";
+  std::cout << "serial\t1\t" << jobs << "\t" << serial << "\t" << jobs / serial
+            << "\t" << serialBytes / ( 1024.0 * 1024.0 ) / serial << "\n";
+  std::cout << "batch\t" << renderer.threadCount() << "\t" << jobs << "\t" << batch << "\t"
+            << jobs / batch << "\t" << stats.bytesPerSecond() / ( 1024.0 * 1024.0 ) << "\n";
+  std::cout << "latency (ms): mean " << 1000 * stats.meanLatencySeconds()
+            << " p50 " << 1000 * latencies[latencies.size() / 2]
+            << " p99 " << 1000 * latencies[( latencies.size() * 99 ) / 100]
+            << " max " << 1000 * stats.maxLatencySeconds << "\n";
+  std::cout << "memory budget " << renderer.memoryBudget()
+            << " peak in flight " << stats.peakMemory << std::endl;
+
+  if ( mismatches || stats.failed || stats.completed != static_cast<std::size_t>( jobs ) ) {
+    std::cerr << "Error: " << mismatches << " mismatches, " << stats.failed << " failed jobs." << std::endl;
+    return 1;
+  }
+  return 0;
+}
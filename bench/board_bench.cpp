@@ -0,0 +1,459 @@
+/**
+ * @file   board_bench.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Benchmark suite on scalable generated scenes.
+ *
+ * Usage: board_bench [--scene name]... [--size n] [--stats] [--trace file] [--list]
+ *
+ * Each scene is generated with about n primitive shapes (default 100000),
+ * then the following phases are timed: construction, transforms (rotation,
+ * translation and scaling of the whole board), bounding box computation,
+ * and export in each format (to a stream that only counts the bytes).
+ * The "primitives" and "flat" scenes hold the same shapes, in a board and
+ * in a FlatShapeList respectively. The "mixed" scene holds a FlatShapeList
+ * between shapes of the board.
+ *
+ * Before running the scenes, the program checks that on a board mixing a
+ * FlatShapeList with other shapes, the FIG depths follow the drawing order
+ * of the other formats. It exits with status 1 if they do not.
+ *
+ * The results are printed as CSV lines on the standard output:
+ *   scene,size,phase,seconds,bytes,peak_rss_kib
+ * where peak_rss_kib is the peak resident set size of the process so far
+ * (run one scene per process to get per-scene peaks).
+ *
+ * With --stats, the statistics of each export (see ExportStats) are also
+ * printed, on the standard error. With --trace, the trace events recorded
+ * by the library are saved in a Chrome trace file (the library must be
+ * configured with the BOARD_TRACING option).
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#if !defined( _WIN32 )
+#include <sys/resource.h>
+#endif
+using namespace PlaneDraw;
+
+namespace {
+
+/*
+ * A stream buffer that discards, and counts, the characters written.
+ */
+class CountingBuffer : public std::streambuf {
+public:
+  CountingBuffer() : _count( 0 ) { setp( _buffer, _buffer + sizeof( _buffer ) ); }
+  std::size_t count() const { return _count + ( pptr() - pbase() ); }
+protected:
+  int_type overflow( int_type c ) {
+    _count += pptr() - pbase();
+    setp( _buffer, _buffer + sizeof( _buffer ) );
+    if ( c != traits_type::eof() ) {
+      *pptr() = traits_type::to_char_type( c );
+      pbump( 1 );
+    }
+    return traits_type::not_eof( c );
+  }
+private:
+  char _buffer[ 64 * 1024 ];
+  std::size_t _count;
+};
+
+long peakRSS()
+{
+#if defined( _WIN32 )
+  return 0;
+#else
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+#if defined( __APPLE__ )
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// A deterministic generator, so that scenes are identical across runs.
+struct Random {
+  unsigned long state;
+  explicit Random( unsigned long seed ) : state( seed ) { }
+  double operator()( double min, double max ) {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return min + ( max - min ) * ( ( state >> 33 ) / 2147483648.0 );
+  }
+};
+
+void koch( Polyline & curve, Point p1, Point p2, int depth )
+{
+  if ( depth > 0 ) {
+    Point v = p2 - p1;
+    Point a = p1 + ( v / 3.0 );
+    Point b = p1 + 2 * ( v / 3.0 );
+    Point c = b.rotated( 60 * Board::Degree, a );
+    koch( curve, p1, a, depth - 1 );
+    koch( curve, a, c, depth - 1 );
+    koch( curve, c, b, depth - 1 );
+    koch( curve, b, p2, depth - 1 );
+  } else {
+    curve << p2;
+  }
+}
+
+// A snowflake has 3 * 4^depth vertices.
+void kochScene( Board & board, std::size_t size )
+{
+  int depth = 0;
+  while ( 3 * std::pow( 4.0, depth + 1 ) <= size ) {
+    ++depth;
+  }
+  Point a( -100, 0 );
+  Point c( 100, 0 );
+  Point b = c.rotated( 60 * Board::Degree, a );
+  Polyline curve( true, Color::Black, Color::Green, 0.1, Shape::SolidStyle, Shape::RoundCap, Shape::RoundJoin );
+  koch( curve, a, b, depth );
+  koch( curve, b, c, depth );
+  koch( curve, c, a, depth );
+  board << curve;
+}
+
+void tilingScene( Board & board, std::size_t size )
+{
+  const std::size_t side = std::max<std::size_t>( 1, static_cast<std::size_t>( std::sqrt( size / 2.0 ) ) );
+  Group tile;
+  tile << Circle( 10, 10, 8, Color::Blue, Color::Null, 0.2 );
+  Polyline l( false, Color::Red, Color::Null, 0.2 );
+  l << Point( 0, 0 ) << Point( 10, 0 ) << Point( 10, 10 );
+  tile << l;
+  board.addTiling( tile, Point( 0, 0 ), side, side, 1.0 );
+}
+
+// Small 10x10 grids (21 shapes each), laid out in a square.
+void gridScene( Board & board, std::size_t size )
+{
+  const std::size_t grids = std::max<std::size_t>( 1, size / 21 );
+  const std::size_t side = static_cast<std::size_t>( std::ceil( std::sqrt( static_cast<double>( grids ) ) ) );
+  for ( std::size_t i = 0; i < grids; ++i ) {
+    board << Board::makeGrid( Point( ( i % side ) * 60.0, ( i / side ) * 60.0 ), 10, 10, 50, 50,
+                              Color::Red, Color( 200, 200, 255 ), 0.1 );
+  }
+}
+
+void randomScene( Board & board, std::size_t size )
+{
+  Random random( 42 );
+  for ( std::size_t i = 0; i < size; ++i ) {
+    const double x = random( 0, 1000 );
+    const double y = random( 0, 1000 );
+    board.setPenColor( Color( static_cast<unsigned char>( random( 0, 255 ) ),
+                              static_cast<unsigned char>( random( 0, 255 ) ),
+                              static_cast<unsigned char>( random( 0, 255 ) ) ) );
+    board.setLineWidth( random( 0.1, 2.0 ) );
+    switch ( i % 6 ) {
+    case 0:
+      board.drawLine( x, y, x + random( -20, 20 ), y + random( -20, 20 ) );
+      break;
+    case 1:
+      board.drawRectangle( x, y, random( 1, 20 ), random( 1, 20 ) );
+      break;
+    case 2:
+      board.drawCircle( x, y, random( 1, 10 ) );
+      break;
+    case 3:
+      board.drawEllipse( x, y, random( 1, 10 ), random( 1, 10 ) );
+      break;
+    case 4:
+      board.drawArrow( x, y, x + random( -20, 20 ), y + random( -20, 20 ) );
+      break;
+    default: {
+      std::vector<Point> points;
+      for ( int k = 0; k < 6; ++k ) {
+        points.push_back( Point( x + random( -10, 10 ), y + random( -10, 10 ) ) );
+      }
+      board.drawPolyline( points );
+      break;
+    }
+    }
+  }
+}
+
+// A chain of nested groups, each one holding its share of the shapes.
+void nestedScene( Board & board, std::size_t size )
+{
+  const std::size_t levels = std::min<std::size_t>( 256, std::max<std::size_t>( 1, size / 4 ) );
+  const std::size_t perLevel = std::max<std::size_t>( 1, size / levels );
+  board << Group();
+  Group * group = &board.last<Group>();
+  for ( std::size_t level = 0; level < levels; ++level ) {
+    for ( std::size_t i = 0; i < perLevel; ++i ) {
+      *group << Rectangle( level + i * 0.01, level, 1, 1, Color::Black, Color::Null, 0.1 );
+    }
+    if ( level + 1 < levels ) {
+      *group << Group();
+      group = &group->last<Group>();
+    }
+  }
+}
+
+void textScene( Board & board, std::size_t size )
+{
+  board.setFont( Fonts::Helvetica, 8 );
+  for ( std::size_t i = 0; i < size; ++i ) {
+    std::ostringstream label;
+    label << "Label " << i << " (" << ( i * 7919 ) % 10007 << ")";
+    board.drawText( ( i % 100 ) * 50.0, ( i / 100 ) * 10.0, label.str() );
+  }
+}
+
+// Each triangle is drawn as 4^2 flat sub-triangles.
+void gouraudScene( Board & board, std::size_t size )
+{
+  const std::size_t triangles = std::max<std::size_t>( 2, size / 16 );
+  const std::size_t side = std::max<std::size_t>( 1, static_cast<std::size_t>( std::sqrt( triangles / 2.0 ) ) );
+  for ( std::size_t i = 0; i < side; ++i ) {
+    for ( std::size_t j = 0; j < side; ++j ) {
+      const Point p( i * 10.0, j * 10.0 );
+      const Color c1( ( i * 13 ) % 256, ( j * 7 ) % 256, 128 );
+      const Color c2( ( j * 13 ) % 256, 128, ( i * 7 ) % 256 );
+      board << GouraudTriangle( p, c1, p + Point( 10, 0 ), c2, p + Point( 0, 10 ), Color::White, 2 );
+      board << GouraudTriangle( p + Point( 10, 10 ), c2, p + Point( 10, 0 ), c1, p + Point( 0, 10 ), Color::Black, 2 );
+    }
+  }
+}
+
+// Lines, dots, circles, rectangles, polylines and texts, either added
+// to the board itself or to a FlatShapeList: both scenes are identical.
+template<typename List>
+void addPrimitives( List & list, std::size_t size )
+{
+  Random random( 7 );
+  std::vector<Point> points;
+  for ( std::size_t i = 0; i < size; ++i ) {
+    const double x = random( 0, 1000 );
+    const double y = random( 0, 1000 );
+    const Color color( static_cast<unsigned char>( random( 0, 255 ) ),
+                       static_cast<unsigned char>( random( 0, 255 ) ),
+                       static_cast<unsigned char>( random( 0, 255 ) ) );
+    const double width = random( 0.1, 2.0 );
+    switch ( i % 6 ) {
+    case 0:
+      list << Line( x, y, x + random( -20, 20 ), y + random( -20, 20 ), color, width );
+      break;
+    case 1:
+      list << Dot( x, y, color, width );
+      break;
+    case 2:
+      list << Circle( x, y, random( 1, 10 ), color, Color::Null, width );
+      break;
+    case 3:
+      list << Rectangle( x, y, random( 1, 20 ), random( 1, 20 ), color, Color::Null, width );
+      break;
+    case 4:
+      points.clear();
+      for ( int k = 0; k < 6; ++k ) {
+        points.push_back( Point( x + random( -10, 10 ), y + random( -10, 10 ) ) );
+      }
+      list << Polyline( points, false, color, Color::Null, width );
+      break;
+    default:
+      list << Text( x, y, "label", Fonts::Helvetica, 8, color );
+      break;
+    }
+  }
+}
+
+void primitivesScene( Board & board, std::size_t size )
+{
+  board.reserve( size );
+  addPrimitives( board, size );
+}
+
+void flatScene( Board & board, std::size_t size )
+{
+  FlatShapeList & list = board.emplace<FlatShapeList>();
+  addPrimitives( list, size );
+}
+
+void mixedScene( Board & board, std::size_t size )
+{
+  board << Rectangle( 0, 1000, 1000, 1000, Color::Black, Color::Silver, 1.0 );
+  FlatShapeList & list = board.emplace<FlatShapeList>();
+  addPrimitives( list, size / 2 );
+  addPrimitives( board, size - size / 2 );
+}
+
+struct Scene {
+  const char * name;
+  void (*generate)( Board &, std::size_t );
+};
+
+const Scene scenes[] = {
+  { "koch", kochScene },
+  { "tiling", tilingScene },
+  { "grid", gridScene },
+  { "random", randomScene },
+  { "nested", nestedScene },
+  { "text", textScene },
+  { "gouraud", gouraudScene },
+  { "primitives", primitivesScene },
+  { "flat", flatScene },
+  { "mixed", mixedScene },
+};
+const std::size_t sceneCount = sizeof( scenes ) / sizeof( scenes[0] );
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+ * A flat list of circles between two rectangles of a board: in the FIG
+ * file, the depths of the circles must lie between those of the
+ * rectangles, the first one (drawn first) being the deepest.
+ */
+bool checkMixedDepths()
+{
+  Board board;
+  board << Rectangle( 0, 10, 10, 10, Color::Black, Color::Null, 1.0 );
+  FlatShapeList & list = board.emplace<FlatShapeList>();
+  for ( int i = 0; i < 10; ++i ) {
+    list << Circle( i, 5, 1, Color::Red, Color::Null, 1.0 );
+  }
+  board << Rectangle( 2, 8, 6, 6, Color::Blue, Color::Null, 1.0 );
+  std::ostringstream fig;
+  board.saveFIG( fig );
+
+  std::vector<int> rectangles;
+  std::vector<int> circles;
+  std::istringstream in( fig.str() );
+  std::string line;
+  while ( std::getline( in, line ) ) {
+    std::istringstream fields( line );
+    int object, subtype, style, thickness, pen, fill, depth;
+    if ( line.empty() || line[0] == ' ' || line[0] == '\t'
+         || ! ( fields >> object >> subtype >> style >> thickness >> pen >> fill >> depth ) ) {
+      continue;
+    }
+    if ( object == 2 ) {
+      rectangles.push_back( depth );
+    } else if ( object == 1 ) {
+      circles.push_back( depth );
+    }
+  }
+  if ( rectangles.size() != 2 || circles.size() != 10 ) {
+    return false;
+  }
+  for ( std::size_t i = 0; i < circles.size(); ++i ) {
+    if ( circles[i] >= rectangles[0] || circles[i] <= rectangles[1] ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void report( const char * scene, std::size_t size, const char * phase,
+             Clock::time_point start, std::size_t bytes )
+{
+  const double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+  std::cout << scene << "," << size << "," << phase << "," << seconds << ","
+            << bytes << "," << peakRSS() << std::endl;
+}
+
+void run( const Scene & scene, std::size_t size, bool printStats )
+{
+  Clock::time_point start = Clock::now();
+  Board board;
+  scene.generate( board, size );
+  report( scene.name, size, "construct", start, 0 );
+
+  start = Clock::now();
+  board.rotate( 0.1 );
+  board.translate( 10, -5 );
+  board.scale( 1.01 );
+  report( scene.name, size, "transform", start, 0 );
+
+  start = Clock::now();
+  Rect bbox = board.boundingBox( Shape::UseLineWidth );
+  bbox = bbox || board.boundingBox( Shape::IgnoreLineWidth );
+  report( scene.name, size, "bbox", start, 0 );
+
+  const Board::Format formats[] = { Board::FormatEPS, Board::FormatFIG, Board::FormatSVG, Board::FormatTikZ };
+  const char * names[] = { "saveEPS", "saveFIG", "saveSVG", "saveTikZ" };
+  for ( int f = 0; f < 4; ++f ) {
+    CountingBuffer buffer;
+    std::ostream out( &buffer );
+    ExportStats stats;
+    start = Clock::now();
+    board.save( out, formats[f], Board::BoundingBox, 0.0, Board::UMillimeter, printStats ? &stats : 0 );
+    out.flush();
+    report( scene.name, size, names[f], start, buffer.count() );
+    if ( printStats ) {
+      stats.flushSummary();
+    }
+  }
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  std::size_t size = 100000;
+  bool printStats = false;
+  const char * traceFile = 0;
+  std::vector<const Scene *> selected;
+  for ( int i = 1; i < argc; ++i ) {
+    if ( ! std::strcmp( argv[i], "--size" ) && i + 1 < argc ) {
+      size = std::strtoul( argv[++i], 0, 10 );
+    } else if ( ! std::strcmp( argv[i], "--scene" ) && i + 1 < argc ) {
+      const char * name = argv[++i];
+      std::size_t s = 0;
+      while ( s < sceneCount && std::strcmp( scenes[s].name, name ) ) {
+        ++s;
+      }
+      if ( s == sceneCount ) {
+        std::cerr << "Unknown scene: " << name << std::endl;
+        return 1;
+      }
+      selected.push_back( &scenes[s] );
+    } else if ( ! std::strcmp( argv[i], "--stats" ) ) {
+      printStats = true;
+    } else if ( ! std::strcmp( argv[i], "--trace" ) && i + 1 < argc ) {
+      traceFile = argv[++i];
+    } else if ( ! std::strcmp( argv[i], "--list" ) ) {
+      for ( std::size_t s = 0; s < sceneCount; ++s ) {
+        std::cout << scenes[s].name << std::endl;
+      }
+      return 0;
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--scene name]... [--size n] [--stats] [--trace file] [--list]" << std::endl;
+      return 1;
+    }
+  }
+  if ( selected.empty() ) {
+    for ( std::size_t s = 0; s < sceneCount; ++s ) {
+      selected.push_back( &scenes[s] );
+    }
+  }
+  if ( ! checkMixedDepths() ) {
+    std::cerr << "Error: FIG depths of a FlatShapeList do not follow the drawing order." << std::endl;
+    return 1;
+  }
+  Trace::setEnabled( traceFile != 0 );
+  std::cout << "scene,size,phase,seconds,bytes,peak_rss_kib" << std::endl;
+  for ( std::size_t s = 0; s < selected.size(); ++s ) {
+    run( *selected[s], size, printStats );
+  }
+  if ( traceFile && ! Trace::save( traceFile ) ) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file   bulk_transforms.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Translating, rotating and scaling large boards.
+ *
+ * Usage: bench_bulk_transforms [shapes [points]]
+ *
+ * Builds a board of random lines, polylines, rectangles and circles
+ * (default 2000000 shapes), the same shapes in groups of 2500 (just above
+ * the size from which a list is transformed in parallel), and a polyline
+ * of 4000000 points (by default), then times boundingBox(), translate(),
+ * rotate(), scale() and scaleToWidth() on each. A checksum of the bounding box after all the
+ * transforms is reported: it is the same whatever the number of threads.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+template<typename T>
+void run( const char * name, T & shape )
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  Rect box = shape.boundingBox( Shape::UseLineWidth );
+  std::cout << name << "\tboundingBox\t" << seconds( start ) << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  shape.translate( 10.0, -5.0 );
+  std::cout << name << "\ttranslate\t" << seconds( start ) << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  shape.rotate( 0.3 );
+  std::cout << name << "\trotate\t" << seconds( start ) << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  shape.scale( 1.5, 0.5 );
+  std::cout << name << "\tscale\t" << seconds( start ) << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  shape.scaleToWidth( 210.0, Shape::UseLineWidth );
+  std::cout << name << "\tscaleToWidth\t" << seconds( start ) << std::endl;
+
+  box = shape.boundingBox( Shape::UseLineWidth );
+  std::cout << name << "\tchecksum\t" << std::setprecision( 17 )
+            << box.left + 2 * box.top + 3 * box.width + 4 * box.height
+            << std::setprecision( 6 ) << std::endl;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 2000000;
+  const std::size_t points = ( argc > 2 ) ? std::atoi( argv[2] ) : 4000000;
+
+  const std::size_t groupSize = 2500;
+  Board board;
+  Board groups;
+  board.reserve( shapes );
+  Group group;
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 1000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 1000;
+    switch ( i % 4 ) {
+    case 0:
+      board << Line( x, y, x + 10, y + 5, Color::Red, 0.5 );
+      break;
+    case 1:
+      board << Polyline( Path( { Point( x, y ), Point( x + 5, y + 8 ), Point( x + 9, y + 2 ) }, true ),
+                         Color::Black, Color::Null, 0.2 );
+      break;
+    case 2:
+      board << Rectangle( x, y + 4, 6, 4, Color::Blue, Color::Null, 0.3 );
+      break;
+    default:
+      board << Circle( x, y, 3, Color::Black, Color::Yellow, 0.2 );
+      break;
+    }
+    group << board.last();
+    if ( group.size() == groupSize || i + 1 == shapes ) {
+      groups << group;
+      group.clear();
+    }
+  }
+
+  Polyline polyline( false, Color::Red, Color::Null, 0.5 );
+  for ( std::size_t i = 0; i < points; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    polyline << Point( i * 0.001, ( seed >> 16 ) % 1000 );
+  }
+
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+  std::cout << "object\toperation\ttime (s)" << std::endl;
+  run( "board", board );
+  run( "groups", groups );
+  run( "polyline", polyline );
+  return 0;
+}
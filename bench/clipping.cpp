@@ -0,0 +1,94 @@
+/**
+ * @file   clipping.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Export of a large clipped group.
+ *
+ * Usage: bench_clipping [shapes]
+ *
+ * Draws random lines, polylines and filled rectangles (default 20000) in a
+ * group, exported with no clipping path, clipped by a rectangle (convex,
+ * Sutherland-Hodgman) and by a star (Greiner-Hormann). The size and time of
+ * the export in each format are reported: FIG has no clipping of its own,
+ * so the shapes are cut; the other formats drop the shapes outside.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+void report( const char * clipping, const Group & group )
+{
+  Board board;
+  board << group;
+  const Board::Format formats[] = { Board::FormatEPS, Board::FormatFIG, Board::FormatSVG, Board::FormatTikZ };
+  const char * names[] = { "EPS", "FIG", "SVG", "TikZ" };
+  for ( int f = 0; f < 4; ++f ) {
+    std::ostringstream out;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.save( out, formats[f], Board::A4, 10.0 );
+    const double time = seconds( start );
+    std::cout << clipping << "\t" << names[f] << "\t" << out.str().size() << "\t" << time << std::endl;
+  }
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 20000;
+
+  Group group;
+  unsigned int seed = 12345;
+  double values[4];
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    for ( int v = 0; v < 4; ++v ) {
+      seed = seed * 1103515245 + 12345;
+      values[v] = ( seed >> 16 ) % 1000;
+    }
+    const Point a( values[0], values[1] );
+    const Point b( values[0] + ( values[2] - 500 ) / 10, values[1] + ( values[3] - 500 ) / 10 );
+    switch ( i % 3 ) {
+    case 0:
+      group << Line( a, b, Color::Blue, 0.5 );
+      break;
+    case 1:
+      group << Polyline( Path( { a, b, Point( b.x, a.y ), a + Point( 5, 30 ) }, false ), Color::Black, Color::Null, 0.5 );
+      break;
+    default:
+      group << Rectangle( a.x, a.y, 10 + values[2] / 50, 10 + values[3] / 50, Color::Black, Color::Green, 0.5 );
+      break;
+    }
+  }
+
+  std::cout << "clipping\tformat\tbytes\ttime (s)" << std::endl;
+  report( "none", group );
+
+  Group rectangle( group );
+  rectangle.setClippingRectangle( 250, 750, 500, 500 );
+  report( "rectangle", rectangle );
+
+  Path star( true );
+  for ( int k = 0; k < 10; ++k ) {
+    const double radius = ( k % 2 ) ? 150 : 400;
+    star << Point( 500 + radius * std::cos( k * M_PI / 5 ), 500 + radius * std::sin( k * M_PI / 5 ) );
+  }
+  Group starred( group );
+  starred.setClippingPath( star );
+  report( "star", starred );
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file   concurrent_export.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Benchmark of concurrent exports of independent boards.
+ *
+ * Usage: bench_concurrent_export [threads [boards [rounds [image]]]]
+ *
+ * Every board is first saved (EPS, FIG, SVG, and TikZ when there is no
+ * image) by the main thread.
+ * The boards are then saved again, many times, by several threads at once.
+ * The program prints the serial and concurrent times. It exits with
+ * status 1 if an output differs from the reference one, or if the clipping
+ * paths of a reference SVG output are not numbered from 0: identifiers
+ * (clipping paths, images) only depend on the document. It also checks
+ * that a group can be flushed with a transform that no save method set up.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+// Each board holds ClippedGroups clipped groups, whose SVG ids must be
+// 0, 1, 2... whatever was saved before.
+const int ClippedGroups = 4;
+
+void buildBoard( Board & board, int index, const char * image )
+{
+  board.setLineWidth( 0.5 + ( index % 3 ) );
+  for ( int i = 0; i < 20; ++i ) {
+    board.setPenColor( Color( ( 37 * i + index ) % 256, ( 11 * i ) % 256, 128 ) );
+    board.drawLine( i, 0, i + index % 7, 10 );
+    board.drawCircle( i, i, 1 + ( i + index ) % 4 );
+  }
+  for ( int g = 0; g < ClippedGroups; ++g ) {
+    Group group;
+    group << Rectangle( 0, 10, 10, 10, Color::Blue, Color::Red, 1.0 );
+    group << Ellipse( 5, 5, 3 + g, 2, Color::Black, Color::Green, 0.5 );
+    std::vector<Point> clip;
+    clip.push_back( Point( 1, 1 ) );
+    clip.push_back( Point( 9, 2 ) );
+    clip.push_back( Point( 5, 9 ) );
+    group.setClippingPath( clip );
+    board << group.translate( 12 * g, 20 + index % 5 );
+  }
+  if ( image ) {
+    board << Image( image, 0, 60, 20 );
+    board << Image( image, 30, 60, 10 ).rotate( 0.3 );
+  }
+  board.drawText( 0, -5, "Board" );
+}
+
+// The creation date is the only part of an EPS file that may vary.
+std::string stripCreationDate( const std::string & eps )
+{
+  const std::string::size_type start = eps.find( "%%CreationDate:" );
+  if ( start == std::string::npos ) {
+    return eps;
+  }
+  return eps.substr( 0, start ) + eps.substr( eps.find( '\n', start ) + 1 );
+}
+
+std::string exportAll( const Board & board, bool tikzExport )
+{
+  std::ostringstream eps, fig, svg, tikz;
+  board.saveEPS( eps );
+  board.saveFIG( fig );
+  board.saveSVG( svg );
+  if ( tikzExport ) {
+    board.saveTikZ( tikz );
+  }
+  return stripCreationDate( eps.str() ) + fig.str() + svg.str() + tikz.str();
+}
+
+bool checkClippingIds( const std::string & output )
+{
+  for ( int id = 0; id <= ClippedGroups; ++id ) {
+    std::ostringstream name;
+    name << "id=\"LocalClipPath" << id << "\"";
+    if ( ( output.find( name.str() ) != std::string::npos ) != ( id < ClippedGroups ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A transform that is given no context by a save method uses its own.
+bool checkStandaloneFlush()
+{
+  Group group;
+  group << Line( 0, 0, 10, 10, Color::Black, 1.0 );
+  std::vector<Point> clip;
+  clip.push_back( Point( 0, 0 ) );
+  clip.push_back( Point( 10, 0 ) );
+  clip.push_back( Point( 5, 10 ) );
+  group.setClippingPath( clip );
+  TransformSVG transform;
+  transform.setBoundingBox( group.boundingBox( Shape::UseLineWidth ), 100, 100, 0 );
+  std::ostringstream svg;
+  group.flushSVG( svg, transform );
+  group.flushSVG( svg, transform );
+  return svg.str().find( "id=\"LocalClipPath1\"" ) != std::string::npos;
+}
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const int threads = ( argc > 1 ) ? std::atoi( argv[1] ) : 8;
+  const int boards = ( argc > 2 ) ? std::atoi( argv[2] ) : 32;
+  const int rounds = ( argc > 3 ) ? std::atoi( argv[3] ) : 20;
+  const char * image = ( argc > 4 ) ? argv[4] : 0;
+
+  if ( ! checkStandaloneFlush() ) {
+    std::cerr << "Error: flushing a group with a transform of its own failed." << std::endl;
+    return 1;
+  }
+
+  std::vector<Board> documents( boards );
+  std::vector<std::string> expected( boards );
+  for ( int i = 0; i < boards; ++i ) {
+    buildBoard( documents[i], i, image );
+  }
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for ( int i = 0; i < boards; ++i ) {
+    expected[i] = exportAll( documents[i], ! image );
+    if ( exportAll( documents[i], ! image ) != expected[i] ) {
+      std::cerr << "Error: two exports of board " << i << " differ." << std::endl;
+      return 1;
+    }
+    if ( ! checkClippingIds( expected[i] ) ) {
+      std::cerr << "Error: wrong clipping path ids in the export of board " << i << "." << std::endl;
+      return 1;
+    }
+  }
+  const double serial = seconds( start ) / 2;
+
+  std::atomic<int> mismatches( 0 );
+  std::vector<std::thread> workers;
+  start = std::chrono::steady_clock::now();
+  for ( int t = 0; t < threads; ++t ) {
+    workers.push_back( std::thread( [&, t]() {
+          for ( int r = 0; r < rounds; ++r ) {
+            for ( int i = t; i < boards; i += threads ) {
+              if ( exportAll( documents[( i + r ) % boards], ! image ) != expected[( i + r ) % boards] ) {
+                ++mismatches;
+              }
+            }
+          }
+        } ) );
+  }
+  for ( std::size_t t = 0; t < workers.size(); ++t ) {
+    workers[t].join();
+  }
+  const double concurrent = seconds( start );
+
+  std::cout << "threads\tboards\trounds\tserial(s/round)\tconcurrent(s/round)\n"
+            << threads << "\t" << boards << "\t" << rounds << "\t"
+            << serial << "\t" << concurrent / rounds << std::endl;
+  if ( mismatches ) {
+    std::cerr << "Error: " << mismatches << " concurrent exports differ from the reference." << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file   document.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of saving a multi-page Postscript document.
+ *
+ * Usage: bench_document [pages [shapes [image]]]
+ *
+ * Builds a document of pages (default 16) of lines and texts (default
+ * 50000 shapes per page), each page also showing the same bitmap image
+ * (default resources/saint_michel.jpg, none if the file cannot be read).
+ * The document is saved with one thread and with one thread per core (the
+ * two files are checked to be identical), and its size is compared to
+ * the total size of the pages saved as separate EPS files.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include "board/Document.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+std::string withoutDate( const std::string & document )
+{
+  std::string result = document;
+  std::string::size_type date = result.find( "%%CreationDate" );
+  if ( date != std::string::npos ) {
+    result.erase( date, result.find( '\n', date ) - date );
+  }
+  return result;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t pages = ( argc > 1 ) ? std::atoi( argv[1] ) : 16;
+  const std::size_t shapes = ( argc > 2 ) ? std::atoi( argv[2] ) : 50000;
+  const char * image = ( argc > 3 ) ? argv[3] : "resources/saint_michel.jpg";
+  const bool withImage = std::ifstream( image ).good();
+
+  Document document;
+  unsigned int seed = 12345;
+  for ( std::size_t p = 0; p < pages; ++p ) {
+    Board & page = document.addPage();
+    page.setLineWidth( 0.5 );
+    for ( std::size_t i = 0; i < shapes; ++i ) {
+      seed = seed * 1103515245 + 12345;
+      const double x = ( seed >> 16 ) % 1000;
+      seed = seed * 1103515245 + 12345;
+      const double y = ( seed >> 16 ) % 1000;
+      if ( i % 4 ) {
+        page.drawLine( x, y, x + 10, y + 5 );
+      } else {
+        page.drawText( x, y, "Sheet" );
+      }
+    }
+    if ( withImage ) {
+      page << Image( image, 0, 1000, 200 );
+    }
+  }
+
+  std::size_t separate = 0;
+  for ( std::size_t p = 0; p < pages; ++p ) {
+    std::ostringstream out;
+    document.page( p ).saveEPS( out, Board::A4, 10.0 );
+    separate += out.str().size();
+  }
+
+  std::ostringstream serial, parallel;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  document.savePostscript( serial, Board::A4, 10.0, Board::UMillimeter, "bench", 1 );
+  const double serialTime = seconds( start );
+  start = std::chrono::steady_clock::now();
+  document.savePostscript( parallel, Board::A4, 10.0, Board::UMillimeter, "bench", 0 );
+  const double parallelTime = seconds( start );
+  if ( withoutDate( serial.str() ) != withoutDate( parallel.str() ) ) {
+    std::cerr << "Error: the documents saved with one and several threads differ." << std::endl;
+    return 1;
+  }
+
+  std::cout << "pages\tshapes/page\timage\t1 thread (s)\tthreads (s)\tspeedup\tdocument (bytes)\tseparate EPS (bytes)" << std::endl;
+  std::cout << pages << "\t" << shapes << "\t" << ( withImage ? "yes" : "no" ) << "\t"
+            << serialTime << "\t" << parallelTime << "\t" << serialTime / parallelTime << "\t"
+            << serial.str().size() << "\t" << separate << std::endl;
+  return 0;
+}
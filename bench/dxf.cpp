@@ -0,0 +1,78 @@
+/**
+ * @file   dxf.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  DXF export of a tiled drawing, with one BLOCK per repeated group.
+ *
+ * Usage: bench_dxf [columns [rows]]
+ *
+ * Tiles a cell of twenty shapes (default 100 x 100 times) with
+ * ShapeList::addTiling(), then saves the board as DXF and as SVG. The
+ * size of each document and the time of the export are reported, with
+ * the number of BLOCK and INSERT entities of the DXF document.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+std::size_t count( const std::string & text, const std::string & word )
+{
+  std::size_t n = 0;
+  for ( std::size_t pos = text.find( word ); pos != std::string::npos; pos = text.find( word, pos + 1 ) ) {
+    ++n;
+  }
+  return n;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t columns = ( argc > 1 ) ? std::atoi( argv[1] ) : 100;
+  const std::size_t rows = ( argc > 2 ) ? std::atoi( argv[2] ) : columns;
+
+  Group cell;
+  for ( int i = 0; i < 5; ++i ) {
+    cell << Line( i, 0, i + 4, 8, Color::Red, 0.2 );
+    cell << Rectangle( i, 8, 2, 2, Color::Blue, Color::Null, 0.1 );
+    cell << Circle( i + 1, 4, 1, Color::Black, Color::Yellow, 0.1 );
+    cell << Polyline( Path( { Point( i, 0 ), Point( i + 1, 2 ), Point( i + 2, 0 ) }, false ),
+                      Color::Green, Color::Null, 0.1 );
+  }
+  Board board;
+  board.addTiling( cell, Point( 0, 0 ), columns, rows, 1.0 );
+
+  std::cout << "format\tbytes\ttime (s)\tblocks\tinserts" << std::endl;
+  const Board::Format formats[] = { Board::FormatDXF, Board::FormatSVG };
+  const char * names[] = { "DXF", "SVG" };
+  for ( int f = 0; f < 2; ++f ) {
+    std::ostringstream out;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.save( out, formats[f] );
+    const double time = seconds( start );
+    const std::string text = out.str();
+    std::cout << names[f] << "\t" << text.size() << "\t" << time << "\t";
+    if ( formats[f] == Board::FormatDXF ) {
+      std::cout << count( text, "\nBLOCK\n" ) << "\t" << count( text, "\nINSERT\n" );
+    } else {
+      std::cout << "-\t-";
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
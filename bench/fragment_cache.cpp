@@ -0,0 +1,112 @@
+/**
+ * @file   fragment_cache.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of saving a board again after a small edit, with and
+ *         without the fragment cache.
+ *
+ * Usage: bench_fragment_cache [shapes [edits]]
+ *
+ * Builds a board of lines, polylines and texts (default 300000 shapes),
+ * then for each format saves it once (cold cache), and again after moving
+ * one text, a number of times (default 10). Each save with the cache is
+ * checked to be identical to a save without it.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+std::string save( const Board & board, Board::Format format, double & time )
+{
+  std::ostringstream out;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  board.save( out, format );
+  time = seconds( start );
+  std::string result = out.str();
+  if ( format == Board::FormatEPS ) {
+    // Skip the creation date.
+    std::string::size_type date = result.find( "%%CreationDate" );
+    if ( date != std::string::npos ) {
+      result.erase( date, result.find( '\n', date ) - date );
+    }
+  }
+  return result;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t count = ( argc > 1 ) ? std::atoi( argv[1] ) : 300000;
+  const int edits = ( argc > 2 ) ? std::atoi( argv[2] ) : 10;
+
+  Board board;
+  board.setLineWidth( 0.5 );
+  unsigned int seed = 12345;
+  std::size_t labels = 0;
+  for ( std::size_t i = 0; i < count; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 1000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 1000;
+    switch ( i % 3 ) {
+    case 0:
+      board.drawLine( x, y, x + 10, y + 5 );
+      break;
+    case 1:
+      board.drawPolyline( std::vector<Point>{ Point( x, y ), Point( x + 5, y + 3 ), Point( x + 8, y - 2 ), Point( x + 12, y ) } );
+      break;
+    case 2:
+      board.drawText( x, y, "12.5 mm" );
+      ++labels;
+      break;
+    }
+  }
+  board.setFragmentCaching( true );
+
+  const Board::Format formats[4] = { Board::FormatEPS, Board::FormatFIG, Board::FormatSVG, Board::FormatTikZ };
+  const char * names[4] = { "EPS", "FIG", "SVG", "TikZ" };
+  std::cout << "format\tuncached (s)\tcold (s)\tedited (s)\tspeedup" << std::endl;
+  for ( int f = 0; f < 4; ++f ) {
+    double uncached = 0.0, cold = 0.0, edited = 0.0, time;
+    Board reference( board );
+    reference.setFragmentCaching( false );
+    save( board, formats[f], cold );
+    for ( int e = 0; e < edits; ++e ) {
+      // Move a label, as an interactive tool would. (Shape i is at position count-1-i.)
+      const std::size_t position = count - 1 - ( 3 * ( e % labels ) + 2 );
+      board.last<Text>( position ).translate( 0.5, 0.0 );
+      reference.last<Text>( position ).translate( 0.5, 0.0 );
+      const std::string cached = save( board, formats[f], time );
+      edited += time;
+      const std::string expected = save( reference, formats[f], time );
+      uncached += time;
+      if ( cached != expected ) {
+        std::cerr << "Error: " << names[f] << " output differs with the fragment cache." << std::endl;
+        return 1;
+      }
+    }
+    std::cout << names[f] << "\t" << uncached / edits << "\t" << cold << "\t" << edited / edits << "\t"
+              << uncached / edited << std::endl;
+  }
+  std::cout << "cache: " << board.fragmentCache()->size() << " shapes, "
+            << board.fragmentCache()->memoryUsage() / ( 1024 * 1024 ) << " MiB, "
+            << board.fragmentCache()->hits() << " hits, "
+            << board.fragmentCache()->misses() << " misses" << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file   hatch.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Hatched sections drawn with lines or with native hatching.
+ *
+ * Usage: bench_hatch [sections [spacing]]
+ *
+ * Draws random rectangular sections (default 500) hatched at 45 degrees
+ * (default spacing 1), first as groups of Lines clipped by the outline of
+ * the section, then as rectangles with a Hatch. The memory used by the
+ * board, and the size and time of the export in each format, are reported.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+void report( const char * method, const Board & board )
+{
+  const Board::Format formats[] = { Board::FormatEPS, Board::FormatFIG, Board::FormatSVG, Board::FormatTikZ };
+  const char * names[] = { "EPS", "FIG", "SVG", "TikZ" };
+  for ( int f = 0; f < 4; ++f ) {
+    std::ostringstream out;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.save( out, formats[f], Board::A4, 10.0 );
+    const double time = seconds( start );
+    std::cout << method << "\t" << board.memoryUsage().totalBytes() << "\t" << names[f] << "\t"
+              << out.str().size() << "\t" << time << std::endl;
+  }
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t sections = ( argc > 1 ) ? std::atoi( argv[1] ) : 500;
+  const double spacing = ( argc > 2 ) ? std::atof( argv[2] ) : 1.0;
+
+  Board lines, hatches;
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < sections; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 1000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 1000;
+    const double width = 20 + i % 30;
+    const double height = 10 + i % 20;
+    const Rectangle outline( x, y + height, width, height, Color::Black, Color::Null, 0.5 );
+
+    // Lines at 45 degrees, clipped by the outline.
+    Group group;
+    const double step = spacing * std::sqrt( 2.0 );
+    for ( double d = -height; d < width; d += step ) {
+      group << Line( x + d, y, x + d + height, y + height, Color::Black, 0.1 );
+    }
+    group.setClippingPath( outline.path() );
+    lines << group << outline;
+
+    Rectangle section( outline );
+    section.setHatch( Hatch( M_PI / 4, spacing, 0.1 ) );
+    hatches << section;
+  }
+
+  std::cout << "method\tmemory (bytes)\tformat\tbytes\ttime (s)" << std::endl;
+  report( "lines", lines );
+  report( "hatch", hatches );
+  return 0;
+}
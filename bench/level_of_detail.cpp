@@ -0,0 +1,88 @@
+/**
+ * @file   level_of_detail.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Size of the export of a large drawing with a detail threshold.
+ *
+ * Usage: bench_level_of_detail [shapes [groups]]
+ *
+ * Draws random lines and circles (default 200000 shapes) and small groups
+ * of dots (default 2000 groups of 20 dots) over a 10 m wide drawing, and
+ * saves it in EPS and SVG on an A4 page with several detail thresholds
+ * (see Board::setDetailThreshold()). The size of the output, the time,
+ * and the numbers of shapes culled and simplified are reported.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+unsigned int seed = 12345;
+
+double random( unsigned int range )
+{
+  seed = seed * 1103515245 + 12345;
+  return ( seed >> 16 ) % range;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 200000;
+  const std::size_t groups = ( argc > 2 ) ? std::atoi( argv[2] ) : 2000;
+
+  Board board;
+  board.setLineWidth( 0.5 );
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    const double x = random( 10000 );
+    const double y = random( 10000 );
+    const double length = 1 + random( i % 100 ? 10 : 400 );
+    if ( i % 3 ) {
+      board.drawLine( x, y, x + length, y + length / 2 );
+    } else {
+      board.setPenColor( Color( i % 256, 128, 255 - i % 256 ) );
+      board.fillCircle( x, y, length / 2 );
+    }
+  }
+  for ( std::size_t i = 0; i < groups; ++i ) {
+    const double x = random( 10000 );
+    const double y = random( 10000 );
+    Group group;
+    for ( int dot = 0; dot < 20; ++dot ) {
+      group << Circle( x + random( 20 ), y + random( 20 ), 1.0, Color::Null, Color( dot * 12, 0, 255 - dot * 12 ), 0.0 );
+    }
+    board << group;
+  }
+
+  std::cout << "format\tthreshold (pt)\tbytes\ttime (s)\tculled\tsimplified" << std::endl;
+  const double thresholds[] = { 0.0, 0.1, 0.5, 1.0, 2.0 };
+  const Board::Format formats[] = { Board::FormatEPS, Board::FormatSVG };
+  const char * names[] = { "EPS", "SVG" };
+  for ( int f = 0; f < 2; ++f ) {
+    for ( int t = 0; t < 5; ++t ) {
+      board.setDetailThreshold( thresholds[t] );
+      std::ostringstream out;
+      ExportStats stats;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      board.save( out, formats[f], Board::A4, 10.0, Board::UMillimeter, &stats );
+      const double time = seconds( start );
+      std::cout << names[f] << "\t" << thresholds[t] << "\t" << out.str().size() << "\t" << time << "\t"
+                << stats.culled << "\t" << stats.simplified << std::endl;
+    }
+  }
+  return 0;
+}
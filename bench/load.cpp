@@ -0,0 +1,123 @@
+/**
+ * @file   load.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Reading back SVG and XFig files.
+ *
+ * Usage: bench_load [shapes [directory]]
+ *
+ * Saves a drawing of random lines, polylines, rectangles, circles and
+ * texts (default 200000 shapes) as SVG and FIG files in a directory
+ * (default the current one), then loads each file into an empty board.
+ * The size of the file, the time of the load, the throughput and the
+ * number of shapes read are reported.
+ *
+ * First checks that a text with markup characters is read back from SVG
+ * as it was written (exits with 1 otherwise).
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+long fileSize( const std::string & filename )
+{
+  std::FILE * file = std::fopen( filename.c_str(), "rb" );
+  if ( ! file ) return 0;
+  std::fseek( file, 0, SEEK_END );
+  const long size = std::ftell( file );
+  std::fclose( file );
+  return size;
+}
+
+// Saves a text with markup characters as SVG, loads it and saves the loaded
+// board again: the text must come back unchanged.
+bool checkTextRoundTrip( const std::string & directory )
+{
+  const std::string filename = directory + "/bench_load_text.svg";
+  Board board;
+  board << Text( 10, 10, "Hello <world> & co", Fonts::Helvetica, 3, Color::Black );
+  board.save( filename.c_str() );
+  Board loaded;
+  const bool ok = loaded.load( filename.c_str() );
+  std::remove( filename.c_str() );
+  if ( ! ok || loaded.size() != 1 ) {
+    std::cerr << "text round trip: the SVG file was not read back" << std::endl;
+    return false;
+  }
+  std::ostringstream out;
+  loaded.saveSVG( out );
+  if ( out.str().find( ">Hello &lt;world&gt; &amp; co</text>" ) == std::string::npos ) {
+    std::cerr << "text round trip: the text was not read back as written" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 200000;
+  const std::string directory = ( argc > 2 ) ? argv[2] : ".";
+  if ( ! checkTextRoundTrip( directory ) ) return 1;
+
+  Board board;
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 1000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 1000;
+    switch ( i % 5 ) {
+    case 0:
+      board << Line( x, y, x + 10, y + 5, Color::Red, 0.5 );
+      break;
+    case 1:
+      board << Polyline( Path( { Point( x, y ), Point( x + 5, y + 8 ), Point( x + 9, y + 2 ), Point( x + 4, y - 3 ) }, true ),
+                         Color::Black, Color( 200, 100, 50 ), 0.2 );
+      break;
+    case 2:
+      board << Rectangle( x, y + 4, 6, 4, Color::Blue, Color::Null, 0.3 );
+      break;
+    case 3:
+      board << Circle( x, y, 3, Color::Black, Color::Yellow, 0.2 );
+      break;
+    default:
+      board << Text( x, y, "label", Fonts::Helvetica, 3, Color::Black );
+      break;
+    }
+  }
+
+  std::cout << "format\tbytes\ttime (s)\tMB/s\tshapes" << std::endl;
+  const char * extensions[] = { "svg", "fig" };
+  for ( int f = 0; f < 2; ++f ) {
+    const std::string filename = directory + "/bench_load." + extensions[f];
+    board.save( filename.c_str() );
+    Board loaded;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const bool ok = loaded.load( filename.c_str() );
+    const double time = seconds( start );
+    const long bytes = fileSize( filename );
+    std::cout << extensions[f] << "\t" << bytes << "\t" << time << "\t"
+              << ( time > 0 ? bytes / time / 1e6 : 0.0 ) << "\t"
+              << ( ok ? loaded.size() : 0 ) << std::endl;
+    std::remove( filename.c_str() );
+  }
+  return 0;
+}
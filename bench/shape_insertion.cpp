@@ -0,0 +1,126 @@
+/**
+ * @file   shape_insertion.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of adding shapes to a board: clone, move, or emplace.
+ *
+ * Usage: bench_shape_insertion [shapes [points]]
+ *
+ * Adds lines (default 1000000) to a board with drawLine(), with
+ * operator<< on a named shape (cloned), on a temporary (moved) and with
+ * emplace(), each time without and with a prior reserve(). Then does the
+ * same with polylines of a given number of points (default 16), whose
+ * point vectors are either copied or moved.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+std::size_t shapes = 1000000;
+std::size_t points = 16;
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+template<typename F>
+void run( const char * name, F fill )
+{
+  for ( int reserved = 0; reserved < 2; ++reserved ) {
+    Board board;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if ( reserved ) {
+      board.reserve( shapes );
+    }
+    fill( board );
+    const double time = seconds( start );
+    if ( board.size() != shapes ) {
+      std::cerr << "Error: " << name << " added " << board.size() << " shapes." << std::endl;
+      std::exit( 1 );
+    }
+    std::cout << name << "\t" << ( reserved ? "yes" : "no" ) << "\t" << shapes << "\t"
+              << time << "\t" << ( shapes / time ) / 1.0e6 << std::endl;
+  }
+}
+
+std::vector<Point> polyline( std::size_t i )
+{
+  std::vector<Point> result;
+  result.reserve( points );
+  for ( std::size_t p = 0; p < points; ++p ) {
+    result.push_back( Point( i + p, p ) );
+  }
+  return result;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : shapes;
+  points = ( argc > 2 ) ? std::atoi( argv[2] ) : points;
+
+  std::cout << "method\treserve\tshapes\tseconds\tMshapes/s" << std::endl;
+
+  run( "drawLine", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board.drawLine( i, 0, i, 10 );
+      }
+    } );
+  run( "line-clone", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        const Line line( i, 0, i, 10, Color::Black );
+        board << line;
+      }
+    } );
+  run( "line-move", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board << Line( i, 0, i, 10, Color::Black );
+      }
+    } );
+  run( "line-emplace", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board.emplace<Line>( i, 0, i, 10, Color::Black );
+      }
+    } );
+
+  run( "drawPolyline-copy", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        const std::vector<Point> path = polyline( i );
+        board.drawPolyline( path );
+      }
+    } );
+  run( "drawPolyline-move", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board.drawPolyline( polyline( i ) );
+      }
+    } );
+  run( "polyline-clone", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        const Polyline shape( polyline( i ), false, Color::Black );
+        board << shape;
+      }
+    } );
+  run( "polyline-move", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board << Polyline( polyline( i ), false, Color::Black );
+      }
+    } );
+  run( "polyline-emplace", []( Board & board ) {
+      for ( std::size_t i = 0; i < shapes; ++i ) {
+        board.emplace<Polyline>( polyline( i ), false, Color::Black );
+      }
+    } );
+  return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file   stroke_bbox.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of the bounding box of a stroked path.
+ *
+ * Usage: bench_stroke_bbox [paths [points]]
+ *
+ * Computes the stroke bounding box of random paths (default 100000 paths
+ * of 8 points), open and closed, for each line join and line cap: from
+ * the points returned by pathBoundaryPoints(), as it used to be done, and
+ * with pathBoundingBox(). The largest difference between the two boxes
+ * is reported along with the timings.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include "board/PathBoundaries.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+Rect fromPoints( const std::vector<Point> & points )
+{
+  std::vector<Point>::const_iterator it = points.begin();
+  if ( it == points.end() ) {
+    return Rect();
+  }
+  Rect result( *it, 0.0, 0.0 );
+  while ( it != points.end() ) {
+    result.growToContain( *it++ );
+  }
+  return result;
+}
+
+double difference( const Rect & a, const Rect & b )
+{
+  double d = std::fabs( a.left - b.left );
+  d = std::max( d, std::fabs( a.top - b.top ) );
+  d = std::max( d, std::fabs( a.width - b.width ) );
+  d = std::max( d, std::fabs( a.height - b.height ) );
+  return d;
+}
+
+const char * joinName( Shape::LineJoin join )
+{
+  switch ( join ) {
+  case Shape::MiterJoin: return "miter";
+  case Shape::RoundJoin: return "round";
+  case Shape::BevelJoin: return "bevel";
+  }
+  return "?";
+}
+
+const char * capName( Shape::LineCap cap )
+{
+  switch ( cap ) {
+  case Shape::ButtCap: return "butt";
+  case Shape::RoundCap: return "round";
+  case Shape::SquareCap: return "square";
+  }
+  return "?";
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t count = ( argc > 1 ) ? std::atoi( argv[1] ) : 100000;
+  const std::size_t length = ( argc > 2 ) ? std::atoi( argv[2] ) : 8;
+  std::vector<Path> paths[2];
+  unsigned int seed = 12345;
+  for ( int closed = 0; closed < 2; ++closed ) {
+    paths[closed].reserve( count );
+    for ( std::size_t i = 0; i < count; ++i ) {
+      Path path( closed != 0 );
+      for ( std::size_t p = 0; p < length; ++p ) {
+        seed = seed * 1103515245 + 12345;
+        const double x = ( seed >> 16 ) % 1000;
+        seed = seed * 1103515245 + 12345;
+        const double y = ( seed >> 16 ) % 1000;
+        path << Point( x, y );
+      }
+      paths[closed].push_back( path );
+    }
+  }
+
+  const Shape::LineJoin joins[3] = { Shape::MiterJoin, Shape::RoundJoin, Shape::BevelJoin };
+  const Shape::LineCap caps[3] = { Shape::ButtCap, Shape::RoundCap, Shape::SquareCap };
+  const double width = 7.5;
+  std::vector<Rect> before( count ), after( count );
+  double totalBefore = 0.0, totalAfter = 0.0;
+
+  std::cout << "path\tjoin\tcap\tpoints (s)\tbox (s)\tspeedup\tmax diff" << std::endl;
+  for ( int closed = 0; closed < 2; ++closed ) {
+    for ( int j = 0; j < 3; ++j ) {
+      for ( int c = 0; c < 3; ++c ) {
+        if ( closed && c ) {
+          continue; // Caps do not apply to closed paths.
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for ( std::size_t i = 0; i < count; ++i ) {
+          before[i] = fromPoints( Tools::pathBoundaryPoints( paths[closed][i], width, caps[c], joins[j] ) );
+        }
+        const double timeBefore = seconds( start );
+        start = std::chrono::steady_clock::now();
+        for ( std::size_t i = 0; i < count; ++i ) {
+          after[i] = Tools::pathBoundingBox( paths[closed][i], width, caps[c], joins[j] );
+        }
+        const double timeAfter = seconds( start );
+        double diff = 0.0;
+        for ( std::size_t i = 0; i < count; ++i ) {
+          diff = std::max( diff, difference( before[i], after[i] ) );
+        }
+        totalBefore += timeBefore;
+        totalAfter += timeAfter;
+        std::cout << ( closed ? "closed" : "open" ) << "\t" << joinName( joins[j] ) << "\t"
+                  << ( closed ? "-" : capName( caps[c] ) ) << "\t" << timeBefore << "\t" << timeAfter << "\t"
+                  << timeBefore / timeAfter << "\t" << diff << std::endl;
+      }
+    }
+  }
+  std::cout << "total\t\t\t" << totalBefore << "\t" << totalAfter << "\t" << totalBefore / totalAfter << std::endl;
+  return 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file   tiles.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of saving a drawing as a pyramid of tiles.
+ *
+ * Usage: bench_tiles [shapes [levels [directory]]]
+ *
+ * Draws random lines and circles (default 100000 shapes) and saves them
+ * with Board::saveTiles() (default 5 levels, 256 mm tiles) in SVG and EPS,
+ * with one thread and with the default number of threads. The number of
+ * tiles written and the timings are reported.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 100000;
+  const unsigned int levels = ( argc > 2 ) ? std::atoi( argv[2] ) : 5;
+  const std::string directory = ( argc > 3 ) ? argv[3] : "bench_tiles_output";
+
+  Board board;
+  board.setLineWidth( 0.5 );
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 10000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 10000;
+    if ( i % 3 ) {
+      board.drawLine( x, y, x + 40, y + 15 );
+    } else {
+      board.setFillColor( Color( i % 256, 128, 255 - i % 256 ) );
+      board.fillCircle( x, y, 8 );
+    }
+  }
+
+  std::cout << "format\tlevels\ttiles\t1 thread (s)\tthreads (s)\tspeedup" << std::endl;
+  const Board::Format formats[] = { Board::FormatSVG, Board::FormatEPS };
+  const char * names[] = { "SVG", "EPS" };
+  for ( int f = 0; f < 2; ++f ) {
+    const std::string path = directory + "-" + names[f];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const std::size_t serialTiles = board.saveTiles( path.c_str(), formats[f], 256.0, levels, 1 );
+    const double serialTime = seconds( start );
+    start = std::chrono::steady_clock::now();
+    const std::size_t tiles = board.saveTiles( path.c_str(), formats[f], 256.0, levels, 0 );
+    const double parallelTime = seconds( start );
+    if ( tiles != serialTiles ) {
+      std::cerr << "Error: " << serialTiles << " tiles saved with one thread, " << tiles << " with several." << std::endl;
+      return 1;
+    }
+    std::cout << names[f] << "\t" << levels << "\t" << tiles << "\t"
+              << serialTime << "\t" << parallelTime << "\t" << serialTime / parallelTime << std::endl;
+  }
+  return 0;
+}
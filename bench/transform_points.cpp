@@ -0,0 +1,106 @@
+/**
+ * @file   transform_points.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Cost of mapping path points to page coordinates.
+ *
+ * Usage: bench_transform_points [points [rounds]]
+ *
+ * Maps a path of 1000000 points (by default) with each export transform,
+ * through the virtual methods of Transform, through the final methods of
+ * the concrete transform, and with mapPoints(). The three results are
+ * checked to be identical.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace PlaneDraw;
+
+namespace {
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+void report( const char * format, const char * method, std::size_t points, double time )
+{
+  std::cout << format << "\t" << method << "\t" << points << "\t" << time << "\t"
+            << ( points / time ) / 1.0e6 << std::endl;
+}
+
+// Calls through the base class, as made from code that only knows a
+// Transform (kept out of line so that the compiler cannot see the type).
+#if defined( __GNUC__ )
+__attribute__(( noinline ))
+#endif
+void mapVirtual( const Transform & transform, const std::vector<Point> & points, std::vector<Point> & out )
+{
+  for ( std::size_t i = 0; i < points.size(); ++i ) {
+    out[i].x = transform.mapX( points[i].x );
+    out[i].y = transform.mapY( points[i].y );
+  }
+}
+
+template<typename T>
+void mapFinal( const T & transform, const std::vector<Point> & points, std::vector<Point> & out )
+{
+  for ( std::size_t i = 0; i < points.size(); ++i ) {
+    out[i].x = transform.mapX( points[i].x );
+    out[i].y = transform.mapY( points[i].y );
+  }
+}
+
+template<typename T>
+bool run( const char * format, T & transform, const std::vector<Point> & points, int rounds )
+{
+  transform.setBoundingBox( Rect( 0, 1000, 1000, 1000 ), 210, 297, 10 );
+  std::vector<Point> a( points.size() ), b( points.size() ), c( points.size() );
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for ( int r = 0; r < rounds; ++r ) mapVirtual( transform, points, a );
+  report( format, "virtual", points.size() * rounds, seconds( start ) );
+  start = std::chrono::steady_clock::now();
+  for ( int r = 0; r < rounds; ++r ) mapFinal( transform, points, b );
+  report( format, "final", points.size() * rounds, seconds( start ) );
+  start = std::chrono::steady_clock::now();
+  for ( int r = 0; r < rounds; ++r ) transform.mapPoints( &points[0], points.size(), &c[0] );
+  report( format, "mapPoints", points.size() * rounds, seconds( start ) );
+  for ( std::size_t i = 0; i < points.size(); ++i ) {
+    if ( a[i].x != b[i].x || a[i].y != b[i].y || a[i].x != c[i].x || a[i].y != c[i].y ) {
+      std::cerr << "Error: " << format << " mappings disagree at point " << i << "." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t count = ( argc > 1 ) ? std::atoi( argv[1] ) : 1000000;
+  const int rounds = ( argc > 2 ) ? std::atoi( argv[2] ) : 10;
+  std::vector<Point> points( count );
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < count; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    points[i] = Point( i * ( 1000.0 / count ), ( seed >> 16 ) % 1000 );
+  }
+
+  std::cout << "format\tmethod\tpoints\tseconds\tMpoints/s" << std::endl;
+  TransformEPS eps;
+  TransformFIG fig;
+  TransformSVG svg;
+  if ( ! run( "EPS", eps, points, rounds )
+       || ! run( "FIG", fig, points, rounds )
+       || ! run( "SVG", svg, points, rounds ) ) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file   visitor.cpp
+ * @author PlaneDraw contributors
+ *
+ * @brief  Typed visitors and parallel visits.
+ *
+ * Usage: bench_visitor [shapes [threads]]
+ *
+ * Visits a drawing of random lines, polylines, circles and texts, spread
+ * over groups (default 1000000 shapes), to sum the lengths of the lines
+ * and the radii of the circles: with a ShapeVisitor and dynamic_cast, with
+ * a TypedShapeVisitor, and with ShapeList::parallelAccept() (default one
+ * thread per hardware thread). A BoundingBoxExtractor is then run with
+ * accept() and with parallelAccept(). The time of each visit is reported.
+ *
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ */
+#include "Board.h"
+#include "board/ShapeVisitor.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+using namespace PlaneDraw;
+
+namespace {
+
+double length( const Line & line )
+{
+  const Rect box = line.boundingBox( Shape::IgnoreLineWidth );
+  return std::sqrt( box.width * box.width + box.height * box.height );
+}
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+struct CastingSum : public ShapeVisitor {
+  CastingSum() : sum( 0.0 ) { }
+  void visit( Shape & shape ) {
+    if ( Line * line = dynamic_cast<Line*>( &shape ) ) {
+      sum += length( *line );
+    } else if ( Circle * circle = dynamic_cast<Circle*>( &shape ) ) {
+      sum += circle->boundingBox( Shape::IgnoreLineWidth ).width / 2;
+    }
+  }
+  void visit( Shape & ) const { }
+  double sum;
+};
+
+struct TypedSum : public TypedShapeVisitor {
+  TypedSum() : sum( 0.0 ) { }
+  void visit( const Line & line ) { sum += length( line ); }
+  void visit( const Circle & circle ) { sum += circle.boundingBox( Shape::IgnoreLineWidth ).width / 2; }
+  TypedShapeVisitor * split() const { return new TypedSum; }
+  void merge( TypedShapeVisitor & part ) { sum += static_cast<TypedSum &>( part ).sum; }
+  double sum;
+};
+
+}
+
+int main( int argc, char * argv[] )
+{
+  const std::size_t shapes = ( argc > 1 ) ? std::atoi( argv[1] ) : 1000000;
+  const std::size_t threads = ( argc > 2 ) ? std::atoi( argv[2] ) : 0;
+
+  Board board;
+  Group group;
+  unsigned int seed = 12345;
+  for ( std::size_t i = 0; i < shapes; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const double x = ( seed >> 16 ) % 1000;
+    seed = seed * 1103515245 + 12345;
+    const double y = ( seed >> 16 ) % 1000;
+    switch ( i % 4 ) {
+    case 0:
+      group << Line( x, y, x + 10, y + 5, Color::Red, 0.5 );
+      break;
+    case 1:
+      group << Polyline( Path( { Point( x, y ), Point( x + 5, y + 8 ), Point( x + 9, y + 2 ) }, true ),
+                         Color::Black, Color::Null, 0.2 );
+      break;
+    case 2:
+      group << Circle( x, y, 3, Color::Black, Color::Yellow, 0.2 );
+      break;
+    default:
+      group << Text( x, y, "label", Fonts::Helvetica, 3, Color::Black );
+      break;
+    }
+    if ( group.size() == 10000 ) {
+      board << std::move( group );
+      group.clear();
+    }
+  }
+  board << group;
+
+  std::cout << "visit\ttime (s)\tresult" << std::endl;
+  {
+    CastingSum sum;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.accept( sum );
+    std::cout << "dynamic_cast\t" << seconds( start ) << "\t" << sum.sum << std::endl;
+  }
+  {
+    TypedSum sum;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.accept( sum );
+    std::cout << "typed\t" << seconds( start ) << "\t" << sum.sum << std::endl;
+  }
+  {
+    TypedSum sum;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.parallelAccept( sum, threads );
+    std::cout << "typed parallel\t" << seconds( start ) << "\t" << sum.sum << std::endl;
+  }
+  {
+    ShapeList boxes;
+    BoundingBoxExtractor extractor( boxes );
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.accept( static_cast<TypedShapeVisitor &>( extractor ) );
+    std::cout << "boxes\t" << seconds( start ) << "\t" << boxes.size() << std::endl;
+  }
+  {
+    ShapeList boxes;
+    BoundingBoxExtractor extractor( boxes );
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    board.parallelAccept( extractor, threads );
+    std::cout << "boxes parallel\t" << seconds( start ) << "\t" << boxes.size() << std::endl;
+  }
+  return 0;
+}
@@ -36,7 +36,13 @@
 #include "board/Path.h"
 #include "board/Shapes.h"
 #include "board/Image.h"
+#include "board/ImageCache.h"
 #include "board/ShapeList.h"
+#include "board/FlatShapeList.h"
+#include "board/ExportStats.h"
+#include "board/FragmentCache.h"
+#include "board/Trace.h"
+#include "board/MemoryUsage.h"
 
 namespace PlaneDraw {
 
@@ -58,6 +64,8 @@ public:
 
   enum AspectRatioFlag { IgnoreAspectRatio, KeepAspectRatio };
 
+  enum Format { FormatEPS, FormatFIG, FormatSVG, FormatTikZ, FormatDXF };
+
   /**
    * Constructs a new board and sets the background color, if any.
    *
@@ -93,6 +101,17 @@ public:
    */
   Board & operator<<( const Shape & shape );
 
+  /**
+   * Moves a temporary shape into the board (see ShapeList::operator<<()).
+   *
+   * @param shape A shape.
+   *
+   * @return The board itself.
+   */
+  template<typename T>
+  typename std::enable_if< std::is_base_of<Shape,T>::value && ! std::is_abstract<T>::value, Board & >::type
+  operator<<( T && shape );
+
   /**
    * Clears the board with a given background color.
    *
@@ -109,6 +128,55 @@ public:
    */
   inline void clear( unsigned char red, unsigned char green, unsigned char blue );
 
+  /**
+   * Walks the drawing and reports the memory used by each shape type: the
+   * objects, the point buffers of the paths, the strings and the shape
+   * vectors of the groups (the board itself is reported as "Board").
+   *
+   * @return The memory usage report.
+   */
+  MemoryUsage memoryUsage() const;
+
+  /**
+   * Releases the unused capacity of all the path buffers, strings and
+   * shape vectors of the drawing.
+   */
+  void shrinkToFit();
+
+  /**
+   * Enables or disables the caching of the exported code of the shapes
+   * (see FragmentCache). With caching enabled, saving the board again
+   * with the same format and page setup only formats the shapes modified
+   * (or added) since the previous save, the code of the others is copied
+   * from the cache. Disabling the caching releases the cache.
+   *
+   * @param enabled Whether the exported code should be cached.
+   */
+  void setFragmentCaching( bool enabled );
+
+  /**
+   * @return The fragment cache of the board, or null if caching is disabled.
+   */
+  inline const FragmentCache * fragmentCache() const;
+
+  /**
+   * Sets the level of detail of the EPS and SVG exports (including the
+   * tiles of saveTiles() and the pages of a Document): shapes smaller
+   * than the given size once mapped to the page are not written, and
+   * groups that small are written as a rectangle of their average color
+   * (see LevelOfDetail). The shapes dropped are counted in the culled and
+   * simplified fields of the ExportStats.
+   *
+   * @param size The minimum size, in points (1/72 inch), 0 (the default)
+   *        to write all the shapes.
+   */
+  void setDetailThreshold( double size );
+
+  /**
+   * @return The minimum size of the shapes written, in points (0 if none).
+   */
+  inline double detailThreshold() const;
+
   Board & rotate( double angle, const Point & center );
 
   Board & rotate( double angle );
@@ -444,6 +512,9 @@ public:
   void drawPolyline( const std::vector<Point> & points,
                      int depth = -1 );
 
+  void drawPolyline( std::vector<Point> && points,
+                     int depth = -1 );
+
   /**
    * Draws a closed polygonal line.
    *
@@ -453,6 +524,9 @@ public:
   void drawClosedPolyline( const std::vector<Point> & points,
                            int depth = -1 );
 
+  void drawClosedPolyline( std::vector<Point> && points,
+                           int depth = -1 );
+
   /**
    * Draws a filled polygon.
    *
@@ -462,6 +536,9 @@ public:
   void fillPolyline( const std::vector<Point> & points,
                      int depth = -1 );
 
+  void fillPolyline( std::vector<Point> && points,
+                     int depth = -1 );
+
   /**
    * Draws a string of text.
    *
@@ -704,6 +781,35 @@ public:
                       double scaleX, double scaleY,
                       double angle = 0.0 );
 
+  /**
+   * Append the shapes of an SVG or XFig file to the drawing, depending on
+   * the filename extension. Only the subset of both formats written by the
+   * library is understood; coordinates are read back in millimeters.
+   *
+   * @param filename Path of the file to be read.
+   * @return false if the file could not be read (an error is reported).
+   */
+  bool load( const char * filename );
+
+  /**
+   * Append the shapes of an SVG file (lines, polylines, polygons, paths
+   * made of straight segments, rectangles, circles, ellipses, texts, groups
+   * and their clipping paths) to the drawing.
+   *
+   * @param filename Path of the file to be read.
+   * @return false if the file could not be read (an error is reported).
+   */
+  bool loadSVG( const char * filename );
+
+  /**
+   * Append the shapes of an XFig 3.2 file to the drawing. Arcs and splines
+   * are read as polylines, and imported pictures are skipped.
+   *
+   * @param filename Path of the file to be read.
+   * @return false if the file could not be read (an error is reported).
+   */
+  bool loadFIG( const char * filename );
+
   /**
    * Save the drawing in an EPS, XFIG of SVG file depending
    * on the filename extension. When a size is given (not BoundingBox), the drawing is
@@ -713,8 +819,9 @@ public:
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void save( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void save( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in an EPS, XFIG of SVG file depending
@@ -726,8 +833,46 @@ public:
    * @param pageHeight Height of the page.
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
+   */
+  void save(const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Writes the drawing in a stream, in a given format. When a size is given (not BoundingBox), the drawing is
+   * scaled (up or down) so that it fits within the dimension while keeping its aspect ratio.
+   *
+   * @param out The output stream.
+   * @param format The file format.
+   * @param size Page size (Either BoundingBox (default), A4 or Letter).
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void save(const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void save( std::ostream & out, Format format, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Saves the drawing as a pyramid of square tiles, for zoomable viewers.
+   * At level z (from 0 to levels-1), the square that encloses the drawing
+   * is cut into 2^z x 2^z tiles, tile (x,y) being the x-th from the left
+   * and the y-th from the top. Each tile is written in the file
+   * "<directory>/<z>-<x>-<y>.svg" (or .eps) with the shapes whose bounding
+   * box meets it, edges included, clipped to the tile. Tiles that meet no
+   * shape are not written. The tiles are written by a pool of threads,
+   * started once for all the levels. A manifest of the
+   * tiles and of their extents (in the coordinates of the board) is
+   * written in "<directory>/tiles.json", with the number of shapes culled
+   * and simplified per tile and per level when a detail threshold is set
+   * (see setDetailThreshold()).
+   *
+   * @param directory The output directory (created if needed).
+   * @param format The format of the tiles (FormatSVG or FormatEPS).
+   * @param tileSize The width (and height) of a tile, in millimeters.
+   * @param levels The number of zoom levels.
+   * @param threads The number of threads (0 means one per hardware thread).
+   *
+   * @return The number of tiles written.
+   */
+  std::size_t saveTiles( const char * directory, Format format, double tileSize, unsigned int levels, std::size_t threads = 0 ) const;
 
   /**
    * Writes the drawing in a stream as an EPS file. When a size is given (not BoundingBox), the drawing is
@@ -738,8 +883,9 @@ public:
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
    * @param title Document title (Postscript comment).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveEPS( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string() ) const ;
+  void saveEPS( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string(), ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in an EPS file. When a size is given (not BoundingBox), the drawing is
@@ -750,8 +896,9 @@ public:
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
    * @param title Document title (Postscript comment).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveEPS( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string() ) const ;
+  void saveEPS( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string(), ExportStats * stats = 0 ) const;
 
   /**
    * Writes the drawing in a stream as an EPS file. The drawing is scaled (up or
@@ -764,8 +911,9 @@ public:
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
    * @param title Document title (Postscript comment).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveEPS( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string() ) const ;
+  void saveEPS( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string(), ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in an EPS file. The drawing is scaled (up or down) so
@@ -777,8 +925,9 @@ public:
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
    * @param title Document title (Postscript comment).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveEPS( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string()  ) const ;
+  void saveEPS( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, const std::string & title = std::string(), ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in an XFig file. When a size is given (not BoundingBox), the drawing is
@@ -788,8 +937,9 @@ public:
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveFIG( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void saveFIG( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in a stream as an XFig file. When a size is given (not BoundingBox), the drawing is
@@ -799,8 +949,9 @@ public:
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveFIG( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void saveFIG( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in an XFig file. When a size is given (not BoundingBox), the drawing is
@@ -812,8 +963,9 @@ public:
    * @param pageHeight Height of the page.
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveFIG( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter ) const ;
+  void saveFIG( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in a stream as an XFig file. The drawing is scaled (up or
@@ -825,8 +977,69 @@ public:
    * @param pageHeight Height of the page.
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
+   */
+  void saveFIG( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Saves the drawing in a DXF file (AutoCAD 2004), in millimeters. When a size is given
+   * (not BoundingBox), the drawing is scaled (up or down) so that it fits within the
+   * dimension while keeping its aspect ratio.
+   *
+   * The shapes given a depth from 0 to 999 (as in XFig) are put on a layer per
+   * depth, named DEPTH_<depth>; the others, with the depths the board numbers
+   * automatically, on layer 0. The groups which are translated copies of one
+   * another (e.g. made by ShapeList::addTiling(), ShapeList::repeat() or
+   * addDuplicates()) are written as a single BLOCK, inserted once per copy.
+   *
+   * @param filename The name of the DXF file.
+   * @param size Page size (Either BoundingBox (default), A4 or Letter).
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
+   */
+  void saveDXF( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Saves the drawing in a stream as a DXF file. When a size is given (not BoundingBox), the drawing is
+   * scaled (up or down) so that it fits within the dimension while keeping its aspect ratio.
+   *
+   * @param out The output stream.
+   * @param size Page size (Either BoundingBox (default), A4 or Letter).
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
+   */
+  void saveDXF( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Saves the drawing in a DXF file. The drawing is scaled (up or
+   * down) so that it fits within the dimension while keeping its aspect ratio.
+   *
+   * @param filename The DXF file name.
+   * @param pageWidth Width of the page.
+   * @param pageHeight Height of the page.
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
+   */
+  void saveDXF( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
+
+  /**
+   * Saves the drawing in a stream as a DXF file. The drawing is scaled (up or
+   * down) so that it fits within the dimension while keeping its aspect ratio.
+   *
+   * The shapes are walked twice (to collect the layers, styles and shared
+   * groups, then to write them), and the document is written as it goes.
+   *
+   * @param out The output stream.
+   * @param pageWidth Width of the page.
+   * @param pageHeight Height of the page.
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveFIG( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter ) const ;
+  void saveDXF( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in an SVG file. When a size is given (not BoundingBox), the drawing is
@@ -836,8 +1049,9 @@ public:
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveSVG( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void saveSVG( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in a stream as an SVG file. When a size is given (not BoundingBox), the drawing is
@@ -847,8 +1061,9 @@ public:
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the margin (default value is millimeter). If size is "BoundingBox", this unit is used for the bounding box as well.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveSVG( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter ) const;
+  void saveSVG( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in an SVG file. When a size is given (not BoundingBox), the drawing is
@@ -860,8 +1075,9 @@ public:
    * @param pageHeight Height of the page.
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveSVG( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter ) const ;
+  void saveSVG( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Saves the drawing in a stream as an SVG file. The drawing is scaled (up or down) so
@@ -873,8 +1089,9 @@ public:
    * @param pageHeight Height of the page.
    * @param margin Minimal margin around the figure in the page.
    * @param unit The unit used to express the previous length parameters (default value is millimeter).
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveSVG( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter) const ;
+  void saveSVG( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, Unit unit = UMillimeter, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in an TikZ file. When a size is given (not BoundingBox), the drawing is
@@ -883,8 +1100,9 @@ public:
    * @param filename The name of the file.
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page, in millimeters.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveTikZ( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0 ) const;
+  void saveTikZ( const char * filename, PageSize size = Board::BoundingBox, double margin = 0.0, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in a stream as TikZ file. When a size is given (not BoundingBox), the drawing is
@@ -893,8 +1111,9 @@ public:
    * @param out The output stream.
    * @param size Page size (Either BoundingBox (default), A4 or Letter).
    * @param margin Minimal margin around the figure in the page, in millimeters.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveTikZ( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0 ) const;
+  void saveTikZ( std::ostream & out, PageSize size = Board::BoundingBox, double margin = 0.0, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in an TikZ file. When a size is given (not BoundingBox), the drawing is
@@ -905,8 +1124,9 @@ public:
    * @param pageWidth Width of the page in millimeters.
    * @param pageHeight Height of the page in millimeters.
    * @param margin Minimal margin around the figure in the page, in millimeters.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveTikZ( const char * filename, double pageWidth, double pageHeight, double margin = 0.0 ) const ;
+  void saveTikZ( const char * filename, double pageWidth, double pageHeight, double margin = 0.0, ExportStats * stats = 0 ) const;
 
   /**
    * Save the drawing in a stream as a TikZ file. The drawing is scaled (up or
@@ -917,8 +1137,9 @@ public:
    * @param pageWidth Width of the page in millimeters.
    * @param pageHeight Height of the page in millimeters.
    * @param margin Minimal margin around the figure in the page, in millimeters.
+   * @param stats If not null, filled with statistics about the export.
    */
-  void saveTikZ( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0 ) const ;
+  void saveTikZ( std::ostream & out, double pageWidth, double pageHeight, double margin = 0.0, ExportStats * stats = 0 ) const;
 
 
   /**
@@ -965,8 +1186,53 @@ public:
 
 protected:
 
+  friend class Document;
+
   static double toMillimeter( double x, Unit unit);
 
+  /**
+   * Gives the dimensions of a page size.
+   *
+   * @param size A page size.
+   * @param width Receives the width of the page, in millimeters.
+   * @param height Receives the height of the page, in millimeters.
+   */
+  static void pageDimensions( PageSize size, double & width, double & height );
+
+  /**
+   * @return The Postscript procedures used by the code of the shapes.
+   */
+  static const char * postscriptProcedures();
+
+  /**
+   * Sets the transform of a Postscript export up (see saveEPS()).
+   *
+   * @return The bounding box of the drawing (within the clipping path, if any).
+   */
+  Rect setupPostscript( TransformEPS & transform, double pageWidth, double pageHeight,
+                        double margin, Unit unit, ExportStats * stats ) const;
+
+  /**
+   * Writes the Postscript code of the drawing: the clipping path, the
+   * background and the shapes.
+   */
+  void flushPostscriptDrawing( std::ostream & out, const TransformEPS & transform,
+                               const Rect & bbox, ExportStats * stats ) const;
+
+  /**
+   * Writes a tile of the drawing (see saveTiles()).
+   *
+   * @param out The output stream.
+   * @param format FormatSVG or FormatEPS.
+   * @param tile The extent of the tile.
+   * @param tileSize The size of the tile, in millimeters.
+   * @param drawing The bounding box of the whole drawing.
+   * @param shapes The shapes that meet the tile, in drawing order.
+   * @param stats If not null, filled with the statistics of the tile.
+   */
+  void flushTile( std::ostream & output, Format format, const Rect & tile, double tileSize,
+                  const Rect & drawing, const std::vector<const Shape*> & shapes, ExportStats * stats ) const;
+
 
   /**
    * Current graphical state for drawings made by the drawSomething() methods.
@@ -986,6 +1252,8 @@ protected:
   State _state;                 /**< The current state. */
   Color _backgroundColor;       /**< The color of the background. */
   Path _clippingPath;
+  FragmentCache * _fragmentCache; /**< Null unless caching is enabled. */
+  double _detailThreshold;        /**< Minimum size of the shapes exported (points). */
 };
 } // namespace PlaneDraw
 
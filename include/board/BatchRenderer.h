@@ -0,0 +1,235 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   BatchRenderer.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Renders queues of boards on a pool of threads.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_BATCHRENDERER_H_
+#define _BOARD_BATCHRENDERER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "Board.h"
+#include "board/ThreadPool.h"
+
+namespace PlaneDraw {
+
+/**
+ * The BatchRenderer class.
+ *
+ * @brief Renders many boards concurrently, with a bounded memory footprint.
+ *
+ * A job is a board, an output format and a sink. Jobs are rendered by a
+ * ThreadPool, each one with Board::save() in a memory buffer that is then
+ * handed to the sink (called from a worker thread).
+ *
+ * The memory held by the jobs in flight (queued boards and rendered
+ * documents not yet consumed by their sink) is bounded: submit() blocks
+ * while accepting a new job would exceed the memory budget. A job is
+ * always accepted when no other job is in flight, whatever its size.
+ * Therefore submit() must not be called from a sink or a listener.
+ */
+class BatchRenderer {
+public:
+
+  /**
+   * Receives a rendered document.
+   */
+  typedef std::function<void( const std::string & document )> Sink;
+
+  /**
+   * The report of a completed job.
+   */
+  struct JobReport {
+    std::size_t id;             /**< Job id, as returned by submit(). */
+    Board::Format format;
+    bool ok;                    /**< false if rendering or the sink failed. */
+    std::size_t bytes;          /**< Size of the rendered document. */
+    double queueSeconds;        /**< Time spent waiting for a worker. */
+    double renderSeconds;       /**< Time spent in Board::save(). */
+    double latencySeconds;      /**< From submission to the sink's return. */
+  };
+
+  /**
+   * Receives a report for each completed job (called from a worker thread).
+   */
+  typedef std::function<void( const JobReport & report )> Listener;
+
+  /**
+   * Counters accumulated since the construction of the renderer.
+   */
+  struct Statistics {
+    std::size_t submitted;
+    std::size_t completed;      /**< Jobs done, including failed ones. */
+    std::size_t failed;
+    std::size_t bytes;
+    double totalLatencySeconds;
+    double maxLatencySeconds;
+    double totalRenderSeconds;
+    double elapsedSeconds;      /**< Since the first submission. */
+    std::size_t peakMemory;     /**< Peak of the in-flight memory. */
+
+    double meanLatencySeconds() const;
+    double jobsPerSecond() const;
+    double bytesPerSecond() const;
+  };
+
+  /**
+   * Creates a renderer and starts its workers.
+   *
+   * @param threads The number of worker threads (0 means one per hardware thread).
+   * @param memoryBudget The maximum amount of in-flight memory, in bytes.
+   */
+  BatchRenderer( std::size_t threads = 0, std::size_t memoryBudget = 256 * 1024 * 1024 );
+
+  /**
+   * Waits for all the jobs to be completed.
+   */
+  ~BatchRenderer();
+
+  /**
+   * Queues a copy of a board. Blocks while the memory budget is exhausted.
+   *
+   * @param board The board to be rendered (copied).
+   * @param format The output format.
+   * @param sink Receives the rendered document.
+   * @param size Page size (see Board::save()).
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the margin.
+   *
+   * @return The id of the job.
+   */
+  std::size_t submit( const Board & board,
+                      Board::Format format,
+                      const Sink & sink,
+                      Board::PageSize size = Board::BoundingBox,
+                      double margin = 0.0,
+                      Board::Unit unit = Board::UMillimeter );
+
+  /**
+   * Queues a shared board, which must not be modified until the job is
+   * completed. Blocks while the memory budget is exhausted.
+   *
+   * @param board The board to be rendered.
+   * @param format The output format.
+   * @param sink Receives the rendered document.
+   * @param size Page size (see Board::save()).
+   * @param margin Minimal margin around the figure in the page.
+   * @param unit The unit used to express the margin.
+   *
+   * @return The id of the job.
+   */
+  std::size_t submit( const std::shared_ptr<const Board> & board,
+                      Board::Format format,
+                      const Sink & sink,
+                      Board::PageSize size = Board::BoundingBox,
+                      double margin = 0.0,
+                      Board::Unit unit = Board::UMillimeter );
+
+  /**
+   * Blocks until all the submitted jobs are completed.
+   */
+  void wait();
+
+  /**
+   * Sets the listener that receives the report of each completed job.
+   *
+   * @param listener The listener (may be empty).
+   */
+  void setListener( const Listener & listener );
+
+  /**
+   * @return The counters of the renderer.
+   */
+  Statistics statistics() const;
+
+  /**
+   * @return The memory budget, in bytes.
+   */
+  std::size_t memoryBudget() const;
+
+  /**
+   * @return The memory currently held by the jobs in flight, in bytes.
+   */
+  std::size_t memoryInFlight() const;
+
+  /**
+   * @return The number of worker threads.
+   */
+  std::size_t threadCount() const;
+
+  /**
+   * @param filename A file path.
+   *
+   * @return A sink that writes the document in a file.
+   */
+  static Sink fileSink( const std::string & filename );
+
+private:
+  BatchRenderer( const BatchRenderer & );
+  BatchRenderer & operator=( const BatchRenderer & );
+
+  typedef std::chrono::steady_clock Clock;
+
+  struct Job {
+    std::size_t id;
+    std::shared_ptr<const Board> board;
+    Board::Format format;
+    Sink sink;
+    Board::PageSize size;
+    double margin;
+    Board::Unit unit;
+    std::size_t charge;
+    Clock::time_point submitted;
+  };
+
+  std::size_t enqueue( const std::shared_ptr<const Board> & board,
+                       Board::Format format,
+                       const Sink & sink,
+                       Board::PageSize size,
+                       double margin,
+                       Board::Unit unit,
+                       std::size_t charge );
+  void render( const std::shared_ptr<Job> & job );
+  void acquire( std::size_t bytes );
+  void release( std::size_t bytes );
+
+  const std::size_t _memoryBudget;
+  mutable std::mutex _mutex;
+  std::condition_variable _memoryAvailable;
+  std::size_t _memoryInFlight;
+  std::size_t _jobsInFlight;
+  std::size_t _nextId;
+  Statistics _statistics;
+  Clock::time_point _start;
+  Listener _listener;
+  ThreadPool _pool;
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_BATCHRENDERER_H_ */
@@ -0,0 +1,118 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Clipping.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Geometric clipping of paths by a polygon.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_CLIPPING_H_
+#define _BOARD_CLIPPING_H_
+
+#include <vector>
+#include "board/Path.h"
+#include "board/Rect.h"
+
+namespace PlaneDraw {
+
+/**
+ * The ClipRegion structure.
+ *
+ * @brief A clipping polygon, prepared for the clipping of many shapes.
+ */
+struct ClipRegion {
+
+  /**
+   * @param polygon The clipping polygon (its first point is not repeated).
+   */
+  explicit ClipRegion( const Path & polygon );
+
+  /**
+   * @param p A point.
+   *
+   * @return true if the point is inside the polygon (even-odd rule).
+   */
+  bool contains( const Point & p ) const;
+
+  /**
+   * @param rect A rectangle.
+   *
+   * @return false if the rectangle is surely outside the polygon (it does
+   *         not meet its bounding box), true otherwise.
+   */
+  bool meets( const Rect & rect ) const;
+
+  /**
+   * @param rect A rectangle.
+   *
+   * @return true if the rectangle is surely inside the polygon.
+   */
+  bool surrounds( const Rect & rect ) const;
+
+  Path polygon;                 /**< Closed, counterclockwise. */
+  Rect box;                     /**< The bounding box of the polygon. */
+  bool convex;                  /**< Whether the polygon is convex. */
+};
+
+namespace Tools {
+
+/**
+ * @param polygon A polygon.
+ *
+ * @return true if the polygon is convex (and not self-intersecting).
+ */
+bool isConvex( const Path & polygon );
+
+/**
+ * Intersects a polygon with a clipping region, with the Sutherland-Hodgman
+ * algorithm if the region is convex, with the Greiner-Hormann algorithm
+ * otherwise. Degenerate configurations (vertices on the edges of the other
+ * polygon) of the latter are solved by a tiny perturbation of the subject.
+ *
+ * @param subject The polygon to be clipped (an open path is closed).
+ * @param region The clipping region.
+ * @param result Receives the polygons of the intersection, if the subject
+ *        is not entirely inside the region.
+ *
+ * @return true if the subject is entirely inside the region (result is
+ *         left untouched).
+ */
+bool clipPolygon( const Path & subject, const ClipRegion & region, std::vector<Path> & result );
+
+/**
+ * Cuts the line of a path by a clipping region, keeping the open pieces
+ * inside the region.
+ *
+ * @param subject The path to be clipped (the line of a closed path goes
+ *        back to its first point).
+ * @param region The clipping region.
+ * @param result Receives the pieces inside the region, if the subject is
+ *        not entirely inside the region.
+ *
+ * @return true if the subject is entirely inside the region (result is
+ *         left untouched).
+ */
+bool clipPolyline( const Path & subject, const ClipRegion & region, std::vector<Path> & result );
+
+} // namespace Tools
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_CLIPPING_H_ */
@@ -0,0 +1,276 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   DXF.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  The tables of a DXF export, shared by the shapes.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_DXF_H_
+#define _BOARD_DXF_H_
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "board/Point.h"
+#include "board/Rect.h"
+#include "board/Color.h"
+#include "board/Hatch.h"
+#include "board/PSFonts.h"
+
+namespace PlaneDraw {
+
+struct Group;
+struct TransformDXF;
+
+/**
+ * The DXFTables structure.
+ *
+ * @brief The state of a DXF export: the handles, the layers, the text
+ * styles, and the blocks of the groups drawn more than once.
+ *
+ * A DXF export runs in two passes over the shapes. In the Collect pass,
+ * nothing is written: the layers and styles are recorded, and each group
+ * is identified by a key, computed as its entities relative to the lower
+ * left corner of its bounding box are streamed, without keeping them.
+ * Groups with the same key (e.g. the copies made by ShapeList::addTiling(),
+ * ShapeList::repeat() or Board::addDuplicates()) are then written in the
+ * Write pass as a single BLOCK, and one INSERT per copy.
+ *
+ * The library gives each shape a depth of its own, counting down from
+ * INT_MAX - 1, so depths are not layers in general. Only the depths of
+ * XFig, from 0 to MaxLayerDepth, which a user sets by hand, are written
+ * as layers (named DEPTH_<depth>). The other shapes are on layer 0.
+ */
+struct DXFTables {
+
+  enum Pass { Collect, Write };
+
+  /**
+   * The greatest depth written as a layer of its own.
+   */
+  static const int MaxLayerDepth = 999;
+
+  /**
+   * The identity of the drawing of a group: two independent 64-bit
+   * hashes of its entities, and their length. The entities themselves
+   * are not kept.
+   */
+  struct Key {
+    unsigned long long hash;
+    unsigned long long check;
+    std::size_t length;
+    bool operator<( const Key & other ) const {
+      if ( hash != other.hash ) return hash < other.hash;
+      if ( check != other.check ) return check < other.check;
+      return length < other.length;
+    }
+  };
+
+  /**
+   * A drawing shared by several groups.
+   */
+  struct Block {
+    const Group * group;        /**< The first group with this drawing. */
+    std::size_t count;          /**< The number of groups with this drawing. */
+    std::string name;
+    unsigned long record;       /**< The handle of the BLOCK_RECORD. */
+  };
+
+  DXFTables();
+
+  inline Pass pass() const { return _pass; }
+
+  inline void setPass( Pass pass ) { _pass = pass; }
+
+  /**
+   * @return The key of a group, or 0 if it was not collected yet.
+   */
+  const Key * key( const Group & group ) const;
+
+  /**
+   * Records a group of the drawing. It shares the block of the previous
+   * groups with the same key.
+   *
+   * @param group The group.
+   * @param key The key of its entities.
+   *
+   * @return The key of the group.
+   */
+  const Key & addGroup( const Group & group, const Key & key );
+
+  /**
+   * @return The block a group is drawn with, or 0 if it is drawn as it is.
+   */
+  const Block * block( const Group & group ) const;
+
+  /**
+   * @return The lower left corner of the bounding box of a group, the
+   *         base point of its block.
+   */
+  static Point origin( const Group & group );
+
+  /**
+   * Writes the common group codes of an entity, and records its layer in
+   * the Collect pass.
+   *
+   * @param stream The output stream.
+   * @param type The entity type (LINE, CIRCLE, ...).
+   * @param depth The depth of the shape.
+   * @param color The color of the entity (that of its layer if invalid).
+   * @param lineWidth The line width, in millimeters (none if negative).
+   * @param lineStyle The line style (Shape::LineStyle).
+   */
+  void entity( std::ostream & stream, const char * type, int depth,
+               const Color & color, double lineWidth, int lineStyle );
+
+  /**
+   * Writes a point as group codes code and code + 10 (and code + 20 for z).
+   */
+  static void point( std::ostream & stream, int code, const Point & p, bool z = true );
+
+  /**
+   * Writes the start of a HATCH entity, up to its number of boundary
+   * paths (one). The boundary path is to be written next, then
+   * endHatch() must be called.
+   *
+   * @param hatch The pattern, or an invalid one for a solid fill.
+   */
+  void beginHatch( std::ostream & stream, int depth, const Color & color,
+                   const Hatch & hatch, const TransformDXF & transform );
+
+  /**
+   * Writes a polygonal boundary path of a HATCH.
+   *
+   * @param points The (mapped) vertices of the polygon.
+   */
+  static void hatchPolygon( std::ostream & stream, const std::vector<Point> & points );
+
+  /**
+   * Writes the end of a HATCH entity (its pattern).
+   */
+  void endHatch( std::ostream & stream, const Hatch & hatch, const TransformDXF & transform );
+
+  /**
+   * Writes a solid HATCH, or a hatched one, over a polygon.
+   */
+  void hatch( std::ostream & stream, const std::vector<Point> & points, int depth,
+              const Color & color, const Hatch & hatch, const TransformDXF & transform );
+
+  /**
+   * Writes an INSERT of the block of a group.
+   */
+  void insert( std::ostream & stream, const Block & block, const Point & position, int depth );
+
+  /**
+   * @return The name of the text style of a font, recorded in the Collect pass.
+   */
+  const char * style( Fonts::Font font );
+
+  /**
+   * Writes the HEADER section.
+   *
+   * @param extents The (mapped) extents of the drawing.
+   */
+  void flushHeader( std::ostream & stream, const Rect & extents ) const;
+
+  /**
+   * Writes the TABLES section, and gives its handle to each block.
+   */
+  void flushTables( std::ostream & stream );
+
+  /**
+   * Writes the start of a block: the model space, or a shared drawing.
+   */
+  void beginBlock( std::ostream & stream, const std::string & name, unsigned long record );
+
+  /**
+   * Writes the end of a block.
+   */
+  void endBlock( std::ostream & stream );
+
+  /**
+   * Writes the OBJECTS section.
+   */
+  void flushObjects( std::ostream & stream );
+
+  /**
+   * @return The blocks, in the order their first group was collected.
+   */
+  std::vector<const Block*> blocks() const;
+
+  inline unsigned long modelSpace() const { return _modelSpace; }
+
+  inline unsigned long paperSpace() const { return _paperSpace; }
+
+  inline void setOwner( unsigned long handle ) { _owner = handle; }
+
+  /**
+   * @return The name of the layer of a depth: DEPTH_<depth> from 0 to
+   *         MaxLayerDepth, "0" otherwise.
+   */
+  static std::string layer( int depth );
+
+private:
+  unsigned long nextHandle() { return ++_handle; }
+  void handle( std::ostream & stream, unsigned long owner );
+  void handle( std::ostream & stream ) { handle( stream, _owner ); }
+
+  Pass _pass;
+  unsigned long _handle;                   /**< The last handle given. */
+  unsigned long _owner;                    /**< The handle of the current block record. */
+  unsigned long _modelSpace;
+  unsigned long _paperSpace;
+  unsigned long _dictionary;
+  std::set<int> _depths;
+  std::set<int> _fonts;
+  std::map<const Group*, Key> _groups;
+  std::map<Key, Block> _blocks;
+  std::vector<Key> _order;
+};
+
+/**
+ * The HashingStreamBuffer class.
+ *
+ * @brief A stream buffer which keeps two independent hashes of the
+ * characters written (64-bit FNV-1a, and a polynomial hash), and their
+ * number, instead of the characters.
+ */
+class HashingStreamBuffer : public std::streambuf {
+public:
+  HashingStreamBuffer() : _hash( 14695981039346656037ULL ), _check( 0 ), _length( 0 ) { }
+  inline DXFTables::Key key() const { DXFTables::Key k = { _hash, _check, _length }; return k; }
+protected:
+  int_type overflow( int_type c );
+  std::streamsize xsputn( const char * s, std::streamsize n );
+private:
+  inline void add( unsigned char c );
+  unsigned long long _hash;
+  unsigned long long _check;
+  std::size_t _length;
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_DXF_H_ */
@@ -0,0 +1,150 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Document.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Multi-page documents.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_DOCUMENT_H_
+#define _BOARD_DOCUMENT_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Board.h"
+
+namespace PlaneDraw {
+
+/**
+ * The Document class.
+ *
+ * @brief A sequence of boards, saved as the pages of a single file.
+ *
+ * A document is saved as a multi-page Postscript file that follows the
+ * document structuring conventions (%%Page comments, one prolog and
+ * one setup for the whole document). What the pages have in common is
+ * written once, before the first page: the Postscript procedures used by
+ * the shapes, and each bitmap image placed in the document (kept in a
+ * reusable stream, so that each placement only refers to it). The pages
+ * are formatted concurrently, then written in order.
+ */
+class Document {
+public:
+
+  Document();
+
+  Document( const Document & other );
+
+  ~Document();
+
+  Document & operator=( const Document & other );
+
+  /**
+   * Adds an empty page at the end of the document.
+   *
+   * @return The new page.
+   */
+  Board & addPage();
+
+  /**
+   * Adds a copy of a board at the end of the document.
+   *
+   * @param board A board.
+   *
+   * @return The new page.
+   */
+  Board & addPage( const Board & board );
+
+  /**
+   * Adds a copy of a board at the end of the document.
+   *
+   * @param board A board.
+   *
+   * @return The document itself.
+   */
+  Document & operator<<( const Board & board );
+
+  /**
+   * @return The number of pages.
+   */
+  std::size_t pageCount() const;
+
+  /**
+   * Returns a page of the document.
+   *
+   * @param n The number of the page (the first page is number 0).
+   *
+   * @return The page.
+   */
+  Board & page( std::size_t n );
+
+  const Board & page( std::size_t n ) const;
+
+  /**
+   * Removes all the pages.
+   */
+  void clear();
+
+  /**
+   * Saves the document in a Postscript file, one board per page. The
+   * drawing of each board is scaled (up or down) so that it fits within
+   * the page while keeping its aspect ratio. With the BoundingBox size,
+   * each page has the size of its drawing.
+   *
+   * @param filename The name of the file.
+   * @param size Page size (A4 by default).
+   * @param margin Minimal margin around the drawings in the pages.
+   * @param unit The unit used to express the margin (default value is millimeter).
+   * @param title Document title (Postscript comment).
+   * @param threads The number of threads that format the pages (0 means one per hardware thread).
+   */
+  void savePostscript( const char * filename,
+                       Board::PageSize size = Board::A4,
+                       double margin = 10.0,
+                       Board::Unit unit = Board::UMillimeter,
+                       const std::string & title = std::string(),
+                       std::size_t threads = 0 ) const;
+
+  /**
+   * Saves the document in a stream as a Postscript file (see above).
+   *
+   * @param out The output stream.
+   * @param size Page size (A4 by default).
+   * @param margin Minimal margin around the drawings in the pages.
+   * @param unit The unit used to express the margin (default value is millimeter).
+   * @param title Document title (Postscript comment).
+   * @param threads The number of threads that format the pages (0 means one per hardware thread).
+   */
+  void savePostscript( std::ostream & out,
+                       Board::PageSize size = Board::A4,
+                       double margin = 10.0,
+                       Board::Unit unit = Board::UMillimeter,
+                       const std::string & title = std::string(),
+                       std::size_t threads = 0 ) const;
+
+private:
+  std::vector<Board*> _pages;
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_DOCUMENT_H_ */
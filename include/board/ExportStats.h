@@ -0,0 +1,160 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ExportStats.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Statistics and phase timings of an export.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_EXPORTSTATS_H_
+#define _BOARD_EXPORTSTATS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "board/Rect.h"
+#include "board/Transforms.h"
+
+namespace PlaneDraw {
+
+struct Shape;
+
+/**
+ * The ExportStats structure.
+ *
+ * @brief What an export did, and where its time went.
+ *
+ * An ExportStats may be passed to any of the Board::save*() methods, it
+ * is then filled with the wall time of each phase of the export, and
+ * with the number of shapes, bytes and time per shape type (as given by
+ * Shape::name()). The bytes and time of a Group do not include the ones
+ * of the shapes it contains.
+ */
+struct ExportStats {
+
+  struct ShapeStats {
+    std::size_t count;
+    std::size_t bytes;
+    double seconds;
+  };
+
+  ExportStats();
+
+  /**
+   * Resets all the counters.
+   */
+  void clear();
+
+  /**
+   * Adds some time to a phase (created if needed, phases keep their
+   * order of creation).
+   *
+   * @param phase The name of the phase.
+   * @param seconds The elapsed time.
+   */
+  void addPhase( const std::string & phase, double seconds );
+
+  /**
+   * @param phase The name of a phase.
+   *
+   * @return The time spent in the phase, in seconds.
+   */
+  double phaseSeconds( const std::string & phase ) const;
+
+  /**
+   * Writes a summary of the statistics through Tools::notice.
+   */
+  void flushSummary() const;
+
+  std::string format;                                     /**< "EPS", "FIG", "SVG" or "TikZ". */
+  double totalSeconds;
+  std::size_t bytes;                                      /**< Bytes written. */
+  std::vector< std::pair<std::string,double> > phases;    /**< Seconds per phase. */
+  std::map<std::string,ShapeStats> shapes;                /**< Per shape type. */
+  std::size_t images;                                     /**< Bitmap payloads embedded. */
+  std::size_t groups;
+  std::size_t clipPaths;
+  std::size_t culled;                                     /**< Shapes not written at all. */
+  std::size_t simplified;                                 /**< Shapes written with less detail. */
+  std::size_t cached;                                     /**< Shapes written from the fragment cache. */
+};
+
+/**
+ * A stream buffer that forwards the characters to another buffer,
+ * and counts them.
+ */
+class CountingStreamBuffer : public std::streambuf {
+public:
+  inline explicit CountingStreamBuffer( std::streambuf * destination );
+  inline std::size_t count() const;
+protected:
+  int_type overflow( int_type c );
+  std::streamsize xsputn( const char * s, std::streamsize n );
+  int sync();
+private:
+  std::streambuf * _destination;
+  std::size_t _count;
+};
+
+/**
+ * Records, in the statistics of an export context (if any), the time
+ * spent and the bytes written while flushing a shape.
+ */
+class ShapeStatsScope {
+public:
+  inline ShapeStatsScope( ExportContext & context, const Shape & shape );
+  inline ~ShapeStatsScope();
+private:
+  ShapeStatsScope( const ShapeStatsScope & );
+  ShapeStatsScope & operator=( const ShapeStatsScope & );
+  void begin();
+  void end();
+  ExportContext * _context;
+  const Shape & _shape;
+  std::chrono::steady_clock::time_point _start;
+  std::size_t _startBytes;
+  std::size_t _outerBytes;
+  double _outerSeconds;
+};
+
+/**
+ * Adds the lifetime of the object to a phase of some statistics (if any).
+ */
+class PhaseTimer {
+public:
+  inline PhaseTimer( ExportStats * stats, const char * phase );
+  inline ~PhaseTimer();
+private:
+  PhaseTimer( const PhaseTimer & );
+  PhaseTimer & operator=( const PhaseTimer & );
+  ExportStats * _stats;
+  const char * _phase;
+  std::chrono::steady_clock::time_point _start;
+};
+
+#include "ExportStats.ih"
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_EXPORTSTATS_H_ */
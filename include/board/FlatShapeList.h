@@ -0,0 +1,233 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   FlatShapeList.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A flat list of primitive shapes, stored by type.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_FLATSHAPELIST_H_
+#define _BOARD_FLATSHAPELIST_H_
+
+#include "board/Shapes.h"
+#include <limits>
+#include <vector>
+
+namespace PlaneDraw {
+
+/**
+ * The FlatShapeList structure.
+ *
+ * @brief A list of primitive shapes (lines, dots, circles, rectangles,
+ * polylines and texts) where each type of shape is stored by value, in
+ * its own contiguous array.
+ *
+ * The shapes are exported in depth order through a compact index of
+ * (depth, type, position) entries, and the export and bounding box
+ * computation call the methods of each type directly instead of going
+ * through virtual calls. This suits large drawings made of many simple
+ * shapes; other shapes (groups, images, arrows, ellipses, etc.) cannot be
+ * stored in a FlatShapeList.
+ *
+ * A FlatShapeList is itself a shape, which is usually added to a board
+ * with Board::emplace<FlatShapeList>() and then filled. It is drawn as a
+ * whole, at its own depth among the shapes of the board, in all the
+ * formats: the depths of its shapes only order them within the list.
+ */
+struct FlatShapeList : public Shape {
+
+  enum Kind { LineKind = 0, DotKind, CircleKind, RectangleKind, PolylineKind, TextKind };
+
+  inline FlatShapeList( int depth = -1 );
+
+  ~FlatShapeList();
+
+  /**
+   * Returns the generic name of the shape (e.g., Circle, Rectangle, etc.)
+   *
+   * @return
+   */
+  const std::string & name() const;
+
+  FlatShapeList & clear();
+
+  /**
+   * @return The number of shapes of the list.
+   */
+  inline std::size_t size() const;
+
+  /**
+   * Returns a shape of the list.
+   *
+   * @param n The rank of the shape, in insertion order.
+   *
+   * @return The n-th shape added to the list.
+   */
+  inline const Shape & operator[]( std::size_t n ) const;
+
+  /**
+   * Reserves room for a number of shapes of a given type.
+   *
+   * @param kind The type of the shapes.
+   * @param n The number of shapes.
+   */
+  void reserve( Kind kind, std::size_t n );
+
+  /**
+   * Tells whether a shape may be stored in a FlatShapeList.
+   *
+   * @param shape A shape.
+   *
+   * @return true if the exact type of the shape is one of the stored types.
+   */
+  static bool accepts( const Shape & shape );
+
+  /**
+   * Adds a copy of a shape to the list. If the shape has no given depth,
+   * it is placed on top of the shapes of the list.
+   *
+   * @param shape A shape whose exact type is one of the stored types.
+   *
+   * @return false if the shape could not be stored (it is then ignored):
+   *         its type is not a stored one, or the list already holds
+   *         MaxShapesPerKind shapes of this type.
+   */
+  bool add( const Shape & shape );
+
+  /**
+   * Adds a copy of a shape to the list (see add()). An error is reported
+   * if the shape cannot be stored.
+   *
+   * @param shape The shape to be added.
+   *
+   * @return The list itself.
+   */
+  FlatShapeList & operator<<( const Shape & shape );
+
+  FlatShapeList & rotate( double angle, const Point & center );
+
+  FlatShapeList & rotate( double angle );
+
+  FlatShapeList & translate( double dx, double dy );
+
+  FlatShapeList & scale( double sx, double sy );
+
+  FlatShapeList & scale( double s );
+
+  void scaleAll( double s );
+
+  void flushPostscript( std::ostream & stream,
+                        const TransformEPS & transform ) const;
+
+  void flushFIG( std::ostream & stream,
+                 const TransformFIG & transform,
+                 std::map<Color,int> & colormap ) const;
+
+  void flushSVG( std::ostream & stream,
+                 const TransformSVG & transform ) const;
+
+  void flushTikZ( std::ostream & stream,
+                  const TransformTikZ & transform ) const;
+
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const;
+
+  Rect boundingBox( LineWidthFlag ) const;
+
+  /**
+   * @return The smallest depth of the shapes of the list (see depth() for
+   *         the depth of the list itself).
+   */
+  int minDepth() const;
+
+  /**
+   * @return The largest depth of the shapes of the list.
+   */
+  int maxDepth() const;
+
+  void shiftDepth( int shift );
+
+  FlatShapeList * clone() const;
+
+  void accountMemory( MemoryUsage & usage ) const;
+
+  void shrinkToFit();
+
+  void accept( ShapeVisitor & visitor );
+
+  void accept( const ShapeVisitor & visitor );
+
+  /**
+   * @brief Accepts a typed visitor, called with the static type of each shape.
+   */
+  void accept( TypedShapeVisitor & visitor ) const;
+
+  /**
+   * The number of shapes of each type a list may hold (the range of
+   * Entry::index).
+   */
+  static const std::size_t MaxShapesPerKind = std::size_t( 1 ) << 29;
+
+  /**
+   * A shape of the list: its depth, its type, and its position in the
+   * array of its type.
+   */
+  struct Entry {
+    int depth;
+    unsigned int kind : 3;
+    unsigned int index : 29;
+  };
+
+private:
+
+  static const std::string _name; /**< The generic name of the shape. */
+
+  /**
+   * Returns the shape of an entry.
+   */
+  Shape & shape( const Entry & entry );
+
+  const Shape & shape( const Entry & entry ) const;
+
+  void addEntry( int depth, Kind kind, std::size_t index );
+
+  /**
+   * Calls flush( shape ) on each shape, in drawing order, with the static
+   * type of the shape.
+   */
+  template<typename Flush>
+  void flushEntries( const Flush & flush, ExportContext & context ) const;
+
+  std::vector<Line> _lines;
+  std::vector<Dot> _dots;
+  std::vector<Circle> _circles;
+  std::vector<Rectangle> _rectangles;
+  std::vector<Polyline> _polylines;
+  std::vector<Text> _texts;
+  std::vector<Entry> _entries; /**< In insertion order. */
+  bool _inOrder;               /**< Whether the depths of the entries do not increase (drawing order). */
+  int _nextDepth;              /**< The depth of the next shape to be added. */
+};
+
+#include "FlatShapeList.ih"
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_FLATSHAPELIST_H_ */
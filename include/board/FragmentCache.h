@@ -0,0 +1,175 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   FragmentCache.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A cache of the exported code of the shapes of a board.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_FRAGMENTCACHE_H_
+#define _BOARD_FRAGMENTCACHE_H_
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "board/Color.h"
+
+namespace PlaneDraw {
+
+struct Shape;
+struct Transform;
+
+/**
+ * The FragmentCache class.
+ *
+ * @brief Keeps the exported code (EPS, FIG, SVG or TikZ) of the shapes of
+ * a board, so that saving it again after a small edit only formats the
+ * shapes that were modified.
+ *
+ * An entry is kept per shape and per format. It is valid as long as the
+ * shape has the same revision (see Shape::revision()), and the export
+ * uses a transform with the same fingerprint (see Transform::fingerprint())
+ * and an output stream with the same formatting flags; a FIG entry also
+ * depends on the colormap. Only the primitive shapes (dots, lines, arrows,
+ * polylines, rectangles, triangles, ellipses, circles and texts) are
+ * cached: the code of groups, images and hatched shapes depends on the
+ * export itself (identifiers of clipping paths, images and patterns). The entries of shapes that
+ * are not part of an export any more are dropped at the end of it.
+ *
+ * A cache is used by one export at a time: an export that starts while
+ * another one uses the cache writes all its shapes without it.
+ *
+ * The cache of a board is enabled with Board::setFragmentCaching().
+ */
+class FragmentCache {
+public:
+
+  enum Format { EPS = 0, FIG, SVG, TikZ };
+
+  FragmentCache();
+
+  /**
+   * Tells whether the code of a shape may be cached.
+   *
+   * @param shape A shape.
+   *
+   * @return true if the exact type of the shape is a primitive one, and
+   *         the shape is not hatched.
+   */
+  static bool cacheable( const Shape & shape );
+
+  /**
+   * @return The number of shapes with cached code.
+   */
+  std::size_t size() const;
+
+  /**
+   * @return The number of bytes of cached code.
+   */
+  std::size_t memoryUsage() const;
+
+  /**
+   * @return The number of shapes written from the cache.
+   */
+  std::size_t hits() const;
+
+  /**
+   * @return The number of shapes formatted (and stored in the cache).
+   */
+  std::size_t misses() const;
+
+  /**
+   * Removes all the entries of the cache.
+   */
+  void clear();
+
+  /**
+   * The shapes of one export, written through the cache.
+   */
+  class Session {
+  public:
+
+    /**
+     * Starts an export. The transform (and the colormap, for the FIG
+     * format) must be set up, and remain unchanged until the session ends.
+     *
+     * @param cache A cache (if null, shapes are written directly).
+     * @param format The format of the export.
+     * @param transform The transform of the export (of the type matching the format).
+     * @param out The output stream.
+     * @param colormap The colormap of a FIG export.
+     */
+    Session( FragmentCache * cache, Format format, const Transform & transform,
+             std::ostream & out, std::map<Color,int> * colormap = 0 );
+
+    /**
+     * Ends the export, dropping the entries of the shapes not written.
+     */
+    ~Session();
+
+    /**
+     * Writes the code of a shape, from the cache if possible.
+     *
+     * @param shape A shape.
+     */
+    void flush( const Shape & shape );
+
+  private:
+    Session( const Session & );
+    Session & operator=( const Session & );
+    void write( const Shape & shape, std::ostream & out );
+    FragmentCache * _cache;
+    std::unique_lock<std::mutex> _lock;
+    Format _format;
+    const Transform & _transform;
+    std::ostream & _out;
+    std::map<Color,int> * _colormap;
+    std::ostringstream _buffer;
+  };
+
+private:
+  FragmentCache( const FragmentCache & );
+  FragmentCache & operator=( const FragmentCache & );
+
+  struct Entry {
+    Entry();
+    unsigned long long revision[4]; /**< Revision of the shape, per format. */
+    unsigned long long epoch[4];    /**< Epoch of the code, per format. */
+    std::string code[4];
+    unsigned long long visit;       /**< Last export that wrote the shape. */
+  };
+
+  mutable std::mutex _mutex;
+  std::unordered_map<const Shape*,Entry> _entries;
+  std::string _fingerprints[4];   /**< Of the last export, per format. */
+  unsigned long long _epochs[4];  /**< Changed when the fingerprint changes. */
+  unsigned long long _visit;
+  std::size_t _bytes;
+  std::size_t _hits;
+  std::size_t _misses;
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_FRAGMENTCACHE_H_ */
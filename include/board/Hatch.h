@@ -0,0 +1,195 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Hatch.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Hatch patterns used to fill closed shapes.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_HATCH_H_
+#define _BOARD_HATCH_H_
+
+#include <ostream>
+#include <string>
+#include "board/Color.h"
+
+namespace PlaneDraw {
+
+struct TransformEPS;
+struct TransformSVG;
+struct TransformTikZ;
+
+/**
+ * The Hatch structure.
+ *
+ * @brief Parallel (or crossed) lines filling a closed shape, as used for
+ * the sections of technical drawings.
+ *
+ * A hatch is written natively by each format, so that a hatched region
+ * is a single shape and a single element of the output: an SVG
+ * &lt;pattern&gt; and a PostScript pattern (both defined once per export
+ * and per distinct hatch), a TikZ pattern of the "patterns.meta" library
+ * (which must be loaded by the document that includes the picture), and
+ * the nearest XFig area fill pattern (41 to 62). XFig patterns have fixed
+ * angles and spacing, and are drawn with the pen color of the shape on
+ * its fill color (white if it has none).
+ */
+struct Hatch {
+
+  /**
+   * Builds an invalid hatch (no hatching).
+   */
+  inline Hatch();
+
+  /**
+   * @param angle The angle of the lines, in radians, counterclockwise.
+   * @param spacing The distance between two lines, in the unit of the board.
+   * @param lineWidth The width of the lines (as the line width of the shapes).
+   * @param cross Whether perpendicular lines are drawn as well.
+   * @param color The color of the lines.
+   */
+  inline Hatch( double angle, double spacing, double lineWidth = 0.25,
+                bool cross = false, const Color & color = Color::Black );
+
+  /**
+   * @return true if lines should be drawn (positive spacing).
+   */
+  inline bool valid() const;
+
+  inline bool operator==( const Hatch & other ) const;
+
+  inline bool operator!=( const Hatch & other ) const;
+
+  /**
+   * Rotates the lines.
+   *
+   * @param angle The rotation angle, in radians.
+   */
+  inline void rotate( double angle );
+
+  /**
+   * @param angle The rotation angle, in radians.
+   *
+   * @return A copy of the hatch, rotated.
+   */
+  inline Hatch rotated( double angle ) const;
+
+  /**
+   * Updates the angle and spacing of the lines after a scaling of the
+   * shape. The perpendicularity of cross hatching is not preserved by a
+   * non uniform scaling: only the main direction is mapped.
+   *
+   * @param sx Scaling factor along the x axis.
+   * @param sy Scaling factor along the y axis.
+   */
+  void scale( double sx, double sy );
+
+  /**
+   * Writes the definition of the PostScript pattern of the hatch, unless
+   * the export already has it.
+   *
+   * @param stream The output stream.
+   * @param transform The transform of the export.
+   *
+   * @return The name of the pattern.
+   */
+  std::string flushPostscriptDefinition( std::ostream & stream, const TransformEPS & transform ) const;
+
+  /**
+   * Writes the definition of the SVG pattern of the hatch, unless the
+   * export already has it.
+   *
+   * @param stream The output stream.
+   * @param transform The transform of the export.
+   * @param background The color below the lines (may be Color::Null).
+   *
+   * @return The value of the fill attribute of the hatched shape.
+   */
+  std::string flushSVGDefinition( std::ostream & stream, const TransformSVG & transform,
+                                  const Color & background ) const;
+
+  /**
+   * @param transform The transform of the export.
+   * @param background The color below the lines (may be Color::Null).
+   *
+   * @return The TikZ options of the hatched path, starting with a comma.
+   */
+  std::string tikz( const TransformTikZ & transform, const Color & background ) const;
+
+  /**
+   * @return The XFig area fill (41 to 62) that best matches the hatch.
+   */
+  int figAreaFill() const;
+
+  double angle;                 /**< The angle of the lines (radians). */
+  double spacing;               /**< The distance between two lines. */
+  double lineWidth;             /**< The width of the lines. */
+  bool cross;                   /**< Whether perpendicular lines are drawn. */
+  Color color;                  /**< The color of the lines. */
+
+  static const Hatch None;
+};
+
+inline
+Hatch::Hatch()
+  : angle( 0.0 ), spacing( 0.0 ), lineWidth( 0.0 ), cross( false ), color( Color::Null )
+{
+}
+
+inline
+Hatch::Hatch( double angle, double spacing, double lineWidth, bool cross, const Color & color )
+  : angle( angle ), spacing( spacing ), lineWidth( lineWidth ), cross( cross ), color( color )
+{
+}
+
+inline bool
+Hatch::valid() const
+{
+  return spacing > 0.0 && color.valid();
+}
+
+inline bool
+Hatch::operator==( const Hatch & other ) const
+{
+  return angle == other.angle && spacing == other.spacing && lineWidth == other.lineWidth
+      && cross == other.cross && color == other.color;
+}
+
+inline bool
+Hatch::operator!=( const Hatch & other ) const
+{
+  return ! ( *this == other );
+}
+
+inline void
+Hatch::rotate( double angle )
+{
+  this->angle += angle;
+}
+
+inline Hatch
+Hatch::rotated( double angle ) const
+{
+  return Hatch( this->angle + angle, spacing, lineWidth, cross, color );
+}
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_HATCH_H_ */
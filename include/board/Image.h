@@ -87,6 +87,19 @@ struct Image : public Shape {
    */
   Image * clone() const;
 
+  void accept( TypedShapeVisitor & visitor ) const;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const;
+
+  void shrinkToFit();
+
+  /**
+   * @return The filename of the bitmap image.
+   */
+  const std::string & filename() const;
+
   /**
    * Rotate the shape around a given center of rotation.
    *
@@ -221,6 +234,38 @@ struct Image : public Shape {
   void flushSVG( std::ostream & stream,
                  const TransformSVG & transform ) const;
 
+  /**
+   * Writes the SVG definition (to be placed in a <defs> element) of a
+   * bitmap image, as a 1x1 image with id "image<id>". Each placement of
+   * the image is then written as a <use> element by flushSVG(), provided
+   * that the transform knows about the definition (see
+   * TransformSVG::setImageDefinitions()).
+   *
+   * @param stream The output stream.
+   * @param filename The image filename.
+   * @param id The id of the definition.
+   */
+  static void flushSVGDefinition( std::ostream & stream,
+                                  const std::string & filename,
+                                  unsigned int id );
+
+  /**
+   * Writes the Postscript definition of a bitmap image, shared by the
+   * pages of a document (see Tools::flushPostscriptImageDefinition()).
+   * Each placement of the image then calls the definition, provided that
+   * the transform knows about it (see ExportContext::setImageDefinitions()).
+   *
+   * @param stream The output stream.
+   * @param filename The image filename.
+   * @param id The id of the definition.
+   *
+   * @return false if the image cannot be defined (it is then written
+   *         inline by each placement).
+   */
+  static bool flushPostscriptDefinition( std::ostream & stream,
+                                         const std::string & filename,
+                                         unsigned int id );
+
   /**
    * Writes the TikZ code of the shape in a stream according
    * to a transform.
@@ -231,6 +276,9 @@ struct Image : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const;
+
 private:
   static const std::string _name;        /**< The generic name of the shape. */
   Rectangle _rectangle;
@@ -0,0 +1,159 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ImageCache.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A process-wide cache of encoded bitmap image payloads.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_IMAGECACHE_H_
+#define _BOARD_IMAGECACHE_H_
+
+#include <iostream>
+#include <string>
+#include <cstddef>
+#include "board/Rect.h"
+
+namespace PlaneDraw {
+
+/**
+ * The ImageCache class.
+ *
+ * @brief Process-wide cache of the encoded payloads of bitmap files.
+ *
+ * Encoding a bitmap image (base64 for SVG, EPS fragment for Postscript)
+ * is by far the most expensive part of exporting a board that contains
+ * images. Payloads are therefore kept, for each file and each encoding,
+ * in a cache shared by all the boards of the process. An entry is keyed
+ * by the file path together with its modification time and size, so that
+ * a file modified on disk is encoded again. The cache has a memory budget:
+ * when it is exceeded, the least recently used payloads are evicted.
+ *
+ * All the methods are thread-safe.
+ */
+class ImageCache {
+public:
+
+  enum Encoding { Base64, EPSFragment };
+
+  /**
+   * Writes a cached payload to a stream, if available.
+   *
+   * @param filename The path of the bitmap file.
+   * @param encoding The requested encoding.
+   * @param out The output stream.
+   * @param boundingBox If not null, receives the bounding box stored along
+   *                    with the payload (EPS fragments).
+   *
+   * @return true if the payload was found (and written), otherwise false.
+   */
+  static bool flush( const std::string & filename,
+                     Encoding encoding,
+                     std::ostream & out,
+                     Rect * boundingBox = 0 );
+
+  /**
+   * Stores an encoded payload in the cache. The payload is silently
+   * dropped if the file cannot be stat'ed, or if it is larger than the
+   * memory budget.
+   *
+   * @param filename The path of the bitmap file.
+   * @param encoding The encoding of the payload.
+   * @param payload The encoded data.
+   * @param boundingBox A bounding box associated with the payload.
+   */
+  static void store( const std::string & filename,
+                     Encoding encoding,
+                     const std::string & payload,
+                     const Rect & boundingBox = Rect() );
+
+  /**
+   * Writes the base64 encoding of a file to a stream, using the
+   * cache when possible and filling it otherwise.
+   *
+   * @param filename The path of the bitmap file.
+   * @param out The output stream.
+   *
+   * @return false if the file could not be read.
+   */
+  static bool flushBase64( const std::string & filename, std::ostream & out );
+
+  /**
+   * Retrieves the dimensions (in pixels) of a bitmap file from its
+   * header (see Tools::probeImageSize()). Dimensions are cached per path
+   * (and modification time), so that placing the same file many times
+   * reads its header once.
+   *
+   * @param filename The path of the bitmap file.
+   * @param width Receives the width of the image.
+   * @param height Receives the height of the image.
+   *
+   * @return false if the dimensions could not be read.
+   */
+  static bool imageSize( const std::string & filename,
+                         std::size_t & width,
+                         std::size_t & height );
+
+  /**
+   * Sets the maximum amount of memory (in bytes) used by the cached
+   * payloads. Entries are evicted, least recently used first, if needed.
+   * A budget of 0 disables the cache.
+   *
+   * @param bytes The memory budget.
+   */
+  static void setMemoryBudget( std::size_t bytes );
+
+  /**
+   * @return The memory budget (in bytes). Default is 64 MiB.
+   */
+  static std::size_t memoryBudget();
+
+  /**
+   * @return The amount of memory (in bytes) used by cached payloads.
+   */
+  static std::size_t memoryUsage();
+
+  /**
+   * @return The number of cached payloads.
+   */
+  static std::size_t size();
+
+  /**
+   * @return The number of lookups that were served from the cache.
+   */
+  static std::size_t hits();
+
+  /**
+   * @return The number of lookups that missed.
+   */
+  static std::size_t misses();
+
+  /**
+   * Removes all the entries of the cache.
+   */
+  static void clear();
+
+private:
+  ImageCache();
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_IMAGECACHE_H_ */
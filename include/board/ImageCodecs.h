@@ -0,0 +1,174 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ImageCodecs.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Minimal bitmap decoders and encoders (PNG, JPEG, ASCII85).
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_IMAGECODECS_H_
+#define _BOARD_IMAGECODECS_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace PlaneDraw {
+
+namespace Tools {
+
+/**
+ * An 8 bits per component bitmap, stored row by row from the top.
+ */
+struct Bitmap {
+  std::size_t width;
+  std::size_t height;
+  int components;                     /**< 1 (gray) or 3 (RGB). */
+  std::vector<unsigned char> pixels;
+};
+
+/**
+ * Information read from the frame header (SOF) of a JPEG file.
+ */
+struct JPEGInfo {
+  std::size_t width;
+  std::size_t height;
+  int components;                     /**< 1 (gray), 3 (YCbCr) or 4 (CMYK). */
+  int precision;                      /**< Bits per sample. */
+  bool adobeInverted;                 /**< Adobe CMYK data, stored inverted. */
+};
+
+/**
+ * Reads a whole file in memory.
+ *
+ * @param filename The file path.
+ * @param data The file content.
+ *
+ * @return false if the file could not be read.
+ */
+bool readFile( const char * filename, std::vector<unsigned char> & data );
+
+/**
+ * Decompresses a raw deflate stream (RFC 1951).
+ *
+ * @param data The compressed data.
+ * @param size The size of the compressed data.
+ * @param out Receives the decompressed data (appended).
+ *
+ * @return false if the stream is invalid.
+ */
+bool inflate( const unsigned char * data, std::size_t size, std::vector<unsigned char> & out );
+
+/**
+ * Decompresses a zlib stream (RFC 1950).
+ *
+ * @param data The compressed data.
+ * @param size The size of the compressed data.
+ * @param out Receives the decompressed data (appended).
+ *
+ * @return false if the stream is invalid.
+ */
+bool zlibDecompress( const unsigned char * data, std::size_t size, std::vector<unsigned char> & out );
+
+/**
+ * Decodes a PNG file (all color types, bit depths and interlacing).
+ * Gray images give 1-component bitmaps, other ones 3-components (RGB)
+ * bitmaps. Transparent pixels are composed over a white background.
+ *
+ * @param data The content of the PNG file.
+ * @param size The size of the file.
+ * @param bitmap The decoded image.
+ *
+ * @return false if the data is not a valid PNG image.
+ */
+bool decodePNG( const unsigned char * data, std::size_t size, Bitmap & bitmap );
+
+/**
+ * Reads the frame header of a JPEG file.
+ *
+ * @param data The content of the JPEG file (or at least its headers).
+ * @param size The size of the data.
+ * @param info The information read.
+ *
+ * @return false if no frame header was found.
+ */
+bool readJPEGInfo( const unsigned char * data, std::size_t size, JPEGInfo & info );
+
+/**
+ * Reads the dimensions of a bitmap image from the header of its file,
+ * without decoding the image. Supported formats are PNG (IHDR chunk),
+ * JPEG (SOF marker), GIF and BMP. Only a few hundred bytes are read
+ * (JPEG segments that precede the frame header are skipped).
+ *
+ * @param filename The path of the file.
+ * @param width Receives the width of the image, in pixels.
+ * @param height Receives the height of the image, in pixels.
+ *
+ * @return false if the file could not be read or its format is not supported.
+ */
+bool probeImageSize( const char * filename, std::size_t & width, std::size_t & height );
+
+/**
+ * Writes data in ASCII85 (base 85) encoding, ended by the "~>" marker.
+ * Lines never begin with a '%' character, so that the output can be
+ * safely embedded in a DSC conforming Postscript file.
+ *
+ * @param data The data.
+ * @param size The size of the data.
+ * @param out The output stream.
+ * @param linesize The maximum length of the output lines.
+ */
+void ascii85encode( const unsigned char * data, std::size_t size, std::ostream & out, int linesize = 75 );
+
+/**
+ * Writes the Postscript code that paints a bitmap file (PNG or JPEG) in the
+ * unit square [0,1]x[0,1] of the current user space. JPEG data is passed
+ * through the DCTDecode filter as is, PNG images are decoded and written
+ * as raw samples. Both are ASCII85 encoded. The code requires Postscript
+ * language level 2.
+ *
+ * @param filename The path of a PNG or JPEG file.
+ * @param out The output stream.
+ *
+ * @return false if the file could not be read or is not supported.
+ */
+bool flushPostscriptImage( const char * filename, std::ostream & out );
+
+/**
+ * Writes the Postscript code that defines a bitmap file (PNG or JPEG)
+ * once for a whole document: the data is kept in a reusable stream, and
+ * the procedure "BoardImage<id>" paints it in the unit square of the
+ * current user space, as flushPostscriptImage() does. The code requires
+ * Postscript language level 3.
+ *
+ * @param filename The path of a PNG or JPEG file.
+ * @param out The output stream.
+ * @param id The identifier of the definition.
+ *
+ * @return false if the file could not be read or is not supported.
+ */
+bool flushPostscriptImageDefinition( const char * filename, std::ostream & out, unsigned int id );
+
+} // namespace Tools
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_IMAGECODECS_H_ */
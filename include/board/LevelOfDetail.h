@@ -0,0 +1,104 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   LevelOfDetail.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Culling of the shapes too small to be seen in an export.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_LEVELOFDETAIL_H_
+#define _BOARD_LEVELOFDETAIL_H_
+
+#include <cstddef>
+#include <iostream>
+#include "board/Color.h"
+
+namespace PlaneDraw {
+
+struct Shape;
+struct Transform;
+struct TransformEPS;
+struct TransformSVG;
+
+/**
+ * The LevelOfDetail structure.
+ *
+ * @brief Decides which shapes are too small to be worth writing in an
+ * export, given the detail threshold of its context (see
+ * ExportContext::setDetailThreshold()).
+ *
+ * A shape whose bounding box, once mapped, is smaller than the threshold
+ * in both directions is culled. A group (or any shape list) that small is
+ * instead written as a single filled rectangle over its bounding box,
+ * with the average color of its shapes, so that dense clusters of tiny
+ * shapes do not vanish. Culled shapes and collapsed groups are counted in
+ * the ExportStats of the export, the shapes of a collapsed group as
+ * culled and the group itself as simplified.
+ *
+ * The sizes are those of the output: points (1/72 inch) for both EPS and
+ * SVG.
+ */
+struct LevelOfDetail {
+
+  enum Decision { Keep = 0, Collapse, Cull };
+
+  /**
+   * @param shape A shape.
+   * @param transform The transform of an export.
+   *
+   * @return What should be written of the shape.
+   */
+  static Decision decide( const Shape & shape, const Transform & transform );
+
+  /**
+   * Writes the reduced version of a shape, if it is below the detail
+   * threshold of the export: nothing, or the rectangle of a group.
+   *
+   * @param shape A shape.
+   * @param stream The output stream.
+   * @param transform The transform of the export.
+   *
+   * @return true if the shape was reduced (and must not be flushed), false
+   *         if it must be written in full.
+   */
+  static bool flushReduced( const Shape & shape, std::ostream & stream, const TransformEPS & transform );
+
+  static bool flushReduced( const Shape & shape, std::ostream & stream, const TransformSVG & transform );
+
+  /**
+   * @param shape A shape.
+   *
+   * @return The average of the fill (or pen, when there is no fill) colors
+   *         of the shape or of the shapes it contains, Color::Null if
+   *         none has a color.
+   */
+  static Color averageColor( const Shape & shape );
+
+  /**
+   * @param shape A shape.
+   *
+   * @return The number of primitive shapes in the shape.
+   */
+  static std::size_t count( const Shape & shape );
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_LEVELOFDETAIL_H_ */
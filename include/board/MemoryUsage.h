@@ -0,0 +1,121 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   MemoryUsage.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Memory footprint of a drawing, per shape type.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_MEMORYUSAGE_H_
+#define _BOARD_MEMORYUSAGE_H_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PlaneDraw {
+
+struct Path;
+
+/**
+ * The MemoryUsage structure.
+ *
+ * @brief The bytes used by the shapes of a drawing, per shape type.
+ *
+ * Filled by Board::memoryUsage(), or by Shape::accountMemory(). Heap
+ * buffers are accounted for their capacity, the part of the capacity
+ * that is not used is also reported as wasted (see Board::shrinkToFit()).
+ * Allocator overhead is not taken into account.
+ */
+struct MemoryUsage {
+
+  struct ShapeUsage {
+    std::size_t count;            /**< Number of objects. */
+    std::size_t objectBytes;      /**< Size of the objects themselves. */
+    std::size_t pointBytes;       /**< Point buffers of the paths. */
+    std::size_t stringBytes;      /**< Heap buffers of the strings. */
+    std::size_t containerBytes;   /**< Shape pointer arrays of the lists. */
+    std::size_t wastedBytes;      /**< Unused capacity of the above buffers. */
+    inline std::size_t totalBytes() const;
+  };
+
+  /**
+   * Counts an object.
+   *
+   * @param type The shape type (Shape::name()).
+   * @param bytes The size of the object.
+   */
+  void addObject( const std::string & type, std::size_t bytes );
+
+  /**
+   * Adds the point buffer of a path (the path object itself being part of
+   * some shape object).
+   *
+   * @param type The shape type.
+   * @param path The path.
+   */
+  void addPath( const std::string & type, const Path & path );
+
+  /**
+   * Adds the heap buffer of a string, if any (short strings are usually
+   * stored in the string object).
+   *
+   * @param type The shape type.
+   * @param str The string.
+   */
+  void addString( const std::string & type, const std::string & str );
+
+  /**
+   * Adds the buffer of an array of elements.
+   *
+   * @param type The shape type.
+   * @param size The number of elements.
+   * @param capacity The capacity of the array.
+   * @param elementSize The size of an element.
+   */
+  void addContainer( const std::string & type, std::size_t size, std::size_t capacity, std::size_t elementSize );
+
+  /**
+   * @return The bytes used by all the shapes.
+   */
+  std::size_t totalBytes() const;
+
+  /**
+   * @return The unused capacity of all the buffers, in bytes.
+   */
+  std::size_t wastedBytes() const;
+
+  /**
+   * Writes a summary of the memory usage through Tools::notice.
+   */
+  void flushSummary() const;
+
+  std::map<std::string,ShapeUsage> shapes;    /**< Per shape type. */
+};
+
+std::size_t MemoryUsage::ShapeUsage::totalBytes() const
+{
+  return objectBytes + pointBytes + stringBytes + containerBytes;
+}
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_MEMORYUSAGE_H_ */
@@ -29,6 +29,7 @@
 #include "board/Point.h"
 #include "board/Rect.h"
 #include "board/Transforms.h"
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -45,6 +46,9 @@ struct Path {
   Path( const std::vector<Point> & points, bool closed )
     : _points( points ), _closed( closed ) { }
 
+  Path( std::vector<Point> && points, bool closed )
+    : _points( std::move( points ) ), _closed( closed ) { }
+
   explicit Path( bool closed ) : _closed( closed ) { }
 
   inline void clear();
@@ -55,6 +59,16 @@ struct Path {
 
   inline std::size_t size() const;
 
+  /**
+   * @return The number of points the path may hold without reallocating.
+   */
+  inline std::size_t capacity() const;
+
+  /**
+   * Releases the unused capacity of the point buffer.
+   */
+  void shrinkToFit();
+
   inline void setClosed( bool closed  );
 
   /**
@@ -318,6 +332,12 @@ Path::size() const
   return _points.size();
 }
 
+std::size_t
+Path::capacity() const
+{
+  return _points.capacity();
+}
+
 void
 Path::setClosed( bool closed )
 {
@@ -58,12 +58,30 @@ std::vector<Point>  pathBoundaryPoints(const Path & path,
                                        Shape::LineJoin lineJoin,
                                        double miterLimit = 4.0);
 
+/*
+ * The bounding box of the stroke of a path. The joins and caps are folded
+ * into the box as the path is scanned, with no allocation; round joins
+ * and caps contribute the extremities of their arcs. Gives the same box
+ * as the points returned by pathBoundaryPoints(), which is kept for the
+ * callers that need the points.
+ */
 Rect pathBoundingBox(const Path & path,
                      double strokeWidth,
                      Shape::LineCap lineCap,
                      Shape::LineJoin lineJoin,
                      double miterLimit = 4.0);
 
+/*
+ * Same as above, for a path given as an array of n points.
+ */
+Rect pathBoundingBox(const Point * points,
+                     std::size_t n,
+                     bool closed,
+                     double strokeWidth,
+                     Shape::LineCap lineCap,
+                     Shape::LineJoin lineJoin,
+                     double miterLimit = 4.0);
+
 
 
 
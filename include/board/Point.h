@@ -57,6 +57,13 @@ struct Point {
    */
   Point( const Point & other ):x(other.x),y(other.y) { }
 
+  /**
+   * Point assignment.
+   *
+   * @param other The point to be copied.
+   */
+  Point & operator=( const Point & other ) { x = other.x; y = other.y; return *this; }
+
   /**
    * Point constructor.
    *
@@ -0,0 +1,114 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Reader.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Reading back the SVG and XFig files written by the library.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_READER_H_
+#define _BOARD_READER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace PlaneDraw {
+
+struct ShapeList;
+
+/**
+ * The MappedFile class.
+ *
+ * @brief A read-only file mapped in memory (or read in a buffer, where
+ * files cannot be mapped).
+ */
+class MappedFile {
+public:
+
+  /**
+   * @param filename The path of the file.
+   */
+  explicit MappedFile( const char * filename );
+
+  ~MappedFile();
+
+  /**
+   * @return true if the file could be opened and mapped (or read).
+   */
+  inline bool valid() const { return _valid; }
+
+  inline const char * begin() const { return _data; }
+
+  inline const char * end() const { return _data + _size; }
+
+  inline std::size_t size() const { return _size; }
+
+private:
+  MappedFile( const MappedFile & );
+  MappedFile & operator=( const MappedFile & );
+
+  const char * _data;
+  std::size_t _size;
+  bool _mapped;
+  bool _valid;
+  std::vector<char> _buffer;   /**< The content, when the file is not mapped. */
+};
+
+/**
+ * The Reader structure.
+ *
+ * @brief Single pass parsers of the SVG and XFig subsets written by the
+ * library. Characters are read in place, without copies.
+ *
+ * The shapes are added to a list with coordinates in millimeters (the
+ * unit of a BoundingBox export in millimeters), the y axis going up.
+ */
+struct Reader {
+
+  /**
+   * Reads SVG elements: svg, g (with a transform, or a clip-path),
+   * clipPath, line, polyline, polygon, path (M, L and Z commands), rect,
+   * circle, ellipse and text. Other elements are skipped, with a warning.
+   *
+   * @param begin The first character of the document.
+   * @param end The end of the document.
+   * @param shapes The list the shapes are added to.
+   *
+   * @return false if the document is not well formed.
+   */
+  static bool readSVG( const char * begin, const char * end, ShapeList & shapes );
+
+  /**
+   * Reads the objects of an XFig 3.2 file: colors, arcs, compounds,
+   * ellipses, polylines, splines and texts (object codes 0 to 6). Arcs
+   * and splines are read as polylines, pictures are skipped.
+   *
+   * @param begin The first character of the file.
+   * @param end The end of the file.
+   * @param shapes The list the shapes are added to.
+   *
+   * @return false if the file is not a valid XFig 3.2 file.
+   */
+  static bool readFIG( const char * begin, const char * end, ShapeList & shapes );
+};
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_READER_H_ */
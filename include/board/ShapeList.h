@@ -29,6 +29,10 @@
 
 #include "board/Shapes.h"
 #include "board/Tools.h"
+#include "board/Clipping.h"
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
 
 #if __cplusplus<201100
 #define override
@@ -102,6 +106,11 @@ struct ShapeList : public Shape {
   
   ShapeList & clear();
 
+  /**
+   * @return The number of shapes of the list (groups count for one).
+   */
+  inline std::size_t size() const;
+
   ShapeList & rotate( double angle, const Point & center );
 
   ShapeList rotated( double angle, const Point & center );
@@ -143,6 +152,11 @@ struct ShapeList : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const;
+
   Rect boundingBox(LineWidthFlag) const;
   
   virtual int minDepth() const;
@@ -152,6 +166,10 @@ struct ShapeList : public Shape {
   void shiftDepth( int shift );
 
   ShapeList * clone() const;
+
+  void accountMemory( MemoryUsage & usage ) const;
+
+  void shrinkToFit();
   
   /**
    * Adds a shape to the shape list. If the shape has no given depth
@@ -164,6 +182,38 @@ struct ShapeList : public Shape {
    */
   ShapeList & operator<<( const Shape & shape );
 
+  /**
+   * Adds a temporary shape to the shape list. The shape is moved into the
+   * list (its buffers are taken over) instead of being cloned. Shape lists
+   * other than groups are inserted as with operator<<( const Shape & ).
+   *
+   * @param shape The shape to be moved into the list.
+   *
+   * @return The shape list itself.
+   */
+  template<typename T>
+  typename std::enable_if< std::is_base_of<Shape,T>::value && ! std::is_abstract<T>::value, ShapeList & >::type
+  operator<<( T && shape );
+
+  /**
+   * Constructs a shape directly in the shape list, with no temporary to
+   * be copied. The shape is placed as with operator<<().
+   *
+   * @param args The arguments of a constructor of T.
+   *
+   * @return The new shape.
+   */
+  template<typename T, typename... Args>
+  T & emplace( Args &&... args );
+
+  /**
+   * Reserves room for a number of shapes, so that adding them does
+   * not reallocate the shape vector.
+   *
+   * @param n The number of shapes.
+   */
+  inline void reserve( std::size_t n );
+
   /**
    * Adds a shape to the list of shape, always preserving the shape's depth.
    *
@@ -279,6 +329,33 @@ struct ShapeList : public Shape {
    */
   virtual void accept( const ShapeVisitor & visitor );
 
+  /**
+   * @brief Accepts a typed visitor, which visits the shapes of the list
+   * (and of its sub-lists), in the order of the list.
+   *
+   * @param visitor A typed visitor object.
+   */
+  void accept( TypedShapeVisitor & visitor ) const;
+
+  /**
+   * @brief Accepts a typed visitor over several threads. The shapes of
+   * the list (and of its sub-lists) are split into consecutive parts, each
+   * visited by its own visitor made by TypedShapeVisitor::split(), and the
+   * parts are then merged in order. The list is visited in the calling
+   * thread, as with accept(), if it is small or the visitor cannot be split.
+   *
+   * The parts are visited by the shared ThreadPool (see
+   * ThreadPool::parallelRanges()), or in the calling thread if it is
+   * itself a worker of a pool. Their visit() methods are called
+   * concurrently: they must not modify the shapes, nor share anything
+   * but read-only data.
+   *
+   * @param visitor A typed visitor object.
+   * @param threads The number of threads the visit is split for (0 means
+   *        one per hardware thread, 1 visits in the calling thread).
+   */
+  void parallelAccept( TypedShapeVisitor & visitor, std::size_t threads = 0 ) const;
+
 private:
 
   static const std::string _name; /**< The generic name of the shape. */
@@ -287,6 +364,75 @@ protected:
 
   void addShape( const Shape & shape, double scaleFactor );
 
+  /**
+   * Adds a shape (not a ShapeList), which the list takes ownership of.
+   *
+   * @param shape A shape allocated with new.
+   */
+  void insertShape( Shape * shape );
+
+  /**
+   * Scales each shape about its own center, and moves it as if the list
+   * were scaled about a given point. The shapes of large lists are scaled
+   * in parallel.
+   *
+   * @param sx The x scaling factor.
+   * @param sy The y scaling factor.
+   * @param center The center of the scaling (that of the list).
+   */
+  void scaleShapes( double sx, double sy, const Point & center );
+
+  /**
+   * Adds the shape vector, and the shapes it points to, to a memory report.
+   *
+   * @param usage The report.
+   * @param type The type the vector is accounted to.
+   */
+  void accountShapes( MemoryUsage & usage, const std::string & type ) const;
+
+  /**
+   * Collects the shapes to be drawn, by decreasing depth.
+   *
+   * @param shapes Receives the shapes.
+   * @param pieces Receives the pieces of the shapes which are clipped (see
+   *        Group), which shapes may point to.
+   * @param geometric Whether the shapes are clipped geometrically, or only
+   *        dropped if outside (for the formats which clip by themselves).
+   */
+  virtual void drawingOrder( std::vector<const Shape*> & shapes,
+                             ShapeList & pieces,
+                             bool geometric ) const;
+
+  /**
+   * Clips shapes by a region, in parallel for large vectors.
+   *
+   * @param shapes The shapes, replaced by the shapes inside the region and
+   *        the pieces of the clipped ones (in the same order).
+   * @param region The clipping region.
+   * @param geometric Whether the shapes are clipped geometrically, or only
+   *        dropped if outside.
+   * @param pieces Receives the pieces of the clipped shapes.
+   */
+  static void clipShapes( std::vector<const Shape*> & shapes,
+                          const ClipRegion & region,
+                          bool geometric,
+                          ShapeList & pieces );
+
+  /**
+   * Fills a list with the children of the list clipped by a region.
+   *
+   * @param region The clipping region.
+   * @param list The list.
+   *
+   * @return true if some child has been clipped.
+   */
+  bool clipChildren( const ClipRegion & region, ShapeList & list ) const;
+
+  /**
+   * Releases the unused capacity of the shape vector, and of the shapes.
+   */
+  void shrinkShapes();
+
   std::vector<Shape*> _shapes; /**< The vector of shapes. */
   int _nextDepth;              /**< The depth of the next figure to be added. */
 
@@ -309,6 +455,9 @@ struct Group : public ShapeList {
   Group( const Group & other )
     : ShapeList( other ), _clippingPath( other._clippingPath ) { }
 
+  Group( Group && other )
+    : ShapeList( std::move( other ) ), _clippingPath( std::move( other._clippingPath ) ) { }
+
   ~Group() { }
   
   /**
@@ -376,16 +525,30 @@ struct Group : public ShapeList {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const;
+
   Group & operator=( const Group & other );
 
   Group * clone() const;
 
+  void accountMemory( MemoryUsage & usage ) const;
+
+  void shrinkToFit();
+
   Rect boundingBox(LineWidthFlag) const;
 
+protected:
+
+  void drawingOrder( std::vector<const Shape*> & shapes,
+                     ShapeList & pieces,
+                     bool geometric ) const;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
   Path _clippingPath;
-  static std::size_t _clippingCount;
 };
 
 
@@ -26,6 +26,9 @@
 #ifndef _BOARD_SHAPE_VISITOR_H_
 #define _BOARD_SHAPE_VISITOR_H_
 
+#include <vector>
+#include "board/Rect.h"
+
 #if __cplusplus<201100
 #define override
 #endif
@@ -36,19 +39,86 @@ namespace PlaneDraw {
   struct Shape;
   struct ShapeList;
   struct Board;
+  struct Dot;
+  struct Line;
+  struct Arrow;
+  struct Polyline;
+  struct Rectangle;
+  struct Triangle;
+  struct GouraudTriangle;
+  struct Ellipse;
+  struct Circle;
+  struct Text;
+  struct Image;
 
   struct ShapeVisitor {
     virtual void visit( Shape & shape ) = 0;
     virtual void visit( Shape & shape ) const = 0;
   };
 
-  struct BoundingBoxExtractor : public ShapeVisitor {
+  /**
+   * The TypedShapeVisitor structure.
+   *
+   * @brief A read-only visitor with one visit() method per type of shape,
+   * called by Shape::accept() with no dynamic_cast. Compound shapes (lists,
+   * groups and flat lists) are not visited themselves: their shapes are.
+   *
+   * Each method calls by default the one of the base type of its shape
+   * (e.g. an Arrow is visited as a Line, a Circle as an Ellipse), down to
+   * visit( const Shape & ), which does nothing. Shapes defined outside the
+   * library are visited as a Shape.
+   *
+   * A visitor may be run over several threads by ShapeList::parallelAccept()
+   * if it can be split: split() returns a new empty visitor, which visits
+   * a part of the shapes, then is merged into the original one.
+   */
+  struct TypedShapeVisitor {
+    virtual ~TypedShapeVisitor();
+    virtual void visit( const Shape & shape );
+    virtual void visit( const Dot & dot );
+    virtual void visit( const Line & line );
+    virtual void visit( const Arrow & arrow );
+    virtual void visit( const Polyline & polyline );
+    virtual void visit( const Rectangle & rectangle );
+    virtual void visit( const Triangle & triangle );
+    virtual void visit( const GouraudTriangle & triangle );
+    virtual void visit( const Ellipse & ellipse );
+    virtual void visit( const Circle & circle );
+    virtual void visit( const Text & text );
+    virtual void visit( const Image & image );
+
+    /**
+     * @return A new visitor, with no result yet, for a part of the shapes
+     *         visited in parallel. The default (0) means that the visitor
+     *         cannot be split, and runs in the calling thread only.
+     */
+    virtual TypedShapeVisitor * split() const;
+
+    /**
+     * Merges the result of a part made by split(). Parts are merged in
+     * the order of their shapes.
+     *
+     * @param part A visitor returned by split().
+     */
+    virtual void merge( TypedShapeVisitor & part );
+  };
+
+  /**
+   * Adds to a shape list the bounding box (as a Rectangle) of each
+   * shape visited.
+   */
+  struct BoundingBoxExtractor : public ShapeVisitor, public TypedShapeVisitor {
     BoundingBoxExtractor( ShapeList & );
     void visit( Shape & ) override;
     void visit( Shape & ) const override;
+    void visit( const Shape & ) override;
+    TypedShapeVisitor * split() const override;
+    void merge( TypedShapeVisitor & part ) override;
     const ShapeList & shapeList() const;
   private:
-    ShapeList & _shapeList;
+    BoundingBoxExtractor();
+    ShapeList * _shapeList;     /**< Null in a part of a parallel visit. */
+    std::vector<Rect> _boxes;   /**< The boxes found by a part. */
   };
 
   struct BoundingBoxViewer : public ShapeVisitor {
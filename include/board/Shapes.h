@@ -30,6 +30,7 @@
 #include "board/Rect.h"
 #include "board/Path.h"
 #include "board/Color.h"
+#include "board/Hatch.h"
 #include "board/PSFonts.h"
 #include "board/Tools.h"
 #include "board/Transforms.h"
@@ -54,6 +55,10 @@
 namespace PlaneDraw {
 
 struct ShapeVisitor;
+struct TypedShapeVisitor;
+struct MemoryUsage;
+struct ShapeList;
+struct ClipRegion;
 
 /**
  * Shape structure.
@@ -317,6 +322,49 @@ struct Shape {
   virtual void flushTikZ( std::ostream & stream,
                           const TransformTikZ & transform ) const = 0;
 
+  /**
+   * Write the DXF entities of the shape in a stream according to a transform.
+   *
+   * @param stream The output stream.
+   * @param transform A 2D transform to be applied.
+   */
+  virtual void flushDXF( std::ostream & stream,
+                         const TransformDXF & transform ) const = 0;
+
+  /**
+   * The outcome of the clipping of a shape by a region.
+   */
+  enum ClipResult { ClippedOut = 0, /**< The shape is outside the region. */
+                    Unclipped,      /**< The shape is kept as it is. */
+                    Clipped         /**< The shape is replaced by its pieces. */ };
+
+  /**
+   * Intersects the shape with a clipping region, for the formats that have
+   * no clipping of their own (e.g. XFig). The default keeps the shape whole
+   * if it meets the region.
+   *
+   * @param region The clipping region.
+   * @param pieces Receives the pieces of the shape inside the region, if the
+   *        result is Clipped.
+   *
+   * @return How the shape is clipped.
+   */
+  virtual ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const;
+
+  /**
+   * Adds the memory used by the shape (and by the shapes it contains)
+   * to a report.
+   *
+   * @param usage The report.
+   */
+  virtual void accountMemory( MemoryUsage & usage ) const;
+
+  /**
+   * Releases the unused capacity of the buffers held by the shape (and
+   * by the shapes it contains).
+   */
+  virtual void shrinkToFit();
+
 
   /**
    *  Globally enable linewidth scaling when using scale functions.
@@ -337,6 +385,17 @@ struct Shape {
 
   virtual void depth( int );
 
+  /**
+   * Returns a number that identifies the current state of the shape. It
+   * is drawn from a process-wide counter when the shape is created and
+   * each time it is modified (a copy keeps the number of its original),
+   * so that data computed from a shape, such as its exported code (see
+   * FragmentCache), can be checked for staleness.
+   *
+   * @return The revision of the shape.
+   */
+  inline unsigned long long revision() const;
+
   virtual void shiftDepth( int shift );
 
   inline const Color & penColor() const;
@@ -400,6 +459,14 @@ struct Shape {
    */
   virtual void accept( const ShapeVisitor & visitor );
 
+  /**
+   * @brief Accepts a typed visitor: calls its visit() method for the
+   * type of the shape.
+   *
+   * @param visitor A typed visitor object.
+   */
+  virtual void accept( TypedShapeVisitor & visitor ) const;
+
 
 
 private:
@@ -420,6 +487,14 @@ protected:
 
   inline void updateLineWidth(double s);
 
+  /**
+   * Gives the shape a new revision. Must be called by the methods that
+   * modify the shape.
+   */
+  inline void changed();
+
+  static unsigned long long nextRevision();
+
   int _depth;          /**< The depth of the shape. */
   Color _penColor;     /**< The color of the shape. */
   Color _fillColor;    /**< The color of the shape. */
@@ -427,6 +502,7 @@ protected:
   LineStyle _lineStyle;/**< The line style (solid, dashed, etc.). */
   LineCap _lineCap;    /**< The linecap attribute. (The way line terminates.) */
   LineJoin _lineJoin;  /**< The linejoin attribute. (The shape of line junctions.) */
+  unsigned long long _revision; /**< See revision(). */
 
   /**
    * Return a string of the svg properties lineWidth, opacity, penColor, fillColor,
@@ -436,6 +512,17 @@ protected:
    */
   std::string svgProperties( const TransformSVG & transform ) const;
 
+  /**
+   * Return a string of the svg properties, with a given value of the fill
+   * attribute (e.g. a pattern) in place of the fill color.
+   *
+   * @param transform The transform of the export.
+   * @param fill The value of the fill attribute (the fill color if empty).
+   *
+   * @return A string of the properties suitable for inclusion in an svg tag.
+   */
+  std::string svgProperties( const TransformSVG & transform, const std::string & fill ) const;
+
 
   /**
    * Return a string of the properties lineWidth, penColor, lineCap, and lineJoin
@@ -598,6 +685,9 @@ struct Dot : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
   /**
    * Returns the bounding box of the dot.
    *
@@ -607,6 +697,12 @@ struct Dot : public Shape {
 
   Dot * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
 
   static const std::string _name; /**< The generic name of the shape. */
@@ -775,6 +871,12 @@ struct Line : public Shape {
 
   Line * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
   void flushPostscript( std::ostream & stream,
                         const TransformEPS & transform ) const override;
 
@@ -788,6 +890,11 @@ struct Line : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
@@ -929,8 +1036,19 @@ struct Arrow : public Line {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const override;
+
   Arrow * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 };
@@ -951,6 +1069,20 @@ struct Polyline : public Shape {
                    const LineJoin join = Shape::defaultLineJoin(),
                    int depth = -1 );
 
+  /**
+   * Builds a polyline from a vector of points, which is moved into the
+   * path of the polyline.
+   */
+  inline Polyline( std::vector<Point> && points,
+                   bool closed,
+                   Color penColor = Shape::defaultPenColor(),
+                   Color fillColor = Shape::defaultFillColor(),
+                   double lineWidth = Shape::defaultLineWidth(),
+                   const LineStyle lineStyle = Shape::defaultLineStyle(),
+                   const LineCap cap = Shape::defaultLineCap(),
+                   const LineJoin join = Shape::defaultLineJoin(),
+                   int depth = -1 );
+
   inline Polyline( const Path & path,
                    Color penColor = Shape::defaultPenColor(),
                    Color fillColor = Shape::defaultFillColor(),
@@ -993,6 +1125,7 @@ struct Polyline : public Shape {
    * @return
    */
   Point & operator[]( const std::size_t n ) {
+    changed();
     return _path[ n ];
   }
 
@@ -1119,19 +1252,47 @@ struct Polyline : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const override;
+
   Rect boundingBox( LineWidthFlag ) const override;
 
   Polyline * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
+  void shrinkToFit() override;
+
   inline std::size_t vertexCount() const;
 
   inline const Path & path() const;
 
+  /**
+   * Sets the hatching of the polyline, drawn over its fill color (if any).
+   *
+   * @param hatch The hatch (Hatch::None to remove the hatching).
+   *
+   * @return A reference to the polyline itself.
+   */
+  Polyline & setHatch( const Hatch & hatch );
+
+  /**
+   * @return The hatching of the polyline.
+   */
+  inline const Hatch & hatch() const;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
 protected:
   Path _path;
+  Hatch _hatch;
 };
 
 /**
@@ -1251,6 +1412,12 @@ struct Rectangle : public Polyline {
 
   Rectangle * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
@@ -1345,6 +1512,12 @@ struct Triangle : public Polyline {
 
   Triangle * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
@@ -1466,8 +1639,19 @@ struct GouraudTriangle : public Polyline {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
+  ClipResult clip( const ClipRegion & region, ShapeList & pieces ) const override;
+
   GouraudTriangle * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
@@ -1637,10 +1821,33 @@ struct Ellipse : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
   Rect boundingBox( LineWidthFlag ) const override;
 
   Ellipse * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
+  /**
+   * Sets the hatching of the ellipse, drawn over its fill color (if any).
+   *
+   * @param hatch The hatch (Hatch::None to remove the hatching).
+   *
+   * @return A reference to the ellipse itself.
+   */
+  Ellipse & setHatch( const Hatch & hatch );
+
+  /**
+   * @return The hatching of the ellipse.
+   */
+  inline const Hatch & hatch() const;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 
@@ -1650,6 +1857,7 @@ protected:
   double _yRadius;
   double _angle;
   bool _circle;
+  Hatch _hatch;
 };
 
 /**
@@ -1777,6 +1985,12 @@ struct Circle : public Ellipse {
 
   Circle * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
 private:
   static const std::string _name; /**< The generic name of the shape. */
 };
@@ -1965,10 +2179,21 @@ struct Text : public Shape {
   void flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const override;
 
+  void flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const override;
+
   Rect boundingBox( LineWidthFlag ) const override;
 
   Text * clone() const override;
 
+  void accept( TypedShapeVisitor & visitor ) const override;
+
+  using Shape::accept;
+
+  void accountMemory( MemoryUsage & usage ) const override;
+
+  void shrinkToFit() override;
+
 private:
 
   static const std::string _name; /**< The generic name of the shape. */
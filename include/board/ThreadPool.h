@@ -0,0 +1,195 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ThreadPool.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A fixed-size pool of worker threads with work stealing.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_THREADPOOL_H_
+#define _BOARD_THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PlaneDraw {
+
+/**
+ * The ThreadPool class.
+ *
+ * @brief A fixed number of worker threads running submitted tasks.
+ *
+ * Each worker owns a queue of tasks. Tasks submitted from outside the
+ * pool are distributed round-robin over the queues, tasks submitted by
+ * a worker go to its own queue. A worker runs the tasks of its queue in
+ * submission order (so that queued jobs are not starved), and when the
+ * queue is empty it steals the oldest task of another worker's queue.
+ *
+ * An exception escaping a task is reported on Tools::error and does not
+ * stop the worker.
+ */
+class ThreadPool {
+public:
+
+  typedef std::function<void()> Task;
+
+  /**
+   * Starts the worker threads.
+   *
+   * @param threads The number of workers (0 means one per hardware thread).
+   */
+  explicit ThreadPool( std::size_t threads = 0 );
+
+  /**
+   * Waits for all the submitted tasks, then stops the workers.
+   */
+  ~ThreadPool();
+
+  /**
+   * Queues a task.
+   *
+   * @param task The task to be run by a worker.
+   */
+  void submit( const Task & task );
+
+  /**
+   * Blocks until all the submitted tasks have been run. Must not be
+   * called from a task.
+   */
+  void wait();
+
+  /**
+   * @return The number of worker threads.
+   */
+  std::size_t threadCount() const;
+
+  /**
+   * @return The number of tasks that were run by another worker than
+   *         the one they were queued to.
+   */
+  std::size_t steals() const;
+
+  /**
+   * @return The pool shared by the parallel loops of the library, with
+   *         one worker per hardware thread, started by the first call.
+   */
+  static ThreadPool & shared();
+
+  /**
+   * The number of ranges parallelFor() splits a loop into: one per
+   * group of grain items, at most four per hardware thread, and one if
+   * there are less than two groups or a single hardware thread.
+   *
+   * @param count The number of items.
+   * @param grain The minimal number of items of a range.
+   */
+  static inline std::size_t ranges( std::size_t count, std::size_t grain );
+
+  /**
+   * Runs body( range, first, last ) over the consecutive ranges of
+   * items [first, last) which cover [0, count), split by ranges(). The
+   * ranges are the same wherever the loop runs, so that results merged
+   * by range are deterministic. A loop with a single range runs in the
+   * calling thread, the others as parallelRanges().
+   *
+   * @param count The number of items.
+   * @param grain The minimal number of items of a range (see ranges()).
+   * @param body The function run on each range.
+   */
+  template<typename Body>
+  static inline void parallelFor( std::size_t count, std::size_t grain, const Body & body );
+
+  /**
+   * Runs task( range, first, last ) over the given number of consecutive
+   * ranges of items which cover [0, count). The first range is run by
+   * the calling thread, the others by the shared() pool, and the call
+   * returns when they are all done; an exception thrown by a range is
+   * rethrown then. A loop run by a worker of a pool (a nested loop) runs
+   * in the calling thread.
+   *
+   * @param count The number of items.
+   * @param ranges The number of ranges.
+   * @param task The function run on each range.
+   */
+  static void parallelRanges( std::size_t count, std::size_t ranges,
+                              const std::function<void( std::size_t, std::size_t, std::size_t )> & task );
+
+  /**
+   * @return The number of hardware threads (at least one), read once.
+   */
+  static std::size_t hardwareThreads();
+
+private:
+  ThreadPool( const ThreadPool & );
+  ThreadPool & operator=( const ThreadPool & );
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool pop( std::size_t index, Task & task );
+  void run( std::size_t index );
+
+  std::vector< std::unique_ptr<Worker> > _workers;
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _wakeup;
+  std::condition_variable _idle;
+  std::size_t _queued;        /**< Tasks not yet started. */
+  std::size_t _unfinished;    /**< Tasks not yet completed. */
+  bool _stop;
+  std::atomic<std::size_t> _next;
+  std::atomic<std::size_t> _steals;
+};
+
+std::size_t
+ThreadPool::ranges( std::size_t count, std::size_t grain )
+{
+  if ( ! grain || count < 2 * grain ) {
+    return 1;
+  }
+  const std::size_t hardware = hardwareThreads();
+  return ( hardware < 2 ) ? 1 : std::min<std::size_t>( hardware * 4, count / grain );
+}
+
+template<typename Body>
+void
+ThreadPool::parallelFor( std::size_t count, std::size_t grain, const Body & body )
+{
+  const std::size_t n = ranges( count, grain );
+  if ( n == 1 ) {
+    body( 0, 0, count );
+  } else {
+    parallelRanges( count, n, body );
+  }
+}
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_THREADPOOL_H_ */
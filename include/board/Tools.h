@@ -98,8 +98,40 @@ inline void secured_strncpy( char * dst, const char * src, size_t count );
 
 inline void secured_ctime( char * str, const time_t * t, size_t count );
 
+/**
+ * Writes the base64 encoding of a stream. Lines hold linesize/4 encoded
+ * blocks and are terminated by "\r\n", including the last one.
+ *
+ * @param in The input stream (read until its end, by large chunks).
+ * @param out The output stream.
+ * @param linesize The maximum length of an output line.
+ *
+ * @return false if writing failed.
+ */
 bool base64encode(std::istream & in, std::ostream & , int linesize = 80);
 
+/**
+ * Encodes a memory buffer in base64, with the same line wrapping as
+ * base64encode(std::istream&,std::ostream&,int). A SIMD kernel is used
+ * when the processor supports it.
+ *
+ * @param data The input bytes.
+ * @param size The number of input bytes.
+ * @param out The output buffer, of size at least base64EncodedSize(size,linesize).
+ * @param linesize The maximum length of an output line.
+ *
+ * @return The number of characters written.
+ */
+std::size_t base64encode( const unsigned char * data, std::size_t size, char * out, int linesize = 80 );
+
+/**
+ * @param size A number of bytes.
+ * @param linesize The maximum length of an output line.
+ *
+ * @return The length of the base64 encoding of size bytes, line breaks included.
+ */
+std::size_t base64EncodedSize( std::size_t size, int linesize = 80 );
+
 bool stringEndsWith( const char * str, const char * end, CaseSensitivity sensitivity = CaseSensitive );
 
 void flushFile( const char * filename, std::ostream & out );
@@ -110,8 +142,24 @@ bool canCreateFile( const char * filename );
 
 bool canReadFile( const char * filename );
 
+/**
+ * Creates a directory (its parent must exist).
+ *
+ * @param path The path of the directory.
+ *
+ * @return true if the directory was created or already exists.
+ */
+bool makeDirectory( const char * path );
+
+/**
+ * @return A path for a new temporary file. The returned buffer belongs to
+ *         the calling thread and is overwritten by its next call.
+ */
 const char * temporaryFilename( const char * extension );
 
+/**
+ * A pseudo-random generator, with a sequence per thread.
+ */
 unsigned int boardRand();
 
 }  // namespace Tools
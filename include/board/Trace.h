@@ -0,0 +1,144 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Trace.h
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Optional recording of trace events, in the Chrome trace format.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BOARD_TRACE_H_
+#define _BOARD_TRACE_H_
+
+#include "BoardConfig.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+/**
+ * Tracing is compiled in only when the library is configured with the
+ * BOARD_TRACING CMake option. Otherwise the BOARD_TRACE_* macros expand
+ * to nothing, and the library itself records no event.
+ *
+ * BOARD_TRACE_SCOPE( name ) records the lifetime of the enclosing scope;
+ * BOARD_TRACE_SCOPE_ARG( name, count ) also records an integer (the
+ * number of shapes involved, for instance). The name must be a string
+ * that lives as long as the program (a literal, or Shape::name()).
+ */
+#if ( _BOARD_HAVE_TRACING_ == 1 )
+#define BOARD_TRACE_CONCAT_( A, B ) A ## B
+#define BOARD_TRACE_CONCAT( A, B ) BOARD_TRACE_CONCAT_( A, B )
+#define BOARD_TRACE_SCOPE( NAME ) \
+  PlaneDraw::Trace::Scope BOARD_TRACE_CONCAT( boardTraceScope, __LINE__ )( NAME )
+#define BOARD_TRACE_SCOPE_ARG( NAME, COUNT ) \
+  PlaneDraw::Trace::Scope BOARD_TRACE_CONCAT( boardTraceScope, __LINE__ )( NAME, static_cast<long>( COUNT ) )
+#else
+#define BOARD_TRACE_SCOPE( NAME )
+#define BOARD_TRACE_SCOPE_ARG( NAME, COUNT )
+#endif
+
+namespace PlaneDraw {
+
+namespace Trace {
+
+/**
+ * Starts or stops the recording (stopped by default). Events are kept
+ * in one ring buffer per thread: when a buffer is full, the oldest
+ * events of the thread are overwritten.
+ *
+ * @param enabled Whether events should be recorded.
+ */
+void setEnabled( bool enabled );
+
+/**
+ * @return true if events are being recorded.
+ */
+inline bool enabled();
+
+/**
+ * Sets the number of events kept per thread (default 65536). Applies to
+ * the buffers of the threads that have not recorded anything yet, and
+ * to all the buffers after a call to clear().
+ *
+ * @param events The capacity of each ring buffer.
+ */
+void setCapacity( std::size_t events );
+
+/**
+ * Discards all the recorded events.
+ */
+void clear();
+
+/**
+ * Writes the recorded events as a Chrome trace (JSON), that may be
+ * loaded in chrome://tracing or in Perfetto.
+ *
+ * @param out The output stream.
+ */
+void dump( std::ostream & out );
+
+/**
+ * Writes the recorded events in a Chrome trace file.
+ *
+ * @param filename The name of the file.
+ *
+ * @return true if the file could be written.
+ */
+bool save( const char * filename );
+
+/**
+ * Records an event of the calling thread.
+ *
+ * @param name The event name.
+ * @param start Start time of the event.
+ * @param end End time of the event.
+ * @param count An integer argument, ignored if negative.
+ */
+void record( const char * name,
+             std::chrono::steady_clock::time_point start,
+             std::chrono::steady_clock::time_point end,
+             long count );
+
+/**
+ * Records the lifetime of an object as an event, when the recording
+ * is enabled at construction time.
+ */
+class Scope {
+public:
+  inline explicit Scope( const char * name, long count = -1 );
+  inline ~Scope();
+private:
+  Scope( const Scope & );
+  Scope & operator=( const Scope & );
+  const char * _name;
+  long _count;
+  std::chrono::steady_clock::time_point _start;
+};
+
+// Internal: read through enabled().
+extern std::atomic<bool> recording;
+
+#include "Trace.ih"
+
+} // namespace Trace
+
+} // namespace PlaneDraw
+
+#endif /* _BOARD_TRACE_H_ */
@@ -28,18 +28,141 @@
 
 #include <limits>
 #include <vector>
+#include <map>
+#include <string>
 #include <cmath>
+#include <cstddef>
 #include "TransformMatrix.h"
 
+#if __cplusplus<201100
+#define final
+#endif
+
 namespace PlaneDraw {
 
 struct Rect;
 struct Shape;
 struct ShapeList;
+struct ExportStats;
+class CountingStreamBuffer;
+struct DXFTables;
+
+/**
+ * The ExportContext class.
+ * @brief State of a single export (save) of a document.
+ *
+ * Each export (a save method of the Board) owns its context and hands
+ * it to its transform (see Transform::setContext()), which carries it to
+ * the flush methods of the shapes. Copies of the transform share the
+ * context of the export. A transform that is used on its own, with the
+ * flush methods of the shapes called directly, uses a context of its own.
+ * The context replaces the counters that used to be shared
+ * by the whole process, so that identifiers (clipping paths, images) are
+ * deterministic for a given document and independent boards may be saved
+ * concurrently from different threads.
+ */
+class ExportContext {
+public:
+  inline ExportContext();
+
+  /**
+   * @return A new clipping path identifier (0, 1, 2... in document order).
+   */
+  inline std::size_t nextClippingId();
+
+  /**
+   * @return A new identifier for an inline (not shared) bitmap image.
+   */
+  inline std::size_t nextImageId();
+
+  /**
+   * @return The number of clipping path identifiers given so far.
+   */
+  inline std::size_t clippingCount() const;
+
+  /**
+   * Sets the table of the bitmap images defined once (in the <defs>
+   * section) of the SVG document being written. Identifiers of inline
+   * images are numbered after the definitions.
+   *
+   * @param ids Maps image filenames to definition ids (may be null).
+   */
+  void setImageDefinitions( const std::map<std::string,unsigned int> * ids );
+
+  /**
+   * @param filename An image filename.
+   *
+   * @return The id of the definition of the image in the document,
+   *         or -1 if the image is not defined.
+   */
+  int imageDefinition( const std::string & filename ) const;
+
+  /**
+   * Sets the statistics to be filled during the export.
+   *
+   * @param stats The statistics (may be null).
+   * @param counter The buffer that counts the bytes written.
+   */
+  void setStats( ExportStats * stats, const CountingStreamBuffer * counter );
+
+  /**
+   * @return The statistics of the export, or null if none is requested.
+   */
+  inline ExportStats * stats() const;
+
+  /**
+   * @return The number of bytes written so far, if statistics are requested.
+   */
+  std::size_t bytesWritten() const;
+
+  /**
+   * Gives an identifier to the definition of a fill pattern (see Hatch),
+   * the same for identical definitions.
+   *
+   * @param definition The code of the pattern.
+   * @param id Receives the identifier (0, 1, 2... in document order).
+   *
+   * @return true if the definition is new to the export, and must be written.
+   */
+  bool definePattern( const std::string & definition, std::size_t & id );
+
+  /**
+   * Sets the size (in output units) below which shapes are not written
+   * (see LevelOfDetail).
+   *
+   * @param size The minimum size, 0 to write all the shapes.
+   */
+  inline void setDetailThreshold( double size );
+
+  /**
+   * @return The size below which shapes are not written (0 if none).
+   */
+  inline double detailThreshold() const;
+
+private:
+  friend class ShapeStatsScope;
+  std::size_t _clippingCount;
+  std::size_t _imageCount;
+  const std::map<std::string,unsigned int> * _imageDefinitions;
+  ExportStats * _stats;
+  const CountingStreamBuffer * _counter;
+  std::size_t _nestedBytes;
+  double _nestedSeconds;
+  double _detailThreshold;
+  std::map<std::string,std::size_t> _patterns;
+};
 
 /**
  * The base class for transforms.
  * @brief
+ *
+ * The concrete transforms (TransformEPS, TransformFIG, TransformSVG and
+ * TransformTikZ) implement the mapping methods as final inline methods:
+ * when called through the concrete type, as the flush methods of the
+ * shapes do, they are resolved at compile time and inlined. Their
+ * mapPoints() methods map arrays of points in a loop that the compiler
+ * may vectorize. The virtual methods of this class are kept for code
+ * that only knows a Transform.
  */
 struct Transform {
 public:
@@ -58,11 +181,34 @@ public:
                                const double margin ) = 0;
   static inline double round( const double & x );
 
+  /**
+   * @return The parameters of the transform as a string of bytes, which
+   *         is the same for two transforms that map the shapes the same way.
+   */
+  virtual std::string fingerprint() const;
+
+  /**
+   * Sets the context of the export this transform is used for. The
+   * context is owned by the export, and shared by the copies of the
+   * transform. Until a context is set, the transform uses one of its own.
+   *
+   * @param context The context (must outlive the export), or null to
+   *                use the context of the transform.
+   */
+  inline void setContext( ExportContext * context );
+
+  /**
+   * @return The context of the export this transform is used for.
+   */
+  inline ExportContext & context() const;
+
 protected:
   double _scale;
   double _deltaX;
   double _deltaY;
   double _height;
+  ExportContext * _context;             /**< The context of the export, or null. */
+  mutable ExportContext _ownContext;    /**< Used when no context is set. */
 };
 
 /**
@@ -72,8 +218,24 @@ protected:
  */
 struct TransformEPS : public Transform {
 public:
+  using Transform::scale;
+  inline double mapX( double x ) const final;
+  inline double mapY( double y ) const final;
+  inline Point map( const Point & ) const final;
+  inline void apply( double & x, double & y ) const final;
+  inline double scale( double x ) const final;
+  inline double rounded( double x ) const final;
+
+  /**
+   * Maps an array of points.
+   *
+   * @param points The points.
+   * @param n The number of points.
+   * @param out The mapped points (n points, may be the input array).
+   */
+  inline void mapPoints( const Point * points, std::size_t n, Point * out ) const;
+
   double mapWidth( double w ) const;
-  double mapY( double y ) const;
   void setBoundingBox( const Rect & rect,
                        const double pageWidth,
                        const double pageHeight,
@@ -93,8 +255,14 @@ private:
 struct TransformFIG : public Transform {
 public:
   inline TransformFIG();
-  double rounded( double x ) const;
-  double mapY( double y ) const;
+  using Transform::scale;
+  inline double mapX( double x ) const final;
+  inline double mapY( double y ) const final;
+  inline Point map( const Point & ) const final;
+  inline void apply( double & x, double & y ) const final;
+  inline double scale( double x ) const final;
+  inline double rounded( double x ) const final;
+  inline void mapPoints( const Point * points, std::size_t n, Point * out ) const;
   int mapWidth( double width ) const;
   void setBoundingBox( const Rect & rect,
                        const double pageWidth,
@@ -102,9 +270,20 @@ public:
                        const double margin );
   void setDepthRange( const ShapeList & shapes );
   int mapDepth( int depth ) const;
+
+  /**
+   * @param depth A depth.
+   *
+   * @return The same transform, which maps every depth to the FIG depth
+   *         of the given one (see FlatShapeList::flushFIG()).
+   */
+  TransformFIG atDepth( int depth ) const;
+
+  std::string fingerprint() const;
 private:
   int _maxDepth;
   int _minDepth;
+  int _fixedDepth;             /**< The FIG depth of all the shapes, or -1. */
   double _postscriptScale;
 };
 
@@ -115,8 +294,15 @@ private:
  */
 struct TransformSVG : public Transform {
 public:
-  double rounded( double x ) const;
-  double mapY( double y ) const;
+  inline TransformSVG();
+  using Transform::scale;
+  inline double mapX( double x ) const final;
+  inline double mapY( double y ) const final;
+  inline Point map( const Point & ) const final;
+  inline void apply( double & x, double & y ) const final;
+  inline double scale( double x ) const final;
+  inline double rounded( double x ) const final;
+  inline void mapPoints( const Point * points, std::size_t n, Point * out ) const;
   double mapWidth( double width ) const;
   void setBoundingBox( const Rect & rect,
                        const double pageWidth,
@@ -129,6 +315,42 @@ public:
   double deltaY() const;
 };
 
+/**
+ * The TransformDXF structure.
+ * @brief Structure representing a scaling and translation suitable for a
+ * DXF output (millimeters, the y axis going up). It gives the shapes
+ * access to the tables of the export: handles, layers, styles and blocks.
+ */
+struct TransformDXF : public Transform {
+public:
+  inline TransformDXF();
+  using Transform::scale;
+  inline double mapX( double x ) const final;
+  inline double mapY( double y ) const final;
+  inline Point map( const Point & ) const final;
+  inline void apply( double & x, double & y ) const final;
+  inline double scale( double x ) const final;
+  inline double rounded( double x ) const final;
+  inline void mapPoints( const Point * points, std::size_t n, Point * out ) const;
+  double mapWidth( double width ) const;
+  void setBoundingBox( const Rect & rect,
+                       const double pageWidth,
+                       const double pageHeight,
+                       const double margin );
+
+  /**
+   * @param origin A point of the drawing.
+   * @return The same transform, translated so that the point is mapped to (0,0).
+   */
+  TransformDXF relativeTo( const Point & origin ) const;
+
+  inline void setTables( DXFTables * tables );
+  inline DXFTables & tables() const;
+
+private:
+  DXFTables * _tables;
+};
+
 /**
  * The TransformTikZ structure.
  * @brief Structure representing a scaling and translation
@@ -142,4 +364,8 @@ struct TransformTikZ : public TransformSVG {
 
 } // namespace PlaneDraw
 
+#if __cplusplus<201100
+#undef final
+#endif
+
 #endif /* _TRANSFORMS_H_ */
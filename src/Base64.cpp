@@ -0,0 +1,253 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Base64.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Block base64 encoder (scalar, SSSE3 and AVX2 kernels).
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/Tools.h"
+#include <vector>
+
+/*
+ * The SIMD kernels are compiled with function-level target attributes and
+ * selected at runtime, so that the library itself can be built for a
+ * baseline x86 target.
+ */
+#if ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+#define _BOARD_BASE64_SIMD_ 1
+#include <immintrin.h>
+#else
+#define _BOARD_BASE64_SIMD_ 0
+#endif
+
+namespace {
+
+const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/*
+ * Encodes n complete 3-bytes blocks into 4n characters.
+ */
+void
+encodeBlocksScalar( const unsigned char * in, std::size_t n, char * out )
+{
+  const unsigned char * end = in + 3 * n;
+  while ( in != end ) {
+    const unsigned int v = ( in[0] << 16 ) | ( in[1] << 8 ) | in[2];
+    out[0] = b64[ ( v >> 18 ) & 0x3f ];
+    out[1] = b64[ ( v >> 12 ) & 0x3f ];
+    out[2] = b64[ ( v >> 6 ) & 0x3f ];
+    out[3] = b64[ v & 0x3f ];
+    in += 3;
+    out += 4;
+  }
+}
+
+#if ( _BOARD_BASE64_SIMD_ == 1 )
+
+/*
+ * Vector kernels: the 3-bytes groups are spread over 32-bit lanes with a
+ * byte shuffle, the four 6-bit indices are isolated with two multiplies,
+ * then translated to ASCII with a 16-entries offset table (W. Mula's
+ * method). Each 128-bit step reads 16 bytes and consumes 12 of them.
+ */
+
+__attribute__((target("ssse3")))
+inline __m128i
+encodeVector128( __m128i in )
+{
+  in = _mm_shuffle_epi8( in, _mm_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+  const __m128i t0 = _mm_and_si128( in, _mm_set1_epi32( 0x0fc0fc00 ) );
+  const __m128i t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+  const __m128i t2 = _mm_and_si128( in, _mm_set1_epi32( 0x003f03f0 ) );
+  const __m128i t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+  const __m128i indices = _mm_or_si128( t1, t3 );
+
+  __m128i reduced = _mm_subs_epu8( indices, _mm_set1_epi8( 51 ) );
+  const __m128i less = _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), indices );
+  reduced = _mm_or_si128( reduced, _mm_and_si128( less, _mm_set1_epi8( 13 ) ) );
+  const __m128i offsets = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+  return _mm_add_epi8( _mm_shuffle_epi8( offsets, reduced ), indices );
+}
+
+__attribute__((target("ssse3")))
+void
+encodeBlocksSSSE3( const unsigned char * in, std::size_t n, char * out )
+{
+  // 4 blocks per step, and 16 readable input bytes are required.
+  while ( n >= 6 ) {
+    const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in ) );
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( out ), encodeVector128( v ) );
+    in += 12;
+    out += 16;
+    n -= 4;
+  }
+  encodeBlocksScalar( in, n, out );
+}
+
+__attribute__((target("avx2")))
+void
+encodeBlocksAVX2( const unsigned char * in, std::size_t n, char * out )
+{
+  // 8 blocks per step; the second lane reads 16 bytes at offset 12.
+  while ( n >= 10 ) {
+    const __m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in ) );
+    const __m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in + 12 ) );
+    __m256i v = _mm256_inserti128_si256( _mm256_castsi128_si256( lo ), hi, 1 );
+    v = _mm256_shuffle_epi8( v, _mm256_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+    const __m256i t0 = _mm256_and_si256( v, _mm256_set1_epi32( 0x0fc0fc00 ) );
+    const __m256i t1 = _mm256_mulhi_epu16( t0, _mm256_set1_epi32( 0x04000040 ) );
+    const __m256i t2 = _mm256_and_si256( v, _mm256_set1_epi32( 0x003f03f0 ) );
+    const __m256i t3 = _mm256_mullo_epi16( t2, _mm256_set1_epi32( 0x01000010 ) );
+    const __m256i indices = _mm256_or_si256( t1, t3 );
+
+    __m256i reduced = _mm256_subs_epu8( indices, _mm256_set1_epi8( 51 ) );
+    const __m256i less = _mm256_cmpgt_epi8( _mm256_set1_epi8( 26 ), indices );
+    reduced = _mm256_or_si256( reduced, _mm256_and_si256( less, _mm256_set1_epi8( 13 ) ) );
+    const __m256i offsets = _mm256_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                              'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+    const __m256i result = _mm256_add_epi8( _mm256_shuffle_epi8( offsets, reduced ), indices );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), result );
+    in += 24;
+    out += 32;
+    n -= 8;
+  }
+  encodeBlocksSSSE3( in, n, out );
+}
+
+#endif // _BOARD_BASE64_SIMD_
+
+typedef void (*BlockEncoder)( const unsigned char *, std::size_t, char * );
+
+BlockEncoder
+selectBlockEncoder()
+{
+#if ( _BOARD_BASE64_SIMD_ == 1 )
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx2" ) ) return encodeBlocksAVX2;
+  if ( __builtin_cpu_supports( "ssse3" ) ) return encodeBlocksSSSE3;
+#endif
+  return encodeBlocksScalar;
+}
+
+void
+encodeBlocks( const unsigned char * in, std::size_t n, char * out )
+{
+  static const BlockEncoder encoder = selectBlockEncoder();
+  encoder( in, n, out );
+}
+
+inline std::size_t
+blocksPerLine( int linesize )
+{
+  return ( linesize >= 4 ) ? static_cast<std::size_t>( linesize / 4 ) : 1;
+}
+
+}
+
+namespace PlaneDraw {
+
+namespace Tools {
+
+std::size_t
+base64EncodedSize( std::size_t size, int linesize )
+{
+  const std::size_t blocks = ( size + 2 ) / 3;
+  const std::size_t lines = ( blocks + blocksPerLine( linesize ) - 1 ) / blocksPerLine( linesize );
+  return 4 * blocks + 2 * lines;
+}
+
+std::size_t
+base64encode( const unsigned char * data, std::size_t size, char * out, int linesize )
+{
+  const std::size_t perLine = blocksPerLine( linesize );
+  const std::size_t lineBytes = 3 * perLine;
+  char * start = out;
+  while ( size >= lineBytes ) {
+    encodeBlocks( data, perLine, out );
+    out += 4 * perLine;
+    *out++ = '\r';
+    *out++ = '\n';
+    data += lineBytes;
+    size -= lineBytes;
+  }
+  if ( size ) {
+    const std::size_t full = size / 3;
+    encodeBlocks( data, full, out );
+    out += 4 * full;
+    data += 3 * full;
+    switch ( size - 3 * full ) {
+    case 2:
+      out[0] = b64[ data[0] >> 2 ];
+      out[1] = b64[ ( ( data[0] & 0x03 ) << 4 ) | ( data[1] >> 4 ) ];
+      out[2] = b64[ ( data[1] & 0x0f ) << 2 ];
+      out[3] = '=';
+      out += 4;
+      break;
+    case 1:
+      out[0] = b64[ data[0] >> 2 ];
+      out[1] = b64[ ( data[0] & 0x03 ) << 4 ];
+      out[2] = '=';
+      out[3] = '=';
+      out += 4;
+      break;
+    default:
+      break;
+    }
+    *out++ = '\r';
+    *out++ = '\n';
+  }
+  return out - start;
+}
+
+bool
+base64encode( std::istream & in, std::ostream & out, int linesize )
+{
+  // Chunks are made of whole lines, so that the encoded chunks
+  // simply concatenate.
+  const std::size_t lineBytes = 3 * blocksPerLine( linesize );
+  const std::size_t chunkSize = lineBytes * ( 1 + ( 192 * 1024 ) / lineBytes );
+  std::vector<unsigned char> input( chunkSize );
+  std::vector<char> output( base64EncodedSize( chunkSize, linesize ) );
+  while ( in ) {
+    in.read( reinterpret_cast<char*>( &input[0] ), chunkSize );
+    const std::size_t count = static_cast<std::size_t>( in.gcount() );
+    if ( ! count ) {
+      break;
+    }
+    const std::size_t length = base64encode( &input[0], count, &output[0], linesize );
+    if ( ! out.write( &output[0], length ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace Tools
+
+}  // namespace PlaneDraw
@@ -0,0 +1,310 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   BatchRenderer.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Renders queues of boards on a pool of threads.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/BatchRenderer.h"
+#include "board/Tools.h"
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// The bytes used by all the shapes of a board, nested ones included (see
+// Board::memoryUsage()). A job is charged this much for the copy of its
+// board, and as much again for the rendered document before it exists.
+std::size_t
+boardBytes( const PlaneDraw::Board & board )
+{
+  return board.memoryUsage().totalBytes();
+}
+
+double
+secondsBetween( std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end )
+{
+  return std::chrono::duration<double>( end - start ).count();
+}
+
+}
+
+namespace PlaneDraw {
+
+double
+BatchRenderer::Statistics::meanLatencySeconds() const
+{
+  return completed ? ( totalLatencySeconds / completed ) : 0.0;
+}
+
+double
+BatchRenderer::Statistics::jobsPerSecond() const
+{
+  return ( elapsedSeconds > 0.0 ) ? ( completed / elapsedSeconds ) : 0.0;
+}
+
+double
+BatchRenderer::Statistics::bytesPerSecond() const
+{
+  return ( elapsedSeconds > 0.0 ) ? ( bytes / elapsedSeconds ) : 0.0;
+}
+
+BatchRenderer::BatchRenderer( std::size_t threads, std::size_t memoryBudget )
+  : _memoryBudget( memoryBudget ),
+    _memoryInFlight( 0 ),
+    _jobsInFlight( 0 ),
+    _nextId( 0 ),
+    _pool( threads )
+{
+  _statistics.submitted = 0;
+  _statistics.completed = 0;
+  _statistics.failed = 0;
+  _statistics.bytes = 0;
+  _statistics.totalLatencySeconds = 0.0;
+  _statistics.maxLatencySeconds = 0.0;
+  _statistics.totalRenderSeconds = 0.0;
+  _statistics.elapsedSeconds = 0.0;
+  _statistics.peakMemory = 0;
+}
+
+BatchRenderer::~BatchRenderer()
+{
+  wait();
+}
+
+std::size_t
+BatchRenderer::submit( const Board & board,
+                       Board::Format format,
+                       const Sink & sink,
+                       Board::PageSize size,
+                       double margin,
+                       Board::Unit unit )
+{
+  // The copy of the board and the document are charged before the copy is made.
+  const std::size_t charge = 2 * boardBytes( board );
+  acquire( charge );
+  std::shared_ptr<const Board> copy;
+  try {
+    copy.reset( new Board( board ) );
+  } catch ( ... ) {
+    release( charge );
+    throw;
+  }
+  return enqueue( copy, format, sink, size, margin, unit, charge );
+}
+
+std::size_t
+BatchRenderer::submit( const std::shared_ptr<const Board> & board,
+                       Board::Format format,
+                       const Sink & sink,
+                       Board::PageSize size,
+                       double margin,
+                       Board::Unit unit )
+{
+  const std::size_t charge = boardBytes( *board );
+  acquire( charge );
+  return enqueue( board, format, sink, size, margin, unit, charge );
+}
+
+std::size_t
+BatchRenderer::enqueue( const std::shared_ptr<const Board> & board,
+                        Board::Format format,
+                        const Sink & sink,
+                        Board::PageSize size,
+                        double margin,
+                        Board::Unit unit,
+                        std::size_t charge )
+{
+  std::shared_ptr<Job> job( new Job );
+  job->board = board;
+  job->format = format;
+  job->sink = sink;
+  job->size = size;
+  job->margin = margin;
+  job->unit = unit;
+  job->charge = charge;
+  job->submitted = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( ! _statistics.submitted ) {
+      _start = job->submitted;
+    }
+    job->id = _nextId++;
+    ++_statistics.submitted;
+  }
+  _pool.submit( [this, job]() { render( job ); } );
+  return job->id;
+}
+
+void
+BatchRenderer::render( const std::shared_ptr<Job> & job )
+{
+  JobReport report;
+  report.id = job->id;
+  report.format = job->format;
+  report.ok = true;
+  report.bytes = 0;
+  const Clock::time_point started = Clock::now();
+  report.queueSeconds = secondsBetween( job->submitted, started );
+
+  std::string document;
+  try {
+    std::ostringstream out;
+    job->board->save( out, job->format, job->size, job->margin, job->unit );
+    document = out.str();
+  } catch ( std::exception & e ) {
+    Tools::error << "BatchRenderer: job " << job->id << " failed (" << e.what() << ").\n";
+    report.ok = false;
+  }
+  const Clock::time_point rendered = Clock::now();
+  report.renderSeconds = secondsBetween( started, rendered );
+  report.bytes = document.size();
+
+  // The board is no longer needed. The document is charged as well
+  // until its sink returns (workers never block on the budget).
+  job->board.reset();
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _memoryInFlight += document.size();
+    if ( _memoryInFlight > _statistics.peakMemory ) {
+      _statistics.peakMemory = _memoryInFlight;
+    }
+  }
+
+  if ( report.ok && job->sink ) {
+    try {
+      job->sink( document );
+    } catch ( std::exception & e ) {
+      Tools::error << "BatchRenderer: sink of job " << job->id << " failed (" << e.what() << ").\n";
+      report.ok = false;
+    }
+  }
+  const std::size_t bytes = document.size();
+  std::string().swap( document );
+  release( job->charge + bytes );
+
+  const Clock::time_point done = Clock::now();
+  report.latencySeconds = secondsBetween( job->submitted, done );
+  Listener listener;
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    ++_statistics.completed;
+    if ( ! report.ok ) {
+      ++_statistics.failed;
+    }
+    _statistics.bytes += report.bytes;
+    _statistics.totalLatencySeconds += report.latencySeconds;
+    _statistics.totalRenderSeconds += report.renderSeconds;
+    if ( report.latencySeconds > _statistics.maxLatencySeconds ) {
+      _statistics.maxLatencySeconds = report.latencySeconds;
+    }
+    listener = _listener;
+  }
+  if ( listener ) {
+    listener( report );
+  }
+}
+
+void
+BatchRenderer::acquire( std::size_t bytes )
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+  _memoryAvailable.wait( lock, [this, bytes]() {
+      return ! _jobsInFlight || _memoryInFlight + bytes <= _memoryBudget;
+    } );
+  _memoryInFlight += bytes;
+  ++_jobsInFlight;
+  if ( _memoryInFlight > _statistics.peakMemory ) {
+    _statistics.peakMemory = _memoryInFlight;
+  }
+}
+
+void
+BatchRenderer::release( std::size_t bytes )
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _memoryInFlight -= bytes;
+    --_jobsInFlight;
+  }
+  _memoryAvailable.notify_all();
+}
+
+void
+BatchRenderer::wait()
+{
+  _pool.wait();
+}
+
+void
+BatchRenderer::setListener( const Listener & listener )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  _listener = listener;
+}
+
+BatchRenderer::Statistics
+BatchRenderer::statistics() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  Statistics result = _statistics;
+  if ( result.submitted ) {
+    result.elapsedSeconds = secondsBetween( _start, Clock::now() );
+  }
+  return result;
+}
+
+std::size_t
+BatchRenderer::memoryBudget() const
+{
+  return _memoryBudget;
+}
+
+std::size_t
+BatchRenderer::memoryInFlight() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _memoryInFlight;
+}
+
+std::size_t
+BatchRenderer::threadCount() const
+{
+  return _pool.threadCount();
+}
+
+BatchRenderer::Sink
+BatchRenderer::fileSink( const std::string & filename )
+{
+  return [filename]( const std::string & document ) {
+    std::ofstream file( filename.c_str(), std::ios::out | std::ios::binary );
+    file.write( document.data(), document.size() );
+    if ( ! file ) {
+      throw std::runtime_error( "cannot write file " + filename );
+    }
+  };
+}
+
+} // namespace PlaneDraw
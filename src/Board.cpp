@@ -30,16 +30,27 @@
 #include "board/Shapes.h"
 #include "board/Tools.h"
 #include "board/PSFonts.h"
+#include "board/ShapeVisitor.h"
+#include "board/FragmentCache.h"
+#include "board/LevelOfDetail.h"
+#include "board/ThreadPool.h"
+#include "board/Trace.h"
+#include "board/Reader.h"
+#include "board/DXF.h"
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <typeinfo>
+#include <utility>
 #include <ctime>
 #include <cstring>
 #include <map>
 #include <algorithm>
 #include <cstdio>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 
 #if defined( max )
 #undef max
@@ -65,6 +76,86 @@ const float pageSizes[][2] = { { 0.0f, 0.0f },               // BoundingBox
                              };
 
 const float ppmm = 72.0f / 25.4f;
+
+/*
+ * Collects the distinct bitmap files used by the images of a board,
+ * in drawing order.
+ */
+struct ImageCollector : public PlaneDraw::TypedShapeVisitor {
+  ImageCollector( std::map<std::string,unsigned int> & ids,
+                  std::vector<std::string> & filenames )
+    : _ids( ids ), _filenames( filenames ) { }
+  void visit( const PlaneDraw::Image & image ) {
+    if ( _ids.find( image.filename() ) == _ids.end() ) {
+      _ids[ image.filename() ] = static_cast<unsigned int>( _filenames.size() );
+      _filenames.push_back( image.filename() );
+    }
+  }
+private:
+  std::map<std::string,unsigned int> & _ids;
+  std::vector<std::string> & _filenames;
+};
+
+/*
+ * Routes an export through a byte counter and fills the export
+ * statistics, if some are requested. Otherwise the output stream
+ * is used as is.
+ */
+class ExportRecorder {
+public:
+  ExportRecorder( std::ostream & output, PlaneDraw::ExportStats * stats,
+                  const char * format, const PlaneDraw::Transform & transform )
+    : _counter( output.rdbuf() ), _counted( &_counter ),
+      _out( stats ? _counted : output ), _stats( stats ), _transform( transform ),
+      _start( std::chrono::steady_clock::now() ) {
+    if ( _stats ) {
+      _stats->clear();
+      _stats->format = format;
+      _counted.copyfmt( output );
+      _transform.context().setStats( _stats, &_counter );
+    }
+  }
+  ~ExportRecorder() {
+    if ( _stats ) {
+      _stats->totalSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - _start ).count();
+      _stats->bytes = _counter.count();
+      _stats->clipPaths += _transform.context().clippingCount();
+      _transform.context().setStats( 0, 0 );
+    }
+  }
+  std::ostream & out() { return _out; }
+private:
+  PlaneDraw::CountingStreamBuffer _counter;
+  std::ostream _counted;
+  std::ostream & _out;
+  PlaneDraw::ExportStats * _stats;
+  const PlaneDraw::Transform & _transform;
+  std::chrono::steady_clock::time_point _start;
+};
+
+// Gives a FIG color number to the pen and fill colors of a shape.
+void addColors( std::map<PlaneDraw::Color,int> & colormap, const PlaneDraw::Shape & shape, int & maxColor )
+{
+  if ( colormap.find( shape.penColor() ) == colormap.end()
+       && shape.penColor().valid() )
+    colormap[ shape.penColor() ] = maxColor++;
+  if ( colormap.find( shape.fillColor() ) == colormap.end()
+       && shape.fillColor().valid() )
+    colormap[ shape.fillColor() ] = maxColor++;
+}
+
+// Gives a FIG color number to the colors of the shapes visited, those
+// of groups and flat lists included.
+struct ColorCollector : public PlaneDraw::TypedShapeVisitor {
+  ColorCollector( std::map<PlaneDraw::Color,int> & colormap, int & maxColor )
+    : _colormap( colormap ), _maxColor( maxColor ) { }
+  void visit( const PlaneDraw::Shape & shape ) {
+    addColors( _colormap, shape, _maxColor );
+  }
+private:
+  std::map<PlaneDraw::Color,int> & _colormap;
+  int & _maxColor;
+};
 }
 
 namespace PlaneDraw {
@@ -84,14 +175,18 @@ Board::State::State()
 }
 
 Board::Board( const Color & backgroundColor )
-  : _backgroundColor( backgroundColor )
+  : _backgroundColor( backgroundColor ),
+    _fragmentCache( 0 ),
+    _detailThreshold( 0.0 )
 {
 }
 
 Board::Board( const Board & other )
   : ShapeList( other ),
     _state( other._state ),
-    _backgroundColor( other._backgroundColor )
+    _backgroundColor( other._backgroundColor ),
+    _fragmentCache( other._fragmentCache ? new FragmentCache : 0 ),
+    _detailThreshold( other._detailThreshold )
 {
 }
 
@@ -120,6 +215,7 @@ Board::operator<<( const Shape & shape )
 
 Board::~Board()
 {
+  delete _fragmentCache;
 }
 
 void
@@ -129,9 +225,47 @@ Board::clear( const Color & color )
   _backgroundColor = color;
 }
 
+MemoryUsage
+Board::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.addObject( "Board", sizeof( Board ) );
+  usage.addPath( "Board", _clippingPath );
+  if ( _fragmentCache ) {
+    usage.addObject( "FragmentCache", sizeof( FragmentCache ) + _fragmentCache->memoryUsage() );
+  }
+  accountShapes( usage, "Board" );
+  return usage;
+}
+
+void
+Board::shrinkToFit()
+{
+  _clippingPath.shrinkToFit();
+  shrinkShapes();
+}
+
+void
+Board::setFragmentCaching( bool enabled )
+{
+  if ( enabled && ! _fragmentCache ) {
+    _fragmentCache = new FragmentCache;
+  } else if ( ! enabled ) {
+    delete _fragmentCache;
+    _fragmentCache = 0;
+  }
+}
+
+void
+Board::setDetailThreshold( double size )
+{
+  _detailThreshold = std::max( 0.0, size );
+}
+
 Board &
 Board::rotate( double angle, const Point & center )
 {
+  BOARD_TRACE_SCOPE_ARG( "Board::rotate", _shapes.size() );
   ShapeList::rotate( angle, center );
   _clippingPath.rotate( angle, center );
   return (*this);
@@ -140,14 +274,17 @@ Board::rotate( double angle, const Point & center )
 Board &
 Board::rotate( double angle )
 {
-  ShapeList::rotate( angle );
-  _clippingPath.rotate( angle, center() );
+  BOARD_TRACE_SCOPE_ARG( "Board::rotate", _shapes.size() );
+  const Point c = center();
+  ShapeList::rotate( angle, c );
+  _clippingPath.rotate( angle, c );
   return (*this);
 }
 
 Board &
 Board::translate( double dx, double dy )
 {
+  BOARD_TRACE_SCOPE_ARG( "Board::translate", _shapes.size() );
   ShapeList::translate( dx, dy );
   _clippingPath.translate( dx, dy );
   return (*this);
@@ -156,16 +293,19 @@ Board::translate( double dx, double dy )
 Board &
 Board::scale( double sx, double sy )
 {
+  BOARD_TRACE_SCOPE_ARG( "Board::scale", _shapes.size() );
+  // The center is computed once, for the shapes and the clipping path.
+  const Point c = center();
   if ( _clippingPath.size() ) {
-    Point delta = _clippingPath.center() - center();
+    Point delta = _clippingPath.center() - c;
     delta.x *= sx;
     delta.y *= sy;
     _clippingPath.scale( sx, sy );
-    ShapeList::scale( sx, sy );
-    delta = ( center() + delta ) - _clippingPath.center();
+    scaleShapes( sx, sy, c );
+    delta = ( c + delta ) - _clippingPath.center();
     _clippingPath.translate( delta.x, delta.y );
   } else {
-    ShapeList::scale( sx, sy );
+    scaleShapes( sx, sy, c );
   }
   return (*this);
 }
@@ -173,17 +313,7 @@ Board::scale( double sx, double sy )
 Board &
 Board::scale( double s )
 {
-  if ( _clippingPath.size() ) {
-    Point delta = _clippingPath.center() - center();
-    delta *= s;
-    _clippingPath.scale( s );
-    ShapeList::scale( s );
-    delta = ( center() + delta ) - _clippingPath.center();
-    _clippingPath.translate( delta.x, delta.y );
-  } else {
-    ShapeList::scale( s );
-  }
-  return (*this);
+  return Board::scale( s, s );
 }
 
 Board
@@ -504,6 +634,22 @@ Board::drawPolyline( const std::vector<Point> & points,
                                    d ) );
 }
 
+void
+Board::drawPolyline( std::vector<Point> && points,
+                     int depth /* = -1 */ )
+{
+  int d = (depth!=-1) ? depth : _nextDepth--;
+  _shapes.push_back( new Polyline( std::move( points ),
+                                   false,
+                                   _state.penColor,
+                                   _state.fillColor,
+                                   _state.lineWidth,
+                                   _state.lineStyle,
+                                   _state.lineCap,
+                                   _state.lineJoin,
+                                   d ) );
+}
+
 void
 Board::drawClosedPolyline( const std::vector<Point> & points,
                            int depth /* = -1 */ )
@@ -517,6 +663,19 @@ Board::drawClosedPolyline( const std::vector<Point> & points,
                                    d ) );
 }
 
+void
+Board::drawClosedPolyline( std::vector<Point> && points,
+                           int depth /* = -1 */ )
+{
+  int d = (depth!=-1) ? depth : _nextDepth--;
+  _shapes.push_back( new Polyline( std::move( points ), true, _state.penColor, _state.fillColor,
+                                   _state.lineWidth,
+                                   _state.lineStyle,
+                                   _state.lineCap,
+                                   _state.lineJoin,
+                                   d ) );
+}
+
 void
 Board::fillPolyline( const std::vector<Point> & points,
                      int depth /* = -1 */ )
@@ -530,6 +689,19 @@ Board::fillPolyline( const std::vector<Point> & points,
                                    d ) );
 }
 
+void
+Board::fillPolyline( std::vector<Point> && points,
+                     int depth /* = -1 */ )
+{
+  int d = (depth!=-1) ? depth : _nextDepth--;
+  _shapes.push_back( new Polyline( std::move( points ), true, Color::Null, _state.penColor,
+                                   0.0f,
+                                   _state.lineStyle,
+                                   _state.lineCap,
+                                   _state.lineJoin,
+                                   d ) );
+}
+
 void
 Board::drawTriangle( double x1, double y1,
                      double x2, double y2,
@@ -538,10 +710,11 @@ Board::drawTriangle( double x1, double y1,
 {
   int d = (depth!=-1) ? depth : _nextDepth--;
   std::vector<Point> points;
+  points.reserve( 3 );
   points.push_back( Point( x1, y1 ) );
   points.push_back( Point( x2, y2 ) );
   points.push_back( Point( x3, y3 ) );
-  _shapes.push_back( new Polyline( points, true, _state.penColor, _state.fillColor,
+  _shapes.push_back( new Polyline( std::move( points ), true, _state.penColor, _state.fillColor,
                                    _state.lineWidth,
                                    _state.lineStyle,
                                    _state.lineCap,
@@ -557,10 +730,11 @@ Board::drawTriangle( const Point & p1,
 {
   int d = (depth!=-1) ? depth : _nextDepth--;
   std::vector<Point> points;
+  points.reserve( 3 );
   points.push_back( Point( p1.x, p1.y ) );
   points.push_back( Point( p2.x, p2.y ) );
   points.push_back( Point( p3.x, p3.y ) );
-  _shapes.push_back( new Polyline( points, true,
+  _shapes.push_back( new Polyline( std::move( points ), true,
                                    _state.penColor, _state.fillColor,
                                    _state.lineWidth,
                                    _state.lineStyle,
@@ -577,10 +751,11 @@ Board::fillTriangle( double x1, double y1,
 {
   int d = (depth!=-1) ? depth : _nextDepth--;
   std::vector<Point> points;
+  points.reserve( 3 );
   points.push_back( Point( x1, y1 ) );
   points.push_back( Point( x2, y2 ) );
   points.push_back( Point( x3, y3 ) );
-  _shapes.push_back( new Polyline( points, true, Color::Null, _state.penColor,
+  _shapes.push_back( new Polyline( std::move( points ), true, Color::Null, _state.penColor,
                                    0.0f,
                                    _state.lineStyle,
                                    _state.lineCap,
@@ -596,10 +771,11 @@ Board::fillTriangle( const Point & p1,
 {
   int d = (depth!=-1) ? depth : _nextDepth--;
   std::vector<Point> points;
+  points.reserve( 3 );
   points.push_back( Point( p1.x, p1.y ) );
   points.push_back( Point( p2.x, p2.y ) );
   points.push_back( Point( p3.x, p3.y ) );
-  _shapes.push_back( new Polyline( points, true, Color::Null, _state.penColor,
+  _shapes.push_back( new Polyline( std::move( points ), true, Color::Null, _state.penColor,
                                    0.0f,
                                    _state.lineStyle,
                                    _state.lineCap,
@@ -778,34 +954,149 @@ Board::addDuplicates( const Shape & shape,
 }
 
 void
-Board::saveEPS( const char * filename, PageSize size, double margin, Unit unit, const std::string & title  ) const
+Board::pageDimensions( PageSize size, double & width, double & height )
+{
+  width = pageSizes[size][0];
+  height = pageSizes[size][1];
+}
+
+const char *
+Board::postscriptProcedures()
+{
+  return
+      "/cp {closepath} bind def\n"
+      "/ef {eofill} bind def\n"
+      "/gr {grestore} bind def\n"
+      "/gs {gsave} bind def\n"
+      "/sa {save} bind def\n"
+      "/rs {restore} bind def\n"
+      "/l {lineto} bind def\n"
+      "/m {moveto} bind def\n"
+      "/rm {rmoveto} bind def\n"
+      "/n {newpath} bind def\n"
+      "/s {stroke} bind def\n"
+      "/sh {show} bind def\n"
+      "/slc {setlinecap} bind def\n"
+      "/slj {setlinejoin} bind def\n"
+      "/slw {setlinewidth} bind def\n"
+      "/srgb {setrgbcolor} bind def\n"
+      "/rot {rotate} bind def\n"
+      "/sc {scale} bind def\n"
+      "/sd {setdash} bind def\n"
+      "/ff {findfont} bind def\n"
+      "/sf {setfont} bind def\n"
+      "/scf {scalefont} bind def\n"
+      "/sw {stringwidth} bind def\n"
+      "/sd {setdash} bind def\n"
+      "/tr {translate} bind def\n"
+      " 0.5 setlinewidth\n";
+}
+
+Rect
+Board::setupPostscript( TransformEPS & transform, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
+{
+  Rect bbox;
+  {
+    PhaseTimer timer( stats, "boundingBox" );
+    BOARD_TRACE_SCOPE( "boundingBox" );
+    bbox = boundingBox(UseLineWidth);
+  }
+  if ( _clippingPath.size() > 2 ) {
+    bbox = bbox && _clippingPath.boundingBox();
+    if ( stats ) ++stats->clipPaths;
+  }
+  if ( pageWidth == 0.0 && pageHeight == 0.0 ) { // Fit to bounding box using given unit.
+    transform.setBoundingBox( bbox,
+                              toMillimeter(bbox.width,unit),
+                              toMillimeter(bbox.height,unit),
+                              -toMillimeter(margin,unit) );
+  } else {
+    transform.setBoundingBox( bbox,
+                              toMillimeter(pageWidth,unit),
+                              toMillimeter(pageHeight,unit),
+                              toMillimeter(margin,unit) );
+  }
+  transform.context().setDetailThreshold( _detailThreshold );
+  return bbox;
+}
+
+void
+Board::flushPostscriptDrawing( std::ostream & out, const TransformEPS & transform, const Rect & bbox, ExportStats * stats ) const
+{
+  if ( _clippingPath.size() > 2 ) {
+    out << " newpath ";
+    _clippingPath.flushPostscript( out, transform );
+    out << " 0 slw clip " << std::endl;
+  }
+
+  // Draw the background color if needed.
+  if ( _backgroundColor != Color::Null ) {
+    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
+    r.flushPostscript( out, transform );
+  }
+
+  // Draw the shapes
+  std::vector< Shape* > shapes = _shapes;
+  {
+    PhaseTimer timer( stats, "sort" );
+    BOARD_TRACE_SCOPE( "sort" );
+    stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  }
+  std::vector< Shape* >::const_iterator i = shapes.begin();
+  std::vector< Shape* >::const_iterator end = shapes.end();
+
+  {
+    PhaseTimer timer( stats, "shapes" );
+    BOARD_TRACE_SCOPE( "shapes" );
+    FragmentCache::Session session( _fragmentCache, FragmentCache::EPS, transform, out );
+    while ( i != end ) {
+      if ( LevelOfDetail::flushReduced( **i, out, transform ) ) {
+        ++i;
+        continue;
+      }
+      ShapeStatsScope scope( transform.context(), **i );
+      BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+      session.flush( **i );
+      ++i;
+    }
+  }
+}
+
+void
+Board::saveEPS( const char * filename, PageSize size, double margin, Unit unit, const std::string & title, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
     if ( title == std::string() )
-      saveEPS( filename, 0.0, 0.0, margin, unit, filename );
+      saveEPS( filename, 0.0, 0.0, margin, unit, filename, stats );
     else
-      saveEPS( filename, 0.0, 0.0, margin, unit, title );
+      saveEPS( filename, 0.0, 0.0, margin, unit, title, stats );
   } else {
     if ( title == std::string() )
-      saveEPS( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, filename );
+      saveEPS( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, filename, stats );
     else
-      saveEPS( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, title );
+      saveEPS( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, title, stats );
   }
 }
 
 void
-Board::saveEPS(std::ostream & out, PageSize size, double margin, Unit unit, const std::string & title  ) const
+Board::saveEPS(std::ostream & out, PageSize size, double margin, Unit unit, const std::string & title, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    saveEPS( out, 0.0, 0.0, margin, unit, title );
+    saveEPS( out, 0.0, 0.0, margin, unit, title, stats );
   } else {
-    saveEPS( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, title );
+    saveEPS( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, title, stats );
   }
 }
 
 void
-Board::saveEPS( std::ostream & out, double pageWidth, double pageHeight, double margin, Unit unit, const std::string & title ) const
+Board::saveEPS( std::ostream & output, double pageWidth, double pageHeight, double margin, Unit unit, const std::string & title, ExportStats * stats ) const
 {
+  BOARD_TRACE_SCOPE_ARG( "Board::saveEPS", _shapes.size() );
+  TransformEPS transform;
+  ExportContext context;
+  transform.setContext( &context );
+  ExportRecorder recorder( output, stats, "EPS", transform );
+  std::ostream & out = recorder.out();
   out << "%!PS-Adobe-2.0 EPSF-2.0" << std::endl;
   out << "%%Title: " << title << std::endl;
   out << "%%Creator: Board library (v" << _BOARD_VERSION_STRING_ << ") Copyleft 2007 Sebastien Fourey" << std::endl;
@@ -816,134 +1107,70 @@ Board::saveEPS( std::ostream & out, double pageWidth, double pageHeight, double
     out << "%%CreationDate: " << str_time;
   }
 
-  Rect bbox = boundingBox(UseLineWidth);
-  bool clipping = _clippingPath.size() > 2;
-  if ( clipping ) {
-    bbox = bbox && _clippingPath.boundingBox();
-  }
-  TransformEPS transform;
-  if ( pageWidth == 0.0 && pageHeight == 0.0 ) { // Fit to bounding box using given unit.
-    transform.setBoundingBox( bbox,
-                              toMillimeter(bbox.width,unit),
-                              toMillimeter(bbox.height,unit),
-                              -toMillimeter(margin,unit) );
-
-    Rect page = transform.pageBoundingBox();
-    out << "%%BoundingBox: "
-        << std::setprecision( 8 )
-        << page.left << " "
-        << page.bottom() << " "
-        << page.right() << " "
-        << page.top << std::endl;
-
-
-  } else {
-    transform.setBoundingBox( bbox,
-                              toMillimeter(pageWidth,unit),
-                              toMillimeter(pageHeight,unit),
-                              toMillimeter(margin,unit) );
-    Rect page = transform.pageBoundingBox();
-    out << "%%BoundingBox: "
-        << std::setprecision( 8 )
-        << page.left << " "
-        << page.bottom() << " "
-        << page.right() << " "
-        << page.top << std::endl;
-  }
-
+  const Rect bbox = setupPostscript( transform, pageWidth, pageHeight, margin, unit, stats );
+  Rect page = transform.pageBoundingBox();
+  out << "%%BoundingBox: "
+      << std::setprecision( 8 )
+      << page.left << " "
+      << page.bottom() << " "
+      << page.right() << " "
+      << page.top << std::endl;
 
   out << "%Magnification: 1.0000" << std::endl;
   out << "%%EndComments" << std::endl;
 
-  out << "\n"
-         "/cp {closepath} bind def\n"
-         "/ef {eofill} bind def\n"
-         "/gr {grestore} bind def\n"
-         "/gs {gsave} bind def\n"
-         "/sa {save} bind def\n"
-         "/rs {restore} bind def\n"
-         "/l {lineto} bind def\n"
-         "/m {moveto} bind def\n"
-         "/rm {rmoveto} bind def\n"
-         "/n {newpath} bind def\n"
-         "/s {stroke} bind def\n"
-         "/sh {show} bind def\n"
-         "/slc {setlinecap} bind def\n"
-         "/slj {setlinejoin} bind def\n"
-         "/slw {setlinewidth} bind def\n"
-         "/srgb {setrgbcolor} bind def\n"
-         "/rot {rotate} bind def\n"
-         "/sc {scale} bind def\n"
-         "/sd {setdash} bind def\n"
-         "/ff {findfont} bind def\n"
-         "/sf {setfont} bind def\n"
-         "/scf {scalefont} bind def\n"
-         "/sw {stringwidth} bind def\n"
-         "/sd {setdash} bind def\n"
-         "/tr {translate} bind def\n"
-         " 0.5 setlinewidth\n";
-
-  if ( clipping ) {
-    out << " newpath ";
-    _clippingPath.flushPostscript( out, transform );
-    out << " 0 slw clip " << std::endl;
-  }
-
-  // Draw the background color if needed.
-  if ( _backgroundColor != Color::Null ) {
-    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0f );
-    r.flushPostscript( out, transform );
-  }
+  out << "\n" << postscriptProcedures();
 
-  // Draw the shapes
-  std::vector< Shape* > shapes = _shapes;
+  flushPostscriptDrawing( out, transform, bbox, stats );
 
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
-  std::vector< Shape* >::const_iterator i = shapes.begin();
-  std::vector< Shape* >::const_iterator end = shapes.end();
-
-  while ( i != end ) {
-    (*i)->flushPostscript( out, transform );
-    ++i;
-  }
   out << "showpage" << std::endl;
   out << "%%Trailer" << std::endl;
   out << "%EOF" << std::endl;
 }
 
 void
-Board::saveEPS( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit, const std::string & title ) const
+Board::saveEPS( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit, const std::string & title, ExportStats * stats ) const
 {
   std::ofstream out(filename);
-  saveEPS(out,pageWidth,pageHeight,margin,unit,title);
+  saveEPS(out,pageWidth,pageHeight,margin,unit,title,stats);
   out.close();
 }
 
 void
-Board::saveFIG( const char * filename, PageSize size, double margin, Unit unit ) const
+Board::saveFIG( const char * filename, PageSize size, double margin, Unit unit, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    saveFIG( filename, 0.0, 0.0, margin, unit );
+    saveFIG( filename, 0.0, 0.0, margin, unit, stats );
   } else {
-    saveFIG( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter );
+    saveFIG( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
   }
 }
 
 void
-Board::saveFIG( std::ostream & out, PageSize size, double margin, Unit unit ) const
+Board::saveFIG( std::ostream & out, PageSize size, double margin, Unit unit, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    saveFIG( out, 0.0, 0.0, margin, unit );
+    saveFIG( out, 0.0, 0.0, margin, unit, stats );
   } else {
-    saveFIG( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter );
+    saveFIG( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
   }
 }
 
 void
-Board::saveFIG( std::ostream & out, double pageWidth, double pageHeight, double margin, Unit unit ) const
+Board::saveFIG( std::ostream & output, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
 {
-  Rect bbox = boundingBox(UseLineWidth);
+  BOARD_TRACE_SCOPE_ARG( "Board::saveFIG", _shapes.size() );
   TransformFIG transform;
+  ExportContext context;
+  transform.setContext( &context );
+  ExportRecorder recorder( output, stats, "FIG", transform );
+  std::ostream & out = recorder.out();
+  Rect bbox;
+  {
+    PhaseTimer timer( stats, "boundingBox" );
+    BOARD_TRACE_SCOPE( "boundingBox" );
+    bbox = boundingBox(UseLineWidth);
+  }
 
   if ( pageWidth == 0.0 && pageHeight == 0.0 ) {
     transform.setBoundingBox( bbox,
@@ -971,112 +1198,274 @@ Board::saveFIG( std::ostream & out, double pageWidth, double pageHeight, double
          "-2\n"
          "1200 2\n";
 
+  std::vector< Shape* > shapes = _shapes;
+  {
+    PhaseTimer timer( stats, "sort" );
+    BOARD_TRACE_SCOPE( "sort" );
+    stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  }
+  std::vector< Shape* >::const_iterator i = shapes.begin();
+  std::vector< Shape* >::const_iterator end = shapes.end();
+
   std::map<Color,int> colormap;
-  int maxColor = 32;
+  {
+    PhaseTimer timer( stats, "colormap" );
+    BOARD_TRACE_SCOPE( "colormap" );
+    int maxColor = 32;
+
+    colormap[Color(0,0,0)] = 0;
+    colormap[Color(0,0,255)] = 1;
+    colormap[Color(0,255,0)] = 2;
+    colormap[Color(0,255,255)] = 0;
+    colormap[Color(255,0,0)] = 4;
+    colormap[Color(255,0,255)] = 0;
+    colormap[Color(255,255,0)] = 6;
+    colormap[Color(255,255,255)] = 7;
+
+    ColorCollector collector( colormap, maxColor );
+    while ( i != end ) {
+      (*i)->accept( collector );
+      ++i;
+    }
+
+    if ( colormap.find( _backgroundColor ) == colormap.end()
+         && _backgroundColor.valid() )
+      colormap[ _backgroundColor ] = maxColor++;
+
+    // Write the colormap
+    std::map<Color,int>::const_iterator iColormap = colormap.begin();
+    std::map<Color,int>::const_iterator endColormap = colormap.end();
+    char colorString[255];
+    while ( iColormap != endColormap ) {
+      secured_sprintf( colorString, 255,
+                       "0 %d #%02x%02x%02x\n",
+                       iColormap->second,
+                       iColormap->first.red(),
+                       iColormap->first.green(),
+                       iColormap->first.blue() );
+      if ( iColormap->second >= 32 ) out << colorString;
+      ++iColormap;
+    }
+  }
 
+  // Draw the background color if needed.
+  if ( _backgroundColor != Color::Null ) {
+    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
+    r.depth( std::numeric_limits<int>::max() );
+    r.flushFIG( out, transform, colormap );
+  }
 
-  colormap[Color(0,0,0)] = 0;
-  colormap[Color(0,0,255)] = 1;
-  colormap[Color(0,255,0)] = 2;
-  colormap[Color(0,255,255)] = 0;
-  colormap[Color(255,0,0)] = 4;
-  colormap[Color(255,0,255)] = 0;
-  colormap[Color(255,255,0)] = 6;
-  colormap[Color(255,255,255)] = 7;
+  // Draw the shapes.
+  i = shapes.begin();
+  {
+    PhaseTimer timer( stats, "shapes" );
+    BOARD_TRACE_SCOPE( "shapes" );
+    FragmentCache::Session session( _fragmentCache, FragmentCache::FIG, transform, out, &colormap );
+    while ( i != end ) {
+      ShapeStatsScope scope( transform.context(), **i );
+      BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+      session.flush( **i );
+      ++i;
+    }
+  }
+}
 
+void
+Board::saveFIG( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
+{
+  std::ofstream out( filename );
+  saveFIG(out,pageWidth,pageHeight,margin,unit,stats);
+  out.close();
+}
+
+void
+Board::saveDXF( const char * filename, PageSize size, double margin, Unit unit, ExportStats * stats ) const
+{
+  if ( size == BoundingBox ) {
+    saveDXF( filename, 0.0, 0.0, margin, unit, stats );
+  } else {
+    saveDXF( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
+  }
+}
+
+void
+Board::saveDXF( std::ostream & out, PageSize size, double margin, Unit unit, ExportStats * stats ) const
+{
+  if ( size == BoundingBox ) {
+    saveDXF( out, 0.0, 0.0, margin, unit, stats );
+  } else {
+    saveDXF( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
+  }
+}
+
+void
+Board::saveDXF( std::ostream & output, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "Board::saveDXF", _shapes.size() );
+  DXFTables tables;
+  TransformDXF transform;
+  ExportContext context;
+  transform.setContext( &context );
+  transform.setTables( &tables );
+  ExportRecorder recorder( output, stats, "DXF", transform );
+  std::ostream & out = recorder.out();
+  Rect bbox;
+  {
+    PhaseTimer timer( stats, "boundingBox" );
+    BOARD_TRACE_SCOPE( "boundingBox" );
+    bbox = boundingBox(UseLineWidth);
+  }
+
+  if ( pageWidth == 0.0 && pageHeight == 0.0 ) {
+    transform.setBoundingBox( bbox,
+                              toMillimeter(bbox.width,unit),
+                              toMillimeter(bbox.height,unit),
+                              -toMillimeter(margin,unit) );
+  } else {
+    transform.setBoundingBox( bbox,
+                              toMillimeter(pageWidth,unit),
+                              toMillimeter(pageHeight,unit),
+                              toMillimeter(margin,unit) );
+  }
+  // The collect pass has a context of its own, which keeps no statistics.
+  ExportContext collectContext;
+  TransformDXF collector( transform );
+  collector.setContext( &collectContext );
 
   std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  {
+    PhaseTimer timer( stats, "sort" );
+    BOARD_TRACE_SCOPE( "sort" );
+    stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  }
   std::vector< Shape* >::const_iterator i = shapes.begin();
   std::vector< Shape* >::const_iterator end = shapes.end();
-  while ( i != end ) {
-    if ( colormap.find( (*i)->penColor() ) == colormap.end()
-         && (*i)->penColor().valid() )
-      colormap[ (*i)->penColor() ] = maxColor++;
-    if ( colormap.find( (*i)->fillColor() ) == colormap.end()
-         && (*i)->fillColor().valid() )
-      colormap[ (*i)->fillColor() ] = maxColor++;
-    ++i;
+
+  Rectangle background( bbox, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
+  background.depth( std::numeric_limits<int>::max() );
+
+  const std::streamsize precision = out.precision( 12 );
+  {
+    PhaseTimer timer( stats, "collect" );
+    BOARD_TRACE_SCOPE( "collect" );
+    std::ostream null( 0 );
+    null.precision( out.precision() );
+    while ( i != end ) {
+      (*i)->flushDXF( null, collector );
+      ++i;
+    }
+    if ( _backgroundColor != Color::Null ) {
+      background.flushDXF( null, collector );
+    }
   }
+  tables.setPass( DXFTables::Write );
 
-  if ( colormap.find( _backgroundColor ) == colormap.end()
-       && _backgroundColor.valid() )
-    colormap[ _backgroundColor ] = maxColor++;
+  Rect extents( transform.mapX( bbox.left ), transform.mapY( bbox.top ),
+                transform.scale( bbox.width ), transform.scale( bbox.height ) );
+  tables.flushHeader( out, extents );
+  tables.flushTables( out );
 
-  // Write the colormap
-  std::map<Color,int>::const_iterator iColormap = colormap.begin();
-  std::map<Color,int>::const_iterator endColormap = colormap.end();
-  char colorString[255];
-  while ( iColormap != endColormap ) {
-    secured_sprintf( colorString, 255,
-                     "0 %d #%02x%02x%02x\n",
-                     iColormap->second,
-                     iColormap->first.red(),
-                     iColormap->first.green(),
-                     iColormap->first.blue() );
-    if ( iColormap->second >= 32 ) out << colorString;
-    ++iColormap;
+  // The drawings shared by several groups.
+  {
+    PhaseTimer timer( stats, "blocks" );
+    BOARD_TRACE_SCOPE( "blocks" );
+    out << "0\nSECTION\n2\nBLOCKS\n";
+    tables.beginBlock( out, "*Model_Space", tables.modelSpace() );
+    tables.endBlock( out );
+    tables.beginBlock( out, "*Paper_Space", tables.paperSpace() );
+    tables.endBlock( out );
+    const std::vector<const DXFTables::Block*> blocks = tables.blocks();
+    for ( std::vector<const DXFTables::Block*>::const_iterator it = blocks.begin(); it != blocks.end(); ++it ) {
+      const Group & group = *(*it)->group;
+      tables.beginBlock( out, (*it)->name, (*it)->record );
+      group.ShapeList::flushDXF( out, transform.relativeTo( DXFTables::origin( group ) ) );
+      tables.endBlock( out );
+    }
+    out << "0\nENDSEC\n";
   }
 
+  out << "0\nSECTION\n2\nENTITIES\n";
+  tables.setOwner( tables.modelSpace() );
+
   // Draw the background color if needed.
   if ( _backgroundColor != Color::Null ) {
-    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0f );
-    r.depth( std::numeric_limits<int>::max() );
-    r.flushFIG( out, transform, colormap );
+    background.flushDXF( out, transform );
   }
 
   // Draw the shapes.
   i = shapes.begin();
-  while ( i != end ) {
-    (*i)->flushFIG( out, transform, colormap );
-    ++i;
+  {
+    PhaseTimer timer( stats, "shapes" );
+    BOARD_TRACE_SCOPE( "shapes" );
+    while ( i != end ) {
+      ShapeStatsScope scope( transform.context(), **i );
+      BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+      (*i)->flushDXF( out, transform );
+      ++i;
+    }
   }
+  out << "0\nENDSEC\n";
+  tables.flushObjects( out );
+  out << "0\nEOF\n";
+  out.precision( precision );
 }
 
 void
-Board::saveFIG( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit ) const
+Board::saveDXF( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
 {
   std::ofstream out( filename );
-  saveFIG(out,pageWidth,pageHeight,margin,unit);
+  saveDXF(out,pageWidth,pageHeight,margin,unit,stats);
   out.close();
 }
 
 void
-Board::saveSVG( const char * filename, PageSize size, double margin, Unit unit ) const
+Board::saveSVG( const char * filename, PageSize size, double margin, Unit unit, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    saveSVG( filename, 0.0, 0.0, margin, unit );
+    saveSVG( filename, 0.0, 0.0, margin, unit, stats );
   } else {
-    saveSVG( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter );
+    saveSVG( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
   }
 }
 
 void
-Board::saveSVG( std::ostream & out, PageSize size, double margin, Unit unit ) const
+Board::saveSVG( std::ostream & out, PageSize size, double margin, Unit unit, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    saveSVG( out, 0.0, 0.0, margin, unit );
+    saveSVG( out, 0.0, 0.0, margin, unit, stats );
   } else {
-    saveSVG( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter );
+    saveSVG( out, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
   }
 }
 
 void
-Board::saveSVG( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit ) const
+Board::saveSVG( const char * filename, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
 {
   std::ofstream out( filename );
-  saveSVG(out,pageWidth,pageHeight,margin,unit);
+  saveSVG(out,pageWidth,pageHeight,margin,unit,stats);
   out.close();
 }
 
 void
-Board::saveSVG( std::ostream & out, double pageWidth, double pageHeight, double margin, Unit unit ) const
+Board::saveSVG( std::ostream & output, double pageWidth, double pageHeight, double margin, Unit unit, ExportStats * stats ) const
 {
-  Rect bbox = boundingBox(UseLineWidth);
+  BOARD_TRACE_SCOPE_ARG( "Board::saveSVG", _shapes.size() );
   TransformSVG transform;
+  ExportContext context;
+  transform.setContext( &context );
+  transform.context().setDetailThreshold( _detailThreshold );
+  ExportRecorder recorder( output, stats, "SVG", transform );
+  std::ostream & out = recorder.out();
+  Rect bbox;
+  {
+    PhaseTimer timer( stats, "boundingBox" );
+    BOARD_TRACE_SCOPE( "boundingBox" );
+    bbox = boundingBox(UseLineWidth);
+  }
   bool clipping = _clippingPath.size() > 2;
   if ( clipping ) {
     bbox = bbox && _clippingPath.boundingBox();
+    if ( stats ) ++stats->clipPaths;
   }
 
   out << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"no\"?>" << std::endl;
@@ -1122,6 +1511,25 @@ Board::saveSVG( std::ostream & out, double pageWidth, double pageHeight, double
          "Drawing created with the Board library (v" << _BOARD_VERSION_STRING_ << ") Copyleft 2007 Sebastien Fourey"
          "</desc>" << std::endl;
 
+  // Each distinct bitmap is embedded once, placements refer to it.
+  std::map<std::string,unsigned int> imageIds;
+  std::vector<std::string> imageFilenames;
+  {
+    PhaseTimer timer( stats, "images" );
+    BOARD_TRACE_SCOPE( "images" );
+    ImageCollector collector( imageIds, imageFilenames );
+    accept( collector );
+    if ( ! imageFilenames.empty() ) {
+      out << "<defs>\n";
+      for ( std::size_t id = 0; id < imageFilenames.size(); ++id ) {
+        Image::flushSVGDefinition( out, imageFilenames[id], static_cast<unsigned int>( id ) );
+      }
+      out << "</defs>\n";
+      transform.context().setImageDefinitions( &imageIds );
+      if ( stats ) stats->images += imageFilenames.size();
+    }
+  }
+
   if ( clipping  ) {
     out << "<g clip-rule=\"nonzero\">\n"
            " <clipPath id=\"GlobalClipPath\">\n"
@@ -1134,18 +1542,33 @@ Board::saveSVG( std::ostream & out, double pageWidth, double pageHeight, double
 
   // Draw the background color if needed.
   if ( _backgroundColor != Color::Null ) {
-    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0 );
+    Rectangle r( bbox, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
     r.flushSVG( out, transform );
   }
 
   // Draw the shapes.
   std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  {
+    PhaseTimer timer( stats, "sort" );
+    BOARD_TRACE_SCOPE( "sort" );
+    stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  }
   std::vector< Shape* >::const_iterator i = shapes.begin();
   std::vector< Shape* >::const_iterator end = shapes.end();
-  while ( i != end ) {
-    (*i)->flushSVG( out, transform );
-    ++i;
+  {
+    PhaseTimer timer( stats, "shapes" );
+    BOARD_TRACE_SCOPE( "shapes" );
+    FragmentCache::Session session( _fragmentCache, FragmentCache::SVG, transform, out );
+    while ( i != end ) {
+      if ( LevelOfDetail::flushReduced( **i, out, transform ) ) {
+        ++i;
+        continue;
+      }
+      ShapeStatsScope scope( transform.context(), **i );
+      BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+      session.flush( **i );
+      ++i;
+    }
   }
 
   if ( clipping )
@@ -1154,25 +1577,37 @@ Board::saveSVG( std::ostream & out, double pageWidth, double pageHeight, double
 }
 
 void
-Board::saveTikZ( const char * filename, PageSize size, double margin ) const
+Board::saveTikZ( const char * filename, PageSize size, double margin, ExportStats * stats ) const
 {
-  saveTikZ( filename, pageSizes[size][0], pageSizes[size][1], margin );
+  saveTikZ( filename, pageSizes[size][0], pageSizes[size][1], margin, stats );
 }
 
 void
-Board::saveTikZ( std::ostream & out, PageSize size, double margin ) const
+Board::saveTikZ( std::ostream & out, PageSize size, double margin, ExportStats * stats ) const
 {
-  saveTikZ( out, pageSizes[size][0], pageSizes[size][1], margin );
+  saveTikZ( out, pageSizes[size][0], pageSizes[size][1], margin, stats );
 }
 
 void
-Board::saveTikZ( std::ostream & out, double pageWidth, double pageHeight, double margin ) const
+Board::saveTikZ( std::ostream & output, double pageWidth, double pageHeight, double margin, ExportStats * stats ) const
 {
+  BOARD_TRACE_SCOPE_ARG( "Board::saveTikZ", _shapes.size() );
   TransformTikZ transform;
-  Rect box = boundingBox(UseLineWidth);
+  ExportContext context;
+  transform.setContext( &context );
+  ExportRecorder recorder( output, stats, "TikZ", transform );
+  std::ostream & out = recorder.out();
+  Rect box;
+  {
+    PhaseTimer timer( stats, "boundingBox" );
+    BOARD_TRACE_SCOPE( "boundingBox" );
+    box = boundingBox(UseLineWidth);
+  }
   bool clipping = _clippingPath.size() > 2;
-  if ( clipping )
+  if ( clipping ) {
     box = box && _clippingPath.boundingBox();
+    if ( stats ) ++stats->clipPaths;
+  }
   transform.setBoundingBox( box, pageWidth, pageHeight, margin );
 
   out << "\\begin{tikzpicture}[anchor=south west,text depth=0,x={(1pt,0pt)},y={(0pt,-1pt)}]" << std::endl;
@@ -1185,18 +1620,29 @@ Board::saveTikZ( std::ostream & out, double pageWidth, double pageHeight, double
 
   // Draw the background color if needed.
   if ( _backgroundColor != Color::Null ) {
-    Rectangle r( box, Color::Null, _backgroundColor, 0.0 );
+    Rectangle r( box, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
     r.flushTikZ( out, transform );
   }
 
   // Draw the shapes.
   std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  {
+    PhaseTimer timer( stats, "sort" );
+    BOARD_TRACE_SCOPE( "sort" );
+    stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  }
   std::vector< Shape* >::const_iterator i = shapes.begin();
   std::vector< Shape* >::const_iterator end = shapes.end();
-  while ( i != end ) {
-    (*i)->flushTikZ( out, transform );
-    ++i;
+  {
+    PhaseTimer timer( stats, "shapes" );
+    BOARD_TRACE_SCOPE( "shapes" );
+    FragmentCache::Session session( _fragmentCache, FragmentCache::TikZ, transform, out );
+    while ( i != end ) {
+      ShapeStatsScope scope( transform.context(), **i );
+      BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+      session.flush( **i );
+      ++i;
+    }
   }
   out << "\\end{tikzpicture}" << std::endl;
 }
@@ -1264,44 +1710,373 @@ Board::toMillimeter(double x, Board::Unit unit)
 }
 
 void
-Board::saveTikZ( const char * filename, double pageWidth, double pageHeight, double margin ) const
+Board::saveTikZ( const char * filename, double pageWidth, double pageHeight, double margin, ExportStats * stats ) const
 {
   std::ofstream out( filename );
-  saveTikZ(out,pageWidth,pageHeight,margin);
+  saveTikZ(out,pageWidth,pageHeight,margin,stats);
   out.close();
 }
 
+bool
+Board::load( const char * filename )
+{
+  if ( Tools::stringEndsWith(filename,".svg", Tools::CaseInsensitive) ) {
+    return loadSVG( filename );
+  }
+  if ( Tools::stringEndsWith(filename,".fig", Tools::CaseInsensitive) ) {
+    return loadFIG( filename );
+  }
+  Tools::error << "Board::load(): unknown format for file " << filename << ".\n";
+  return false;
+}
+
+bool
+Board::loadSVG( const char * filename )
+{
+  BOARD_TRACE_SCOPE( "Board::loadSVG" );
+  MappedFile file( filename );
+  if ( ! file.valid() ) {
+    Tools::error << "Board::loadSVG(): cannot read file " << filename << ".\n";
+    return false;
+  }
+  return Reader::readSVG( file.begin(), file.end(), *this );
+}
+
+bool
+Board::loadFIG( const char * filename )
+{
+  BOARD_TRACE_SCOPE( "Board::loadFIG" );
+  MappedFile file( filename );
+  if ( ! file.valid() ) {
+    Tools::error << "Board::loadFIG(): cannot read file " << filename << ".\n";
+    return false;
+  }
+  return Reader::readFIG( file.begin(), file.end(), *this );
+}
+
 void
-Board::save(const char * filename, double pageWidth, double pageHeight, double margin , Unit unit) const
+Board::save(const char * filename, double pageWidth, double pageHeight, double margin , Unit unit, ExportStats * stats ) const
 {
   if ( Tools::stringEndsWith(filename,".eps", Tools::CaseInsensitive) ) {
-    saveEPS( filename, pageWidth, pageHeight, margin, unit );
+    saveEPS( filename, pageWidth, pageHeight, margin, unit, std::string(), stats );
     return;
   }
   if ( Tools::stringEndsWith(filename,".fig", Tools::CaseInsensitive) ) {
-    saveFIG( filename, pageWidth, pageHeight, margin, unit );
+    saveFIG( filename, pageWidth, pageHeight, margin, unit, stats );
     return;
   }
   if ( Tools::stringEndsWith(filename,".svg", Tools::CaseInsensitive) ) {
-    saveSVG( filename, pageWidth, pageHeight, margin, unit );
+    saveSVG( filename, pageWidth, pageHeight, margin, unit, stats );
     return;
   }
   if ( Tools::stringEndsWith(filename,".tikz", Tools::CaseInsensitive) ) {
-    saveTikZ( filename, pageWidth, pageHeight, margin );
+    saveTikZ( filename, pageWidth, pageHeight, margin, stats );
+    return;
+  }
+  if ( Tools::stringEndsWith(filename,".dxf", Tools::CaseInsensitive) ) {
+    saveDXF( filename, pageWidth, pageHeight, margin, unit, stats );
     return;
   }
 }
 
 void
-Board::save(const char * filename, PageSize size, double margin , Unit unit) const
+Board::save(const char * filename, PageSize size, double margin , Unit unit, ExportStats * stats ) const
 {
   if ( size == BoundingBox ) {
-    save( filename, 0.0, 0.0, margin, unit );
+    save( filename, 0.0, 0.0, margin, unit, stats );
   } else {
-    save( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter );
+    save( filename, pageSizes[size][0], pageSizes[size][1], toMillimeter(margin,unit), UMillimeter, stats );
   }
 }
 
+void
+Board::save( std::ostream & out, Format format, PageSize size, double margin, Unit unit, ExportStats * stats ) const
+{
+  switch ( format ) {
+  case FormatEPS:
+    saveEPS( out, size, margin, unit, std::string(), stats );
+    break;
+  case FormatFIG:
+    saveFIG( out, size, margin, unit, stats );
+    break;
+  case FormatSVG:
+    saveSVG( out, size, margin, unit, stats );
+    break;
+  case FormatTikZ:
+    saveTikZ( out, size, margin, stats );
+    break;
+  case FormatDXF:
+    saveDXF( out, size, margin, unit, stats );
+    break;
+  }
+}
+
+std::size_t
+Board::saveTiles( const char * directory, Format format, double tileSize, unsigned int levels, std::size_t threads ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "Board::saveTiles", _shapes.size() );
+  if ( format != FormatSVG && format != FormatEPS ) {
+    Tools::error << "Board::saveTiles(): tiles may only be saved in SVG or EPS format.\n";
+    return 0;
+  }
+  if ( ! Tools::makeDirectory( directory ) ) {
+    Tools::error << "Board::saveTiles(): cannot create directory " << directory << "\n";
+    return 0;
+  }
+  const char * extension = ( format == FormatSVG ) ? "svg" : "eps";
+
+  // The shapes in drawing order, with their bounding boxes.
+  std::vector< Shape* > shapes = _shapes;
+  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+  std::vector< Rect > boxes( shapes.size() );
+  Rect drawing;
+  for ( std::size_t i = 0; i < shapes.size(); ++i ) {
+    boxes[i] = shapes[i]->boundingBox( UseLineWidth );
+    drawing = i ? ( drawing || boxes[i] ) : boxes[i];
+  }
+  if ( _clippingPath.size() > 2 ) {
+    drawing = drawing && _clippingPath.boundingBox();
+  }
+  const double extent = std::max( drawing.width, drawing.height );
+  if ( shapes.empty() || extent <= 0.0 ) {
+    return 0;
+  }
+
+  struct Tile {
+    unsigned int level, x, y;
+    Rect rect;
+    std::size_t shapes;
+    std::size_t culled;
+    std::size_t simplified;
+  };
+  std::vector< Tile > written;
+  ThreadPool pool( threads );
+  for ( unsigned int level = 0; level < levels; ++level ) {
+    BOARD_TRACE_SCOPE_ARG( "level", level );
+    const std::size_t n = std::size_t( 1 ) << level;
+    const double side = extent / n;
+
+    // A shape goes to each tile its bounding box meets, edges included:
+    // the first tile is the one before the box starts, unless the box
+    // starts inside it, the last one is the one where the box ends.
+    std::vector< std::vector< const Shape* > > tiles( n * n );
+    for ( std::size_t i = 0; i < shapes.size(); ++i ) {
+      const Rect & box = boxes[i];
+      if ( box.right() < drawing.left || box.left > drawing.left + extent
+           || box.bottom() > drawing.top || box.top < drawing.top - extent ) {
+        continue;
+      }
+      const std::size_t x0 = std::min( n - 1, static_cast<std::size_t>( std::max( 0.0, std::ceil( ( box.left - drawing.left ) / side ) - 1.0 ) ) );
+      const std::size_t x1 = std::min( n - 1, static_cast<std::size_t>( std::max( 0.0, std::floor( ( box.right() - drawing.left ) / side ) ) ) );
+      const std::size_t y0 = std::min( n - 1, static_cast<std::size_t>( std::max( 0.0, std::ceil( ( drawing.top - box.top ) / side ) - 1.0 ) ) );
+      const std::size_t y1 = std::min( n - 1, static_cast<std::size_t>( std::max( 0.0, std::floor( ( drawing.top - box.bottom() ) / side ) ) ) );
+      for ( std::size_t y = y0; y <= y1; ++y ) {
+        for ( std::size_t x = x0; x <= x1; ++x ) {
+          tiles[ y * n + x ].push_back( shapes[i] );
+        }
+      }
+    }
+
+    const std::size_t first = written.size();
+    for ( std::size_t t = 0; t < tiles.size(); ++t ) {
+      if ( ! tiles[t].empty() ) {
+        Tile tile;
+        tile.level = level;
+        tile.x = static_cast<unsigned int>( t % n );
+        tile.y = static_cast<unsigned int>( t / n );
+        tile.rect = Rect( drawing.left + tile.x * side, drawing.top - tile.y * side, side, side );
+        tile.shapes = tiles[t].size();
+        tile.culled = tile.simplified = 0;
+        written.push_back( tile );
+      }
+    }
+
+    for ( std::size_t k = first; k < written.size(); ++k ) {
+      Tile * tile = &written[k];
+      const std::vector< const Shape* > * tileShapes = &tiles[ tile->y * n + tile->x ];
+      pool.submit( [=]() {
+          BOARD_TRACE_SCOPE( "Board::tile" );
+          std::ostringstream filename;
+          filename << directory << "/" << tile->level << "-" << tile->x << "-" << tile->y << "." << extension;
+          std::ofstream out( filename.str().c_str() );
+          if ( ! out ) {
+            Tools::error << "Board::saveTiles(): cannot write " << filename.str() << "\n";
+            return;
+          }
+          if ( _detailThreshold > 0.0 ) {
+            ExportStats stats;
+            flushTile( out, format, tile->rect, tileSize, drawing, *tileShapes, &stats );
+            tile->culled = stats.culled;
+            tile->simplified = stats.simplified;
+          } else {
+            flushTile( out, format, tile->rect, tileSize, drawing, *tileShapes, 0 );
+          }
+        } );
+    }
+    pool.wait();
+  }
+
+  std::ostringstream manifestName;
+  manifestName << directory << "/tiles.json";
+  std::ofstream manifest( manifestName.str().c_str() );
+  manifest << std::setprecision( 12 );
+  manifest << "{\n"
+           << "  \"format\": \"" << extension << "\",\n"
+           << "  \"tileSize\": " << tileSize << ",\n"
+           << "  \"levels\": " << levels << ",\n"
+           << "  \"extent\": { \"left\": " << drawing.left << ", \"top\": " << drawing.top
+           << ", \"size\": " << extent << " },\n"
+           << "  \"detailThreshold\": " << _detailThreshold << ",\n"
+           << "  \"pyramid\": [\n";
+  for ( unsigned int level = 0; level < levels; ++level ) {
+    std::size_t count = 0, culled = 0, simplified = 0;
+    for ( std::size_t k = 0; k < written.size(); ++k ) {
+      if ( written[k].level == level ) {
+        ++count;
+        culled += written[k].culled;
+        simplified += written[k].simplified;
+      }
+    }
+    manifest << "    { \"level\": " << level << ", \"tiles\": " << count
+             << ", \"culled\": " << culled << ", \"simplified\": " << simplified << " }"
+             << ( level + 1 < levels ? "," : "" ) << "\n";
+  }
+  manifest << "  ],\n"
+           << "  \"tiles\": [\n";
+  for ( std::size_t k = 0; k < written.size(); ++k ) {
+    const Tile & tile = written[k];
+    manifest << "    { \"level\": " << tile.level << ", \"x\": " << tile.x << ", \"y\": " << tile.y
+             << ", \"file\": \"" << tile.level << "-" << tile.x << "-" << tile.y << "." << extension << "\""
+             << ", \"left\": " << tile.rect.left << ", \"top\": " << tile.rect.top
+             << ", \"size\": " << tile.rect.width << ", \"shapes\": " << tile.shapes
+             << ", \"culled\": " << tile.culled << ", \"simplified\": " << tile.simplified << " }"
+             << ( k + 1 < written.size() ? "," : "" ) << "\n";
+  }
+  manifest << "  ]\n}\n";
+  return written.size();
+}
+
+void
+Board::flushTile( std::ostream & output, Format format, const Rect & tile, double tileSize,
+                  const Rect & drawing, const std::vector<const Shape*> & shapes, ExportStats * stats ) const
+{
+  Path frame( true );
+  frame << tile.topLeft() << tile.topRight() << tile.bottomRight() << tile.bottomLeft();
+  const bool clipping = _clippingPath.size() > 2;
+  Rectangle background( drawing, Color::Null, _backgroundColor, 0.0, SolidStyle, ButtCap, MiterJoin );
+  std::vector<const Shape*>::const_iterator i = shapes.begin();
+  std::vector<const Shape*>::const_iterator end = shapes.end();
+
+  if ( format == FormatEPS ) {
+    TransformEPS transform;
+    ExportContext context;
+    transform.setContext( &context );
+    transform.setBoundingBox( tile, tileSize, tileSize, 0.0 );
+    transform.context().setDetailThreshold( _detailThreshold );
+    ExportRecorder recorder( output, stats, "EPS", transform );
+    std::ostream & out = recorder.out();
+    Rect page = transform.pageBoundingBox();
+    out << "%!PS-Adobe-2.0 EPSF-2.0" << std::endl;
+    out << "%%Creator: Board library (v" << _BOARD_VERSION_STRING_ << ") Copyleft 2007 Sebastien Fourey" << std::endl;
+    out << "%%BoundingBox: "
+        << std::setprecision( 8 )
+        << page.left << " "
+        << page.bottom() << " "
+        << page.right() << " "
+        << page.top << std::endl;
+    out << "%%EndComments" << std::endl;
+    out << "\n" << postscriptProcedures();
+    out << " newpath ";
+    frame.flushPostscript( out, transform );
+    out << " 0 slw clip " << std::endl;
+    if ( clipping ) {
+      out << " newpath ";
+      _clippingPath.flushPostscript( out, transform );
+      out << " 0 slw clip " << std::endl;
+    }
+    if ( _backgroundColor != Color::Null ) {
+      background.flushPostscript( out, transform );
+    }
+    while ( i != end ) {
+      if ( ! LevelOfDetail::flushReduced( **i, out, transform ) ) {
+        (*i)->flushPostscript( out, transform );
+      }
+      ++i;
+    }
+    out << "showpage" << std::endl;
+    out << "%%Trailer" << std::endl;
+    out << "%EOF" << std::endl;
+    return;
+  }
+
+  TransformSVG transform;
+  ExportContext context;
+  transform.setContext( &context );
+  transform.setBoundingBox( tile, tileSize, tileSize, 0.0 );
+  transform.context().setDetailThreshold( _detailThreshold );
+  ExportRecorder recorder( output, stats, "SVG", transform );
+  std::ostream & out = recorder.out();
+  out << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"no\"?>" << std::endl;
+  out << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"" << std::endl;
+  out << " \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">" << std::endl;
+  out << "<svg width=\""
+      << tileSize << "mm\" height=\""
+      << tileSize << "mm\" " << std::endl;
+  out << "     viewBox=\"0 0 "
+      << tileSize * ppmm  << " "
+      << tileSize * ppmm  << "\" " << std::endl;
+  out << "     xmlns=\"http://www.w3.org/2000/svg\""
+      << " xmlns:xlink=\"http://www.w3.org/1999/xlink\""
+      << " version=\"1.1\" >"
+      << std::endl;
+
+  // Each distinct bitmap of the tile is embedded once.
+  std::map<std::string,unsigned int> imageIds;
+  std::vector<std::string> imageFilenames;
+  ImageCollector collector( imageIds, imageFilenames );
+  while ( i != end ) {
+    (*i)->accept( collector );
+    ++i;
+  }
+  if ( ! imageFilenames.empty() ) {
+    out << "<defs>\n";
+    for ( std::size_t id = 0; id < imageFilenames.size(); ++id ) {
+      Image::flushSVGDefinition( out, imageFilenames[id], static_cast<unsigned int>( id ) );
+    }
+    out << "</defs>\n";
+    transform.context().setImageDefinitions( &imageIds );
+  }
+
+  out << "<g clip-rule=\"nonzero\">\n"
+         " <clipPath id=\"TileClipPath\">\n"
+         "  <path clip-rule=\"evenodd\"  d=\"";
+  frame.flushSVGCommands( out, transform );
+  out << "\" />\n"
+         " </clipPath>\n"
+         "<g clip-path=\"url(#TileClipPath)\">\n";
+  if ( clipping ) {
+    out << "<g clip-rule=\"nonzero\">\n"
+           " <clipPath id=\"GlobalClipPath\">\n"
+           "  <path clip-rule=\"evenodd\"  d=\"";
+    _clippingPath.flushSVGCommands( out, transform );
+    out << "\" />\n"
+           " </clipPath>\n"
+           "<g clip-path=\"url(#GlobalClipPath)\">\n";
+  }
+  if ( _backgroundColor != Color::Null ) {
+    background.flushSVG( out, transform );
+  }
+  for ( i = shapes.begin(); i != end; ++i ) {
+    if ( ! LevelOfDetail::flushReduced( **i, out, transform ) ) {
+      (*i)->flushSVG( out, transform );
+    }
+  }
+  if ( clipping )
+    out << "</g>\n</g>\n";
+  out << "</g>\n</g>\n";
+  out << "</svg>" << std::endl;
+}
+
 } // namespace PlaneDraw;
 
 /**
@@ -0,0 +1,476 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Clipping.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Geometric clipping of paths by a polygon.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "board/Clipping.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using PlaneDraw::Path;
+using PlaneDraw::Point;
+using PlaneDraw::Rect;
+using PlaneDraw::ClipRegion;
+
+inline double
+cross( const Point & a, const Point & b )
+{
+  return a.x * b.y - a.y * b.x;
+}
+
+double
+signedArea( const Path & polygon )
+{
+  double area = 0.0;
+  const std::size_t n = polygon.size();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    area += cross( polygon[i], polygon[ ( i + 1 ) % n ] );
+  }
+  return area / 2;
+}
+
+bool
+contains( const Path & polygon, const Point & p )
+{
+  bool inside = false;
+  const std::size_t n = polygon.size();
+  for ( std::size_t i = 0, j = n - 1; i < n; j = i++ ) {
+    const Point & a = polygon[i];
+    const Point & b = polygon[j];
+    if ( ( a.y > p.y ) != ( b.y > p.y )
+         && p.x < a.x + ( b.x - a.x ) * ( p.y - a.y ) / ( b.y - a.y ) ) {
+      inside = ! inside;
+    }
+  }
+  return inside;
+}
+
+// Intersection of the segments [p0,p1] and [q0,q1], at p0 + alpha (p1 - p0)
+// and q0 + beta (q1 - q0). Collinear overlapping segments are reported as
+// degenerate.
+enum Crossing { NoCrossing = 0, Crosses, Degenerate };
+
+Crossing
+segmentCrossing( const Point & p0, const Point & p1, const Point & q0, const Point & q1,
+                 double & alpha, double & beta )
+{
+  const Point r = p1 - p0;
+  const Point s = q1 - q0;
+  const Point qp = q0 - p0;
+  const double d = cross( r, s );
+  if ( std::fabs( d ) <= 1e-12 * r.norm() * s.norm() ) {
+    if ( std::fabs( cross( qp, r ) ) > 1e-12 * r.norm() * qp.norm() ) {
+      return NoCrossing;
+    }
+    // Collinear: overlapping unless the projections are disjoint.
+    const double rr = r * r;
+    if ( rr == 0.0 ) {
+      return NoCrossing;
+    }
+    const double t0 = ( qp * r ) / rr;
+    const double t1 = ( ( q1 - p0 ) * r ) / rr;
+    return ( std::max( t0, t1 ) < 0.0 || std::min( t0, t1 ) > 1.0 ) ? NoCrossing : Degenerate;
+  }
+  alpha = cross( qp, s ) / d;
+  beta = cross( qp, r ) / d;
+  return ( alpha >= 0.0 && alpha <= 1.0 && beta >= 0.0 && beta <= 1.0 ) ? Crosses : NoCrossing;
+}
+
+// Sutherland-Hodgman, the clipping polygon being convex and counterclockwise.
+bool
+sutherlandHodgman( const Path & subject, const Path & clip, std::vector<Path> & result )
+{
+  std::vector<Point> output;
+  bool inside = true;
+  for ( std::size_t i = 0; i < subject.size() && inside; ++i ) {
+    const Point & p = subject[i];
+    for ( std::size_t j = 0; j < clip.size(); ++j ) {
+      if ( cross( clip[ ( j + 1 ) % clip.size() ] - clip[j], p - clip[j] ) < 0.0 ) {
+        inside = false;
+        break;
+      }
+    }
+  }
+  if ( inside ) {
+    return true;
+  }
+  for ( std::size_t i = 0; i < subject.size(); ++i ) {
+    output.push_back( subject[i] );
+  }
+  std::vector<Point> input;
+  for ( std::size_t j = 0; j < clip.size() && ! output.empty(); ++j ) {
+    const Point & a = clip[j];
+    const Point edge = clip[ ( j + 1 ) % clip.size() ] - a;
+    input.swap( output );
+    output.clear();
+    Point s = input.back();
+    double sideS = cross( edge, s - a );
+    for ( std::size_t k = 0; k < input.size(); ++k ) {
+      const Point & p = input[k];
+      const double sideP = cross( edge, p - a );
+      if ( ( sideP >= 0.0 ) != ( sideS >= 0.0 ) ) {
+        const double t = sideS / ( sideS - sideP );
+        output.push_back( s + ( p - s ) * t );
+      }
+      if ( sideP >= 0.0 ) {
+        output.push_back( p );
+      }
+      s = p;
+      sideS = sideP;
+    }
+  }
+  if ( output.size() > 2 ) {
+    result.push_back( Path( output, true ) );
+  }
+  return false;
+}
+
+// A vertex of the lists of the Greiner-Hormann algorithm.
+struct Vertex {
+  Point p;
+  bool intersection;
+  bool entry;
+  bool visited;
+  std::size_t neighbor;
+  double alpha;
+  Vertex( const Point & p )
+    : p( p ), intersection( false ), entry( false ), visited( false ), neighbor( 0 ), alpha( 0.0 ) { }
+  bool operator<( const Vertex & other ) const { return alpha < other.alpha; }
+};
+
+struct Intersection {
+  std::size_t subjectEdge, clipEdge;
+  double alpha, beta;
+  Point p;
+};
+
+// Links the vertices of a polygon with the intersections on its edges,
+// sorted along each edge. position[k] receives the index of the k-th
+// intersection in the list.
+void
+buildList( const Path & polygon, const std::vector<Intersection> & intersections, bool subject,
+           std::vector<Vertex> & list, std::vector<std::size_t> & position )
+{
+  std::vector< std::vector<std::size_t> > onEdge( polygon.size() );
+  for ( std::size_t k = 0; k < intersections.size(); ++k ) {
+    onEdge[ subject ? intersections[k].subjectEdge : intersections[k].clipEdge ].push_back( k );
+  }
+  position.resize( intersections.size() );
+  for ( std::size_t i = 0; i < polygon.size(); ++i ) {
+    list.push_back( Vertex( polygon[i] ) );
+    const std::size_t first = list.size();
+    for ( std::size_t e = 0; e < onEdge[i].size(); ++e ) {
+      const Intersection & intersection = intersections[ onEdge[i][e] ];
+      Vertex vertex( intersection.p );
+      vertex.intersection = true;
+      vertex.alpha = subject ? intersection.alpha : intersection.beta;
+      vertex.neighbor = onEdge[i][e];
+      list.push_back( vertex );
+    }
+    std::stable_sort( list.begin() + first, list.end() );
+    for ( std::size_t v = first; v < list.size(); ++v ) {
+      position[ list[v].neighbor ] = v;
+    }
+  }
+}
+
+void
+markEntries( std::vector<Vertex> & list, const Path & other )
+{
+  bool inside = contains( other, list[0].p );
+  for ( std::size_t v = 0; v < list.size(); ++v ) {
+    if ( list[v].intersection ) {
+      list[v].entry = ! inside;
+      inside = ! inside;
+    }
+  }
+}
+
+enum Outcome { Clipped = 0, Inside, Failed };
+
+// Greiner-Hormann, for the intersection of two polygons. Fails on
+// degenerate configurations.
+Outcome
+greinerHormann( const Path & subject, const Path & clip, std::vector<Path> & result )
+{
+  const double epsilon = 1e-9;
+  std::vector<Intersection> intersections;
+  for ( std::size_t i = 0; i < subject.size(); ++i ) {
+    const Point & p0 = subject[i];
+    const Point & p1 = subject[ ( i + 1 ) % subject.size() ];
+    for ( std::size_t j = 0; j < clip.size(); ++j ) {
+      Intersection intersection;
+      const Crossing crossing = segmentCrossing( p0, p1, clip[j], clip[ ( j + 1 ) % clip.size() ],
+                                                 intersection.alpha, intersection.beta );
+      if ( crossing == Degenerate ) {
+        return Failed;
+      }
+      if ( crossing == Crosses ) {
+        if ( intersection.alpha < epsilon || intersection.alpha > 1 - epsilon
+             || intersection.beta < epsilon || intersection.beta > 1 - epsilon ) {
+          return Failed;
+        }
+        intersection.subjectEdge = i;
+        intersection.clipEdge = j;
+        intersection.p = p0 + ( p1 - p0 ) * intersection.alpha;
+        intersections.push_back( intersection );
+      }
+    }
+  }
+  if ( intersections.empty() ) {
+    if ( contains( clip, subject[0] ) ) {
+      return Inside;
+    }
+    if ( contains( subject, clip[0] ) ) {
+      result.push_back( clip );
+    }
+    return Clipped;
+  }
+
+  std::vector<Vertex> lists[2];
+  std::vector<std::size_t> positions[2];
+  buildList( subject, intersections, true, lists[0], positions[0] );
+  buildList( clip, intersections, false, lists[1], positions[1] );
+  for ( int l = 0; l < 2; ++l ) {
+    for ( std::size_t v = 0; v < lists[l].size(); ++v ) {
+      if ( lists[l][v].intersection ) {
+        lists[l][v].neighbor = positions[ 1 - l ][ lists[l][v].neighbor ];
+      }
+    }
+  }
+  markEntries( lists[0], clip );
+  markEntries( lists[1], subject );
+
+  for ( std::size_t start = 0; start < lists[0].size(); ++start ) {
+    if ( ! lists[0][start].intersection || lists[0][start].visited ) {
+      continue;
+    }
+    Path polygon( true );
+    polygon << lists[0][start].p;
+    int l = 0;
+    std::size_t v = start;
+    while ( ! lists[l][v].visited ) {
+      std::vector<Vertex> & list = lists[l];
+      list[v].visited = true;
+      lists[ 1 - l ][ list[v].neighbor ].visited = true;
+      const bool forward = list[v].entry;
+      const std::size_t n = list.size();
+      do {
+        v = forward ? ( v + 1 ) % n : ( v + n - 1 ) % n;
+        polygon << list[v].p;
+      } while ( ! list[v].intersection );
+      v = list[v].neighbor;
+      l = 1 - l;
+    }
+    polygon.pop_back();
+    if ( polygon.size() > 2 ) {
+      result.push_back( polygon );
+    }
+  }
+  return Clipped;
+}
+
+}
+
+namespace PlaneDraw {
+
+ClipRegion::ClipRegion( const Path & path )
+  : polygon( true ), box( path.boundingBox() )
+{
+  if ( signedArea( path ) < 0.0 ) {
+    for ( std::size_t i = path.size(); i > 0; --i ) {
+      polygon << path[ i - 1 ];
+    }
+  } else {
+    for ( std::size_t i = 0; i < path.size(); ++i ) {
+      polygon << path[i];
+    }
+  }
+  convex = Tools::isConvex( polygon );
+}
+
+bool
+ClipRegion::contains( const Point & p ) const
+{
+  return ::contains( polygon, p );
+}
+
+bool
+ClipRegion::meets( const Rect & rect ) const
+{
+  return rect.left <= box.right() && box.left <= rect.right()
+      && rect.bottom() <= box.top && box.bottom() <= rect.top;
+}
+
+bool
+ClipRegion::surrounds( const Rect & rect ) const
+{
+  if ( ! convex ) {
+    return false;
+  }
+  return contains( rect.topLeft() ) && contains( rect.topRight() )
+      && contains( rect.bottomLeft() ) && contains( rect.bottomRight() );
+}
+
+namespace Tools {
+
+bool
+isConvex( const Path & polygon )
+{
+  const std::size_t n = polygon.size();
+  if ( n < 3 ) {
+    return false;
+  }
+  int sign = 0;
+  double turn = 0.0;
+  for ( std::size_t i = 0; i < n; ++i ) {
+    const Point a = polygon[ ( i + 1 ) % n ] - polygon[i];
+    const Point b = polygon[ ( i + 2 ) % n ] - polygon[ ( i + 1 ) % n ];
+    const double c = cross( a, b );
+    if ( c != 0.0 ) {
+      const int s = ( c > 0.0 ) ? 1 : -1;
+      if ( sign && s != sign ) {
+        return false;
+      }
+      sign = s;
+    }
+    turn += std::atan2( c, a * b );
+  }
+  // A star has consistent turns, but winds more than once.
+  return std::fabs( std::fabs( turn ) - 2 * M_PI ) < 1e-6;
+}
+
+bool
+clipPolygon( const Path & subject, const ClipRegion & region, std::vector<Path> & result )
+{
+  if ( subject.size() < 3 ) {
+    return false;
+  }
+  if ( region.convex ) {
+    return sutherlandHodgman( subject, region.polygon, result );
+  }
+  Path perturbed( subject );
+  const Rect box = subject.boundingBox() || region.box;
+  for ( int attempt = 1; attempt <= 8; ++attempt ) {
+    std::vector<Path> polygons;
+    switch ( greinerHormann( perturbed, region.polygon, polygons ) ) {
+    case Inside:
+      return true;
+    case Clipped:
+      // Drop the slivers left by edges shared with the region.
+      for ( std::size_t i = 0; i < polygons.size(); ++i ) {
+        if ( std::fabs( signedArea( polygons[i] ) ) > 1e-9 * box.width * box.height ) {
+          result.push_back( polygons[i] );
+        }
+      }
+      return false;
+    case Failed:
+      break;
+    }
+    // Move the vertices off the edges of the region, by a distance far
+    // below what an output format can show.
+    const double shift = attempt * 1e-9 * ( box.width + box.height );
+    for ( std::size_t i = 0; i < subject.size(); ++i ) {
+      const double angle = ( attempt * 7 + i ) * 2.39996322972865332;
+      perturbed[i] = subject[i] + Point( std::cos( angle ), std::sin( angle ) ) * shift;
+    }
+  }
+  // Still degenerate: keep the subject whole.
+  return true;
+}
+
+bool
+clipPolyline( const Path & subject, const ClipRegion & region, std::vector<Path> & result )
+{
+  const std::size_t n = subject.size();
+  if ( n < 2 ) {
+    return n == 1 && region.contains( subject[0] );
+  }
+  const std::size_t segments = subject.closed() ? n : n - 1;
+  std::vector<Path> pieces;
+  Path current;
+  bool inside = true;
+  bool continued = false;      // Whether current ends at the start of the segment.
+  std::vector<double> cuts;
+  for ( std::size_t i = 0; i < segments; ++i ) {
+    const Point & p0 = subject[i];
+    const Point & p1 = subject[ ( i + 1 ) % n ];
+    cuts.clear();
+    cuts.push_back( 0.0 );
+    for ( std::size_t j = 0; j < region.polygon.size(); ++j ) {
+      double alpha, beta;
+      if ( segmentCrossing( p0, p1, region.polygon[j], region.polygon[ ( j + 1 ) % region.polygon.size() ],
+                            alpha, beta ) == Crosses ) {
+        cuts.push_back( alpha );
+      }
+    }
+    cuts.push_back( 1.0 );
+    std::sort( cuts.begin(), cuts.end() );
+    if ( cuts.size() > 2 ) {
+      inside = false;
+    }
+    for ( std::size_t k = 0; k + 1 < cuts.size(); ++k ) {
+      if ( cuts[k + 1] - cuts[k] <= 0.0 ) {
+        continue;
+      }
+      const Point a = p0 + ( p1 - p0 ) * cuts[k];
+      const Point b = p0 + ( p1 - p0 ) * cuts[k + 1];
+      if ( region.contains( ( a + b ) * 0.5 ) ) {
+        if ( ! continued ) {
+          if ( current.size() > 1 ) {
+            pieces.push_back( current );
+          }
+          current.clear();
+          current << a;
+        }
+        current << b;
+        continued = true;
+      } else {
+        inside = false;
+        continued = false;
+      }
+    }
+  }
+  if ( inside ) {
+    return true;
+  }
+  if ( current.size() > 1 ) {
+    // The last piece of a closed line may go on with the first one.
+    if ( subject.closed() && continued && ! pieces.empty() && pieces.front()[0] == subject[0] ) {
+      for ( std::size_t i = 1; i < pieces.front().size(); ++i ) {
+        current << pieces.front()[i];
+      }
+      pieces.front() = current;
+    } else {
+      pieces.push_back( current );
+    }
+  }
+  result.insert( result.end(), pieces.begin(), pieces.end() );
+  return false;
+}
+
+} // namespace Tools
+
+} // namespace PlaneDraw
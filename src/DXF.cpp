@@ -0,0 +1,491 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   DXF.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  The tables of a DXF export, shared by the shapes.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "board/DXF.h"
+#include "board/ShapeList.h"
+#include "board/Shapes.h"
+#include "board/Transforms.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI		3.14159265358979323846	/* pi */
+#endif
+
+namespace {
+
+using namespace PlaneDraw;
+
+// The dashes of the line styles, as in the EPS export (in points).
+struct LineType {
+  const char * name;
+  const char * description;
+  int count;
+  double lengths[8];
+};
+
+const LineType lineTypes[] = {
+  { "Continuous", "Solid line", 0, { 0 } },
+  { "DASH", "Dash", 2, { 1, -1 } },
+  { "DOT", "Dot", 2, { 1.5, -4.5 } },
+  { "DASHDOT", "Dash dot", 4, { 4.5, -2.3, 1.5, -2.3 } },
+  { "DASHDOTDOT", "Dash dot dot", 6, { 4.5, -2.0, 1.5, -1.5, 1.5, -2.0 } },
+  { "DASHDOTDOTDOT", "Dash dot dot dot", 8, { 4.5, -1.8, 1.5, -1.4, 1.5, -1.4, 1.5, -1.8 } }
+};
+
+const int lineTypeCount = sizeof( lineTypes ) / sizeof( lineTypes[0] );
+
+// The line weights a DXF reader accepts (hundredths of a millimeter).
+const int lineWeights[] = { 0, 5, 9, 13, 15, 18, 20, 25, 30, 35, 40, 50, 53, 60, 70,
+                            80, 90, 100, 106, 120, 140, 158, 200, 211 };
+
+int
+lineWeight( double width )
+{
+  const double hundredths = width * 100;
+  int best = 0;
+  for ( std::size_t i = 1; i < sizeof( lineWeights ) / sizeof( lineWeights[0] ); ++i ) {
+    if ( std::fabs( lineWeights[i] - hundredths ) < std::fabs( lineWeights[best] - hundredths ) ) {
+      best = static_cast<int>( i );
+    }
+  }
+  return lineWeights[best];
+}
+
+// The nearest color of the AutoCAD Color Index, for the readers that
+// ignore true colors.
+int
+colorIndex( const Color & color )
+{
+  static const struct { int index; int red, green, blue; } colors[] = {
+    { 1, 255, 0, 0 }, { 2, 255, 255, 0 }, { 3, 0, 255, 0 }, { 4, 0, 255, 255 },
+    { 5, 0, 0, 255 }, { 6, 255, 0, 255 }, { 7, 0, 0, 0 }, { 8, 128, 128, 128 },
+    { 9, 192, 192, 192 }, { 250, 51, 51, 51 }, { 251, 80, 80, 80 }, { 252, 105, 105, 105 },
+    { 254, 190, 190, 190 }, { 255, 255, 255, 255 }
+  };
+  int best = 7;
+  long bestDistance = std::numeric_limits<long>::max();
+  for ( std::size_t i = 0; i < sizeof( colors ) / sizeof( colors[0] ); ++i ) {
+    const long r = colors[i].red - color.red();
+    const long g = colors[i].green - color.green();
+    const long b = colors[i].blue - color.blue();
+    const long distance = r * r + g * g + b * b;
+    if ( distance < bestDistance ) {
+      bestDistance = distance;
+      best = colors[i].index;
+    }
+  }
+  return best;
+}
+
+std::string
+hex( unsigned long handle )
+{
+  char buffer[32];
+  std::snprintf( buffer, sizeof( buffer ), "%lX", handle );
+  return buffer;
+}
+
+// A TrueType font close to a Postscript font.
+std::string
+fontFile( Fonts::Font font )
+{
+  const char * name = PSFontNames[ font ];
+  const bool bold = std::strstr( name, "Bold" ) || std::strstr( name, "Demi" );
+  const bool italic = std::strstr( name, "Italic" ) || std::strstr( name, "Oblique" );
+  if ( ! std::strncmp( name, "Symbol", 6 ) ) return "symbol.ttf";
+  if ( ! std::strncmp( name, "ZapfDingbats", 12 ) ) return "wingding.ttf";
+  std::string base = "arial";
+  if ( ! std::strncmp( name, "Times", 5 ) || ! std::strncmp( name, "NewCentury", 10 )
+       || ! std::strncmp( name, "Palatino", 8 ) || ! std::strncmp( name, "Bookman", 7 ) ) {
+    base = "times";
+  } else if ( ! std::strncmp( name, "Courier", 7 ) ) {
+    base = "cour";
+  }
+  return base + ( bold ? ( italic ? "bi" : "bd" ) : ( italic ? "i" : "" ) ) + ".ttf";
+}
+
+void
+beginTable( std::ostream & stream, const char * name, unsigned long handle, std::size_t count )
+{
+  stream << "0\nTABLE\n2\n" << name << "\n5\n" << hex( handle ) << "\n330\n0\n"
+         << "100\nAcDbSymbolTable\n70\n" << count << "\n";
+}
+
+void
+tableEntry( std::ostream & stream, const char * type, const char * subclass,
+            unsigned long handle, unsigned long table, const std::string & name )
+{
+  stream << "0\n" << type << "\n5\n" << hex( handle ) << "\n330\n" << hex( table ) << "\n"
+         << "100\nAcDbSymbolTableRecord\n100\n" << subclass << "\n2\n" << name << "\n70\n0\n";
+}
+
+}
+
+namespace PlaneDraw {
+
+DXFTables::DXFTables()
+  : _pass( Collect ), _handle( 0 ), _owner( 0 ), _modelSpace( 0 ), _paperSpace( 0 ), _dictionary( 0 )
+{
+}
+
+const DXFTables::Key *
+DXFTables::key( const Group & group ) const
+{
+  std::map<const Group*, Key>::const_iterator it = _groups.find( &group );
+  return ( it != _groups.end() ) ? &it->second : 0;
+}
+
+const DXFTables::Key &
+DXFTables::addGroup( const Group & group, const Key & key )
+{
+  std::map<Key, Block>::iterator it = _blocks.find( key );
+  if ( it == _blocks.end() ) {
+    Block & block = _blocks[ key ];
+    block.group = &group;
+    block.count = 1;
+    block.record = 0;
+    _order.push_back( key );
+  } else {
+    ++it->second.count;
+  }
+  return _groups[ &group ] = key;
+}
+
+const DXFTables::Block *
+DXFTables::block( const Group & group ) const
+{
+  std::map<const Group*, Key>::const_iterator it = _groups.find( &group );
+  if ( it == _groups.end() ) {
+    return 0;
+  }
+  std::map<Key, Block>::const_iterator block = _blocks.find( it->second );
+  return ( block != _blocks.end() && block->second.count > 1 ) ? &block->second : 0;
+}
+
+std::vector<const DXFTables::Block*>
+DXFTables::blocks() const
+{
+  std::vector<const Block*> result;
+  for ( std::vector<Key>::const_iterator it = _order.begin(); it != _order.end(); ++it ) {
+    const Block & block = _blocks.find( *it )->second;
+    if ( block.count > 1 ) {
+      result.push_back( &block );
+    }
+  }
+  return result;
+}
+
+Point
+DXFTables::origin( const Group & group )
+{
+  const Rect bbox = group.boundingBox( Shape::UseLineWidth );
+  return Point( bbox.left, bbox.top - bbox.height );
+}
+
+std::string
+DXFTables::layer( int depth )
+{
+  if ( depth < 0 || depth > MaxLayerDepth ) {
+    return "0";
+  }
+  char buffer[32];
+  std::snprintf( buffer, sizeof( buffer ), "DEPTH_%d", depth );
+  return buffer;
+}
+
+void
+DXFTables::handle( std::ostream & stream, unsigned long owner )
+{
+  stream << "5\n" << hex( nextHandle() ) << "\n330\n" << hex( owner ) << "\n";
+}
+
+void
+DXFTables::entity( std::ostream & stream, const char * type, int depth,
+                   const Color & color, double lineWidth, int lineStyle )
+{
+  stream << "0\n" << type << "\n";
+  if ( _pass == Collect ) {
+    if ( depth >= 0 && depth <= MaxLayerDepth ) {
+      _depths.insert( depth );
+    }
+  } else {
+    handle( stream );
+  }
+  stream << "100\nAcDbEntity\n8\n" << layer( depth ) << "\n";
+  if ( lineStyle > 0 && lineStyle < lineTypeCount ) {
+    stream << "6\n" << lineTypes[ lineStyle ].name << "\n";
+  }
+  if ( color.valid() ) {
+    stream << "62\n" << colorIndex( color ) << "\n"
+           << "420\n" << ( ( color.red() << 16 ) | ( color.green() << 8 ) | color.blue() ) << "\n";
+    if ( color.alpha() != 255 ) {
+      stream << "440\n" << ( 0x02000000 | color.alpha() ) << "\n";
+    }
+  } else {
+    stream << "62\n256\n";
+  }
+  if ( lineWidth >= 0.0 ) {
+    stream << "370\n" << lineWeight( lineWidth ) << "\n";
+  }
+}
+
+void
+DXFTables::point( std::ostream & stream, int code, const Point & p, bool z )
+{
+  stream << code << "\n" << p.x << "\n" << code + 10 << "\n" << p.y << "\n";
+  if ( z ) {
+    stream << code + 20 << "\n0.0\n";
+  }
+}
+
+void
+DXFTables::beginHatch( std::ostream & stream, int depth, const Color & color,
+                       const Hatch & hatch, const TransformDXF & transform )
+{
+  entity( stream, "HATCH", depth, color, hatch.valid() ? transform.mapWidth( hatch.lineWidth ) : -1.0, 0 );
+  stream << "100\nAcDbHatch\n";
+  point( stream, 10, Point( 0, 0 ) );
+  stream << "210\n0.0\n220\n0.0\n230\n1.0\n"
+         << "2\n" << ( hatch.valid() ? "_USER" : "SOLID" ) << "\n"
+         << "70\n" << ( hatch.valid() ? 0 : 1 ) << "\n"
+         << "71\n0\n91\n1\n";
+}
+
+void
+DXFTables::hatchPolygon( std::ostream & stream, const std::vector<Point> & points )
+{
+  // External polyline boundary, no bulges, closed.
+  stream << "92\n3\n72\n0\n73\n1\n93\n" << points.size() << "\n";
+  for ( std::vector<Point>::const_iterator it = points.begin(); it != points.end(); ++it ) {
+    point( stream, 10, *it, false );
+  }
+  stream << "97\n0\n";
+}
+
+void
+DXFTables::endHatch( std::ostream & stream, const Hatch & hatch, const TransformDXF & transform )
+{
+  stream << "75\n0\n76\n" << ( hatch.valid() ? 0 : 1 ) << "\n";
+  if ( hatch.valid() ) {
+    // A user defined pattern: one family of lines, or two.
+    const double degrees = hatch.angle * 180.0 / M_PI;
+    const double spacing = transform.scale( hatch.spacing );
+    stream << "52\n" << degrees << "\n41\n" << spacing << "\n77\n" << ( hatch.cross ? 1 : 0 ) << "\n"
+           << "78\n" << ( hatch.cross ? 2 : 1 ) << "\n";
+    for ( int family = 0; family < ( hatch.cross ? 2 : 1 ); ++family ) {
+      const double angle = hatch.angle + family * M_PI / 2;
+      stream << "53\n" << ( degrees + family * 90 ) << "\n43\n0.0\n44\n0.0\n"
+             << "45\n" << -spacing * std::sin( angle ) << "\n46\n" << spacing * std::cos( angle ) << "\n"
+             << "79\n0\n";
+    }
+  }
+  stream << "98\n0\n";
+}
+
+void
+DXFTables::hatch( std::ostream & stream, const std::vector<Point> & points, int depth,
+                  const Color & color, const Hatch & hatch, const TransformDXF & transform )
+{
+  beginHatch( stream, depth, color, hatch, transform );
+  hatchPolygon( stream, points );
+  endHatch( stream, hatch, transform );
+}
+
+void
+DXFTables::insert( std::ostream & stream, const Block & block, const Point & position, int depth )
+{
+  entity( stream, "INSERT", depth, Color::Null, -1.0, 0 );
+  stream << "100\nAcDbBlockReference\n2\n" << block.name << "\n";
+  point( stream, 10, position );
+}
+
+const char *
+DXFTables::style( Fonts::Font font )
+{
+  if ( _pass == Collect ) {
+    _fonts.insert( font );
+  }
+  return PSFontNames[ font ];
+}
+
+void
+DXFTables::flushHeader( std::ostream & stream, const Rect & extents ) const
+{
+  stream << "0\nSECTION\n2\nHEADER\n"
+         << "9\n$ACADVER\n1\nAC1018\n"
+         << "9\n$DWGCODEPAGE\n3\nANSI_1252\n"
+         // Handles are given while the entities are written: the seed
+         // is above any of them.
+         << "9\n$HANDSEED\n5\nFFFFFFFFFF\n"
+         << "9\n$INSUNITS\n70\n4\n"
+         << "9\n$MEASUREMENT\n70\n1\n"
+         << "9\n$EXTMIN\n";
+  point( stream, 10, Point( extents.left, extents.top - extents.height ) );
+  stream << "9\n$EXTMAX\n";
+  point( stream, 10, Point( extents.left + extents.width, extents.top ) );
+  stream << "0\nENDSEC\n";
+}
+
+void
+DXFTables::flushTables( std::ostream & stream )
+{
+  stream << "0\nSECTION\n2\nTABLES\n";
+  unsigned long table;
+
+  beginTable( stream, "VPORT", table = nextHandle(), 0 );
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "LTYPE", table = nextHandle(), lineTypeCount + 2 );
+  tableEntry( stream, "LTYPE", "AcDbLinetypeTableRecord", nextHandle(), table, "ByBlock" );
+  stream << "3\n\n72\n65\n73\n0\n40\n0.0\n";
+  tableEntry( stream, "LTYPE", "AcDbLinetypeTableRecord", nextHandle(), table, "ByLayer" );
+  stream << "3\n\n72\n65\n73\n0\n40\n0.0\n";
+  for ( int i = 0; i < lineTypeCount; ++i ) {
+    const LineType & type = lineTypes[i];
+    double total = 0.0;
+    for ( int n = 0; n < type.count; ++n ) {
+      total += std::fabs( type.lengths[n] ) * 25.4 / 72.0;
+    }
+    tableEntry( stream, "LTYPE", "AcDbLinetypeTableRecord", nextHandle(), table, type.name );
+    stream << "3\n" << type.description << "\n72\n65\n73\n" << type.count << "\n40\n" << total << "\n";
+    for ( int n = 0; n < type.count; ++n ) {
+      stream << "49\n" << type.lengths[n] * 25.4 / 72.0 << "\n74\n0\n";
+    }
+  }
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "LAYER", table = nextHandle(), _depths.size() + 1 );
+  tableEntry( stream, "LAYER", "AcDbLayerTableRecord", nextHandle(), table, "0" );
+  stream << "62\n7\n6\nContinuous\n370\n-3\n";
+  for ( std::set<int>::const_reverse_iterator it = _depths.rbegin(); it != _depths.rend(); ++it ) {
+    tableEntry( stream, "LAYER", "AcDbLayerTableRecord", nextHandle(), table, layer( *it ) );
+    stream << "62\n7\n6\nContinuous\n370\n-3\n";
+  }
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "STYLE", table = nextHandle(), _fonts.size() + 1 );
+  tableEntry( stream, "STYLE", "AcDbTextStyleTableRecord", nextHandle(), table, "Standard" );
+  stream << "40\n0.0\n41\n1.0\n50\n0.0\n71\n0\n42\n2.5\n3\narial.ttf\n4\n\n";
+  for ( std::set<int>::const_iterator it = _fonts.begin(); it != _fonts.end(); ++it ) {
+    const Fonts::Font font = static_cast<Fonts::Font>( *it );
+    tableEntry( stream, "STYLE", "AcDbTextStyleTableRecord", nextHandle(), table, PSFontNames[ font ] );
+    stream << "40\n0.0\n41\n1.0\n50\n0.0\n71\n0\n42\n2.5\n3\n" << fontFile( font ) << "\n4\n\n";
+  }
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "VIEW", table = nextHandle(), 0 );
+  stream << "0\nENDTAB\n";
+  beginTable( stream, "UCS", table = nextHandle(), 0 );
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "APPID", table = nextHandle(), 1 );
+  tableEntry( stream, "APPID", "AcDbRegAppTableRecord", nextHandle(), table, "ACAD" );
+  stream << "0\nENDTAB\n";
+
+  beginTable( stream, "DIMSTYLE", table = nextHandle(), 0 );
+  stream << "100\nAcDbDimStyleTable\n71\n0\n0\nENDTAB\n";
+
+  const std::vector<const Block*> shared = blocks();
+  beginTable( stream, "BLOCK_RECORD", table = nextHandle(), shared.size() + 2 );
+  stream << "0\nBLOCK_RECORD\n5\n" << hex( _modelSpace = nextHandle() ) << "\n330\n" << hex( table ) << "\n"
+         << "100\nAcDbSymbolTableRecord\n100\nAcDbBlockTableRecord\n2\n*Model_Space\n";
+  stream << "0\nBLOCK_RECORD\n5\n" << hex( _paperSpace = nextHandle() ) << "\n330\n" << hex( table ) << "\n"
+         << "100\nAcDbSymbolTableRecord\n100\nAcDbBlockTableRecord\n2\n*Paper_Space\n";
+  for ( std::size_t i = 0; i < shared.size(); ++i ) {
+    Block & block = _blocks[ _groups[ shared[i]->group ] ];
+    char name[32];
+    std::snprintf( name, sizeof( name ), "GROUP_%lu", static_cast<unsigned long>( i + 1 ) );
+    block.name = name;
+    block.record = nextHandle();
+    stream << "0\nBLOCK_RECORD\n5\n" << hex( block.record ) << "\n330\n" << hex( table ) << "\n"
+           << "100\nAcDbSymbolTableRecord\n100\nAcDbBlockTableRecord\n2\n" << block.name << "\n";
+  }
+  stream << "0\nENDTAB\n";
+
+  stream << "0\nENDSEC\n";
+}
+
+void
+DXFTables::beginBlock( std::ostream & stream, const std::string & name, unsigned long record )
+{
+  _owner = record;
+  stream << "0\nBLOCK\n";
+  handle( stream );
+  stream << "100\nAcDbEntity\n8\n0\n100\nAcDbBlockBegin\n2\n" << name << "\n70\n0\n";
+  point( stream, 10, Point( 0, 0 ) );
+  stream << "3\n" << name << "\n1\n\n";
+}
+
+void
+DXFTables::endBlock( std::ostream & stream )
+{
+  stream << "0\nENDBLK\n";
+  handle( stream );
+  stream << "100\nAcDbEntity\n8\n0\n100\nAcDbBlockEnd\n";
+}
+
+void
+DXFTables::flushObjects( std::ostream & stream )
+{
+  _dictionary = nextHandle();
+  const unsigned long groups = nextHandle();
+  stream << "0\nSECTION\n2\nOBJECTS\n"
+         << "0\nDICTIONARY\n5\n" << hex( _dictionary ) << "\n330\n0\n100\nAcDbDictionary\n281\n1\n"
+         << "3\nACAD_GROUP\n350\n" << hex( groups ) << "\n"
+         << "0\nDICTIONARY\n5\n" << hex( groups ) << "\n330\n" << hex( _dictionary ) << "\n100\nAcDbDictionary\n281\n1\n"
+         << "0\nENDSEC\n";
+}
+
+void
+HashingStreamBuffer::add( unsigned char c )
+{
+  _hash = ( _hash ^ c ) * 1099511628211ULL;
+  _check = _check * 0x9E3779B97F4A7C15ULL + c + 1;
+  ++_length;
+}
+
+HashingStreamBuffer::int_type
+HashingStreamBuffer::overflow( int_type c )
+{
+  if ( traits_type::eq_int_type( c, traits_type::eof() ) ) {
+    return traits_type::not_eof( c );
+  }
+  add( static_cast<unsigned char>( traits_type::to_char_type( c ) ) );
+  return c;
+}
+
+std::streamsize
+HashingStreamBuffer::xsputn( const char * s, std::streamsize n )
+{
+  for ( std::streamsize i = 0; i < n; ++i ) {
+    add( static_cast<unsigned char>( s[i] ) );
+  }
+  return n;
+}
+
+} // namespace PlaneDraw
@@ -0,0 +1,270 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Document.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Multi-page documents.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/Document.h"
+#include "board/ShapeVisitor.h"
+#include "board/ThreadPool.h"
+#include "board/Tools.h"
+#include "board/Trace.h"
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace {
+
+/*
+ * Collects the distinct bitmap files used by the images of the pages,
+ * in document order.
+ */
+struct ImageCollector : public PlaneDraw::TypedShapeVisitor {
+  ImageCollector( std::vector<std::string> & filenames )
+    : _filenames( filenames ) { }
+  void visit( const PlaneDraw::Image & image ) {
+    if ( _seen.insert( std::make_pair( image.filename(), true ) ).second ) {
+      _filenames.push_back( image.filename() );
+    }
+  }
+private:
+  std::vector<std::string> & _filenames;
+  std::map<std::string,bool> _seen;
+};
+
+/*
+ * The Postscript code of the drawing of a page, and its bounding box.
+ */
+struct PageCode {
+  std::string code;
+  PlaneDraw::Rect box;
+};
+
+}
+
+namespace PlaneDraw {
+
+Document::Document()
+{
+}
+
+Document::Document( const Document & other )
+{
+  *this = other;
+}
+
+Document::~Document()
+{
+  clear();
+}
+
+Document &
+Document::operator=( const Document & other )
+{
+  if ( &other == this ) {
+    return *this;
+  }
+  clear();
+  _pages.reserve( other._pages.size() );
+  std::vector<Board*>::const_iterator it = other._pages.begin();
+  while ( it != other._pages.end() ) {
+    _pages.push_back( new Board( **it ) );
+    ++it;
+  }
+  return *this;
+}
+
+Board &
+Document::addPage()
+{
+  _pages.push_back( new Board );
+  return *_pages.back();
+}
+
+Board &
+Document::addPage( const Board & board )
+{
+  _pages.push_back( new Board( board ) );
+  return *_pages.back();
+}
+
+Document &
+Document::operator<<( const Board & board )
+{
+  addPage( board );
+  return *this;
+}
+
+std::size_t
+Document::pageCount() const
+{
+  return _pages.size();
+}
+
+Board &
+Document::page( std::size_t n )
+{
+  return *_pages[n];
+}
+
+const Board &
+Document::page( std::size_t n ) const
+{
+  return *_pages[n];
+}
+
+void
+Document::clear()
+{
+  std::vector<Board*>::iterator it = _pages.begin();
+  while ( it != _pages.end() ) {
+    delete *it;
+    ++it;
+  }
+  _pages.clear();
+}
+
+void
+Document::savePostscript( const char * filename, Board::PageSize size, double margin, Board::Unit unit,
+                          const std::string & title, std::size_t threads ) const
+{
+  std::ofstream out( filename );
+  savePostscript( out, size, margin, unit, title, threads );
+  out.close();
+}
+
+void
+Document::savePostscript( std::ostream & out, Board::PageSize size, double margin, Board::Unit unit,
+                          const std::string & title, std::size_t threads ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "Document::savePostscript", _pages.size() );
+  double pageWidth = 0.0;
+  double pageHeight = 0.0;
+  if ( size != Board::BoundingBox ) {
+    Board::pageDimensions( size, pageWidth, pageHeight );
+    margin = Board::toMillimeter( margin, unit );
+    unit = Board::UMillimeter;
+  }
+
+  // Each distinct bitmap is defined once, placements refer to it.
+  std::map<std::string,unsigned int> imageIds;
+  std::ostringstream definitions;
+  {
+    BOARD_TRACE_SCOPE( "images" );
+    std::vector<std::string> filenames;
+    ImageCollector collector( filenames );
+    std::vector<Board*>::const_iterator it = _pages.begin();
+    while ( it != _pages.end() ) {
+      ( *it )->accept( collector );
+      ++it;
+    }
+    for ( std::size_t i = 0; i < filenames.size(); ++i ) {
+      const unsigned int id = static_cast<unsigned int>( imageIds.size() );
+      std::ostringstream definition;
+      if ( Image::flushPostscriptDefinition( definition, filenames[i], id ) ) {
+        definitions << definition.str();
+        imageIds[ filenames[i] ] = id;
+      }
+    }
+  }
+
+  // The pages are formatted concurrently.
+  std::vector<PageCode> pages( _pages.size() );
+  {
+    BOARD_TRACE_SCOPE( "pages" );
+    ThreadPool pool( ( _pages.size() > 1 ) ? threads : 1 );
+    for ( std::size_t n = 0; n < _pages.size(); ++n ) {
+      const Board * board = _pages[n];
+      PageCode * page = &pages[n];
+      const std::map<std::string,unsigned int> * ids = &imageIds;
+      pool.submit( [=]() {
+          BOARD_TRACE_SCOPE_ARG( "Document::page", n );
+          TransformEPS transform;
+          ExportContext context;
+          transform.setContext( &context );
+          transform.context().setImageDefinitions( ids );
+          const Rect bbox = board->setupPostscript( transform, pageWidth, pageHeight, margin, unit, 0 );
+          std::ostringstream code;
+          code << std::setprecision( 8 );
+          board->flushPostscriptDrawing( code, transform, bbox, 0 );
+          page->code = code.str();
+          page->box = transform.pageBoundingBox();
+        } );
+    }
+    pool.wait();
+  }
+
+  Rect documentBox;
+  for ( std::size_t n = 0; n < pages.size(); ++n ) {
+    documentBox = n ? ( documentBox || pages[n].box ) : pages[n].box;
+  }
+  out << "%!PS-Adobe-3.0" << std::endl;
+  out << "%%Title: " << title << std::endl;
+  out << "%%Creator: Board library (v" << _BOARD_VERSION_STRING_ << ") Copyleft 2007 Sebastien Fourey" << std::endl;
+  {
+    time_t t = time(0);
+    char str_time[255];
+    Tools::secured_ctime( str_time, &t, 255 );
+    out << "%%CreationDate: " << str_time;
+  }
+  out << std::setprecision( 8 );
+  out << "%%Pages: " << pages.size() << std::endl;
+  out << "%%BoundingBox: "
+      << documentBox.left << " "
+      << documentBox.bottom() << " "
+      << documentBox.right() << " "
+      << documentBox.top << std::endl;
+  out << "%%LanguageLevel: " << ( imageIds.empty() ? 2 : 3 ) << std::endl;
+  out << "%%EndComments" << std::endl;
+
+  out << "%%BeginProlog" << std::endl;
+  out << Board::postscriptProcedures();
+  out << "%%EndProlog" << std::endl;
+  out << "%%BeginSetup" << std::endl;
+  const std::string & setup = definitions.str();
+  out.write( setup.data(), setup.size() );
+  out << "%%EndSetup" << std::endl;
+
+  for ( std::size_t n = 0; n < pages.size(); ++n ) {
+    const Rect & box = pages[n].box;
+    out << "%%Page: " << ( n + 1 ) << " " << ( n + 1 ) << std::endl;
+    out << "%%PageBoundingBox: "
+        << box.left << " "
+        << box.bottom() << " "
+        << box.right() << " "
+        << box.top << std::endl;
+    out << "%%BeginPageSetup" << std::endl;
+    out << "<< /PageSize [ " << box.right() << " " << box.top << " ] >> setpagedevice" << std::endl;
+    out << "%%EndPageSetup" << std::endl;
+    out << "save" << std::endl;
+    out << " 0.5 setlinewidth" << std::endl;
+    out.write( pages[n].code.data(), pages[n].code.size() );
+    out << "restore showpage" << std::endl;
+  }
+  out << "%%Trailer" << std::endl;
+  out << "%%EOF" << std::endl;
+}
+
+} // namespace PlaneDraw
@@ -0,0 +1,163 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ExportStats.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Statistics and phase timings of an export.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/ExportStats.h"
+#include "board/Shapes.h"
+#include "board/Tools.h"
+#include <cstdio>
+
+namespace PlaneDraw {
+
+ExportStats::ExportStats()
+{
+  clear();
+}
+
+void
+ExportStats::clear()
+{
+  format.clear();
+  totalSeconds = 0.0;
+  bytes = 0;
+  phases.clear();
+  shapes.clear();
+  images = 0;
+  groups = 0;
+  clipPaths = 0;
+  culled = 0;
+  simplified = 0;
+  cached = 0;
+}
+
+void
+ExportStats::addPhase( const std::string & phase, double seconds )
+{
+  std::vector< std::pair<std::string,double> >::iterator it = phases.begin();
+  while ( it != phases.end() && it->first != phase ) {
+    ++it;
+  }
+  if ( it == phases.end() ) {
+    phases.push_back( std::make_pair( phase, seconds ) );
+  } else {
+    it->second += seconds;
+  }
+}
+
+double
+ExportStats::phaseSeconds( const std::string & phase ) const
+{
+  std::vector< std::pair<std::string,double> >::const_iterator it = phases.begin();
+  while ( it != phases.end() ) {
+    if ( it->first == phase ) {
+      return it->second;
+    }
+    ++it;
+  }
+  return 0.0;
+}
+
+void
+ExportStats::flushSummary() const
+{
+  char line[256];
+  secured_sprintf( line, 256, "%s export: %.6f s, %lu bytes.\n",
+                   format.c_str(), totalSeconds, static_cast<unsigned long>( bytes ) );
+  Tools::notice << line;
+  std::vector< std::pair<std::string,double> >::const_iterator phase = phases.begin();
+  while ( phase != phases.end() ) {
+    secured_sprintf( line, 256, "  phase %-14s %10.6f s\n", phase->first.c_str(), phase->second );
+    Tools::notice << line;
+    ++phase;
+  }
+  std::map<std::string,ShapeStats>::const_iterator shape = shapes.begin();
+  while ( shape != shapes.end() ) {
+    secured_sprintf( line, 256, "  shape %-14s %10lu shapes %12lu bytes %10.6f s\n",
+                     shape->first.c_str(),
+                     static_cast<unsigned long>( shape->second.count ),
+                     static_cast<unsigned long>( shape->second.bytes ),
+                     shape->second.seconds );
+    Tools::notice << line;
+    ++shape;
+  }
+  secured_sprintf( line, 256, "  images %lu, groups %lu, clip paths %lu, culled %lu, simplified %lu, cached %lu.\n",
+                   static_cast<unsigned long>( images ),
+                   static_cast<unsigned long>( groups ),
+                   static_cast<unsigned long>( clipPaths ),
+                   static_cast<unsigned long>( culled ),
+                   static_cast<unsigned long>( simplified ),
+                   static_cast<unsigned long>( cached ) );
+  Tools::notice << line;
+}
+
+CountingStreamBuffer::int_type
+CountingStreamBuffer::overflow( int_type c )
+{
+  if ( traits_type::eq_int_type( c, traits_type::eof() ) ) {
+    return traits_type::not_eof( c );
+  }
+  ++_count;
+  return _destination->sputc( traits_type::to_char_type( c ) );
+}
+
+std::streamsize
+CountingStreamBuffer::xsputn( const char * s, std::streamsize n )
+{
+  const std::streamsize written = _destination->sputn( s, n );
+  _count += static_cast<std::size_t>( written );
+  return written;
+}
+
+int
+CountingStreamBuffer::sync()
+{
+  return _destination->pubsync();
+}
+
+void
+ShapeStatsScope::begin()
+{
+  _startBytes = _context->bytesWritten();
+  _outerBytes = _context->_nestedBytes;
+  _outerSeconds = _context->_nestedSeconds;
+  _context->_nestedBytes = 0;
+  _context->_nestedSeconds = 0.0;
+  _start = std::chrono::steady_clock::now();
+}
+
+void
+ShapeStatsScope::end()
+{
+  const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - _start ).count();
+  const std::size_t bytes = _context->bytesWritten() - _startBytes;
+  ExportStats::ShapeStats & stats = _context->_stats->shapes[ _shape.name() ];
+  ++stats.count;
+  stats.bytes += bytes - _context->_nestedBytes;
+  stats.seconds += seconds - _context->_nestedSeconds;
+  _context->_nestedBytes = _outerBytes + bytes;
+  _context->_nestedSeconds = _outerSeconds + seconds;
+}
+
+} // namespace PlaneDraw
@@ -0,0 +1,623 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   FlatShapeList.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A flat list of primitive shapes, stored by type.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/FlatShapeList.h"
+#include "board/ExportStats.h"
+#include "board/MemoryUsage.h"
+#include "board/ShapeVisitor.h"
+#include "board/Tools.h"
+#include "board/Trace.h"
+#include <algorithm>
+#include <typeinfo>
+
+namespace {
+
+bool
+entryGreaterDepth( const PlaneDraw::FlatShapeList::Entry & a, const PlaneDraw::FlatShapeList::Entry & b )
+{
+  return a.depth > b.depth;
+}
+
+// The methods below are called with a qualified name (T::method), which
+// the compiler resolves statically: no virtual call is involved.
+
+template<typename T>
+std::size_t
+store( std::vector<T> & shapes, const PlaneDraw::Shape & shape, int depth )
+{
+  shapes.push_back( static_cast<const T &>( shape ) );
+  shapes.back().T::depth( depth );
+  return shapes.size() - 1;
+}
+
+template<typename T>
+void
+unite( PlaneDraw::Rect & rect, bool & empty, const std::vector<T> & shapes, PlaneDraw::Shape::LineWidthFlag flag )
+{
+  typename std::vector<T>::const_iterator i = shapes.begin();
+  typename std::vector<T>::const_iterator end = shapes.end();
+  if ( i != end && empty ) {
+    rect = i->T::boundingBox( flag );
+    empty = false;
+    ++i;
+  }
+  while ( i != end ) {
+    rect = rect || i->T::boundingBox( flag );
+    ++i;
+  }
+}
+
+template<typename T>
+void
+rotateShapes( std::vector<T> & shapes, double angle, const PlaneDraw::Point & center )
+{
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::rotate( angle, center );
+  }
+}
+
+template<typename T>
+void
+translateShapes( std::vector<T> & shapes, double dx, double dy )
+{
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::translate( dx, dy );
+  }
+}
+
+// Scales each shape, and moves it so that its center is scaled with
+// respect to the given center (as ShapeList::scale() does).
+template<typename T>
+void
+scaleShapes( std::vector<T> & shapes, double sx, double sy, const PlaneDraw::Point & c )
+{
+  PlaneDraw::Point delta;
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    delta = i->T::center() - c;
+    delta.x *= sx;
+    delta.y *= sy;
+    i->T::scale( sx, sy );
+    delta = ( c + delta ) - i->T::center();
+    (i++)->T::translate( delta.x, delta.y );
+  }
+}
+
+template<typename T>
+void
+scaleAllShapes( std::vector<T> & shapes, double s )
+{
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::scaleAll( s );
+  }
+}
+
+template<typename T>
+void
+shiftShapesDepth( std::vector<T> & shapes, int shift )
+{
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::shiftDepth( shift );
+  }
+}
+
+// The objects are accounted one by one, and the unused capacity of the
+// array as a container.
+template<typename T>
+void
+accountShapes( PlaneDraw::MemoryUsage & usage, const std::string & type, const std::vector<T> & shapes )
+{
+  typename std::vector<T>::const_iterator i = shapes.begin();
+  typename std::vector<T>::const_iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::accountMemory( usage );
+  }
+  usage.addContainer( type, 0, shapes.capacity() - shapes.size(), sizeof( T ) );
+}
+
+template<typename T>
+void
+shrinkShapes( std::vector<T> & shapes )
+{
+  if ( shapes.capacity() > shapes.size() ) {
+    std::vector<T>( shapes ).swap( shapes );
+  }
+  typename std::vector<T>::iterator i = shapes.begin();
+  typename std::vector<T>::iterator end = shapes.end();
+  while ( i != end ) {
+    (i++)->T::shrinkToFit();
+  }
+}
+
+struct FlushPostscript {
+  FlushPostscript( std::ostream & stream, const PlaneDraw::TransformEPS & transform )
+    : stream( stream ), transform( transform ) { }
+  template<typename T> void operator()( const T & shape ) const {
+    shape.T::flushPostscript( stream, transform );
+  }
+  std::ostream & stream;
+  const PlaneDraw::TransformEPS & transform;
+};
+
+struct FlushFIG {
+  FlushFIG( std::ostream & stream, const PlaneDraw::TransformFIG & transform, std::map<PlaneDraw::Color,int> & colormap )
+    : stream( stream ), transform( transform ), colormap( colormap ) { }
+  template<typename T> void operator()( const T & shape ) const {
+    shape.T::flushFIG( stream, transform, colormap );
+  }
+  std::ostream & stream;
+  const PlaneDraw::TransformFIG & transform;
+  std::map<PlaneDraw::Color,int> & colormap;
+};
+
+struct FlushSVG {
+  FlushSVG( std::ostream & stream, const PlaneDraw::TransformSVG & transform )
+    : stream( stream ), transform( transform ) { }
+  template<typename T> void operator()( const T & shape ) const {
+    shape.T::flushSVG( stream, transform );
+  }
+  std::ostream & stream;
+  const PlaneDraw::TransformSVG & transform;
+};
+
+struct FlushTikZ {
+  FlushTikZ( std::ostream & stream, const PlaneDraw::TransformTikZ & transform )
+    : stream( stream ), transform( transform ) { }
+  template<typename T> void operator()( const T & shape ) const {
+    shape.T::flushTikZ( stream, transform );
+  }
+  std::ostream & stream;
+  const PlaneDraw::TransformTikZ & transform;
+};
+
+struct FlushDXF {
+  FlushDXF( std::ostream & stream, const PlaneDraw::TransformDXF & transform )
+    : stream( stream ), transform( transform ) { }
+  template<typename T> void operator()( const T & shape ) const {
+    shape.T::flushDXF( stream, transform );
+  }
+  std::ostream & stream;
+  const PlaneDraw::TransformDXF & transform;
+};
+
+}
+
+namespace PlaneDraw {
+
+const std::string FlatShapeList::_name("FlatListOfShapes");
+
+const std::size_t FlatShapeList::MaxShapesPerKind;
+
+const std::string &
+FlatShapeList::name() const
+{
+  return _name;
+}
+
+FlatShapeList::~FlatShapeList()
+{
+}
+
+FlatShapeList &
+FlatShapeList::clear()
+{
+  _lines.clear();
+  _dots.clear();
+  _circles.clear();
+  _rectangles.clear();
+  _polylines.clear();
+  _texts.clear();
+  _entries.clear();
+  _inOrder = true;
+  _nextDepth = std::numeric_limits<int>::max() - 1;
+  return *this;
+}
+
+void
+FlatShapeList::reserve( Kind kind, std::size_t n )
+{
+  switch ( kind ) {
+  case LineKind: _lines.reserve( _lines.size() + n ); break;
+  case DotKind: _dots.reserve( _dots.size() + n ); break;
+  case CircleKind: _circles.reserve( _circles.size() + n ); break;
+  case RectangleKind: _rectangles.reserve( _rectangles.size() + n ); break;
+  case PolylineKind: _polylines.reserve( _polylines.size() + n ); break;
+  case TextKind: _texts.reserve( _texts.size() + n ); break;
+  }
+  _entries.reserve( _entries.size() + n );
+}
+
+bool
+FlatShapeList::accepts( const Shape & shape )
+{
+  const std::type_info & type = typeid( shape );
+  return type == typeid( Line ) || type == typeid( Dot ) || type == typeid( Circle )
+      || type == typeid( Rectangle ) || type == typeid( Polyline ) || type == typeid( Text );
+}
+
+bool
+FlatShapeList::add( const Shape & shape )
+{
+  const std::type_info & type = typeid( shape );
+  Kind kind;
+  std::size_t count;
+  if ( type == typeid( Line ) ) {
+    kind = LineKind;
+    count = _lines.size();
+  } else if ( type == typeid( Dot ) ) {
+    kind = DotKind;
+    count = _dots.size();
+  } else if ( type == typeid( Circle ) ) {
+    kind = CircleKind;
+    count = _circles.size();
+  } else if ( type == typeid( Rectangle ) ) {
+    kind = RectangleKind;
+    count = _rectangles.size();
+  } else if ( type == typeid( Polyline ) ) {
+    kind = PolylineKind;
+    count = _polylines.size();
+  } else if ( type == typeid( Text ) ) {
+    kind = TextKind;
+    count = _texts.size();
+  } else {
+    return false;
+  }
+  if ( count >= MaxShapesPerKind ) {
+    return false;
+  }
+  const int depth = ( shape.depth() != -1 ) ? shape.depth() : _nextDepth;
+  switch ( kind ) {
+  case LineKind: addEntry( depth, kind, store( _lines, shape, depth ) ); break;
+  case DotKind: addEntry( depth, kind, store( _dots, shape, depth ) ); break;
+  case CircleKind: addEntry( depth, kind, store( _circles, shape, depth ) ); break;
+  case RectangleKind: addEntry( depth, kind, store( _rectangles, shape, depth ) ); break;
+  case PolylineKind: addEntry( depth, kind, store( _polylines, shape, depth ) ); break;
+  case TextKind: addEntry( depth, kind, store( _texts, shape, depth ) ); break;
+  }
+  if ( shape.depth() == -1 ) {
+    --_nextDepth;
+  }
+  return true;
+}
+
+FlatShapeList &
+FlatShapeList::operator<<( const Shape & shape )
+{
+  if ( ! add( shape ) ) {
+    if ( accepts( shape ) ) {
+      Tools::error << "FlatShapeList: cannot store more than " << MaxShapesPerKind
+                   << " shapes of type " << shape.name() << ".\n";
+    } else {
+      Tools::error << "FlatShapeList: cannot store a shape of type " << shape.name() << ".\n";
+    }
+  }
+  return *this;
+}
+
+void
+FlatShapeList::addEntry( int depth, Kind kind, std::size_t index )
+{
+  if ( ! _entries.empty() && depth > _entries.back().depth ) {
+    _inOrder = false;
+  }
+  Entry entry;
+  entry.depth = depth;
+  entry.kind = kind;
+  entry.index = static_cast<unsigned int>( index );
+  _entries.push_back( entry );
+}
+
+Shape &
+FlatShapeList::shape( const Entry & entry )
+{
+  return const_cast<Shape &>( static_cast<const FlatShapeList *>( this )->shape( entry ) );
+}
+
+const Shape &
+FlatShapeList::shape( const Entry & entry ) const
+{
+  switch ( entry.kind ) {
+  case LineKind: return _lines[ entry.index ];
+  case DotKind: return _dots[ entry.index ];
+  case CircleKind: return _circles[ entry.index ];
+  case RectangleKind: return _rectangles[ entry.index ];
+  case PolylineKind: return _polylines[ entry.index ];
+  default: return _texts[ entry.index ];
+  }
+}
+
+template<typename Flush>
+void
+FlatShapeList::flushEntries( const Flush & flush, ExportContext & context ) const
+{
+  // Shapes added with no explicit depth are already in drawing order.
+  std::vector<Entry> sorted;
+  if ( ! _inOrder ) {
+    sorted = _entries;
+    std::stable_sort( sorted.begin(), sorted.end(), entryGreaterDepth );
+  }
+  const std::vector<Entry> & entries = _inOrder ? _entries : sorted;
+  std::vector<Entry>::const_iterator i = entries.begin();
+  std::vector<Entry>::const_iterator end = entries.end();
+  while ( i != end ) {
+    ShapeStatsScope scope( context, shape( *i ) );
+    switch ( i->kind ) {
+    case LineKind: flush( _lines[ i->index ] ); break;
+    case DotKind: flush( _dots[ i->index ] ); break;
+    case CircleKind: flush( _circles[ i->index ] ); break;
+    case RectangleKind: flush( _rectangles[ i->index ] ); break;
+    case PolylineKind: flush( _polylines[ i->index ] ); break;
+    case TextKind: flush( _texts[ i->index ] ); break;
+    }
+    ++i;
+  }
+}
+
+FlatShapeList &
+FlatShapeList::rotate( double angle, const Point & center )
+{
+  rotateShapes( _lines, angle, center );
+  rotateShapes( _dots, angle, center );
+  rotateShapes( _circles, angle, center );
+  rotateShapes( _rectangles, angle, center );
+  rotateShapes( _polylines, angle, center );
+  rotateShapes( _texts, angle, center );
+  return *this;
+}
+
+FlatShapeList &
+FlatShapeList::rotate( double angle )
+{
+  return FlatShapeList::rotate( angle, center() );
+}
+
+FlatShapeList &
+FlatShapeList::translate( double dx, double dy )
+{
+  translateShapes( _lines, dx, dy );
+  translateShapes( _dots, dx, dy );
+  translateShapes( _circles, dx, dy );
+  translateShapes( _rectangles, dx, dy );
+  translateShapes( _polylines, dx, dy );
+  translateShapes( _texts, dx, dy );
+  return *this;
+}
+
+FlatShapeList &
+FlatShapeList::scale( double sx, double sy )
+{
+  const Point c = center();
+  scaleShapes( _lines, sx, sy, c );
+  scaleShapes( _dots, sx, sy, c );
+  scaleShapes( _circles, sx, sy, c );
+  scaleShapes( _rectangles, sx, sy, c );
+  scaleShapes( _polylines, sx, sy, c );
+  scaleShapes( _texts, sx, sy, c );
+  return *this;
+}
+
+FlatShapeList &
+FlatShapeList::scale( double s )
+{
+  return FlatShapeList::scale( s, s );
+}
+
+void
+FlatShapeList::scaleAll( double s )
+{
+  scaleAllShapes( _lines, s );
+  scaleAllShapes( _dots, s );
+  scaleAllShapes( _circles, s );
+  scaleAllShapes( _rectangles, s );
+  scaleAllShapes( _polylines, s );
+  scaleAllShapes( _texts, s );
+}
+
+void
+FlatShapeList::flushPostscript( std::ostream & stream,
+                                const TransformEPS & transform ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "FlatShapeList::flushPostscript", _entries.size() );
+  stream << "%%% Begin FlatShapeList\n";
+  flushEntries( FlushPostscript( stream, transform ), transform.context() );
+  stream << "%%% End FlatShapeList\n";
+}
+
+void
+FlatShapeList::flushFIG( std::ostream & stream,
+                         const TransformFIG & transform,
+                         std::map<Color,int> & colormap ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "FlatShapeList::flushFIG", _entries.size() );
+  // The list is drawn as a whole, at its own depth, as in the other formats.
+  const TransformFIG atDepth = transform.atDepth( _depth );
+  flushEntries( FlushFIG( stream, atDepth, colormap ), transform.context() );
+}
+
+void
+FlatShapeList::flushSVG( std::ostream & stream,
+                         const TransformSVG & transform ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "FlatShapeList::flushSVG", _entries.size() );
+  flushEntries( FlushSVG( stream, transform ), transform.context() );
+}
+
+void
+FlatShapeList::flushTikZ( std::ostream & stream,
+                          const TransformTikZ & transform ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "FlatShapeList::flushTikZ", _entries.size() );
+  stream << "\\begin{scope}\n";
+  flushEntries( FlushTikZ( stream, transform ), transform.context() );
+  stream << "\\end{scope}\n";
+}
+
+void
+FlatShapeList::flushDXF( std::ostream & stream,
+                         const TransformDXF & transform ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "FlatShapeList::flushDXF", _entries.size() );
+  flushEntries( FlushDXF( stream, transform ), transform.context() );
+}
+
+Rect
+FlatShapeList::boundingBox( LineWidthFlag flag ) const
+{
+  // The order does not matter here: the arrays are scanned one by one.
+  Rect r;
+  bool empty = true;
+  unite( r, empty, _lines, flag );
+  unite( r, empty, _dots, flag );
+  unite( r, empty, _circles, flag );
+  unite( r, empty, _rectangles, flag );
+  unite( r, empty, _polylines, flag );
+  unite( r, empty, _texts, flag );
+  return r;
+}
+
+int
+FlatShapeList::minDepth() const
+{
+  int res = std::numeric_limits<int>::max();
+  std::vector<Entry>::const_iterator i = _entries.begin();
+  std::vector<Entry>::const_iterator end = _entries.end();
+  while ( i != end ) {
+    if ( i->depth < res ) res = i->depth;
+    ++i;
+  }
+  return res;
+}
+
+int
+FlatShapeList::maxDepth() const
+{
+  int res = std::numeric_limits<int>::min();
+  std::vector<Entry>::const_iterator i = _entries.begin();
+  std::vector<Entry>::const_iterator end = _entries.end();
+  while ( i != end ) {
+    if ( i->depth > res ) res = i->depth;
+    ++i;
+  }
+  return res;
+}
+
+void
+FlatShapeList::shiftDepth( int shift )
+{
+  shiftShapesDepth( _lines, shift );
+  shiftShapesDepth( _dots, shift );
+  shiftShapesDepth( _circles, shift );
+  shiftShapesDepth( _rectangles, shift );
+  shiftShapesDepth( _polylines, shift );
+  shiftShapesDepth( _texts, shift );
+  std::vector<Entry>::iterator i = _entries.begin();
+  std::vector<Entry>::iterator end = _entries.end();
+  while ( i != end ) {
+    (i++)->depth += shift;
+  }
+}
+
+FlatShapeList *
+FlatShapeList::clone() const
+{
+  return new FlatShapeList( *this );
+}
+
+void
+FlatShapeList::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( FlatShapeList ) );
+  usage.addContainer( name(), _entries.size(), _entries.capacity(), sizeof( Entry ) );
+  accountShapes( usage, name(), _lines );
+  accountShapes( usage, name(), _dots );
+  accountShapes( usage, name(), _circles );
+  accountShapes( usage, name(), _rectangles );
+  accountShapes( usage, name(), _polylines );
+  accountShapes( usage, name(), _texts );
+}
+
+void
+FlatShapeList::shrinkToFit()
+{
+  shrinkShapes( _lines );
+  shrinkShapes( _dots );
+  shrinkShapes( _circles );
+  shrinkShapes( _rectangles );
+  shrinkShapes( _polylines );
+  shrinkShapes( _texts );
+  if ( _entries.capacity() > _entries.size() ) {
+    std::vector<Entry>( _entries ).swap( _entries );
+  }
+}
+
+void
+FlatShapeList::accept( ShapeVisitor & visitor )
+{
+  std::vector<Entry>::const_iterator i = _entries.begin();
+  std::vector<Entry>::const_iterator end = _entries.end();
+  while ( i != end ) {
+    shape( *i++ ).accept( visitor );
+  }
+}
+
+void
+FlatShapeList::accept( const ShapeVisitor & visitor )
+{
+  std::vector<Entry>::const_iterator i = _entries.begin();
+  std::vector<Entry>::const_iterator end = _entries.end();
+  while ( i != end ) {
+    shape( *i++ ).accept( visitor );
+  }
+}
+
+void
+FlatShapeList::accept( TypedShapeVisitor & visitor ) const
+{
+  std::vector<Entry>::const_iterator i = _entries.begin();
+  std::vector<Entry>::const_iterator end = _entries.end();
+  while ( i != end ) {
+    switch ( i->kind ) {
+    case LineKind: visitor.visit( _lines[ i->index ] ); break;
+    case DotKind: visitor.visit( _dots[ i->index ] ); break;
+    case CircleKind: visitor.visit( _circles[ i->index ] ); break;
+    case RectangleKind: visitor.visit( _rectangles[ i->index ] ); break;
+    case PolylineKind: visitor.visit( _polylines[ i->index ] ); break;
+    case TextKind: visitor.visit( _texts[ i->index ] ); break;
+    }
+    ++i;
+  }
+}
+
+} // namespace PlaneDraw
@@ -0,0 +1,208 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   FragmentCache.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A cache of the exported code of the shapes of a board.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/FragmentCache.h"
+#include "board/Shapes.h"
+#include "board/Transforms.h"
+#include "board/ExportStats.h"
+#include <typeinfo>
+
+namespace PlaneDraw {
+
+FragmentCache::Entry::Entry()
+  : visit( 0 )
+{
+  for ( int format = 0; format < 4; ++format ) {
+    revision[format] = 0;
+    epoch[format] = 0;
+  }
+}
+
+FragmentCache::FragmentCache()
+  : _visit( 0 ), _bytes( 0 ), _hits( 0 ), _misses( 0 )
+{
+  for ( int format = 0; format < 4; ++format ) {
+    _epochs[format] = 0;
+  }
+}
+
+bool
+FragmentCache::cacheable( const Shape & shape )
+{
+  const std::type_info & type = typeid( shape );
+  // The code of a hatched shape refers to a pattern defined by the export.
+  if ( type == typeid( Polyline ) || type == typeid( Rectangle ) || type == typeid( Triangle ) ) {
+    return ! static_cast<const Polyline&>( shape ).hatch().valid();
+  }
+  if ( type == typeid( Circle ) || type == typeid( Ellipse ) ) {
+    return ! static_cast<const Ellipse&>( shape ).hatch().valid();
+  }
+  return type == typeid( Line ) || type == typeid( Text )
+      || type == typeid( Dot ) || type == typeid( Arrow )
+      || type == typeid( GouraudTriangle );
+}
+
+std::size_t
+FragmentCache::size() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _entries.size();
+}
+
+std::size_t
+FragmentCache::memoryUsage() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _bytes;
+}
+
+std::size_t
+FragmentCache::hits() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _hits;
+}
+
+std::size_t
+FragmentCache::misses() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _misses;
+}
+
+void
+FragmentCache::clear()
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  _entries.clear();
+  _bytes = 0;
+}
+
+//
+// FragmentCache::Session
+//
+
+FragmentCache::Session::Session( FragmentCache * cache, Format format, const Transform & transform,
+                                 std::ostream & out, std::map<Color,int> * colormap )
+  : _cache( cache ), _format( format ), _transform( transform ), _out( out ), _colormap( colormap )
+{
+  if ( ! _cache ) {
+    return;
+  }
+  _lock = std::unique_lock<std::mutex>( _cache->_mutex, std::try_to_lock );
+  if ( ! _lock.owns_lock() ) {
+    _cache = 0;
+    return;
+  }
+  _buffer.copyfmt( out );
+  std::string fingerprint = transform.fingerprint();
+  const std::streamsize precision = out.precision();
+  const std::ios_base::fmtflags flags = out.flags();
+  fingerprint.append( reinterpret_cast<const char*>( &precision ), sizeof( precision ) );
+  fingerprint.append( reinterpret_cast<const char*>( &flags ), sizeof( flags ) );
+  if ( colormap ) {
+    std::map<Color,int>::const_iterator it = colormap->begin();
+    while ( it != colormap->end() ) {
+      const int entry[5] = { it->first.red(), it->first.green(), it->first.blue(), it->first.alpha(), it->second };
+      fingerprint.append( reinterpret_cast<const char*>( entry ), sizeof( entry ) );
+      ++it;
+    }
+  }
+  if ( fingerprint != _cache->_fingerprints[format] ) {
+    _cache->_fingerprints[format] = fingerprint;
+    ++_cache->_epochs[format];
+  }
+  ++_cache->_visit;
+}
+
+FragmentCache::Session::~Session()
+{
+  if ( ! _cache ) {
+    return;
+  }
+  std::unordered_map<const Shape*,Entry>::iterator it = _cache->_entries.begin();
+  while ( it != _cache->_entries.end() ) {
+    if ( it->second.visit != _cache->_visit ) {
+      for ( int format = 0; format < 4; ++format ) {
+        _cache->_bytes -= it->second.code[format].size();
+      }
+      it = _cache->_entries.erase( it );
+    } else {
+      ++it;
+    }
+  }
+}
+
+void
+FragmentCache::Session::flush( const Shape & shape )
+{
+  if ( ! _cache || ! cacheable( shape ) ) {
+    write( shape, _out );
+    return;
+  }
+  Entry & entry = _cache->_entries[ &shape ];
+  entry.visit = _cache->_visit;
+  std::string & code = entry.code[_format];
+  if ( entry.revision[_format] == shape.revision()
+       && entry.epoch[_format] == _cache->_epochs[_format] ) {
+    _out.write( code.data(), static_cast<std::streamsize>( code.size() ) );
+    ++_cache->_hits;
+    if ( ExportStats * stats = _transform.context().stats() ) {
+      ++stats->cached;
+    }
+    return;
+  }
+  _buffer.str( std::string() );
+  write( shape, _buffer );
+  _cache->_bytes -= code.size();
+  code = _buffer.str();
+  _cache->_bytes += code.size();
+  entry.revision[_format] = shape.revision();
+  entry.epoch[_format] = _cache->_epochs[_format];
+  ++_cache->_misses;
+  _out.write( code.data(), static_cast<std::streamsize>( code.size() ) );
+}
+
+void
+FragmentCache::Session::write( const Shape & shape, std::ostream & out )
+{
+  switch ( _format ) {
+  case EPS:
+    shape.flushPostscript( out, static_cast<const TransformEPS &>( _transform ) );
+    break;
+  case FIG:
+    shape.flushFIG( out, static_cast<const TransformFIG &>( _transform ), *_colormap );
+    break;
+  case SVG:
+    shape.flushSVG( out, static_cast<const TransformSVG &>( _transform ) );
+    break;
+  case TikZ:
+    shape.flushTikZ( out, static_cast<const TransformTikZ &>( _transform ) );
+    break;
+  }
+}
+
+} // namespace PlaneDraw
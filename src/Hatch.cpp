@@ -0,0 +1,176 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Hatch.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Hatch patterns used to fill closed shapes.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/Hatch.h"
+#include "board/Rect.h"
+#include "board/Transforms.h"
+#include <cmath>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// The angle in degrees, in [0,period).
+double
+normalizedDegrees( double angle, double period )
+{
+  double degrees = std::fmod( angle * 180.0 / M_PI, period );
+  if ( degrees < 0.0 ) degrees += period;
+  return degrees;
+}
+
+// The XFig area fill among candidates (angle, fill) nearest to an angle.
+int
+nearestFill( double degrees, double period, const double (*candidates)[2], int count )
+{
+  int best = 0;
+  double bestDistance = period;
+  for ( int i = 0; i < count; ++i ) {
+    double distance = std::fabs( degrees - candidates[i][0] );
+    distance = std::min( distance, period - distance );
+    if ( distance < bestDistance ) {
+      bestDistance = distance;
+      best = static_cast<int>( candidates[i][1] );
+    }
+  }
+  return best;
+}
+
+}
+
+namespace PlaneDraw {
+
+const Hatch Hatch::None;
+
+void
+Hatch::scale( double sx, double sy )
+{
+  const double x = sx * std::cos( angle );
+  const double y = sy * std::sin( angle );
+  const double norm = std::sqrt( x * x + y * y );
+  if ( norm == 0.0 ) {
+    return;
+  }
+  spacing *= std::fabs( sx * sy ) / norm;
+  angle = std::atan2( y, x );
+}
+
+std::string
+Hatch::flushPostscriptDefinition( std::ostream & stream, const TransformEPS & transform ) const
+{
+  const double step = transform.scale( spacing );
+  std::ostringstream definition;
+  definition.copyfmt( stream );
+  definition << "<< /PatternType 1 /PaintType 1 /TilingType 1"
+             << " /BBox [0 0 " << step << " " << step << "]"
+             << " /XStep " << step << " /YStep " << step << "\n"
+             << "   /PaintProc { pop " << color.postscript() << " srgb "
+             << transform.mapWidth( lineWidth ) << " slw 0 slc"
+             << " n 0 " << step / 2 << " m " << step << " " << step / 2 << " l stroke";
+  if ( cross ) {
+    definition << " n " << step / 2 << " 0 m " << step / 2 << " " << step << " l stroke";
+  }
+  definition << " } >>\n"
+             << "   [" << std::cos( angle ) << " " << std::sin( angle ) << " "
+             << -std::sin( angle ) << " " << std::cos( angle ) << " 0 0] makepattern";
+  std::size_t id;
+  if ( transform.context().definePattern( definition.str(), id ) ) {
+    stream << "/BoardHatch" << id << " " << definition.str() << " def\n";
+  }
+  std::ostringstream name;
+  name << "BoardHatch" << id;
+  return name.str();
+}
+
+std::string
+Hatch::flushSVGDefinition( std::ostream & stream, const TransformSVG & transform,
+                           const Color & background ) const
+{
+  const double step = transform.scale( spacing );
+  std::ostringstream definition;
+  definition.copyfmt( stream );
+  definition << " patternUnits=\"userSpaceOnUse\" width=\"" << step << "\" height=\"" << step << "\"";
+  if ( angle != 0.0 ) {
+    definition << " patternTransform=\"rotate(" << -( angle * 180 / M_PI ) << ")\"";
+  }
+  definition << ">\n";
+  if ( background.valid() ) {
+    definition << "  <rect width=\"" << step << "\" height=\"" << step << "\""
+               << " fill=\"" << background.svg() << "\"" << background.svgAlpha( " fill" ) << " />\n";
+  }
+  definition << "  <line x1=\"0\" y1=\"" << step / 2 << "\" x2=\"" << step << "\" y2=\"" << step / 2 << "\""
+             << " stroke=\"" << color.svg() << "\"" << color.svgAlpha( " stroke" )
+             << " stroke-width=\"" << transform.mapWidth( lineWidth ) << "mm\" />\n";
+  if ( cross ) {
+    definition << "  <line x1=\"" << step / 2 << "\" y1=\"0\" x2=\"" << step / 2 << "\" y2=\"" << step << "\""
+               << " stroke=\"" << color.svg() << "\"" << color.svgAlpha( " stroke" )
+               << " stroke-width=\"" << transform.mapWidth( lineWidth ) << "mm\" />\n";
+  }
+  std::size_t id;
+  if ( transform.context().definePattern( definition.str(), id ) ) {
+    stream << "<defs>\n"
+           << " <pattern id=\"Hatch" << id << "\"" << definition.str()
+           << " </pattern>\n"
+           << "</defs>\n";
+  }
+  std::ostringstream fill;
+  fill << "url(#Hatch" << id << ")";
+  return fill.str();
+}
+
+std::string
+Hatch::tikz( const TransformTikZ & transform, const Color & background ) const
+{
+  std::ostringstream str;
+  if ( background.valid() ) {
+    str << ",preaction={fill=" << background.tikz() << "}";
+  }
+  str << ",pattern={" << ( cross ? "Hatch" : "Lines" )
+      << "[angle=" << angle * 180 / M_PI
+      << ",distance=" << transform.scale( spacing ) << "pt"
+      << ",line width=" << transform.mapWidth( lineWidth ) << "mm]}"
+      << ",pattern color=" << color.tikz();
+  return str.str();
+}
+
+int
+Hatch::figAreaFill() const
+{
+  // 41/42: 30 degrees left/right diagonal, 43: 30 degrees crosshatch,
+  // 44/45: 45 degrees left/right diagonal, 46: 45 degrees crosshatch,
+  // 49/50: horizontal/vertical lines, 51: crosshatch.
+  static const double lines[][2] = { { 0, 49 }, { 30, 42 }, { 45, 45 }, { 90, 50 }, { 135, 44 }, { 150, 41 } };
+  static const double crosses[][2] = { { 0, 51 }, { 30, 43 }, { 45, 46 }, { 60, 43 } };
+  if ( cross ) {
+    return nearestFill( normalizedDegrees( angle, 90.0 ), 90.0, crosses, 4 );
+  }
+  return nearestFill( normalizedDegrees( angle, 180.0 ), 180.0, lines, 6 );
+}
+
+} // namespace PlaneDraw
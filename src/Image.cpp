@@ -25,6 +25,13 @@
  */
 #include "BoardConfig.h"
 #include "board/Image.h"
+#include "board/ImageCache.h"
+#include "board/ImageCodecs.h"
+#include "board/ExportStats.h"
+#include "board/DXF.h"
+#include "board/Trace.h"
+#include "board/MemoryUsage.h"
+#include "board/ShapeVisitor.h"
 #include <sstream>
 #include <fstream>
 #include <cstring>
@@ -36,6 +43,25 @@
 #include <Magick++.h>
 #endif
 
+namespace {
+
+void
+flushSVGDataURI( std::ostream & stream, const std::string & filename )
+{
+  BOARD_TRACE_SCOPE( "Image::encodeBase64" );
+  if ( PlaneDraw::Tools::stringEndsWith(filename.c_str(),".png",PlaneDraw::Tools::CaseInsensitive) )
+    stream << "data:image/png;base64,";
+  else if ( PlaneDraw::Tools::stringEndsWith(filename.c_str(),".jpg",PlaneDraw::Tools::CaseInsensitive)
+            || PlaneDraw::Tools::stringEndsWith(filename.c_str(),".jpeg",PlaneDraw::Tools::CaseInsensitive) )
+    stream << "data:image/jpeg;base64,";
+  else {
+    PlaneDraw::Tools::error << "Only png and jpeg image files may be included. SVG file will be corrupted.\n";
+  }
+  PlaneDraw::ImageCache::flushBase64(filename,stream);
+}
+
+}
+
 namespace PlaneDraw {
 
 const std::string PlaneDraw::Image::_name("Image");
@@ -48,19 +74,26 @@ Image::Image(const char * filename,
     _filename( filename )
 {
   if ( height == 0.0 ) {
-#if ( _BOARD_HAVE_MAGICKPLUSPLUS_ == 1)
-    try {
-      Magick::Image image;
-      image.read(_filename);
-      height = width * (image.rows() / (double) image.columns());
+    std::size_t columns = 0;
+    std::size_t rows = 0;
+    if ( ImageCache::imageSize(_filename,columns,rows) ) {
+      height = width * (rows / (double) columns);
       _rectangle = _originalRectangle = Rectangle(left, top, width, height, Color::Black, Color::Null, 0.0, SolidStyle, ButtCap, MiterJoin, depth);
-    } catch (std::exception & e) {
-      Tools::error << "Image::Image(): ";
-      std::cerr << e.what() << std::endl;
-    }
+    } else {
+#if ( _BOARD_HAVE_MAGICKPLUSPLUS_ == 1)
+      try {
+        Magick::Image image;
+        image.ping(_filename);
+        height = width * (image.rows() / (double) image.columns());
+        _rectangle = _originalRectangle = Rectangle(left, top, width, height, Color::Black, Color::Null, 0.0, SolidStyle, ButtCap, MiterJoin, depth);
+      } catch (std::exception & e) {
+        Tools::error << "Image::Image(): ";
+        std::cerr << e.what() << std::endl;
+      }
 #else
-    Tools::error << "Image::Image(): ImageMagick is required to retrieve the aspect ratio of bitmap images.\n";
+      Tools::error << "Image::Image(): cannot read the size of image " << _filename << " (ImageMagick is required for this format).\n";
 #endif
+    }
   }
 }
 
@@ -85,6 +118,35 @@ Image::clone() const
   return new Image(*this);
 }
 
+void
+Image::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Image::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Image ) );
+  usage.addString( name(), _filename );
+  usage.addPath( name(), _rectangle.path() );
+  usage.addPath( name(), _originalRectangle.path() );
+}
+
+void
+Image::shrinkToFit()
+{
+  _filename.shrink_to_fit();
+  _rectangle.shrinkToFit();
+  _originalRectangle.shrinkToFit();
+}
+
+const std::string &
+Image::filename() const
+{
+  return _filename;
+}
+
 Shape &
 Image::rotate(double angle, const Point &center)
 {
@@ -176,38 +238,59 @@ Image::scaleAll(double s)
 void
 Image::flushPostscript(std::ostream & stream, const TransformEPS & transform) const
 {
+  // The fragment paints the bitmap in the rectangle "rect" of its own user space.
+  Rect rect;
+  std::ostringstream fragment;
+  const int definition = transform.context().imageDefinition(_filename);
+  if ( definition >= 0 ) {
+    rect = Rect(0.0,1.0,1.0,1.0);
+    fragment << "BoardImage" << definition << "\n";
+  } else if ( ! ImageCache::flush(_filename,ImageCache::EPSFragment,fragment,&rect) ) {
+    BOARD_TRACE_SCOPE( "Image::encodePostscript" );
+    if ( Tools::flushPostscriptImage(_filename.c_str(),fragment) ) {
+      rect = Rect(0.0,1.0,1.0,1.0);
+    } else {
 #if ( _BOARD_HAVE_MAGICKPLUSPLUS_ == 1 )
-  Magick::Image image;
-  image.read(_filename);
-  const char * tmpFilename = Tools::temporaryFilename(".eps");
-  image.write(tmpFilename);
-  Rect rect = Tools::getEPSBoundingBox(tmpFilename);
-
+      fragment.str("");
+      Magick::Image image;
+      image.read(_filename);
+      const char * tmpFilename = Tools::temporaryFilename(".eps");
+      image.write(tmpFilename);
+      rect = Tools::getEPSBoundingBox(tmpFilename);
+      fragment << "%%BeginDocument: board_temporary.eps\n";
+      Tools::flushFile(tmpFilename,fragment);
+      fragment << "%%EndDocument\n";
+      std::remove(tmpFilename);
+#else
+      Tools::error << "Image::flushPostscript(): only PNG and JPEG files are supported without ImageMagick's Magick++ lib. Aborted.\n";
+      return;
+#endif
+    }
+    ImageCache::store(_filename,ImageCache::EPSFragment,fragment.str(),rect);
+  }
 
   double scaleX = transform.scale(_originalRectangle.width()) / rect.width;
   double scaleY = transform.scale(_originalRectangle.height()) / rect.height;
 
-  TransformMatrix originalMoveAndScale = TransformMatrix::scaling(scaleX,scaleY) + _originalRectangle.bottomLeft();
+  TransformMatrix originalMoveAndScale = TransformMatrix::scaling(scaleX,scaleY)
+      * TransformMatrix::translation(-rect.left,-rect.bottom())
+      + _originalRectangle.bottomLeft();
 
   stream << "%\n";
   stream << "% Bitmap Image\n";
   stream << "%\n";
-  stream <<  "%%BeginDocument: board_temporary.eps\n";
   stream << "gs\n";
 
   Point shift = transform.map(_rectangle.bottomLeft()) - (_transformMatrixEPS*_originalRectangle.bottomLeft());
   ((_transformMatrixEPS+shift)*originalMoveAndScale).flushEPS(stream);
 
   stream << "\n";
-  Tools::flushFile(tmpFilename,stream);
-  std::remove(tmpFilename);
-  stream <<  "%%EndDocument\n";
+  const std::string & payload = fragment.str();
+  stream.write(payload.data(),payload.size());
   stream << "gr\n";
-#else
-  (void) stream;
-  (void) transform;
-  Tools::error << "Image::flushPostscript(): requires ImageMagick's Magick++ lib. Aborted.\n";
-#endif
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->images;
+  }
 }
 
 void
@@ -231,29 +314,52 @@ Image::flushFIG(std::ostream & stream, const TransformFIG & transform, std::map<
 void
 Image::flushSVG(std::ostream & stream, const TransformSVG & transform) const
 {
-  static unsigned int imageId = 0;
+  const double width = transform.scale(_originalRectangle[1].x - _originalRectangle[0].x);
+  const double height = transform.scale(_originalRectangle[0].y - _originalRectangle[3].y);
+  Point shift = transform.map(_rectangle.topLeft()) - (_transformMatrixSVG*_originalRectangle.topLeft());
+  const int definition = transform.context().imageDefinition(_filename);
+  if ( definition >= 0 ) {
+    stream << "<use xlink:href=\"#image" << definition << "\" ";
+    TransformMatrix placement = (_transformMatrixSVG+shift)
+        * TransformMatrix::translation(_originalRectangle[0].x,_originalRectangle[0].y)
+        * TransformMatrix::scaling(width,height);
+    placement.flushSVG(stream);
+    stream << " />\n";
+    return;
+  }
+
   stream << "<image x=\"" << _originalRectangle[0].x << "\"";
   stream << " y=\"" << _originalRectangle[0].y << "\" ";
-  stream << " width=\"" << transform.scale(_originalRectangle[1].x - _originalRectangle[0].x) << "\"";
-  stream << " height=\"" << transform.scale(_originalRectangle[0].y - _originalRectangle[3].y) << "\"";
+  stream << " width=\"" << width << "\"";
+  stream << " height=\"" << height << "\"";
   stream << " preserveAspectRatio=\"none\"";
-  stream << " id=\"image" << imageId++ << "\"";
-  if ( Tools::stringEndsWith(_filename.c_str(),".png",Tools::CaseInsensitive) )
-    stream << "\n     xlink:href=\"data:image/png;base64,";
-  else if ( Tools::stringEndsWith(_filename.c_str(),".jpg",Tools::CaseInsensitive) || Tools::stringEndsWith(_filename.c_str(),".jpeg",Tools::CaseInsensitive) )
-    stream << "\n     xlink:href=\"data:image/jpeg;base64,";
-  else {
-    Tools::error << "Only png and jpeg image files may be included. SVG file will be corrupted.\n";
+  stream << " id=\"image" << transform.context().nextImageId() << "\"";
+  stream << "\n     xlink:href=\"";
+  flushSVGDataURI(stream,_filename);
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->images;
   }
-  std::ifstream in;
-  in.open(_filename.c_str());
-  Tools::base64encode(in,stream);
   stream << "\"\n  ";
-  Point shift = transform.map(_rectangle.topLeft()) - (_transformMatrixSVG*_originalRectangle.topLeft());
   (_transformMatrixSVG+shift).flushSVG(stream);
   stream << " />\n";
 }
 
+bool
+Image::flushPostscriptDefinition(std::ostream & stream, const std::string & filename, unsigned int id)
+{
+  return Tools::flushPostscriptImageDefinition(filename.c_str(),stream,id);
+}
+
+void
+Image::flushSVGDefinition(std::ostream & stream, const std::string & filename, unsigned int id)
+{
+  stream << "<image x=\"0\" y=\"0\" width=\"1\" height=\"1\" preserveAspectRatio=\"none\"";
+  stream << " id=\"image" << id << "\"";
+  stream << "\n     xlink:href=\"";
+  flushSVGDataURI(stream,filename);
+  stream << "\" />\n";
+}
+
 void
 Image::flushTikZ(std::ostream & stream, const TransformTikZ & transform) const
 {
@@ -261,4 +367,13 @@ Image::flushTikZ(std::ostream & stream, const TransformTikZ & transform) const
   Tools::error << "Image::flushTikZ(): not available.\n";
 }
 
+void
+Image::flushDXF(std::ostream & stream, const TransformDXF & transform) const
+{
+  _rectangle.flushDXF( stream, transform );
+  if ( transform.tables().pass() == DXFTables::Write ) {
+    Tools::error << "Image::flushDXF(): not available.\n";
+  }
+}
+
 } // namespace PlaneDraw
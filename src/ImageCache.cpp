@@ -0,0 +1,295 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ImageCache.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A process-wide cache of encoded bitmap image payloads.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/ImageCache.h"
+#include "board/Tools.h"
+#include "board/ImageCodecs.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct CacheKey {
+  PlaneDraw::ImageCache::Encoding encoding;
+  std::string filename;
+  time_t mtime;
+  long long size;
+  // The versions of a file (for an encoding) are contiguous in the index.
+  bool operator<( const CacheKey & other ) const {
+    if ( encoding != other.encoding ) return encoding < other.encoding;
+    const int c = filename.compare( other.filename );
+    if ( c ) return c < 0;
+    if ( mtime != other.mtime ) return mtime < other.mtime;
+    return size < other.size;
+  }
+};
+
+struct CacheEntry {
+  CacheKey key;
+  std::shared_ptr<const std::string> payload;
+  PlaneDraw::Rect boundingBox;
+};
+
+struct ImageSize {
+  time_t mtime;
+  long long size;
+  std::size_t width;
+  std::size_t height;
+};
+
+typedef std::list<CacheEntry> EntryList;
+typedef std::map<CacheKey,EntryList::iterator> EntryMap;
+
+std::mutex cacheMutex;
+EntryList cacheEntries;  // Most recently used first.
+EntryMap cacheIndex;
+std::size_t cacheBudget = 64 * 1024 * 1024;
+std::size_t cacheUsage = 0;
+std::size_t cacheHits = 0;
+std::size_t cacheMisses = 0;
+
+// Probed dimensions are tiny, they are only bounded by a number of entries.
+const std::size_t MaxImageSizes = 65536;
+std::map<std::string,ImageSize> imageSizes;
+
+bool
+makeKey( const std::string & filename,
+         PlaneDraw::ImageCache::Encoding encoding,
+         CacheKey & key )
+{
+  struct stat st;
+  if ( stat( filename.c_str(), &st ) != 0 ) {
+    return false;
+  }
+  key.encoding = encoding;
+  key.filename = filename;
+  key.mtime = st.st_mtime;
+  key.size = static_cast<long long>( st.st_size );
+  return true;
+}
+
+// Must be called with cacheMutex locked.
+void
+eraseEntry( EntryList::iterator it )
+{
+  cacheUsage -= it->payload->size();
+  cacheIndex.erase( it->key );
+  cacheEntries.erase( it );
+}
+
+// Must be called with cacheMutex locked.
+void
+evict( std::size_t budget )
+{
+  while ( cacheUsage > budget && ! cacheEntries.empty() ) {
+    EntryList::iterator last = cacheEntries.end();
+    eraseEntry( --last );
+  }
+}
+
+}
+
+namespace PlaneDraw {
+
+bool
+ImageCache::flush( const std::string & filename,
+                   Encoding encoding,
+                   std::ostream & out,
+                   Rect * boundingBox )
+{
+  CacheKey key;
+  if ( ! makeKey( filename, encoding, key ) ) {
+    return false;
+  }
+  std::shared_ptr<const std::string> payload;
+  {
+    std::lock_guard<std::mutex> lock( cacheMutex );
+    EntryMap::iterator it = cacheIndex.find( key );
+    if ( it == cacheIndex.end() ) {
+      ++cacheMisses;
+      return false;
+    }
+    ++cacheHits;
+    cacheEntries.splice( cacheEntries.begin(), cacheEntries, it->second );
+    payload = it->second->payload;
+    if ( boundingBox ) {
+      *boundingBox = it->second->boundingBox;
+    }
+  }
+  out.write( payload->data(), payload->size() );
+  return true;
+}
+
+void
+ImageCache::store( const std::string & filename,
+                   Encoding encoding,
+                   const std::string & payload,
+                   const Rect & boundingBox )
+{
+  CacheKey key;
+  if ( ! makeKey( filename, encoding, key ) ) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  if ( payload.size() > cacheBudget ) {
+    return;
+  }
+
+  // Drop entries of previous versions of the same file.
+  CacheKey first = key;
+  first.mtime = std::numeric_limits<time_t>::min();
+  first.size = std::numeric_limits<long long>::min();
+  EntryMap::iterator it = cacheIndex.lower_bound( first );
+  while ( it != cacheIndex.end()
+          && it->first.encoding == encoding && it->first.filename == filename ) {
+    eraseEntry( (it++)->second );
+  }
+
+  evict( cacheBudget - payload.size() );
+  CacheEntry entry;
+  entry.key = key;
+  entry.payload = std::make_shared<const std::string>( payload );
+  entry.boundingBox = boundingBox;
+  cacheEntries.push_front( entry );
+  cacheIndex[ key ] = cacheEntries.begin();
+  cacheUsage += payload.size();
+}
+
+bool
+ImageCache::flushBase64( const std::string & filename, std::ostream & out )
+{
+  if ( flush( filename, Base64, out ) ) {
+    return true;
+  }
+  std::ifstream in( filename.c_str(), std::ios::in | std::ios::binary );
+  if ( ! in ) {
+    Tools::error << "ImageCache::flushBase64(): cannot read file " << filename << "\n";
+    return false;
+  }
+  std::ostringstream encoded;
+  Tools::base64encode( in, encoded );
+  const std::string payload = encoded.str();
+  store( filename, Base64, payload );
+  out.write( payload.data(), payload.size() );
+  return true;
+}
+
+bool
+ImageCache::imageSize( const std::string & filename,
+                       std::size_t & width,
+                       std::size_t & height )
+{
+  CacheKey key;
+  if ( ! makeKey( filename, Base64, key ) ) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock( cacheMutex );
+    std::map<std::string,ImageSize>::const_iterator it = imageSizes.find( filename );
+    if ( it != imageSizes.end() && it->second.mtime == key.mtime && it->second.size == key.size ) {
+      width = it->second.width;
+      height = it->second.height;
+      return true;
+    }
+  }
+  if ( ! Tools::probeImageSize( filename.c_str(), width, height ) ) {
+    return false;
+  }
+  ImageSize entry;
+  entry.mtime = key.mtime;
+  entry.size = key.size;
+  entry.width = width;
+  entry.height = height;
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  if ( imageSizes.size() >= MaxImageSizes ) {
+    imageSizes.clear();
+  }
+  imageSizes[ filename ] = entry;
+  return true;
+}
+
+void
+ImageCache::setMemoryBudget( std::size_t bytes )
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  cacheBudget = bytes;
+  evict( cacheBudget );
+}
+
+std::size_t
+ImageCache::memoryBudget()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  return cacheBudget;
+}
+
+std::size_t
+ImageCache::memoryUsage()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  return cacheUsage;
+}
+
+std::size_t
+ImageCache::size()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  return cacheEntries.size();
+}
+
+std::size_t
+ImageCache::hits()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  return cacheHits;
+}
+
+std::size_t
+ImageCache::misses()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  return cacheMisses;
+}
+
+void
+ImageCache::clear()
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  cacheEntries.clear();
+  cacheIndex.clear();
+  cacheUsage = 0;
+  imageSizes.clear();
+}
+
+} // namespace PlaneDraw
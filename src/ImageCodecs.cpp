@@ -0,0 +1,908 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ImageCodecs.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Minimal bitmap decoders and encoders (PNG, JPEG, ASCII85).
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/ImageCodecs.h"
+#include "board/Tools.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+//
+// Inflate (RFC 1951)
+//
+
+/*
+ * Bits are read least significant first. Reading past the end of the
+ * input yields zero bits, which is detected with overrun().
+ */
+class BitReader {
+public:
+  BitReader( const unsigned char * data, std::size_t size )
+    : _data( data ), _size( size ), _pos( 0 ), _buffer( 0 ), _count( 0 ) { }
+
+  unsigned int peek( int n ) {
+    while ( _count < n ) {
+      const unsigned int byte = ( _pos < _size ) ? _data[ _pos ] : 0;
+      ++_pos;
+      _buffer |= static_cast<unsigned long>( byte ) << _count;
+      _count += 8;
+    }
+    return static_cast<unsigned int>( _buffer & ( ( 1ul << n ) - 1 ) );
+  }
+
+  void drop( int n ) {
+    _buffer >>= n;
+    _count -= n;
+  }
+
+  unsigned int bits( int n ) {
+    const unsigned int value = peek( n );
+    drop( n );
+    return value;
+  }
+
+  // Drops the remaining bits of the current byte, returns the byte position.
+  std::size_t align() {
+    drop( _count & 7 );
+    const std::size_t position = _pos - _count / 8;
+    _buffer = 0;
+    _count = 0;
+    _pos = position;
+    return position;
+  }
+
+  void seek( std::size_t position ) { _pos = position; }
+
+  bool overrun() const {
+    return _pos * 8 > _size * 8 + _count;
+  }
+
+private:
+  const unsigned char * _data;
+  std::size_t _size;
+  std::size_t _pos;
+  unsigned long _buffer;
+  int _count;
+};
+
+const int MaxCodeLength = 15;
+const int FastBits = 9;
+
+/*
+ * Canonical Huffman decoding table. Codes of at most FastBits bits are
+ * decoded with a single lookup, longer ones bit by bit.
+ */
+struct Huffman {
+  short count[ MaxCodeLength + 1 ];
+  short symbol[ 288 ];
+  unsigned short fast[ 1 << FastBits ];  // (symbol << 4) | length, or 0.
+};
+
+bool
+buildHuffman( Huffman & h, const unsigned char * lengths, int n )
+{
+  std::memset( h.count, 0, sizeof( h.count ) );
+  for ( int symbol = 0; symbol < n; ++symbol ) {
+    h.count[ lengths[ symbol ] ]++;
+  }
+  h.count[0] = 0;
+  int left = 1;
+  for ( int len = 1; len <= MaxCodeLength; ++len ) {
+    left <<= 1;
+    left -= h.count[ len ];
+    if ( left < 0 ) return false; // Over-subscribed.
+  }
+  short offsets[ MaxCodeLength + 1 ];
+  offsets[1] = 0;
+  for ( int len = 1; len < MaxCodeLength; ++len ) {
+    offsets[ len + 1 ] = offsets[ len ] + h.count[ len ];
+  }
+  for ( int symbol = 0; symbol < n; ++symbol ) {
+    if ( lengths[ symbol ] ) {
+      h.symbol[ offsets[ lengths[ symbol ] ]++ ] = static_cast<short>( symbol );
+    }
+  }
+  std::memset( h.fast, 0, sizeof( h.fast ) );
+  unsigned int code = 0;
+  int index = 0;
+  for ( int len = 1; len <= FastBits; ++len ) {
+    for ( int k = 0; k < h.count[ len ]; ++k ) {
+      unsigned int reversed = 0;
+      for ( int b = 0; b < len; ++b ) {
+        reversed |= ( ( code >> b ) & 1 ) << ( len - 1 - b );
+      }
+      const unsigned short entry = static_cast<unsigned short>( ( h.symbol[ index ] << 4 ) | len );
+      for ( unsigned int j = reversed; j < ( 1u << FastBits ); j += ( 1u << len ) ) {
+        h.fast[ j ] = entry;
+      }
+      ++code;
+      ++index;
+    }
+    code <<= 1;
+  }
+  return true;
+}
+
+int
+decodeSymbol( BitReader & in, const Huffman & h )
+{
+  const unsigned int bits = in.peek( MaxCodeLength );
+  const unsigned short entry = h.fast[ bits & ( ( 1u << FastBits ) - 1 ) ];
+  if ( entry ) {
+    in.drop( entry & 15 );
+    return entry >> 4;
+  }
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for ( int len = 1; len <= MaxCodeLength; ++len ) {
+    code |= ( bits >> ( len - 1 ) ) & 1;
+    const int count = h.count[ len ];
+    if ( code - count < first ) {
+      in.drop( len );
+      return h.symbol[ index + ( code - first ) ];
+    }
+    index += count;
+    first += count;
+    first <<= 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+const short lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const short lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const unsigned short distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                          257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                          8193, 12289, 16385, 24577 };
+const short distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+bool
+inflateCodes( BitReader & in, const Huffman & lengths, const Huffman & distances,
+              std::vector<unsigned char> & out, std::size_t start )
+{
+  for ( ;; ) {
+    int symbol = decodeSymbol( in, lengths );
+    if ( symbol < 0 || in.overrun() ) return false;
+    if ( symbol < 256 ) {
+      out.push_back( static_cast<unsigned char>( symbol ) );
+    } else if ( symbol == 256 ) {
+      return true;
+    } else {
+      symbol -= 257;
+      if ( symbol >= 29 ) return false;
+      const std::size_t length = lengthBase[ symbol ] + in.bits( lengthExtra[ symbol ] );
+      symbol = decodeSymbol( in, distances );
+      if ( symbol < 0 || symbol >= 30 ) return false;
+      const std::size_t distance = distanceBase[ symbol ] + in.bits( distanceExtra[ symbol ] );
+      if ( distance > out.size() - start ) return false;
+      std::size_t from = out.size() - distance;
+      for ( std::size_t i = 0; i < length; ++i ) {
+        out.push_back( out[ from++ ] );
+      }
+    }
+  }
+}
+
+struct FixedTables {
+  Huffman lengths;
+  Huffman distances;
+  FixedTables() {
+    unsigned char l[288];
+    int symbol = 0;
+    for ( ; symbol < 144; ++symbol ) l[ symbol ] = 8;
+    for ( ; symbol < 256; ++symbol ) l[ symbol ] = 9;
+    for ( ; symbol < 280; ++symbol ) l[ symbol ] = 7;
+    for ( ; symbol < 288; ++symbol ) l[ symbol ] = 8;
+    buildHuffman( lengths, l, 288 );
+    for ( symbol = 0; symbol < 30; ++symbol ) l[ symbol ] = 5;
+    buildHuffman( distances, l, 30 );
+  }
+};
+
+bool
+inflateDynamic( BitReader & in, std::vector<unsigned char> & out, std::size_t start )
+{
+  static const unsigned char order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+  const int nlen = in.bits( 5 ) + 257;
+  const int ndist = in.bits( 5 ) + 1;
+  const int ncode = in.bits( 4 ) + 4;
+  if ( nlen > 286 || ndist > 30 ) return false;
+  unsigned char lengths[ 286 + 30 ];
+  std::memset( lengths, 0, sizeof( lengths ) );
+  for ( int i = 0; i < ncode; ++i ) {
+    lengths[ order[ i ] ] = static_cast<unsigned char>( in.bits( 3 ) );
+  }
+  Huffman codes;
+  if ( ! buildHuffman( codes, lengths, 19 ) ) return false;
+  int index = 0;
+  while ( index < nlen + ndist ) {
+    int symbol = decodeSymbol( in, codes );
+    if ( symbol < 0 || in.overrun() ) return false;
+    if ( symbol < 16 ) {
+      lengths[ index++ ] = static_cast<unsigned char>( symbol );
+    } else {
+      unsigned char value = 0;
+      int repeat;
+      if ( symbol == 16 ) {
+        if ( index == 0 ) return false;
+        value = lengths[ index - 1 ];
+        repeat = 3 + in.bits( 2 );
+      } else if ( symbol == 17 ) {
+        repeat = 3 + in.bits( 3 );
+      } else {
+        repeat = 11 + in.bits( 7 );
+      }
+      if ( index + repeat > nlen + ndist ) return false;
+      while ( repeat-- ) lengths[ index++ ] = value;
+    }
+  }
+  if ( lengths[ 256 ] == 0 ) return false;
+  Huffman lengthCodes;
+  Huffman distanceCodes;
+  if ( ! buildHuffman( lengthCodes, lengths, nlen )
+       || ! buildHuffman( distanceCodes, lengths + nlen, ndist ) ) {
+    return false;
+  }
+  return inflateCodes( in, lengthCodes, distanceCodes, out, start );
+}
+
+//
+// PNG
+//
+
+inline unsigned int
+bigEndian32( const unsigned char * p )
+{
+  return ( static_cast<unsigned int>( p[0] ) << 24 ) | ( p[1] << 16 ) | ( p[2] << 8 ) | p[3];
+}
+
+inline unsigned int
+bigEndian16( const unsigned char * p )
+{
+  return ( p[0] << 8 ) | p[1];
+}
+
+inline unsigned char
+paeth( int a, int b, int c )
+{
+  const int p = a + b - c;
+  const int pa = std::abs( p - a );
+  const int pb = std::abs( p - b );
+  const int pc = std::abs( p - c );
+  if ( pa <= pb && pa <= pc ) return static_cast<unsigned char>( a );
+  if ( pb <= pc ) return static_cast<unsigned char>( b );
+  return static_cast<unsigned char>( c );
+}
+
+bool
+unfilterRow( unsigned char * row, const unsigned char * previous,
+             std::size_t length, std::size_t bpp, int type )
+{
+  switch ( type ) {
+  case 0:
+    break;
+  case 1:
+    for ( std::size_t i = bpp; i < length; ++i ) row[i] += row[ i - bpp ];
+    break;
+  case 2:
+    for ( std::size_t i = 0; i < length; ++i ) row[i] += previous[i];
+    break;
+  case 3:
+    for ( std::size_t i = 0; i < length; ++i ) {
+      const int left = ( i >= bpp ) ? row[ i - bpp ] : 0;
+      row[i] += static_cast<unsigned char>( ( left + previous[i] ) >> 1 );
+    }
+    break;
+  case 4:
+    for ( std::size_t i = 0; i < length; ++i ) {
+      const int left = ( i >= bpp ) ? row[ i - bpp ] : 0;
+      const int upperLeft = ( i >= bpp ) ? previous[ i - bpp ] : 0;
+      row[i] += paeth( left, previous[i], upperLeft );
+    }
+    break;
+  default:
+    return false;
+  }
+  return true;
+}
+
+struct PNGHeader {
+  std::size_t width;
+  std::size_t height;
+  int depth;
+  int colorType;
+  int interlace;
+  int channels;
+  std::vector<unsigned char> palette;       // RGB triplets
+  std::vector<unsigned char> paletteAlpha;
+  bool hasTransparentColor;
+  unsigned int transparentColor[3];
+};
+
+inline unsigned int
+sample( const unsigned char * row, std::size_t index, int depth )
+{
+  switch ( depth ) {
+  case 16: return bigEndian16( row + 2 * index );
+  case 8: return row[ index ];
+  default: {
+    const std::size_t bit = index * depth;
+    return ( row[ bit >> 3 ] >> ( 8 - depth - ( bit & 7 ) ) ) & ( ( 1u << depth ) - 1 );
+  }
+  }
+}
+
+inline unsigned char
+blendOverWhite( unsigned int value, unsigned int alpha )
+{
+  return static_cast<unsigned char>( ( value * alpha + 255 * ( 255 - alpha ) + 127 ) / 255 );
+}
+
+/*
+ * Converts the x-th pixel of an unfiltered row to 8-bits gray or RGB.
+ */
+void
+convertPixel( const PNGHeader & header, const unsigned char * row, std::size_t x, unsigned char * out )
+{
+  const int depth = header.depth;
+  const unsigned int maxValue = ( 1u << depth ) - 1;
+  unsigned int alpha = 255;
+  switch ( header.colorType ) {
+  case 0: {
+    const unsigned int g = sample( row, x, depth );
+    if ( header.hasTransparentColor && g == header.transparentColor[0] ) alpha = 0;
+    out[0] = blendOverWhite( ( g * 255 + maxValue / 2 ) / maxValue, alpha );
+    break;
+  }
+  case 2: {
+    unsigned int c[3];
+    for ( int k = 0; k < 3; ++k ) c[k] = sample( row, 3 * x + k, depth );
+    if ( header.hasTransparentColor && c[0] == header.transparentColor[0]
+         && c[1] == header.transparentColor[1] && c[2] == header.transparentColor[2] ) {
+      alpha = 0;
+    }
+    for ( int k = 0; k < 3; ++k ) out[k] = blendOverWhite( depth == 16 ? ( c[k] >> 8 ) : c[k], alpha );
+    break;
+  }
+  case 3: {
+    const unsigned int index = sample( row, x, depth );
+    if ( index < header.paletteAlpha.size() ) alpha = header.paletteAlpha[ index ];
+    for ( int k = 0; k < 3; ++k ) {
+      const unsigned int c = ( 3 * index + k < header.palette.size() ) ? header.palette[ 3 * index + k ] : 0;
+      out[k] = blendOverWhite( c, alpha );
+    }
+    break;
+  }
+  case 4: {
+    const unsigned int g = sample( row, 2 * x, depth );
+    alpha = sample( row, 2 * x + 1, depth );
+    if ( depth == 16 ) alpha >>= 8;
+    out[0] = blendOverWhite( depth == 16 ? ( g >> 8 ) : g, alpha );
+    break;
+  }
+  case 6: {
+    alpha = sample( row, 4 * x + 3, depth );
+    if ( depth == 16 ) alpha >>= 8;
+    for ( int k = 0; k < 3; ++k ) {
+      const unsigned int c = sample( row, 4 * x + k, depth );
+      out[k] = blendOverWhite( depth == 16 ? ( c >> 8 ) : c, alpha );
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+bool
+validPNGFormat( int colorType, int depth )
+{
+  switch ( colorType ) {
+  case 0: return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+  case 3: return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+  case 2: case 4: case 6: return depth == 8 || depth == 16;
+  default: return false;
+  }
+}
+
+const unsigned char pngSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+//
+// Postscript output
+//
+
+void
+flushImageDictionary( std::ostream & out, int components,
+                      std::size_t width, std::size_t height,
+                      bool invertedDecode, const std::string & dataSource )
+{
+  out << "<< /ImageType 1 /Width " << width << " /Height " << height
+      << " /BitsPerComponent 8\n     /Decode [";
+  for ( int k = 0; k < components; ++k ) {
+    out << ( invertedDecode ? " 1 0" : " 0 1" );
+  }
+  out << " ] /ImageMatrix [ " << width << " 0 0 -" << height << " 0 " << height << " ]\n"
+      << "     /DataSource " << dataSource << " >> image\n";
+}
+
+void
+flushImageHeader( std::ostream & out, const char * colorSpace, int components,
+                  std::size_t width, std::size_t height,
+                  bool invertedDecode, const char * filter )
+{
+  out << "1 dict begin\n"
+      << "/BoardImageData currentfile /ASCII85Decode filter def\n"
+      << "/" << colorSpace << " setcolorspace\n"
+      << "{ ";
+  flushImageDictionary( out, components, width, height, invertedDecode,
+                        std::string( "BoardImageData" ) + ( filter ? " " : "" ) + ( filter ? filter : "" ) );
+  out << "  BoardImageData flushfile end } exec\n";
+}
+
+}
+
+namespace PlaneDraw {
+
+namespace Tools {
+
+bool
+readFile( const char * filename, std::vector<unsigned char> & data )
+{
+  std::ifstream in( filename, std::ios::in | std::ios::binary );
+  if ( ! in ) {
+    return false;
+  }
+  in.seekg( 0, std::ios::end );
+  const std::streamoff size = in.tellg();
+  if ( size < 0 ) {
+    return false;
+  }
+  in.seekg( 0, std::ios::beg );
+  data.resize( static_cast<std::size_t>( size ) );
+  if ( size > 0 ) {
+    in.read( reinterpret_cast<char*>( &data[0] ), size );
+  }
+  return static_cast<bool>( in );
+}
+
+bool
+inflate( const unsigned char * data, std::size_t size, std::vector<unsigned char> & out )
+{
+  static const FixedTables fixed;
+  const std::size_t start = out.size();
+  BitReader in( data, size );
+  int last;
+  do {
+    last = in.bits( 1 );
+    const int type = in.bits( 2 );
+    switch ( type ) {
+    case 0: {
+      const std::size_t position = in.align();
+      if ( position + 4 > size ) return false;
+      const unsigned int length = data[ position ] | ( data[ position + 1 ] << 8 );
+      const unsigned int complement = data[ position + 2 ] | ( data[ position + 3 ] << 8 );
+      if ( length != ( ~complement & 0xffff ) || position + 4 + length > size ) return false;
+      out.insert( out.end(), data + position + 4, data + position + 4 + length );
+      in.seek( position + 4 + length );
+      break;
+    }
+    case 1:
+      if ( ! inflateCodes( in, fixed.lengths, fixed.distances, out, start ) ) return false;
+      break;
+    case 2:
+      if ( ! inflateDynamic( in, out, start ) ) return false;
+      break;
+    default:
+      return false;
+    }
+    if ( in.overrun() ) return false;
+  } while ( ! last );
+  return true;
+}
+
+bool
+zlibDecompress( const unsigned char * data, std::size_t size, std::vector<unsigned char> & out )
+{
+  if ( size < 2 ) return false;
+  const unsigned int cmf = data[0];
+  const unsigned int flg = data[1];
+  if ( ( cmf & 0x0f ) != 8 || ( ( cmf << 8 ) | flg ) % 31 != 0 || ( flg & 0x20 ) ) {
+    return false;
+  }
+  return inflate( data + 2, size - 2, out );
+}
+
+bool
+decodePNG( const unsigned char * data, std::size_t size, Bitmap & bitmap )
+{
+  if ( size < 8 || std::memcmp( data, pngSignature, 8 ) ) {
+    return false;
+  }
+  PNGHeader header;
+  header.width = header.height = 0;
+  header.hasTransparentColor = false;
+  std::vector<unsigned char> compressed;
+  std::size_t pos = 8;
+  bool headerRead = false;
+  while ( pos + 8 <= size ) {
+    const std::size_t length = bigEndian32( data + pos );
+    const unsigned char * type = data + pos + 4;
+    const unsigned char * chunk = data + pos + 8;
+    if ( length > size || pos + 12 + length > size ) return false;
+    if ( ! std::memcmp( type, "IHDR", 4 ) && length >= 13 ) {
+      header.width = bigEndian32( chunk );
+      header.height = bigEndian32( chunk + 4 );
+      header.depth = chunk[8];
+      header.colorType = chunk[9];
+      header.interlace = chunk[12];
+      if ( chunk[10] != 0 || chunk[11] != 0 || header.interlace > 1
+           || ! validPNGFormat( header.colorType, header.depth ) ) {
+        return false;
+      }
+      headerRead = true;
+    } else if ( ! std::memcmp( type, "PLTE", 4 ) ) {
+      header.palette.assign( chunk, chunk + length );
+    } else if ( ! std::memcmp( type, "tRNS", 4 ) && headerRead ) {
+      if ( header.colorType == 3 ) {
+        header.paletteAlpha.assign( chunk, chunk + length );
+      } else if ( header.colorType == 0 && length >= 2 ) {
+        header.hasTransparentColor = true;
+        header.transparentColor[0] = bigEndian16( chunk );
+      } else if ( header.colorType == 2 && length >= 6 ) {
+        header.hasTransparentColor = true;
+        for ( int k = 0; k < 3; ++k ) header.transparentColor[k] = bigEndian16( chunk + 2 * k );
+      }
+    } else if ( ! std::memcmp( type, "IDAT", 4 ) ) {
+      compressed.insert( compressed.end(), chunk, chunk + length );
+    } else if ( ! std::memcmp( type, "IEND", 4 ) ) {
+      break;
+    }
+    pos += 12 + length;
+  }
+  if ( ! headerRead || ! header.width || ! header.height
+       || header.width > ( 1u << 24 ) || header.height > ( 1u << 24 ) || compressed.empty() ) {
+    return false;
+  }
+
+  static const int channelsByType[7] = { 1, 0, 3, 1, 2, 0, 4 };
+  header.channels = channelsByType[ header.colorType ];
+  const std::size_t bitsPerPixel = header.channels * header.depth;
+  const std::size_t bpp = ( bitsPerPixel + 7 ) / 8;
+  const std::size_t width = header.width;
+  const std::size_t height = header.height;
+
+  std::vector<unsigned char> raw;
+  raw.reserve( height * ( 1 + ( width * bitsPerPixel + 7 ) / 8 ) );
+  if ( ! zlibDecompress( &compressed[0], compressed.size(), raw ) ) {
+    return false;
+  }
+
+  bitmap.width = width;
+  bitmap.height = height;
+  bitmap.components = ( header.colorType == 0 || header.colorType == 4 ) ? 1 : 3;
+  bitmap.pixels.assign( width * height * bitmap.components, 255 );
+
+  static const int adam7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+                                   { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+  static const int noInterlace[1][4] = { { 0, 0, 1, 1 } };
+  const int (*passes)[4] = header.interlace ? adam7 : noInterlace;
+  const int passCount = header.interlace ? 7 : 1;
+
+  std::size_t offset = 0;
+  std::vector<unsigned char> previous;
+  for ( int pass = 0; pass < passCount; ++pass ) {
+    const std::size_t x0 = passes[pass][0], y0 = passes[pass][1];
+    const std::size_t dx = passes[pass][2], dy = passes[pass][3];
+    const std::size_t passWidth = ( width > x0 ) ? ( width - x0 + dx - 1 ) / dx : 0;
+    const std::size_t passHeight = ( height > y0 ) ? ( height - y0 + dy - 1 ) / dy : 0;
+    if ( ! passWidth || ! passHeight ) continue;
+    const std::size_t rowBytes = ( passWidth * bitsPerPixel + 7 ) / 8;
+    previous.assign( rowBytes, 0 );
+    for ( std::size_t y = 0; y < passHeight; ++y ) {
+      if ( offset + 1 + rowBytes > raw.size() ) return false;
+      unsigned char * row = &raw[ offset + 1 ];
+      if ( ! unfilterRow( row, &previous[0], rowBytes, bpp, raw[ offset ] ) ) return false;
+      unsigned char * target = &bitmap.pixels[ ( ( y0 + y * dy ) * width + x0 ) * bitmap.components ];
+      for ( std::size_t x = 0; x < passWidth; ++x ) {
+        convertPixel( header, row, x, target );
+        target += dx * bitmap.components;
+      }
+      std::memcpy( &previous[0], row, rowBytes );
+      offset += 1 + rowBytes;
+    }
+  }
+  return true;
+}
+
+bool
+readJPEGInfo( const unsigned char * data, std::size_t size, JPEGInfo & info )
+{
+  if ( size < 4 || data[0] != 0xFF || data[1] != 0xD8 ) {
+    return false;
+  }
+  info.adobeInverted = false;
+  std::size_t pos = 2;
+  while ( pos + 4 <= size ) {
+    if ( data[ pos ] != 0xFF ) {
+      ++pos;
+      continue;
+    }
+    while ( pos < size && data[ pos ] == 0xFF ) ++pos;
+    if ( pos >= size ) break;
+    const unsigned char marker = data[ pos++ ];
+    if ( marker == 0xD8 || marker == 0x01 || ( marker >= 0xD0 && marker <= 0xD7 ) ) {
+      continue;
+    }
+    if ( marker == 0xD9 || marker == 0xDA || pos + 2 > size ) {
+      break;
+    }
+    const std::size_t length = bigEndian16( data + pos );
+    if ( length < 2 || pos + length > size ) break;
+    const unsigned char * segment = data + pos + 2;
+    if ( marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC ) {
+      if ( length < 8 ) return false;
+      info.precision = segment[0];
+      info.height = bigEndian16( segment + 1 );
+      info.width = bigEndian16( segment + 3 );
+      info.components = segment[5];
+      return info.width > 0 && info.height > 0;
+    }
+    if ( marker == 0xEE && length >= 14 && ! std::memcmp( segment, "Adobe", 5 ) ) {
+      info.adobeInverted = true;
+    }
+    pos += length;
+  }
+  return false;
+}
+
+bool
+probeImageSize( const char * filename, std::size_t & width, std::size_t & height )
+{
+  std::ifstream in( filename, std::ios::in | std::ios::binary );
+  unsigned char header[32];
+  std::memset( header, 0, sizeof( header ) );
+  in.read( reinterpret_cast<char*>( header ), sizeof( header ) );
+  const std::streamsize count = in.gcount();
+  if ( count < 10 ) {
+    return false;
+  }
+  // PNG: the IHDR chunk comes first.
+  if ( count >= 24 && ! std::memcmp( header, pngSignature, 8 ) && ! std::memcmp( header + 12, "IHDR", 4 ) ) {
+    width = bigEndian32( header + 16 );
+    height = bigEndian32( header + 20 );
+    return width && height;
+  }
+  // GIF: logical screen descriptor.
+  if ( ! std::memcmp( header, "GIF87a", 6 ) || ! std::memcmp( header, "GIF89a", 6 ) ) {
+    width = header[6] | ( header[7] << 8 );
+    height = header[8] | ( header[9] << 8 );
+    return width && height;
+  }
+  // BMP: the size is in the DIB header, which follows the 14 bytes file header.
+  if ( count >= 26 && header[0] == 'B' && header[1] == 'M' ) {
+    const unsigned int dibSize = header[14] | ( header[15] << 8 ) | ( header[16] << 16 ) | ( header[17] << 24 );
+    if ( dibSize == 12 ) {
+      width = header[18] | ( header[19] << 8 );
+      height = header[20] | ( header[21] << 8 );
+    } else {
+      const int w = static_cast<int>( header[18] | ( header[19] << 8 ) | ( header[20] << 16 ) | ( static_cast<unsigned int>( header[21] ) << 24 ) );
+      const int h = static_cast<int>( header[22] | ( header[23] << 8 ) | ( header[24] << 16 ) | ( static_cast<unsigned int>( header[25] ) << 24 ) );
+      width = static_cast<std::size_t>( std::abs( w ) );
+      height = static_cast<std::size_t>( std::abs( h ) ); // Negative for top-down bitmaps.
+    }
+    return width && height;
+  }
+  // JPEG: walk the segments up to the frame header, skipping their content.
+  if ( header[0] == 0xFF && header[1] == 0xD8 ) {
+    std::streamoff pos = 2;
+    unsigned char segment[10];
+    for ( ;; ) {
+      in.clear();
+      in.seekg( pos );
+      if ( ! in.read( reinterpret_cast<char*>( segment ), 4 ) ) return false;
+      if ( segment[0] != 0xFF ) return false;
+      if ( segment[1] == 0xFF ) { // Fill byte.
+        ++pos;
+        continue;
+      }
+      const unsigned char marker = segment[1];
+      if ( marker == 0x01 || ( marker >= 0xD0 && marker <= 0xD7 ) ) {
+        pos += 2;
+        continue;
+      }
+      if ( marker == 0xD9 || marker == 0xDA ) return false;
+      const std::size_t length = bigEndian16( segment + 2 );
+      if ( length < 2 ) return false;
+      if ( marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC ) {
+        if ( ! in.read( reinterpret_cast<char*>( segment + 4 ), 5 ) ) return false;
+        height = bigEndian16( segment + 5 );
+        width = bigEndian16( segment + 7 );
+        return width && height;
+      }
+      pos += 2 + static_cast<std::streamoff>( length );
+    }
+  }
+  return false;
+}
+
+void
+ascii85encode( const unsigned char * data, std::size_t size, std::ostream & out, int linesize )
+{
+  std::vector<char> buffer;
+  buffer.reserve( 64 * 1024 + 16 );
+  int column = 0;
+  std::size_t i = 0;
+  char group[5];
+  while ( i < size ) {
+    const std::size_t n = ( size - i >= 4 ) ? 4 : ( size - i );
+    unsigned int value = 0;
+    for ( std::size_t k = 0; k < 4; ++k ) {
+      value = ( value << 8 ) | ( ( k < n ) ? data[ i + k ] : 0 );
+    }
+    i += n;
+    int length;
+    if ( value == 0 && n == 4 ) {
+      group[0] = 'z';
+      length = 1;
+    } else {
+      for ( int k = 4; k >= 0; --k ) {
+        group[k] = static_cast<char>( '!' + value % 85 );
+        value /= 85;
+      }
+      length = static_cast<int>( n ) + 1;
+    }
+    for ( int k = 0; k < length; ++k ) {
+      if ( column >= linesize ) {
+        buffer.push_back( '\n' );
+        column = 0;
+      }
+      if ( column == 0 && group[k] == '%' ) {
+        buffer.push_back( ' ' );
+        ++column;
+      }
+      buffer.push_back( group[k] );
+      ++column;
+    }
+    if ( buffer.size() >= 64 * 1024 ) {
+      out.write( &buffer[0], buffer.size() );
+      buffer.clear();
+    }
+  }
+  if ( column + 2 > linesize ) {
+    buffer.push_back( '\n' );
+  }
+  buffer.push_back( '~' );
+  buffer.push_back( '>' );
+  buffer.push_back( '\n' );
+  out.write( &buffer[0], buffer.size() );
+}
+
+namespace {
+
+/*
+ * The samples of a bitmap file, as painted by Postscript code.
+ */
+struct PostscriptImage {
+  const char * kind;
+  const char * colorSpace;
+  int components;
+  std::size_t width;
+  std::size_t height;
+  bool invertedDecode;
+  const char * filter;                  /**< Applied after ASCII85 decoding, if not null. */
+  std::vector<unsigned char> samples;   /**< JPEG data, or raw PNG samples. */
+};
+
+bool
+readPostscriptImage( const char * filename, PostscriptImage & image )
+{
+  std::vector<unsigned char> data;
+  if ( ! readFile( filename, data ) || data.size() < 8 ) {
+    Tools::error << "flushPostscriptImage(): cannot read file " << filename << "\n";
+    return false;
+  }
+  JPEGInfo jpeg;
+  if ( readJPEGInfo( &data[0], data.size(), jpeg ) ) {
+    static const char * spaces[5] = { 0, "DeviceGray", 0, "DeviceRGB", "DeviceCMYK" };
+    if ( jpeg.precision != 8 || jpeg.components < 1 || jpeg.components > 4 || ! spaces[ jpeg.components ] ) {
+      Tools::error << "flushPostscriptImage(): unsupported JPEG format in " << filename << "\n";
+      return false;
+    }
+    image.kind = "JPEG";
+    image.colorSpace = spaces[ jpeg.components ];
+    image.components = jpeg.components;
+    image.width = jpeg.width;
+    image.height = jpeg.height;
+    image.invertedDecode = jpeg.adobeInverted && jpeg.components == 4;
+    image.filter = "/DCTDecode filter";
+    image.samples.swap( data );
+    return true;
+  }
+  if ( ! std::memcmp( &data[0], pngSignature, 8 ) ) {
+    Bitmap bitmap;
+    if ( ! decodePNG( &data[0], data.size(), bitmap ) ) {
+      Tools::error << "flushPostscriptImage(): invalid PNG file " << filename << "\n";
+      return false;
+    }
+    image.kind = "PNG";
+    image.colorSpace = ( bitmap.components == 1 ) ? "DeviceGray" : "DeviceRGB";
+    image.components = bitmap.components;
+    image.width = bitmap.width;
+    image.height = bitmap.height;
+    image.invertedDecode = false;
+    image.filter = 0;
+    image.samples.swap( bitmap.pixels );
+    return true;
+  }
+  return false;
+}
+
+}
+
+bool
+flushPostscriptImage( const char * filename, std::ostream & out )
+{
+  PostscriptImage image;
+  if ( ! readPostscriptImage( filename, image ) ) {
+    return false;
+  }
+  out << "% " << image.kind << " image " << image.width << "x" << image.height << "\n";
+  flushImageHeader( out, image.colorSpace, image.components, image.width, image.height,
+                    image.invertedDecode, image.filter );
+  ascii85encode( &image.samples[0], image.samples.size(), out );
+  return true;
+}
+
+bool
+flushPostscriptImageDefinition( const char * filename, std::ostream & out, unsigned int id )
+{
+  PostscriptImage image;
+  if ( ! readPostscriptImage( filename, image ) ) {
+    return false;
+  }
+  out << "% " << image.kind << " image " << image.width << "x" << image.height << "\n"
+      << "/BoardImageData" << id << " currentfile /ASCII85Decode filter /ReusableStreamDecode filter def\n";
+  ascii85encode( &image.samples[0], image.samples.size(), out );
+  std::ostringstream dataSource;
+  dataSource << "BoardImageData" << id << " dup resetfile" << ( image.filter ? " " : "" ) << ( image.filter ? image.filter : "" );
+  out << "/BoardImage" << id << " {\n"
+      << "/" << image.colorSpace << " setcolorspace\n";
+  flushImageDictionary( out, image.components, image.width, image.height, image.invertedDecode, dataSource.str() );
+  out << "} bind def\n";
+  return true;
+}
+
+} // namespace Tools
+
+} // namespace PlaneDraw
@@ -0,0 +1,136 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   LevelOfDetail.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Culling of the shapes too small to be seen in an export.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "board/LevelOfDetail.h"
+#include "board/ExportStats.h"
+#include "board/ShapeList.h"
+#include "board/Shapes.h"
+#include "board/ShapeVisitor.h"
+#include "board/Transforms.h"
+#include <algorithm>
+
+namespace {
+
+// Sums the colors of the primitive shapes of a shape.
+struct ColorAccumulator : public PlaneDraw::ShapeVisitor {
+  ColorAccumulator()
+    : red( 0 ), green( 0 ), blue( 0 ), alpha( 0 ), colored( 0 ), shapes( 0 ) { }
+  void visit( PlaneDraw::Shape & shape ) {
+    ++shapes;
+    const PlaneDraw::Color & color = shape.fillColor().valid() ? shape.fillColor() : shape.penColor();
+    if ( color.valid() ) {
+      red += color.red();
+      green += color.green();
+      blue += color.blue();
+      alpha += color.alpha();
+      ++colored;
+    }
+  }
+  void visit( PlaneDraw::Shape & ) const { }
+  unsigned long long red, green, blue, alpha;
+  std::size_t colored;
+  std::size_t shapes;
+};
+
+template< typename T >
+bool flushReducedShape( const PlaneDraw::Shape & shape, std::ostream & stream, const T & transform,
+                        void (PlaneDraw::Shape::*flush)( std::ostream &, const T & ) const )
+{
+  using PlaneDraw::LevelOfDetail;
+  const LevelOfDetail::Decision decision = LevelOfDetail::decide( shape, transform );
+  if ( decision == LevelOfDetail::Keep ) {
+    return false;
+  }
+  PlaneDraw::ExportStats * stats = transform.context().stats();
+  const PlaneDraw::Color color = ( decision == LevelOfDetail::Collapse ) ? LevelOfDetail::averageColor( shape ) : PlaneDraw::Color::Null;
+  if ( color.valid() ) {
+    PlaneDraw::Rectangle rectangle( shape.boundingBox( PlaneDraw::Shape::UseLineWidth ),
+                                    PlaneDraw::Color::Null, color, 0.0,
+                                    PlaneDraw::Shape::SolidStyle, PlaneDraw::Shape::ButtCap, PlaneDraw::Shape::MiterJoin );
+    (rectangle.*flush)( stream, transform );
+    if ( stats ) {
+      stats->culled += LevelOfDetail::count( shape );
+      ++stats->simplified;
+    }
+  } else if ( stats ) {
+    stats->culled += LevelOfDetail::count( shape );
+  }
+  return true;
+}
+
+}
+
+namespace PlaneDraw {
+
+LevelOfDetail::Decision
+LevelOfDetail::decide( const Shape & shape, const Transform & transform )
+{
+  const double threshold = transform.context().detailThreshold();
+  if ( threshold <= 0.0 ) {
+    return Keep;
+  }
+  const Rect box = shape.boundingBox( Shape::UseLineWidth );
+  if ( std::max( transform.scale( box.width ), transform.scale( box.height ) ) >= threshold ) {
+    return Keep;
+  }
+  return dynamic_cast<const ShapeList*>( &shape ) ? Collapse : Cull;
+}
+
+bool
+LevelOfDetail::flushReduced( const Shape & shape, std::ostream & stream, const TransformEPS & transform )
+{
+  return flushReducedShape( shape, stream, transform, &Shape::flushPostscript );
+}
+
+bool
+LevelOfDetail::flushReduced( const Shape & shape, std::ostream & stream, const TransformSVG & transform )
+{
+  return flushReducedShape( shape, stream, transform, &Shape::flushSVG );
+}
+
+Color
+LevelOfDetail::averageColor( const Shape & shape )
+{
+  ColorAccumulator accumulator;
+  const_cast<Shape&>( shape ).accept( accumulator );
+  if ( ! accumulator.colored ) {
+    return Color::Null;
+  }
+  const unsigned long long n = accumulator.colored;
+  return Color( static_cast<unsigned char>( ( accumulator.red + n / 2 ) / n ),
+                static_cast<unsigned char>( ( accumulator.green + n / 2 ) / n ),
+                static_cast<unsigned char>( ( accumulator.blue + n / 2 ) / n ),
+                static_cast<unsigned char>( ( accumulator.alpha + n / 2 ) / n ) );
+}
+
+std::size_t
+LevelOfDetail::count( const Shape & shape )
+{
+  ColorAccumulator accumulator;
+  const_cast<Shape&>( shape ).accept( accumulator );
+  return accumulator.shapes;
+}
+
+} // namespace PlaneDraw
@@ -0,0 +1,136 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   MemoryUsage.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Memory footprint of a drawing, per shape type.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/MemoryUsage.h"
+#include "board/Path.h"
+#include "board/Tools.h"
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+PlaneDraw::MemoryUsage::ShapeUsage &
+entry( std::map<std::string,PlaneDraw::MemoryUsage::ShapeUsage> & shapes, const std::string & type )
+{
+  std::map<std::string,PlaneDraw::MemoryUsage::ShapeUsage>::iterator it = shapes.find( type );
+  if ( it == shapes.end() ) {
+    const PlaneDraw::MemoryUsage::ShapeUsage empty = { 0, 0, 0, 0, 0, 0 };
+    it = shapes.insert( std::make_pair( type, empty ) ).first;
+  }
+  return it->second;
+}
+
+}
+
+namespace PlaneDraw {
+
+void
+MemoryUsage::addObject( const std::string & type, std::size_t bytes )
+{
+  ShapeUsage & usage = entry( shapes, type );
+  ++usage.count;
+  usage.objectBytes += bytes;
+}
+
+void
+MemoryUsage::addPath( const std::string & type, const Path & path )
+{
+  ShapeUsage & usage = entry( shapes, type );
+  usage.pointBytes += path.capacity() * sizeof( Point );
+  usage.wastedBytes += ( path.capacity() - path.size() ) * sizeof( Point );
+}
+
+void
+MemoryUsage::addString( const std::string & type, const std::string & str )
+{
+  // A string whose characters are stored in the object itself has no heap buffer.
+  const char * data = str.data();
+  const char * object = reinterpret_cast<const char *>( &str );
+  if ( data >= object && data < object + sizeof( std::string ) ) {
+    return;
+  }
+  ShapeUsage & usage = entry( shapes, type );
+  usage.stringBytes += str.capacity() + 1;
+  usage.wastedBytes += str.capacity() - str.size();
+}
+
+void
+MemoryUsage::addContainer( const std::string & type, std::size_t size, std::size_t capacity, std::size_t elementSize )
+{
+  ShapeUsage & usage = entry( shapes, type );
+  usage.containerBytes += capacity * elementSize;
+  usage.wastedBytes += ( capacity - size ) * elementSize;
+}
+
+std::size_t
+MemoryUsage::totalBytes() const
+{
+  std::size_t total = 0;
+  std::map<std::string,ShapeUsage>::const_iterator it = shapes.begin();
+  while ( it != shapes.end() ) {
+    total += it->second.totalBytes();
+    ++it;
+  }
+  return total;
+}
+
+std::size_t
+MemoryUsage::wastedBytes() const
+{
+  std::size_t total = 0;
+  std::map<std::string,ShapeUsage>::const_iterator it = shapes.begin();
+  while ( it != shapes.end() ) {
+    total += it->second.wastedBytes;
+    ++it;
+  }
+  return total;
+}
+
+void
+MemoryUsage::flushSummary() const
+{
+  char line[256];
+  secured_sprintf( line, 256, "Memory usage: %lu bytes, %lu wasted.\n",
+                   static_cast<unsigned long>( totalBytes() ),
+                   static_cast<unsigned long>( wastedBytes() ) );
+  Tools::notice << line;
+  std::map<std::string,ShapeUsage>::const_iterator it = shapes.begin();
+  while ( it != shapes.end() ) {
+    const ShapeUsage & usage = it->second;
+    secured_sprintf( line, 256, "  %-14s %10lu objects %12lu bytes (points %lu, strings %lu, lists %lu, wasted %lu)\n",
+                     it->first.c_str(),
+                     static_cast<unsigned long>( usage.count ),
+                     static_cast<unsigned long>( usage.totalBytes() ),
+                     static_cast<unsigned long>( usage.pointBytes ),
+                     static_cast<unsigned long>( usage.stringBytes ),
+                     static_cast<unsigned long>( usage.containerBytes ),
+                     static_cast<unsigned long>( usage.wastedBytes ) );
+    Tools::notice << line;
+    ++it;
+  }
+}
+
+} // namespace PlaneDraw
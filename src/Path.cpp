@@ -26,9 +26,40 @@
 #include "BoardConfig.h"
 #include "board/Path.h"
 #include "board/Transforms.h"
+#include "board/ThreadPool.h"
 #include <algorithm>
 #include <iterator>
 
+namespace {
+// The flush methods map the points by chunks of this size, on the stack.
+const std::size_t MapChunk = 256;
+
+// Paths are transformed (and bounded) by ranges of at least this number
+// of points, in parallel. A range of the cheapest loop (translate, about
+// 3 ns a point) then takes some 50 us, against about 10 us to hand it
+// to the shared pool.
+const std::size_t ParallelGrain = 16384;
+
+// The extent of a set of points.
+struct Bounds {
+  double left, right, bottom, top;
+  explicit Bounds( const PlaneDraw::Point & p = PlaneDraw::Point() )
+    : left( p.x ), right( p.x ), bottom( p.y ), top( p.y ) { }
+  void add( const PlaneDraw::Point & p ) {
+    left = std::min( left, p.x );
+    right = std::max( right, p.x );
+    bottom = std::min( bottom, p.y );
+    top = std::max( top, p.y );
+  }
+  void add( const Bounds & other ) {
+    left = std::min( left, other.left );
+    right = std::max( right, other.right );
+    bottom = std::min( bottom, other.bottom );
+    top = std::max( top, other.top );
+  }
+};
+}
+
 namespace PlaneDraw {
 
 Path &
@@ -38,6 +69,14 @@ Path::pop_back()
   return *this;
 }
 
+void
+Path::shrinkToFit()
+{
+  if ( _points.capacity() > _points.size() ) {
+    std::vector<Point>( _points ).swap( _points );
+  }
+}
+
 Path &
 Path::operator<<( const Point & p )
 {
@@ -60,12 +99,13 @@ Path::center() const {
 Path &
 Path::rotate( double angle, const Point & center )
 {
-  std::vector<Point>::iterator i = _points.begin();
-  std::vector<Point>::iterator end = _points.end();
-  while ( i != end ) {
-    i->rotate( angle, center );
-    ++i;
-  }
+  std::vector<Point> & points = _points;
+  ThreadPool::parallelFor( points.size(), ParallelGrain,
+                           [&points,angle,&center]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               points[k].rotate( angle, center );
+                             }
+                           } );
   return *this;
 }
 
@@ -78,14 +118,7 @@ Path::rotateDeg( double angle, const Point & center )
 Path
 Path::rotated( double angle, const Point & center ) const
 {
-  Path res(*this);
-  std::vector<Point>::iterator i = res._points.begin();
-  std::vector<Point>::iterator end = res._points.end();
-  while ( i != end ) {
-    i->rotate( angle, center );
-    ++i;
-  }
-  return res;
+  return Path(*this).rotate( angle, center );
 }
 
 Path
@@ -121,44 +154,36 @@ Path::rotatedDeg( double angle ) const
 Path &
 Path::translate( double dx, double dy )
 {
-  std::vector<Point>::iterator i = _points.begin();
-  std::vector<Point>::iterator end = _points.end();
-  Point delta( dx, dy );
-  while ( i != end ) {
-    (*i) += delta;
-    ++i;
-  }
+  std::vector<Point> & points = _points;
+  const Point delta( dx, dy );
+  ThreadPool::parallelFor( points.size(), ParallelGrain,
+                           [&points,&delta]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               points[k] += delta;
+                             }
+                           } );
   return *this;
 }
 
 Path
 Path::translated( double dx, double dy ) const
 {
-  Path res(*this);
-  std::vector<Point>::iterator i = res._points.begin();
-  std::vector<Point>::iterator end = res._points.end();
-  Point delta( dx, dy );
-  while ( i != end ) {
-    (*i) += delta;
-    ++i;
-  }
-  return res;
+  return Path(*this).translate( dx, dy );
 }
 
 Path &
 Path::scale( double sx, double sy )
 {
-  Point c = center();
-  translate( -c.x, -c.y );
-  std::vector<Point>::iterator i = _points.begin();
-  std::vector<Point>::iterator end = _points.end();
-  while ( i != end ) {
-    i->x *= sx;
-    i->y *= sy;
-    ++i;
-  }
-  Point delta = c - center();
-  translate( delta.x, delta.y );
+  // The points are scaled about the center, in a single pass.
+  std::vector<Point> & points = _points;
+  const Point c = center();
+  ThreadPool::parallelFor( points.size(), ParallelGrain,
+                           [&points,&c,sx,sy]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               points[k].x = c.x + ( points[k].x - c.x ) * sx;
+                               points[k].y = c.y + ( points[k].y - c.y ) * sy;
+                             }
+                           } );
   return *this;
 }
 
@@ -183,12 +208,13 @@ Path::scaled( double s) const
 void
 Path::scaleAll( double s )
 {
-  std::vector<Point>::iterator it = _points.begin();
-  std::vector<Point>::iterator end = _points.end();
-  while ( it != end ) {
-    (*it) *= s;
-    ++it;
-  }
+  std::vector<Point> & points = _points;
+  ThreadPool::parallelFor( points.size(), ParallelGrain,
+                           [&points,s]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               points[k] *= s;
+                             }
+                           } );
 }
 
 void
@@ -197,14 +223,17 @@ Path::flushPostscript( std::ostream & stream,
 {
   if ( _points.empty() )
     return;
-  std::vector<Point>::const_iterator i = _points.begin();
-  std::vector<Point>::const_iterator end = _points.end();
-
-  stream << transform.mapX( i->x ) << " " << transform.mapY( i->y ) << " m";
-  ++i;
-  while ( i != end ) {
-    stream << " " << transform.mapX( i->x ) << " " << transform.mapY( i->y ) << " l";
-    ++i;
+  Point mapped[ MapChunk ];
+  for ( std::size_t first = 0; first < _points.size(); first += MapChunk ) {
+    const std::size_t n = std::min( MapChunk, _points.size() - first );
+    transform.mapPoints( &_points[first], n, mapped );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( first + i ) {
+        stream << " " << mapped[i].x << " " << mapped[i].y << " l";
+      } else {
+        stream << mapped[i].x << " " << mapped[i].y << " m";
+      }
+    }
   }
   if ( _closed ) stream << " cp";
   stream << " ";
@@ -217,12 +246,14 @@ Path::flushFIG( std::ostream & stream,
   if ( _points.empty() )
     return;
 
-  std::vector<Point>::const_iterator i = _points.begin();
-  std::vector<Point>::const_iterator end = _points.end();
-  while ( i != end ) {
-    stream << " " << static_cast<int>( transform.mapX( i->x ) )
-           << " " << static_cast<int>( transform.mapY( i->y ) );
-    ++i;
+  Point mapped[ MapChunk ];
+  for ( std::size_t first = 0; first < _points.size(); first += MapChunk ) {
+    const std::size_t n = std::min( MapChunk, _points.size() - first );
+    transform.mapPoints( &_points[first], n, mapped );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      stream << " " << static_cast<int>( mapped[i].x )
+             << " " << static_cast<int>( mapped[i].y );
+    }
   }
   if ( _closed ) {
     stream << " " << static_cast<int>( transform.mapX( _points.begin()->x ) )
@@ -236,17 +267,20 @@ Path::flushSVGCommands( std::ostream & stream,
 {
   if ( _points.empty() )
     return;
-  std::vector<Point>::const_iterator i = _points.begin();
-  std::vector<Point>::const_iterator end = _points.end();
+  Point mapped[ MapChunk ];
   int count = 0;
-
-  stream << "M " << transform.mapX( i->x ) << " " << transform.mapY( i->y );
-  ++i;
-  while ( i != end ) {
-    stream << " L " << transform.mapX( i->x ) << " " << transform.mapY( i->y );
-    ++i;
-    count = ( count + 1 ) % 6;
-    if ( !count ) stream << "\n                  ";
+  for ( std::size_t first = 0; first < _points.size(); first += MapChunk ) {
+    const std::size_t n = std::min( MapChunk, _points.size() - first );
+    transform.mapPoints( &_points[first], n, mapped );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( first + i ) {
+        stream << " L " << mapped[i].x << " " << mapped[i].y;
+        count = ( count + 1 ) % 6;
+        if ( !count ) stream << "\n                  ";
+      } else {
+        stream << "M " << mapped[i].x << " " << mapped[i].y;
+      }
+    }
   }
   if ( _closed )
     stream << " Z" << std::endl;
@@ -258,16 +292,20 @@ Path::flushSVGPoints( std::ostream & stream,
 {
   if ( _points.empty() )
     return;
-  std::vector<Point>::const_iterator i = _points.begin();
-  std::vector<Point>::const_iterator end = _points.end();
+  Point mapped[ MapChunk ];
   int count = 0;
-  stream << transform.mapX( i->x ) << "," << transform.mapY( i->y );
-  ++i;
-  while ( i != end ) {
-    stream << " " << transform.mapX( i->x ) << "," << transform.mapY( i->y );
-    ++i;
-    count = ( count + 1 ) % 6;
-    if ( !count ) stream << "\n                  ";
+  for ( std::size_t first = 0; first < _points.size(); first += MapChunk ) {
+    const std::size_t n = std::min( MapChunk, _points.size() - first );
+    transform.mapPoints( &_points[first], n, mapped );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( first + i ) {
+        stream << " " << mapped[i].x << "," << mapped[i].y;
+        count = ( count + 1 ) % 6;
+        if ( !count ) stream << "\n                  ";
+      } else {
+        stream << mapped[i].x << "," << mapped[i].y;
+      }
+    }
   }
 }
 
@@ -277,14 +315,16 @@ Path::flushTikZPoints( std::ostream & stream,
 {
   if ( _points.empty() )
     return;
-  std::vector<Point>::const_iterator i = _points.begin();
-  std::vector<Point>::const_iterator end = _points.end();
-  stream << '(' << transform.mapX( i->x ) << "," << transform.mapY( i->y ) << ')';
-  ++i;
-  while ( i != end ) {
-    stream << " -- "
-           << '(' << transform.mapX( i->x ) << "," << transform.mapY( i->y ) << ')';
-    ++i;
+  Point mapped[ MapChunk ];
+  for ( std::size_t first = 0; first < _points.size(); first += MapChunk ) {
+    const std::size_t n = std::min( MapChunk, _points.size() - first );
+    transform.mapPoints( &_points[first], n, mapped );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( first + i ) {
+        stream << " -- ";
+      }
+      stream << '(' << mapped[i].x << "," << mapped[i].y << ')';
+    }
   }
 }
 
@@ -293,14 +333,26 @@ Path::boundingBox() const
 {
   if ( _points.empty() )
     return Rect( 0, 0, 0, 0 );
-  std::vector< Point >::const_iterator it = _points.begin();
-  std::vector< Point >::const_iterator end = _points.end();
-  Rect rect(*it,0.0,0.0);
-  ++it;
-  while ( it != end ) {
-    rect.growToContain(*it++);
+  // Each range of points is bounded on its own. Minima and maxima are
+  // exact, so the box does not depend on the ranges.
+  const std::vector<Point> & points = _points;
+  // A single range (the common case of a short path) needs no storage.
+  const std::size_t ranges = ThreadPool::ranges( points.size(), ParallelGrain );
+  Bounds single( points[0] );
+  std::vector<Bounds> bounds( ranges > 1 ? ranges : 0 );
+  Bounds * const out = ( ranges > 1 ) ? &bounds[0] : &single;
+  ThreadPool::parallelFor( points.size(), ParallelGrain,
+                           [&points,out]( std::size_t range, std::size_t first, std::size_t last ) {
+                             Bounds & b = out[range] = Bounds( points[first] );
+                             for ( std::size_t k = first + 1; k < last; ++k ) {
+                               b.add( points[k] );
+                             }
+                           } );
+  for ( std::size_t range = 1; range < ranges; ++range ) {
+    out[0].add( out[range] );
   }
-  return rect;
+  const Bounds & b = out[0];
+  return Rect( b.left, b.top, b.right - b.left, b.top - b.bottom );
 }
 
 const
@@ -26,6 +26,7 @@
 #include "BoardConfig.h"
 #include "board/PathBoundaries.h"
 #include "board/Shapes.h"
+#include "board/Trace.h"
 #include <algorithm>
 #include <iterator>
 #include <set>
@@ -360,22 +361,188 @@ pathBoundaryPoints(const Path & path,
   return result;
 }
 
+namespace {
+
+/*
+ * A bounding box being built, point after point.
+ */
+struct BoxBuilder {
+  BoxBuilder() : empty(true), left(0), right(0), bottom(0), top(0) { }
+  void add(const Point & p) {
+    if ( empty ) {
+      left = right = p.x;
+      bottom = top = p.y;
+      empty = false;
+      return;
+    }
+    if ( p.x < left ) left = p.x;
+    if ( p.x > right ) right = p.x;
+    if ( p.y < bottom ) bottom = p.y;
+    if ( p.y > top ) top = p.y;
+  }
+  Rect rect() const {
+    return empty ? Rect() : Rect(left,top,right-left,top-bottom);
+  }
+  bool empty;
+  double left, right, bottom, top;
+};
+
+inline double
+cross(const Point & u, const Point & v)
+{
+  return u.x * v.y - u.y * v.x;
+}
+
+/*
+ * Adds the points of a circle (center c, radius r) that are extreme
+ * along the axes, and that lie on the arc going counterclockwise from
+ * direction u to direction v (unit vectors, less than half a turn apart).
+ * A null arc stands for the whole circle; a half turn is the half circle
+ * on the side of direction w.
+ */
+void
+addArcExtremities(BoxBuilder & box, const Point & c, double r,
+                  const Point & u, const Point & v, const Point & w)
+{
+  static const Point axes[4] = { Point(1,0), Point(0,1), Point(-1,0), Point(0,-1) };
+  const double uv = cross(u,v);
+  for ( int k = 0; k < 4; ++k ) {
+    const Point & d = axes[k];
+    bool inside;
+    if ( uv > 0.0 ) {
+      inside = cross(u,d) >= 0.0 && cross(d,v) >= 0.0;
+    } else if ( uv < 0.0 ) {
+      inside = cross(u,d) <= 0.0 && cross(d,v) <= 0.0;
+    } else if ( u * v > 0.0 ) {
+      inside = true;
+    } else {
+      inside = d * w >= 0.0;
+    }
+    if ( inside ) {
+      box.add(c + r * d);
+    }
+  }
+}
+
+void
+addRoundJoin(BoxBuilder & box, const Point & p1, const Point & p2, const Point & p3, double strokeWidth)
+{
+  Point va(p2-p1);
+  Point vb(p3-p2);
+  Point na = va.rotatedPI2().normalise();
+  Point nb = vb.rotatedPI2().normalise();
+  if ( na * vb > 0.0 ) {
+    // Left turn: the exterior is on the right, the arc goes counterclockwise.
+    addArcExtremities(box,p2,0.5*strokeWidth,-na,-nb,va);
+  } else {
+    // Right turn (or no turn): the arc goes clockwise on the left.
+    addArcExtremities(box,p2,0.5*strokeWidth,nb,na,va);
+  }
+}
+
+void
+addRoundCap(BoxBuilder & box, const Point & p1, const Point & p2, double strokeWidth)
+{
+  Point v(p2-p1);
+  const double r = 0.5 * strokeWidth;
+  if ( v.x >= 0.0 ) box.add(Point(p2.x + r, p2.y));
+  if ( v.x <= 0.0 ) box.add(Point(p2.x - r, p2.y));
+  if ( v.y >= 0.0 ) box.add(Point(p2.x, p2.y + r));
+  if ( v.y <= 0.0 ) box.add(Point(p2.x, p2.y - r));
+}
+
+void
+addCap(BoxBuilder & box, const Point & p, const Point & q, double strokeWidth, Shape::LineCap lineCap)
+{
+  Point a,b;
+  switch ( lineCap ) {
+  case Shape::ButtCap:
+    butCapExtremities(p,q,strokeWidth,a,b);
+    box.add(a);
+    box.add(b);
+    break;
+  case Shape::SquareCap:
+    squareCapExtremities(p,q,strokeWidth,a,b);
+    box.add(a);
+    box.add(b);
+    break;
+  case Shape::RoundCap:
+    addRoundCap(box,p,q,strokeWidth);
+    break;
+  }
+}
+
+}
+
 Rect
 pathBoundingBox(const Path & path, double strokeWidth, Shape::LineCap lineCap, Shape::LineJoin lineJoin, double miterLimit)
 {
   if ( strokeWidth == 0.0 ) {
     return path.boundingBox();
   }
-  std::vector<Point> v = pathBoundaryPoints(path,strokeWidth,lineCap,lineJoin,miterLimit);
-  std::vector<Point>::iterator it = v.begin();
-  if ( it == v.end() ) {
+  if ( ! path.size() ) {
     return Rect();
   }
-  Rect result(*it);
-  while (it != v.end()) {
-    result.growToContain(*it++);
+  return pathBoundingBox(&path[0],path.size(),path.closed(),strokeWidth,lineCap,lineJoin,miterLimit);
+}
+
+Rect
+pathBoundingBox(const Point * points, std::size_t n, bool closed,
+                double strokeWidth, Shape::LineCap lineCap, Shape::LineJoin lineJoin, double miterLimit)
+{
+  BOARD_TRACE_SCOPE_ARG( "Tools::pathBoundingBox", n );
+  BoxBuilder box;
+  if ( strokeWidth == 0.0 ) {
+    for ( std::size_t i = 0; i < n; ++i ) {
+      box.add(points[i]);
+    }
+    return box.rect();
+  }
+  if ( closed ) {
+    // Points repeating the first one at the end are ignored.
+    while ( n > 1 && points[0] == points[n-1] ) {
+      --n;
+    }
   }
-  return result;
+  if ( n <= 1 ) {
+    if ( n ) box.add(points[0]);
+    return box.rect();
+  }
+  const std::size_t limit = closed ? n : (n-2);
+  for ( std::size_t i = 0; i < limit; ++i ) {
+    const Point & p0 = points[i];
+    const Point & p1 = points[(i+1)%n];
+    const Point & p2 = points[(i+2)%n];
+    switch ( lineJoin ) {
+    case Shape::MiterJoin:
+      if ( isASharpCorner(p0,p1,p2)
+           && (1/sin(sharpCornerAngle(p0,p1,p2)/2.0)) > miterLimit ) { // Fallback to BevelJoin
+        Point a,b;
+        exteriorBevelIntersection(p0,p1,p2,strokeWidth,a,b);
+        box.add(a);
+        box.add(b);
+      } else {
+        box.add(exteriorMiterIntersection(p0,p1,p2,strokeWidth));
+      }
+      break;
+    case Shape::BevelJoin:
+    {
+      Point a,b;
+      exteriorBevelIntersection(p0,p1,p2,strokeWidth,a,b);
+      box.add(a);
+      box.add(b);
+    }
+      break;
+    case Shape::RoundJoin:
+      addRoundJoin(box,p0,p1,p2,strokeWidth);
+      break;
+    }
+  }
+  if ( ! closed ) {
+    addCap(box,points[1],points[0],strokeWidth,lineCap);
+    addCap(box,points[n-2],points[n-1],strokeWidth,lineCap);
+  }
+  return box.rect();
 }
 
 }  // namespace Tools;
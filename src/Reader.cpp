@@ -0,0 +1,1544 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Reader.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Reading back the SVG and XFig files written by the library.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/Reader.h"
+#include "board/ShapeList.h"
+#include "board/Shapes.h"
+#include "board/PSFonts.h"
+#include "board/Tools.h"
+#include "board/Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#if ( _BOARD_WIN32_ == 0 )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace PlaneDraw;
+
+const double ppmm = 72.0 / 25.4;
+
+/*
+ * Lexical tools, on characters read in place.
+ */
+
+// A range of characters of the document.
+struct Chars {
+  const char * begin;
+  const char * end;
+  Chars() : begin( 0 ), end( 0 ) { }
+  Chars( const char * begin, const char * end ) : begin( begin ), end( end ) { }
+  bool empty() const { return begin == end; }
+  std::size_t size() const { return end - begin; }
+  bool operator==( const char * s ) const {
+    const std::size_t n = std::strlen( s );
+    return size() == n && ! std::memcmp( begin, s, n );
+  }
+  bool operator!=( const char * s ) const { return ! ( *this == s ); }
+  bool operator==( const Chars & other ) const {
+    return size() == other.size() && ! std::memcmp( begin, other.begin, size() );
+  }
+  bool operator!=( const Chars & other ) const { return ! ( *this == other ); }
+  bool startsWith( const char * s ) const {
+    const std::size_t n = std::strlen( s );
+    return size() >= n && ! std::memcmp( begin, s, n );
+  }
+  std::string str() const { return std::string( begin, end ); }
+};
+
+inline bool
+isSpace( char c )
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// The first c in [p, end), or 0. An empty range (possibly two null
+// pointers, for an empty input) is not passed to memchr().
+inline const char *
+findChar( const char * p, const char * end, char c )
+{
+  return ( p == end ) ? 0 : static_cast<const char*>( std::memchr( p, c, end - p ) );
+}
+
+inline void
+skipSpaces( const char *& p, const char * end )
+{
+  while ( p != end && isSpace( *p ) ) ++p;
+}
+
+// Spaces and at most one comma, between the numbers of SVG attributes.
+inline void
+skipSeparators( const char *& p, const char * end )
+{
+  skipSpaces( p, end );
+  if ( p != end && *p == ',' ) {
+    ++p;
+    skipSpaces( p, end );
+  }
+}
+
+// Reads a decimal number. Unlike strtod(), needs neither a terminating
+// NUL nor the C locale.
+bool
+readNumber( const char *& p, const char * end, double & value )
+{
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                   1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                   1e20, 1e21, 1e22 };
+  const char * q = p;
+  bool negative = false;
+  if ( q != end && ( *q == '-' || *q == '+' ) ) {
+    negative = ( *q == '-' );
+    ++q;
+  }
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any = false;
+  for ( ; q != end && *q >= '0' && *q <= '9'; ++q, any = true ) {
+    if ( digits < 18 ) {
+      mantissa = 10 * mantissa + ( *q - '0' );
+      if ( mantissa ) ++digits;
+    } else {
+      ++exponent;
+    }
+  }
+  if ( q != end && *q == '.' ) {
+    for ( ++q; q != end && *q >= '0' && *q <= '9'; ++q, any = true ) {
+      if ( digits < 18 ) {
+        mantissa = 10 * mantissa + ( *q - '0' );
+        if ( mantissa ) ++digits;
+        --exponent;
+      }
+    }
+  }
+  if ( ! any ) {
+    return false;
+  }
+  if ( q != end && ( *q == 'e' || *q == 'E' ) ) {
+    const char * e = q + 1;
+    bool negativeExponent = false;
+    if ( e != end && ( *e == '-' || *e == '+' ) ) {
+      negativeExponent = ( *e == '-' );
+      ++e;
+    }
+    if ( e != end && *e >= '0' && *e <= '9' ) {
+      int n = 0;
+      for ( ; e != end && *e >= '0' && *e <= '9'; ++e ) {
+        n = std::min( 10 * n + ( *e - '0' ), 1000 );
+      }
+      exponent += negativeExponent ? -n : n;
+      q = e;
+    }
+  }
+  double x = static_cast<double>( mantissa );
+  if ( exponent < 0 && exponent >= -22 ) {
+    x /= powers[ -exponent ];
+  } else if ( exponent > 0 && exponent <= 22 ) {
+    x *= powers[ exponent ];
+  } else if ( exponent ) {
+    x *= std::pow( 10.0, exponent );
+  }
+  value = negative ? -x : x;
+  p = q;
+  return true;
+}
+
+/*
+ * Affine transforms, as SVG writes them: x' = a x + c y + e, y' = b x + d y + f.
+ */
+struct Affine {
+  double a, b, c, d, e, f;
+  Affine() : a( 1 ), b( 0 ), c( 0 ), d( 1 ), e( 0 ), f( 0 ) { }
+  Affine( double a, double b, double c, double d, double e, double f )
+    : a( a ), b( b ), c( c ), d( d ), e( e ), f( f ) { }
+  Affine operator*( const Affine & m ) const {
+    return Affine( a * m.a + c * m.b, b * m.a + d * m.b,
+                   a * m.c + c * m.d, b * m.c + d * m.d,
+                   a * m.e + c * m.f + e, b * m.e + d * m.f + f );
+  }
+  // Maps a point of the document to the board (millimeters, y up).
+  Point board( double x, double y ) const {
+    return Point( ( a * x + c * y + e ) / ppmm, - ( b * x + d * y + f ) / ppmm );
+  }
+  // The scale factor, for lengths (assuming a similarity).
+  double scale() const { return std::sqrt( std::fabs( a * d - b * c ) ); }
+  // The rotation on the board (y up), in radians.
+  double angle() const { return - std::atan2( b, a ); }
+};
+
+// Parses a transform attribute (matrix, translate, scale and rotate).
+bool
+parseTransform( Chars text, Affine & result )
+{
+  const char * p = text.begin;
+  const char * end = text.end;
+  skipSpaces( p, end );
+  while ( p != end ) {
+    const char * name = p;
+    while ( p != end && *p != '(' && ! isSpace( *p ) ) ++p;
+    const Chars function( name, p );
+    skipSpaces( p, end );
+    if ( p == end || *p != '(' ) return false;
+    ++p;
+    double v[6];
+    int n = 0;
+    skipSpaces( p, end );
+    while ( n < 6 && readNumber( p, end, v[n] ) ) {
+      ++n;
+      skipSeparators( p, end );
+    }
+    if ( p == end || *p != ')' ) return false;
+    ++p;
+    Affine m;
+    if ( function == "matrix" && n == 6 ) {
+      m = Affine( v[0], v[1], v[2], v[3], v[4], v[5] );
+    } else if ( function == "translate" && n >= 1 ) {
+      m = Affine( 1, 0, 0, 1, v[0], ( n > 1 ) ? v[1] : 0.0 );
+    } else if ( function == "scale" && n >= 1 ) {
+      m = Affine( v[0], 0, 0, ( n > 1 ) ? v[1] : v[0], 0, 0 );
+    } else if ( function == "rotate" && ( n == 1 || n == 3 ) ) {
+      const double angle = v[0] * M_PI / 180.0;
+      const double co = std::cos( angle );
+      const double si = std::sin( angle );
+      m = Affine( co, si, -si, co, 0, 0 );
+      if ( n == 3 ) {
+        m = Affine( 1, 0, 0, 1, v[1], v[2] ) * m * Affine( 1, 0, 0, 1, -v[1], -v[2] );
+      }
+    } else {
+      return false;
+    }
+    result = result * m;
+    skipSeparators( p, end );
+  }
+  return true;
+}
+
+/*
+ * A streaming XML scanner, enough for the SVG files of the library.
+ */
+struct Attribute {
+  Chars name;
+  Chars value;
+};
+
+struct Tag {
+  Chars name;
+  bool closing;
+  bool empty;                           /**< <tag ... /> */
+  std::vector<Attribute> attributes;
+  Chars attribute( const char * name ) const {
+    for ( std::size_t i = 0; i < attributes.size(); ++i ) {
+      if ( attributes[i].name == name ) return attributes[i].value;
+    }
+    return Chars();
+  }
+  bool has( const char * name ) const {
+    for ( std::size_t i = 0; i < attributes.size(); ++i ) {
+      if ( attributes[i].name == name ) return true;
+    }
+    return false;
+  }
+};
+
+class XMLScanner {
+public:
+  XMLScanner( const char * begin, const char * end )
+    : _begin( begin ), _p( begin ), _end( end ) { }
+
+  enum Token { Element, EndOfDocument, Malformed };
+
+  // Reads the next tag, and the character data before it.
+  Token next( Tag & tag, Chars & text );
+
+  // The line of the current position, for error messages.
+  std::size_t line() const { return 1 + std::count( _begin, _p, '\n' ); }
+
+private:
+  bool skipPast( const char * delimiter );
+  Chars name();
+
+  const char * _begin;
+  const char * _p;
+  const char * _end;
+};
+
+bool
+XMLScanner::skipPast( const char * delimiter )
+{
+  const std::size_t n = std::strlen( delimiter );
+  while ( _p != _end ) {
+    const char * q = findChar( _p, _end, delimiter[0] );
+    if ( ! q || static_cast<std::size_t>( _end - q ) < n ) {
+      _p = _end;
+      return false;
+    }
+    if ( ! std::memcmp( q, delimiter, n ) ) {
+      _p = q + n;
+      return true;
+    }
+    _p = q + 1;
+  }
+  return false;
+}
+
+Chars
+XMLScanner::name()
+{
+  const char * first = _p;
+  while ( _p != _end && ! isSpace( *_p ) && *_p != '>' && *_p != '/' && *_p != '=' ) ++_p;
+  return Chars( first, _p );
+}
+
+XMLScanner::Token
+XMLScanner::next( Tag & tag, Chars & text )
+{
+  for ( ;; ) {
+    // A '<' which does not start a markup is kept in the text, as older
+    // versions of the library wrote texts unescaped.
+    const char * lt = findChar( _p, _end, '<' );
+    while ( lt && lt + 1 != _end && ! std::isalpha( static_cast<unsigned char>( lt[1] ) )
+            && lt[1] != '_' && lt[1] != '/' && lt[1] != '!' && lt[1] != '?' ) {
+      lt = findChar( lt + 1, _end, '<' );
+    }
+    text = Chars( _p, lt ? lt : _end );
+    if ( ! lt ) {
+      _p = _end;
+      return EndOfDocument;
+    }
+    _p = lt + 1;
+    const Chars rest( _p, _end );
+    if ( rest.startsWith( "!--" ) ) {
+      if ( ! skipPast( "-->" ) ) return Malformed;
+      continue;
+    }
+    if ( rest.startsWith( "?" ) ) {
+      if ( ! skipPast( "?>" ) ) return Malformed;
+      continue;
+    }
+    if ( rest.startsWith( "!" ) ) {
+      if ( ! skipPast( ">" ) ) return Malformed;
+      continue;
+    }
+    tag.attributes.clear();
+    tag.closing = tag.empty = false;
+    if ( _p != _end && *_p == '/' ) {
+      tag.closing = true;
+      ++_p;
+    }
+    tag.name = name();
+    if ( tag.name.empty() ) return Malformed;
+    for ( ;; ) {
+      skipSpaces( _p, _end );
+      if ( _p == _end ) return Malformed;
+      if ( *_p == '>' ) {
+        ++_p;
+        return Element;
+      }
+      if ( *_p == '/' ) {
+        if ( _end - _p < 2 || _p[1] != '>' ) return Malformed;
+        _p += 2;
+        tag.empty = true;
+        return Element;
+      }
+      Attribute attribute;
+      attribute.name = name();
+      skipSpaces( _p, _end );
+      if ( attribute.name.empty() || _p == _end || *_p != '=' ) return Malformed;
+      ++_p;
+      skipSpaces( _p, _end );
+      if ( _p == _end || ( *_p != '"' && *_p != '\'' ) ) return Malformed;
+      const char * close = findChar( _p + 1, _end, *_p );
+      if ( ! close ) return Malformed;
+      attribute.value = Chars( _p + 1, close );
+      _p = close + 1;
+      tag.attributes.push_back( attribute );
+    }
+  }
+}
+
+// Replaces the predefined entities and character references.
+std::string
+unescape( Chars text )
+{
+  std::string result;
+  result.reserve( text.size() );
+  for ( const char * p = text.begin; p != text.end; ++p ) {
+    if ( *p != '&' ) {
+      result += *p;
+      continue;
+    }
+    const char * semicolon = findChar( p, text.end, ';' );
+    if ( ! semicolon ) {
+      // A bare ampersand, as the library writes it.
+      result += *p;
+      continue;
+    }
+    const Chars entity( p + 1, semicolon );
+    if ( entity == "lt" ) result += '<';
+    else if ( entity == "gt" ) result += '>';
+    else if ( entity == "amp" ) result += '&';
+    else if ( entity == "quot" ) result += '"';
+    else if ( entity == "apos" ) result += '\'';
+    else if ( entity.startsWith( "#" ) ) {
+      const bool hexadecimal = entity.size() > 1 && ( entity.begin[1] == 'x' || entity.begin[1] == 'X' );
+      const unsigned long code = std::strtoul( std::string( entity.begin + ( hexadecimal ? 2 : 1 ), entity.end ).c_str(), 0, hexadecimal ? 16 : 10 );
+      result += static_cast<char>( code < 256 ? code : '?' );
+    } else {
+      result += *p;
+      continue;
+    }
+    p = semicolon;
+  }
+  return result;
+}
+
+bool
+parseColor( Chars text, Color & color )
+{
+  static const struct { const char * name; unsigned int rgb; } names[] = {
+    { "black", 0x000000 }, { "white", 0xFFFFFF }, { "red", 0xFF0000 }, { "green", 0x008000 },
+    { "blue", 0x0000FF }, { "yellow", 0xFFFF00 }, { "cyan", 0x00FFFF }, { "magenta", 0xFF00FF },
+    { "gray", 0x808080 }, { "grey", 0x808080 }, { "silver", 0xC0C0C0 }, { "maroon", 0x800000 },
+    { "purple", 0x800080 }, { "lime", 0x00FF00 }, { "olive", 0x808000 }, { "navy", 0x000080 },
+    { "teal", 0x008080 }, { "orange", 0xFFA500 }
+  };
+  while ( ! text.empty() && isSpace( text.begin[0] ) ) ++text.begin;
+  while ( ! text.empty() && isSpace( text.end[-1] ) ) --text.end;
+  if ( text == "none" || text.startsWith( "url(" ) ) {
+    // Patterns are not read back.
+    color = Color::Null;
+    return true;
+  }
+  if ( text.startsWith( "rgb(" ) ) {
+    const char * p = text.begin + 4;
+    double v[3];
+    for ( int i = 0; i < 3; ++i ) {
+      skipSeparators( p, text.end );
+      if ( ! readNumber( p, text.end, v[i] ) ) return false;
+      if ( p != text.end && *p == '%' ) {
+        v[i] *= 2.55;
+        ++p;
+      }
+    }
+    color = Color( static_cast<unsigned char>( std::max( 0.0, std::min( 255.0, v[0] ) ) ),
+                   static_cast<unsigned char>( std::max( 0.0, std::min( 255.0, v[1] ) ) ),
+                   static_cast<unsigned char>( std::max( 0.0, std::min( 255.0, v[2] ) ) ) );
+    return true;
+  }
+  if ( text.startsWith( "#" ) && ( text.size() == 7 || text.size() == 4 ) ) {
+    const unsigned long rgb = std::strtoul( std::string( text.begin + 1, text.end ).c_str(), 0, 16 );
+    if ( text.size() == 7 ) {
+      color = Color( static_cast<unsigned int>( rgb ) );
+    } else {
+      color = Color( static_cast<unsigned char>( 17 * ( ( rgb >> 8 ) & 15 ) ),
+                     static_cast<unsigned char>( 17 * ( ( rgb >> 4 ) & 15 ) ),
+                     static_cast<unsigned char>( 17 * ( rgb & 15 ) ) );
+    }
+    return true;
+  }
+  for ( std::size_t i = 0; i < sizeof( names ) / sizeof( names[0] ); ++i ) {
+    if ( text == names[i].name ) {
+      color = Color( names[i].rgb );
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * SVG
+ */
+
+// The presentation attributes of an element.
+struct Style {
+  Color pen;
+  Color fill;
+  double lineWidth;              /**< In millimeters, before the transform. */
+  Shape::LineStyle lineStyle;
+  Shape::LineCap cap;
+  Shape::LineJoin join;
+  Style()
+    : pen( Color::Null ), fill( Color::Black ), lineWidth( 1.0 / ppmm ),
+      lineStyle( Shape::SolidStyle ), cap( Shape::ButtCap ), join( Shape::MiterJoin ) { }
+};
+
+class SVGReader {
+public:
+  SVGReader( const char * begin, const char * end, ShapeList & shapes )
+    : _scanner( begin, end ), _shapes( shapes ) { }
+
+  bool read();
+
+private:
+
+  // An open element, which shapes go to.
+  struct Frame {
+    Chars name;
+    Affine transform;
+    ShapeList * target;
+    std::unique_ptr<Group> group;    /**< Null if the shapes go to the parent. */
+    bool wrapper;                    /**< A group with a clip-rule, which the
+                                          next clipped group merges into. */
+    bool clipPath;
+    Chars clipId;
+    bool bare;                       /**< A group without attributes, which
+                                          may hold an arrow. */
+    Style shaft;                     /**< The line of an arrow, waiting for its
+                                          head (with its final width). */
+    Point shaftStart;
+    Point shaftEnd;
+    bool pendingShaft;
+  };
+
+  void open( const Tag & tag );
+  void close();
+  void element( const Tag & tag, const std::string & content = std::string() );
+  void style( const Tag & tag, Style & style ) const;
+  void property( const Chars & name, const Chars & value, Style & style ) const;
+  bool points( const Chars & text, const Affine & transform, std::vector<Point> & result ) const;
+  void pathData( const Chars & text, const Affine & transform, std::vector<Path> & result ) const;
+  double number( const Tag & tag, const char * name ) const;
+  template<typename T> void add( T && shape );
+  template<typename T> void add( T && shape, const Affine & transform, const Point & center );
+  void warnOnce( const Chars & name );
+  void flushShaft();
+
+  XMLScanner _scanner;
+  ShapeList & _shapes;
+  std::vector<Frame> _frames;
+  std::map<std::string,Path> _clipPaths;
+  std::set<std::string> _warned;
+  std::size_t _skipped;            /**< Depth of the unknown element being skipped. */
+  bool _malformed;
+};
+
+template<typename T>
+void
+SVGReader::add( T && shape )
+{
+  flushShaft();
+  *_frames.back().target << std::move( shape );
+}
+
+void
+SVGReader::flushShaft()
+{
+  Frame & frame = _frames.back();
+  if ( frame.pendingShaft ) {
+    frame.pendingShaft = false;
+    const Style & s = frame.shaft;
+    *frame.target << Line( frame.shaftStart, frame.shaftEnd, s.pen, s.lineWidth, s.lineStyle, s.cap, s.join );
+  }
+}
+
+double
+SVGReader::number( const Tag & tag, const char * name ) const
+{
+  const Chars text = tag.attribute( name );
+  const char * p = text.begin;
+  double value = 0.0;
+  skipSpaces( p, text.end );
+  if ( ! readNumber( p, text.end, value ) ) {
+    return 0.0;
+  }
+  return value;
+}
+
+void
+SVGReader::warnOnce( const Chars & name )
+{
+  if ( _warned.insert( name.str() ).second ) {
+    Tools::warning << "Reader: SVG element <" << name.str() << "> is not supported (line "
+                   << _scanner.line() << ").\n";
+  }
+}
+
+void
+SVGReader::property( const Chars & name, const Chars & value, Style & style ) const
+{
+  Color color;
+  if ( name == "fill" ) {
+    if ( parseColor( value, color ) ) style.fill = color;
+  } else if ( name == "stroke" ) {
+    if ( parseColor( value, color ) ) style.pen = color;
+  } else if ( name == "fill-opacity" || name == "stroke-opacity" ) {
+    const char * p = value.begin;
+    double alpha;
+    skipSpaces( p, value.end );
+    if ( readNumber( p, value.end, alpha ) ) {
+      Color & target = ( name == "fill-opacity" ) ? style.fill : style.pen;
+      if ( target.valid() ) {
+        target.alpha( static_cast<unsigned char>( 255 * std::max( 0.0, std::min( 1.0, alpha ) ) + 0.5 ) );
+      }
+    }
+  } else if ( name == "stroke-width" ) {
+    const char * p = value.begin;
+    double width;
+    skipSpaces( p, value.end );
+    if ( readNumber( p, value.end, width ) ) {
+      style.lineWidth = Chars( p, value.end ).startsWith( "mm" ) ? width : width / ppmm;
+    }
+  } else if ( name == "stroke-linecap" ) {
+    style.cap = ( value == "round" ) ? Shape::RoundCap : ( value == "square" ) ? Shape::SquareCap : Shape::ButtCap;
+  } else if ( name == "stroke-linejoin" ) {
+    style.join = ( value == "round" ) ? Shape::RoundJoin : ( value == "bevel" ) ? Shape::BevelJoin : Shape::MiterJoin;
+  } else if ( name == "stroke-dasharray" ) {
+    // The dash styles are told apart by the number of dashes (see
+    // xFigDashStylesSVG), dots by their first length.
+    const char * p = value.begin;
+    double first = 0.0, length;
+    int count = 0;
+    skipSpaces( p, value.end );
+    while ( readNumber( p, value.end, length ) ) {
+      if ( ! count++ ) first = length;
+      skipSeparators( p, value.end );
+    }
+    switch ( count ) {
+    case 0: style.lineStyle = Shape::SolidStyle; break;
+    case 2: style.lineStyle = ( first > 1.2 ) ? Shape::DotStyle : Shape::DashStyle; break;
+    case 4: style.lineStyle = Shape::DashDotStyle; break;
+    case 6: style.lineStyle = Shape::DashDotDotStyle; break;
+    default: style.lineStyle = Shape::DashDotDotDotStyle; break;
+    }
+  }
+}
+
+void
+SVGReader::style( const Tag & tag, Style & style ) const
+{
+  for ( std::size_t i = 0; i < tag.attributes.size(); ++i ) {
+    const Attribute & attribute = tag.attributes[i];
+    if ( attribute.name != "style" ) {
+      property( attribute.name, attribute.value, style );
+      continue;
+    }
+    // style="name:value;name:value"
+    const char * p = attribute.value.begin;
+    const char * end = attribute.value.end;
+    while ( p != end ) {
+      const char * semicolon = std::find( p, end, ';' );
+      const char * colon = std::find( p, semicolon, ':' );
+      if ( colon != semicolon ) {
+        Chars name( p, colon );
+        Chars value( colon + 1, semicolon );
+        while ( ! name.empty() && isSpace( name.begin[0] ) ) ++name.begin;
+        while ( ! name.empty() && isSpace( name.end[-1] ) ) --name.end;
+        while ( ! value.empty() && isSpace( value.begin[0] ) ) ++value.begin;
+        while ( ! value.empty() && isSpace( value.end[-1] ) ) --value.end;
+        property( name, value, style );
+      }
+      p = ( semicolon == end ) ? end : semicolon + 1;
+    }
+  }
+}
+
+bool
+SVGReader::points( const Chars & text, const Affine & transform, std::vector<Point> & result ) const
+{
+  const char * p = text.begin;
+  double x, y;
+  skipSpaces( p, text.end );
+  while ( readNumber( p, text.end, x ) ) {
+    skipSeparators( p, text.end );
+    if ( ! readNumber( p, text.end, y ) ) return false;
+    result.push_back( transform.board( x, y ) );
+    skipSeparators( p, text.end );
+  }
+  return p == text.end;
+}
+
+void
+SVGReader::pathData( const Chars & text, const Affine & transform, std::vector<Path> & result ) const
+{
+  const char * p = text.begin;
+  const char * end = text.end;
+  char command = 0;
+  double x = 0.0, y = 0.0, startX = 0.0, startY = 0.0;
+  skipSpaces( p, end );
+  while ( p != end ) {
+    if ( ( *p >= 'A' && *p <= 'Z' ) || ( *p >= 'a' && *p <= 'z' ) ) {
+      command = *p++;
+      skipSpaces( p, end );
+      if ( command == 'Z' || command == 'z' ) {
+        if ( ! result.empty() ) result.back().setClosed( true );
+        x = startX;
+        y = startY;
+        continue;
+      }
+    }
+    double u, v = 0.0;
+    if ( ! readNumber( p, end, u ) ) {
+      // An unsupported command, or garbage: the rest is ignored.
+      return;
+    }
+    skipSeparators( p, end );
+    const bool relative = ( command >= 'a' && command <= 'z' );
+    switch ( command ) {
+    case 'M': case 'm': case 'L': case 'l':
+      if ( ! readNumber( p, end, v ) ) return;
+      x = relative ? x + u : u;
+      y = relative ? y + v : v;
+      break;
+    case 'H': case 'h':
+      x = relative ? x + u : u;
+      break;
+    case 'V': case 'v':
+      y = relative ? y + u : u;
+      break;
+    default:
+      return;
+    }
+    if ( command == 'M' || command == 'm' ) {
+      result.push_back( Path() );
+      startX = x;
+      startY = y;
+      // Further coordinates are implicit lineto commands.
+      command = relative ? 'l' : 'L';
+    } else if ( result.empty() ) {
+      result.push_back( Path() );
+    }
+    result.back() << transform.board( x, y );
+    skipSeparators( p, end );
+  }
+}
+
+template<typename T>
+void
+SVGReader::add( T && shape, const Affine & transform, const Point & center )
+{
+  // The shape was built at its place: the rotation part of the transform
+  // remains.
+  const double angle = transform.angle();
+  if ( std::fabs( angle ) > 1e-12 ) {
+    shape.rotate( angle, center );
+  }
+  add( std::move( shape ) );
+}
+
+void
+SVGReader::element( const Tag & tag, const std::string & content )
+{
+  Frame & frame = _frames.back();
+  Affine transform = frame.transform;
+  if ( tag.has( "transform" ) && ! parseTransform( tag.attribute( "transform" ), transform ) ) {
+    Tools::warning << "Reader: unsupported transform (line " << _scanner.line() << ").\n";
+  }
+  if ( frame.clipPath ) {
+    if ( tag.name == "path" && ! frame.clipId.empty() ) {
+      std::vector<Path> paths;
+      pathData( tag.attribute( "d" ), transform, paths );
+      if ( ! paths.empty() ) {
+        _clipPaths[ frame.clipId.str() ] = paths.front();
+      }
+    } else if ( tag.name == "rect" && ! frame.clipId.empty() ) {
+      const double x = number( tag, "x" ), y = number( tag, "y" );
+      const double w = number( tag, "width" ), h = number( tag, "height" );
+      Path path( true );
+      path << transform.board( x, y ) << transform.board( x + w, y )
+           << transform.board( x + w, y + h ) << transform.board( x, y + h );
+      _clipPaths[ frame.clipId.str() ] = path;
+    }
+    return;
+  }
+  Style s;
+  style( tag, s );
+  const double scale = transform.scale();
+  const double lineWidth = s.lineWidth * scale;
+  if ( tag.name == "line" ) {
+    add( Line( transform.board( number( tag, "x1" ), number( tag, "y1" ) ),
+               transform.board( number( tag, "x2" ), number( tag, "y2" ) ),
+               s.pen, lineWidth, s.lineStyle, s.cap, s.join ) );
+  } else if ( tag.name == "polyline" || tag.name == "polygon" ) {
+    std::vector<Point> vertices;
+    if ( ! points( tag.attribute( "points" ), transform, vertices ) ) {
+      Tools::warning << "Reader: bad points (line " << _scanner.line() << ").\n";
+      return;
+    }
+    const bool closed = ( tag.name == "polygon" );
+    if ( closed && vertices.size() > 1 && vertices.front() == vertices.back() ) {
+      vertices.pop_back();
+    }
+    if ( closed && frame.pendingShaft && vertices.size() == 3 ) {
+      // The head of an arrow, whose tip is the second point.
+      const Style & shaft = frame.shaft;
+      frame.pendingShaft = false;
+      add( Arrow( frame.shaftStart, vertices[1], shaft.pen, s.fill, shaft.lineWidth,
+                  shaft.lineStyle, shaft.cap, shaft.join ) );
+      return;
+    }
+    add( Polyline( Path( std::move( vertices ), closed ), s.pen, s.fill, lineWidth, s.lineStyle, s.cap, s.join ) );
+  } else if ( tag.name == "path" ) {
+    std::vector<Path> paths;
+    pathData( tag.attribute( "d" ), transform, paths );
+    for ( std::size_t i = 0; i < paths.size(); ++i ) {
+      Path & path = paths[i];
+      if ( path.size() == 2 && ! s.fill.valid() ) {
+        if ( frame.bare && paths.size() == 1 ) {
+          // Possibly the line of an arrow.
+          flushShaft();
+          frame.shaft = s;
+          frame.shaft.lineWidth = lineWidth;
+          frame.shaftStart = path[0];
+          frame.shaftEnd = path[1];
+          frame.pendingShaft = true;
+        } else {
+          add( Line( path[0], path[1], s.pen, lineWidth, s.lineStyle, s.cap, s.join ) );
+        }
+      } else if ( path.size() ) {
+        if ( path.closed() && path.size() > 1 && path[0] == path[ path.size() - 1 ] ) {
+          path.pop_back();
+        }
+        add( Polyline( path, s.pen, s.fill, lineWidth, s.lineStyle, s.cap, s.join ) );
+      }
+    }
+  } else if ( tag.name == "rect" ) {
+    const double x = number( tag, "x" ), y = number( tag, "y" );
+    const double w = number( tag, "width" ), h = number( tag, "height" );
+    const Point center = transform.board( x + w / 2, y + h / 2 );
+    const double width = w * scale / ppmm, height = h * scale / ppmm;
+    Rectangle rectangle( center.x - width / 2, center.y + height / 2, width, height,
+                         s.pen, s.fill, lineWidth, s.lineStyle, s.cap, s.join );
+    add( std::move( rectangle ), transform, center );
+  } else if ( tag.name == "circle" ) {
+    Circle circle( transform.board( number( tag, "cx" ), number( tag, "cy" ) ),
+                   number( tag, "r" ) * scale / ppmm, s.pen, s.fill, lineWidth, s.lineStyle );
+    add( std::move( circle ) );
+  } else if ( tag.name == "ellipse" ) {
+    const Point center = transform.board( number( tag, "cx" ), number( tag, "cy" ) );
+    Ellipse ellipse( center, number( tag, "rx" ) * scale / ppmm, number( tag, "ry" ) * scale / ppmm,
+                     s.pen, s.fill, lineWidth, s.lineStyle );
+    add( std::move( ellipse ), transform, center );
+  } else if ( tag.name == "text" ) {
+    const Chars family = tag.attribute( "font-family" );
+    Fonts::Font font = Fonts::TimesRoman;
+    bool postscript = false;
+    for ( int f = Fonts::TimesRoman; f <= Fonts::ZapfDingbats; ++f ) {
+      if ( family == PSFontNames[f] ) {
+        font = static_cast<Fonts::Font>( f );
+        postscript = true;
+        break;
+      }
+    }
+    const Point position = transform.board( number( tag, "x" ), number( tag, "y" ) );
+    Text label( position, content, font, postscript ? std::string() : family.str(),
+                number( tag, "font-size" ) * scale / ppmm, s.fill.valid() ? s.fill : Color::Black );
+    add( std::move( label ), transform, position );
+  } else {
+    warnOnce( tag.name );
+  }
+}
+
+void
+SVGReader::open( const Tag & tag )
+{
+  Frame frame;
+  frame.name = tag.name;
+  frame.transform = _frames.back().transform;
+  frame.target = _frames.back().target;
+  frame.wrapper = false;
+  frame.bare = false;
+  frame.pendingShaft = false;
+  frame.clipPath = _frames.back().clipPath;
+  if ( tag.has( "transform" ) && ! parseTransform( tag.attribute( "transform" ), frame.transform ) ) {
+    Tools::warning << "Reader: unsupported transform (line " << _scanner.line() << ").\n";
+  }
+  if ( tag.name == "clipPath" ) {
+    frame.clipPath = true;
+    frame.clipId = tag.attribute( "id" );
+  } else if ( tag.name == "g" && ! frame.clipPath ) {
+    const Chars clip = tag.attribute( "clip-path" );
+    Frame & parent = _frames.back();
+    Path clippingPath;
+    if ( clip.startsWith( "url(#" ) ) {
+      const std::map<std::string,Path>::const_iterator it = _clipPaths.find( std::string( clip.begin + 5, clip.end - 1 ) );
+      if ( it != _clipPaths.end() ) {
+        clippingPath = it->second;
+      }
+    }
+    if ( clippingPath.size() > 2 && parent.wrapper && parent.group->size() == 0 ) {
+      // The library writes a clipped group as two nested groups.
+      parent.group->setClippingPath( clippingPath );
+      parent.wrapper = false;
+    } else if ( tag.attributes.size() == tag.has( "transform" ) ) {
+      // A transform alone does not make a group.
+      frame.bare = true;
+    } else {
+      frame.group.reset( new Group );
+      frame.target = frame.group.get();
+      frame.wrapper = tag.has( "clip-rule" ) && clippingPath.size() < 3;
+      if ( clippingPath.size() > 2 ) {
+        frame.group->setClippingPath( clippingPath );
+      }
+    }
+  } else if ( tag.name != "svg" ) {
+    // defs, pattern, image, ... and their content
+    if ( tag.name != "defs" && tag.name != "desc" && tag.name != "title" && tag.name != "metadata" ) {
+      warnOnce( tag.name );
+    }
+    _skipped = 1;
+    return;
+  }
+  _frames.push_back( std::move( frame ) );
+}
+
+void
+SVGReader::close()
+{
+  flushShaft();
+  Frame & frame = _frames.back();
+  if ( frame.group ) {
+    Frame & parent = _frames[ _frames.size() - 2 ];
+    if ( frame.group->size() ) {
+      *parent.target << std::move( *frame.group );
+    }
+  }
+  _frames.pop_back();
+}
+
+bool
+SVGReader::read()
+{
+  BOARD_TRACE_SCOPE( "Reader::readSVG" );
+  Frame root;
+  root.target = &_shapes;
+  root.wrapper = false;
+  root.clipPath = false;
+  root.bare = false;
+  root.pendingShaft = false;
+  _frames.push_back( std::move( root ) );
+  _skipped = 0;
+  Tag tag;
+  Chars text;
+  bool inText = false;
+  Tag textTag;
+  std::string content;
+  for ( ;; ) {
+    switch ( _scanner.next( tag, text ) ) {
+    case XMLScanner::EndOfDocument:
+      if ( _frames.size() != 1 || _skipped ) {
+        Tools::error << "Reader: unexpected end of the SVG document.\n";
+        return false;
+      }
+      return true;
+    case XMLScanner::Malformed:
+      Tools::error << "Reader: malformed SVG document (line " << _scanner.line() << ").\n";
+      return false;
+    case XMLScanner::Element:
+      break;
+    }
+    if ( _skipped ) {
+      // Inside an unsupported element.
+      if ( tag.closing ) --_skipped;
+      else if ( ! tag.empty ) ++_skipped;
+      continue;
+    }
+    if ( inText ) {
+      // The content of a text, up to </text> (tspan tags are ignored).
+      content += unescape( text );
+      if ( tag.closing && tag.name == "text" ) {
+        inText = false;
+        element( textTag, content );
+      }
+      continue;
+    }
+    if ( tag.closing ) {
+      if ( _frames.size() < 2 || tag.name != _frames.back().name ) {
+        Tools::error << "Reader: unexpected </" << tag.name.str() << "> (line " << _scanner.line() << ").\n";
+        return false;
+      }
+      close();
+      continue;
+    }
+    if ( tag.name == "text" && ! tag.empty ) {
+      inText = true;
+      textTag = tag;
+      content.clear();
+      continue;
+    }
+    const bool container = ( tag.name == "g" || tag.name == "svg" || tag.name == "clipPath"
+                             || tag.name == "defs" || tag.name == "pattern" || tag.name == "desc"
+                             || tag.name == "title" || tag.name == "metadata" );
+    if ( container ) {
+      if ( tag.empty ) continue;
+      open( tag );
+    } else if ( ! tag.empty ) {
+      // An element with content: read as empty, its content skipped.
+      element( tag );
+      _skipped = 1;
+    } else {
+      element( tag );
+    }
+  }
+}
+
+/*
+ * XFig
+ */
+
+class FIGReader {
+public:
+  FIGReader( const char * begin, const char * end, ShapeList & shapes )
+    : _begin( begin ), _p( begin ), _end( end ), _shapes( shapes ), _unitsPerMM( 1143 / 25.4 ) { }
+
+  bool read();
+
+private:
+
+  // The fields common to arcs, ellipses, polylines and splines.
+  struct Graphics {
+    int subtype, lineStyle, thickness, penColor, fillColor, depth, penStyle, areaFill;
+    double styleValue;
+  };
+
+  bool integer( int & value );
+  bool real( double & value );
+  bool graphics( Graphics & g );
+  bool points( int count, std::vector<Point> & result );
+  bool skipArrows( int forward, int backward );
+  void skipLine();
+  bool fail( const char * what );
+
+  Color color( int index ) const;
+  Color pen( const Graphics & g ) const;
+  Color fill( const Graphics & g, Hatch & hatch ) const;
+  double width( const Graphics & g ) const { return g.thickness * 25.4 / 80; }
+  Shape::LineStyle lineStyle( const Graphics & g ) const {
+    return ( g.lineStyle > 0 && g.lineStyle <= Shape::DashDotDotDotStyle ) ? static_cast<Shape::LineStyle>( g.lineStyle ) : Shape::SolidStyle;
+  }
+  Point point( double x, double y ) const { return Point( x / _unitsPerMM, -y / _unitsPerMM ); }
+  ShapeList & target() { return _groups.empty() ? _shapes : *_groups.back(); }
+
+  bool arc();
+  bool ellipse();
+  bool polyline();
+  bool spline();
+  bool text();
+  bool endCompound();
+
+  const char * _begin;
+  const char * _p;
+  const char * _end;
+  ShapeList & _shapes;
+  double _unitsPerMM;
+  std::map<int,Color> _colors;
+  std::vector< std::unique_ptr<Group> > _groups;
+};
+
+bool
+FIGReader::fail( const char * what )
+{
+  Tools::error << "Reader: " << what << " in XFig file (line "
+               << 1 + std::count( _begin, _p, '\n' ) << ").\n";
+  return false;
+}
+
+bool
+FIGReader::integer( int & value )
+{
+  double x;
+  if ( ! real( x ) ) return false;
+  value = static_cast<int>( x >= 0 ? x + 0.5 : x - 0.5 );
+  return true;
+}
+
+bool
+FIGReader::real( double & value )
+{
+  skipSpaces( _p, _end );
+  return readNumber( _p, _end, value );
+}
+
+void
+FIGReader::skipLine()
+{
+  const char * eol = findChar( _p, _end, '\n' );
+  _p = eol ? eol + 1 : _end;
+}
+
+bool
+FIGReader::graphics( Graphics & g )
+{
+  return integer( g.subtype ) && integer( g.lineStyle ) && integer( g.thickness )
+      && integer( g.penColor ) && integer( g.fillColor ) && integer( g.depth )
+      && integer( g.penStyle ) && integer( g.areaFill ) && real( g.styleValue );
+}
+
+bool
+FIGReader::points( int count, std::vector<Point> & result )
+{
+  result.reserve( count );
+  for ( int i = 0; i < count; ++i ) {
+    double x, y;
+    if ( ! real( x ) || ! real( y ) ) return false;
+    result.push_back( point( x, y ) );
+  }
+  return true;
+}
+
+bool
+FIGReader::skipArrows( int forward, int backward )
+{
+  // type, style, thickness, width, height
+  double v;
+  for ( int i = 0; i < 5 * ( ( forward != 0 ) + ( backward != 0 ) ); ++i ) {
+    if ( ! real( v ) ) return false;
+  }
+  return true;
+}
+
+Color
+FIGReader::color( int index ) const
+{
+  static const unsigned int standard[32] = {
+    0x000000, 0x0000FF, 0x00FF00, 0x00FFFF, 0xFF0000, 0xFF00FF, 0xFFFF00, 0xFFFFFF,
+    0x000090, 0x0000B0, 0x0000D0, 0x87CEFF, 0x009000, 0x00B000, 0x00D000, 0x009090,
+    0x00B0B0, 0x00D0D0, 0x900000, 0xB00000, 0xD00000, 0x900090, 0xB000B0, 0xD000D0,
+    0x803000, 0xA04000, 0xC06000, 0xFF8080, 0xFFA0A0, 0xFFC0C0, 0xFFE0E0, 0xFFD700
+  };
+  if ( index < 0 ) return Color::Black;
+  if ( index < 32 ) return Color( standard[index] );
+  std::map<int,Color>::const_iterator it = _colors.find( index );
+  return ( it != _colors.end() ) ? it->second : Color::Black;
+}
+
+Color
+FIGReader::pen( const Graphics & g ) const
+{
+  return g.thickness > 0 ? color( g.penColor ) : Color::Null;
+}
+
+Color
+FIGReader::fill( const Graphics & g, Hatch & hatch ) const
+{
+  const int area = g.areaFill;
+  if ( area < 0 ) return Color::Null;
+  if ( area > 40 ) {
+    // Patterns of lines, in the pen color (see Hatch::figAreaFill()). The
+    // spacing of the lines is not in the file.
+    static const struct { int fill; double degrees; bool cross; } patterns[] = {
+      { 41, 150, false }, { 42, 30, false }, { 43, 30, true }, { 44, 135, false }, { 45, 45, false },
+      { 46, 45, true }, { 49, 0, false }, { 50, 90, false }, { 51, 0, true }
+    };
+    for ( std::size_t i = 0; i < sizeof( patterns ) / sizeof( patterns[0] ); ++i ) {
+      if ( patterns[i].fill == area ) {
+        hatch = Hatch( patterns[i].degrees * M_PI / 180.0, 1.5, 0.25, patterns[i].cross, color( g.penColor ) );
+        // The library writes white as the background of a bare pattern.
+        return ( g.fillColor == 7 ) ? Color::Null : color( g.fillColor );
+      }
+    }
+    return color( g.fillColor );
+  }
+  if ( g.fillColor <= 0 || g.fillColor == 7 ) {
+    // Grays: from white to black for black, the other way for white.
+    const int level = std::min( area, 20 );
+    const int gray = ( g.fillColor == 7 ) ? 255 * level / 20 : 255 * ( 20 - level ) / 20;
+    return Color( static_cast<unsigned char>( gray ) );
+  }
+  const Color c = color( g.fillColor );
+  if ( area <= 20 ) {
+    // Shades, mixed with black.
+    return Color( static_cast<unsigned char>( c.red() * area / 20 ),
+                  static_cast<unsigned char>( c.green() * area / 20 ),
+                  static_cast<unsigned char>( c.blue() * area / 20 ) );
+  }
+  // Tints, mixed with white.
+  const int tint = area - 20;
+  return Color( static_cast<unsigned char>( c.red() + ( 255 - c.red() ) * tint / 20 ),
+                static_cast<unsigned char>( c.green() + ( 255 - c.green() ) * tint / 20 ),
+                static_cast<unsigned char>( c.blue() + ( 255 - c.blue() ) * tint / 20 ) );
+}
+
+bool
+FIGReader::arc()
+{
+  Graphics g;
+  int cap, direction, forward, backward;
+  double cx, cy, x[3], y[3];
+  if ( ! graphics( g ) || ! integer( cap ) || ! integer( direction )
+       || ! integer( forward ) || ! integer( backward )
+       || ! real( cx ) || ! real( cy )
+       || ! real( x[0] ) || ! real( y[0] ) || ! real( x[1] ) || ! real( y[1] ) || ! real( x[2] ) || ! real( y[2] )
+       || ! skipArrows( forward, backward ) ) {
+    return fail( "bad arc" );
+  }
+  // Sampled from the first point to the last one, through the second.
+  const Point center = point( cx, cy );
+  double angles[3];
+  for ( int i = 0; i < 3; ++i ) {
+    const Point p = point( x[i], y[i] ) - center;
+    angles[i] = std::atan2( p.y, p.x );
+  }
+  const double radius = ( point( x[0], y[0] ) - center ).norm();
+  double sweep = std::fmod( angles[2] - angles[0] + 4 * M_PI, 2 * M_PI );
+  const double middle = std::fmod( angles[1] - angles[0] + 4 * M_PI, 2 * M_PI );
+  if ( middle > sweep ) {
+    sweep -= 2 * M_PI;
+  }
+  const int steps = std::max( 4, static_cast<int>( std::fabs( sweep ) / ( M_PI / 32 ) ) );
+  Path path( g.subtype == 2 );
+  for ( int i = 0; i <= steps; ++i ) {
+    const double angle = angles[0] + sweep * i / steps;
+    path << center + Point( radius * std::cos( angle ), radius * std::sin( angle ) );
+  }
+  if ( g.subtype == 2 ) {
+    path << center;
+  }
+  Hatch hatch;
+  const Color fillColor = fill( g, hatch );
+  Polyline polyline( path, pen( g ), fillColor, width( g ), lineStyle( g ),
+                     static_cast<Shape::LineCap>( std::max( 0, std::min( cap, 2 ) ) ), Shape::RoundJoin, g.depth );
+  polyline.setHatch( hatch );
+  target() << std::move( polyline );
+  return true;
+}
+
+bool
+FIGReader::ellipse()
+{
+  Graphics g;
+  int direction;
+  double angle, cx, cy, rx, ry, v;
+  if ( ! graphics( g ) || ! integer( direction ) || ! real( angle )
+       || ! real( cx ) || ! real( cy ) || ! real( rx ) || ! real( ry ) ) {
+    return fail( "bad ellipse" );
+  }
+  for ( int i = 0; i < 4; ++i ) {
+    if ( ! real( v ) ) return fail( "bad ellipse" );
+  }
+  Hatch hatch;
+  const Color fillColor = fill( g, hatch );
+  const Point center = point( cx, cy );
+  if ( ( g.subtype == 3 || g.subtype == 4 ) && rx == ry ) {
+    Circle circle( center, rx / _unitsPerMM, pen( g ), fillColor, width( g ), lineStyle( g ), g.depth );
+    circle.setHatch( hatch );
+    target() << std::move( circle );
+  } else {
+    Ellipse e( center, rx / _unitsPerMM, ry / _unitsPerMM, pen( g ), fillColor, width( g ), lineStyle( g ), g.depth );
+    if ( angle != 0.0 ) {
+      e.rotate( angle, center );
+    }
+    e.setHatch( hatch );
+    target() << std::move( e );
+  }
+  return true;
+}
+
+bool
+FIGReader::polyline()
+{
+  Graphics g;
+  int join, cap, radius, forward, backward, count;
+  if ( ! graphics( g ) || ! integer( join ) || ! integer( cap ) || ! integer( radius )
+       || ! integer( forward ) || ! integer( backward ) || ! integer( count )
+       || count < 0 || ! skipArrows( forward, backward ) ) {
+    return fail( "bad polyline" );
+  }
+  if ( g.subtype == 5 ) {
+    // Imported picture: flag and filename.
+    skipLine();
+    skipLine();
+    Tools::warning << "Reader: XFig pictures are not supported.\n";
+    std::vector<Point> skipped;
+    return points( count, skipped ) || fail( "bad picture" );
+  }
+  std::vector<Point> vertices;
+  if ( ! points( count, vertices ) ) {
+    return fail( "bad polyline" );
+  }
+  const bool closed = ( g.subtype >= 2 );
+  if ( closed && vertices.size() > 1 && vertices.front() == vertices.back() ) {
+    vertices.pop_back();
+  }
+  const Shape::LineCap lineCap = static_cast<Shape::LineCap>( std::max( 0, std::min( cap, 2 ) ) );
+  const Shape::LineJoin lineJoin = static_cast<Shape::LineJoin>( std::max( 0, std::min( join, 2 ) ) );
+  Hatch hatch;
+  const Color fillColor = fill( g, hatch );
+  if ( ! closed && vertices.size() == 2 && ( forward || backward ) ) {
+    const Point & a = vertices[ forward ? 0 : 1 ];
+    const Point & b = vertices[ forward ? 1 : 0 ];
+    target() << Arrow( a, b, pen( g ), pen( g ), width( g ), lineStyle( g ), lineCap, lineJoin, g.depth );
+    return true;
+  }
+  if ( ( g.subtype == 2 || g.subtype == 4 ) && vertices.size() == 4 ) {
+    const Path path( vertices, true );
+    const Rect box = path.boundingBox();
+    Rectangle rectangle( box, pen( g ), fillColor, width( g ), lineStyle( g ), lineCap, lineJoin, g.depth );
+    rectangle.setHatch( hatch );
+    target() << std::move( rectangle );
+    return true;
+  }
+  Polyline line( Path( std::move( vertices ), closed ), pen( g ), fillColor, width( g ), lineStyle( g ), lineCap, lineJoin, g.depth );
+  line.setHatch( hatch );
+  target() << std::move( line );
+  return true;
+}
+
+bool
+FIGReader::spline()
+{
+  Graphics g;
+  int cap, forward, backward, count;
+  if ( ! graphics( g ) || ! integer( cap ) || ! integer( forward ) || ! integer( backward )
+       || ! integer( count ) || count < 0 || ! skipArrows( forward, backward ) ) {
+    return fail( "bad spline" );
+  }
+  // Read as the polyline of its control points.
+  std::vector<Point> vertices;
+  if ( ! points( count, vertices ) ) {
+    return fail( "bad spline" );
+  }
+  double factor;
+  for ( int i = 0; i < count; ++i ) {
+    if ( ! real( factor ) ) return fail( "bad spline" );
+  }
+  const bool closed = ( g.subtype % 2 ) == 1;
+  Hatch hatch;
+  const Color fillColor = fill( g, hatch );
+  Polyline line( Path( std::move( vertices ), closed ), pen( g ), fillColor, width( g ), lineStyle( g ),
+                 static_cast<Shape::LineCap>( std::max( 0, std::min( cap, 2 ) ) ), Shape::RoundJoin, g.depth );
+  line.setHatch( hatch );
+  target() << std::move( line );
+  return true;
+}
+
+bool
+FIGReader::text()
+{
+  int subtype, colorIndex, depth, penStyle, font, flags;
+  double size, angle, height, length, x, y;
+  if ( ! integer( subtype ) || ! integer( colorIndex ) || ! integer( depth ) || ! integer( penStyle )
+       || ! integer( font ) || ! real( size ) || ! real( angle ) || ! integer( flags )
+       || ! real( height ) || ! real( length ) || ! real( x ) || ! real( y ) ) {
+    return fail( "bad text" );
+  }
+  // The string starts after one blank, and ends before \001.
+  if ( _p != _end ) ++_p;
+  std::string string;
+  for ( ;; ) {
+    if ( _p == _end ) return fail( "unterminated text" );
+    const char c = *_p++;
+    if ( c == '\001' ) break;
+    if ( c != '\\' || _p == _end ) {
+      string += c;
+      continue;
+    }
+    if ( _end - _p >= 3 && _p[0] >= '0' && _p[0] <= '3' && _p[1] >= '0' && _p[1] <= '7' && _p[2] >= '0' && _p[2] <= '7' ) {
+      const char code = static_cast<char>( ( _p[0] - '0' ) * 64 + ( _p[1] - '0' ) * 8 + ( _p[2] - '0' ) );
+      _p += 3;
+      if ( code == '\001' ) break;
+      string += code;
+    } else {
+      string += *_p++;
+    }
+  }
+  skipLine();
+  Fonts::Font face = Fonts::TimesRoman;
+  if ( flags & 4 ) {
+    if ( font >= Fonts::TimesRoman && font <= Fonts::ZapfDingbats ) {
+      face = static_cast<Fonts::Font>( font );
+    }
+  } else {
+    static const Fonts::Font latex[] = { Fonts::TimesRoman, Fonts::TimesRoman, Fonts::TimesBold,
+                                         Fonts::TimesItalic, Fonts::Helvetica, Fonts::Courier };
+    if ( font >= 0 && font <= 5 ) face = latex[font];
+  }
+  // The origin is the lower left, center or right of the string.
+  Point position = point( x, y );
+  const double shift = ( subtype == 1 ? length / 2 : subtype == 2 ? length : 0.0 ) / _unitsPerMM;
+  position -= Point( shift * std::cos( angle ), shift * std::sin( angle ) );
+  Text label( position, string, face, size * 25.4 / 72.0, color( colorIndex ), depth );
+  if ( angle != 0.0 ) {
+    label.rotate( angle, position );
+  }
+  target() << std::move( label );
+  return true;
+}
+
+bool
+FIGReader::endCompound()
+{
+  if ( _groups.empty() ) {
+    return fail( "unexpected end of compound" );
+  }
+  std::unique_ptr<Group> group( std::move( _groups.back() ) );
+  _groups.pop_back();
+  if ( group->size() ) {
+    // XFig has no depth for a compound: the group goes at the depth of
+    // its front-most shape.
+    group->depth( group->minDepth() );
+    target() << std::move( *group );
+  }
+  return true;
+}
+
+bool
+FIGReader::read()
+{
+  BOARD_TRACE_SCOPE( "Reader::readFIG" );
+  if ( ! Chars( _p, _end ).startsWith( "#FIG 3.2" ) ) {
+    return fail( "not an XFig 3.2 file" );
+  }
+  skipLine();
+  // orientation, justification, units, paper size, magnification,
+  // multiple page, transparent color, then resolution and coordinates.
+  for ( int header = 0; header < 8; ) {
+    skipSpaces( _p, _end );
+    if ( _p == _end ) return fail( "truncated header" );
+    if ( *_p == '#' ) {
+      skipLine();
+      continue;
+    }
+    if ( header == 7 ) {
+      int resolution;
+      if ( ! integer( resolution ) || resolution <= 0 ) return fail( "bad resolution" );
+      // Like xfig, the library draws 1200 ppi at 1143 units per inch.
+      _unitsPerMM = resolution * ( 1143.0 / 1200.0 ) / 25.4;
+    }
+    skipLine();
+    ++header;
+  }
+  for ( ;; ) {
+    skipSpaces( _p, _end );
+    if ( _p == _end ) break;
+    if ( *_p == '#' ) {
+      skipLine();
+      continue;
+    }
+    int code;
+    if ( ! integer( code ) ) return fail( "bad object code" );
+    bool ok = true;
+    switch ( code ) {
+    case 0: {
+      int index;
+      skipSpaces( _p, _end );
+      if ( ! integer( index ) || ! ( skipSpaces( _p, _end ), Chars( _p, _end ).startsWith( "#" ) ) || _end - _p < 7 ) {
+        return fail( "bad color" );
+      }
+      _colors[ index ] = Color( static_cast<unsigned int>( std::strtoul( std::string( _p + 1, _p + 7 ).c_str(), 0, 16 ) ) );
+      skipLine();
+      break;
+    }
+    case 1: ok = ellipse(); break;
+    case 2: ok = polyline(); break;
+    case 3: ok = spline(); break;
+    case 4: ok = text(); break;
+    case 5: ok = arc(); break;
+    case 6: {
+      double v;
+      for ( int i = 0; i < 4; ++i ) {
+        if ( ! real( v ) ) return fail( "bad compound" );
+      }
+      _groups.push_back( std::unique_ptr<Group>( new Group ) );
+      break;
+    }
+    case -6: ok = endCompound(); break;
+    default:
+      return fail( "unknown object code" );
+    }
+    if ( ! ok ) return false;
+  }
+  while ( ! _groups.empty() ) {
+    Tools::warning << "Reader: unterminated XFig compound.\n";
+    endCompound();
+  }
+  return true;
+}
+
+} // namespace
+
+namespace PlaneDraw {
+
+MappedFile::MappedFile( const char * filename )
+  : _data( 0 ), _size( 0 ), _mapped( false ), _valid( false )
+{
+#if ( _BOARD_WIN32_ == 0 )
+  const int fd = ::open( filename, O_RDONLY );
+  if ( fd < 0 ) {
+    return;
+  }
+  struct stat st;
+  if ( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0 ) {
+    void * address = mmap( 0, static_cast<std::size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( address != MAP_FAILED ) {
+      madvise( address, static_cast<std::size_t>( st.st_size ), MADV_SEQUENTIAL );
+      _data = static_cast<const char*>( address );
+      _size = static_cast<std::size_t>( st.st_size );
+      _mapped = _valid = true;
+    }
+  }
+  ::close( fd );
+  if ( _mapped ) {
+    return;
+  }
+#endif
+  // Empty files, and files which cannot be mapped, are read.
+  std::ifstream in( filename, std::ios::in | std::ios::binary );
+  if ( ! in ) {
+    return;
+  }
+  _buffer.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  _size = _buffer.size();
+  _data = _buffer.empty() ? 0 : &_buffer[0];
+  _valid = true;
+}
+
+MappedFile::~MappedFile()
+{
+#if ( _BOARD_WIN32_ == 0 )
+  if ( _mapped ) {
+    munmap( const_cast<char*>( _data ), _size );
+  }
+#endif
+}
+
+bool
+Reader::readSVG( const char * begin, const char * end, ShapeList & shapes )
+{
+  SVGReader reader( begin, end, shapes );
+  return reader.read();
+}
+
+bool
+Reader::readFIG( const char * begin, const char * end, ShapeList & shapes )
+{
+  FIGReader reader( begin, end, shapes );
+  return reader.read();
+}
+
+} // namespace PlaneDraw
@@ -26,15 +26,61 @@
  */
 #include "BoardConfig.h"
 #include "board/ShapeList.h"
+#include "board/LevelOfDetail.h"
 #include <algorithm>
+#include <memory>
 #include <typeinfo>
 #include <utility>
 #include "board/Tools.h"
+#include "board/ExportStats.h"
+#include "board/Trace.h"
+#include "board/MemoryUsage.h"
+#include "board/ThreadPool.h"
+#include "board/ShapeVisitor.h"
+#include "board/DXF.h"
 
 #if defined( max )
 #undef max
 #endif
 
+namespace {
+// Shapes are clipped geometrically by ranges of at least this number of
+// shapes, in parallel. (Bounding box tests are always run in the calling
+// thread: they cost less than handing a range to the pool.)
+const std::size_t ParallelClippingGrain = 512;
+
+// Below this number of shapes, a visit is not worth a thread pool.
+const std::size_t ParallelVisitThreshold = 4096;
+
+// The shapes of a list are transformed (and bounded) by ranges of at
+// least this number of shapes, in parallel. A range of the cheapest loop
+// (translate, about 25 ns a shape) then takes some 50 us, against about
+// 10 us to hand it to the shared pool.
+const std::size_t ParallelTransformGrain = 2048;
+
+// The edges of a union of boxes. Minima and maxima are exact, so that
+// the union of defined boxes does not depend on their order (or ranges).
+struct Edges {
+  double left, right, bottom, top;
+  explicit Edges( const PlaneDraw::Rect & r = PlaneDraw::Rect() )
+    : left( r.left ), right( r.left + r.width ), bottom( r.top - r.height ), top( r.top ) { }
+  // As operator||, keeps an edge only if it is strictly beyond the other
+  // one (so that an undefined box, e.g. of a null arrow, is dropped).
+  void add( const Edges & other ) {
+    left = ( left < other.left ) ? left : other.left;
+    right = ( right > other.right ) ? right : other.right;
+    bottom = ( bottom < other.bottom ) ? bottom : other.bottom;
+    top = ( top > other.top ) ? top : other.top;
+  }
+};
+
+// Lists the shapes visited, in order.
+struct ShapeCollector : public PlaneDraw::TypedShapeVisitor {
+  void visit( const PlaneDraw::Shape & shape ) { shapes.push_back( &shape ); }
+  std::vector<const PlaneDraw::Shape*> shapes;
+};
+}
+
 namespace PlaneDraw {
 
 //
@@ -224,6 +270,17 @@ ShapeList::addShape( const Shape & shape, double scaleFactor )
   }
 }
 
+void
+ShapeList::insertShape( Shape * shape )
+{
+  if ( shape->depth() == -1 )
+    shape->depth( _nextDepth-- );
+  _shapes.push_back( shape );
+  if ( typeid( *shape ) == typeid( Group ) ) {
+    _nextDepth = static_cast<Group*>( shape )->minDepth() - 1;
+  }
+}
+
 ShapeList &
 ShapeList::dup( std::size_t copies )
 {
@@ -355,12 +412,14 @@ ShapeList::insert( const Shape & , int /* depth */ )
 ShapeList &
 ShapeList::rotate( double angle, const Point & center )
 {
-  std::vector<Shape*>::iterator i = _shapes.begin();
-  std::vector<Shape*>::iterator end = _shapes.end();
-  while ( i != end ) {
-    (*i)->rotate( angle, center );
-    ++i;
-  }
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::rotate", _shapes.size() );
+  std::vector<Shape*> & shapes = _shapes;
+  ThreadPool::parallelFor( shapes.size(), ParallelTransformGrain,
+                           [&shapes,angle,&center]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               shapes[k]->rotate( angle, center );
+                             }
+                           } );
   return *this;
 }
 
@@ -386,12 +445,14 @@ ShapeList::rotated( double angle )
 ShapeList &
 ShapeList::translate( double dx, double dy )
 {
-  std::vector<Shape*>::iterator i = _shapes.begin();
-  std::vector<Shape*>::iterator end = _shapes.end();
-  while ( i != end ) {
-    (*i)->translate( dx, dy );
-    ++i;
-  }
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::translate", _shapes.size() );
+  std::vector<Shape*> & shapes = _shapes;
+  ThreadPool::parallelFor( shapes.size(), ParallelTransformGrain,
+                           [&shapes,dx,dy]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               shapes[k]->translate( dx, dy );
+                             }
+                           } );
   return *this;
 }
 
@@ -404,21 +465,29 @@ ShapeList::translated( double dx, double dy )
 ShapeList &
 ShapeList::scale( double sx, double sy )
 {
-  Point c = center();
-  Point delta;
-  std::vector<Shape*>::iterator i = _shapes.begin();
-  std::vector<Shape*>::iterator end = _shapes.end();
-  while ( i != end ) {
-    delta = (*i)->center() - c;
-    delta.x *= sx;
-    delta.y *= sy;
-    (*i)->scale( sx, sy );
-    delta = ( c + delta ) - (*i)->center();
-    (*i++)->translate( delta.x, delta.y );
-  }
+  scaleShapes( sx, sy, center() );
   return *this;
 }
 
+void
+ShapeList::scaleShapes( double sx, double sy, const Point & center )
+{
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::scale", _shapes.size() );
+  std::vector<Shape*> & shapes = _shapes;
+  ThreadPool::parallelFor( shapes.size(), ParallelTransformGrain,
+                           [&shapes,sx,sy,&center]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               Shape & shape = *shapes[k];
+                               Point delta = shape.center() - center;
+                               delta.x *= sx;
+                               delta.y *= sy;
+                               shape.scale( sx, sy );
+                               delta = ( center + delta ) - shape.center();
+                               shape.translate( delta.x, delta.y );
+                             }
+                           } );
+}
+
 ShapeList &
 ShapeList::scale( double s )
 {
@@ -440,23 +509,33 @@ ShapeList::scaled( double s )
 void
 ShapeList::scaleAll( double s )
 {
-  std::vector<Shape*>::iterator i = _shapes.begin();
-  std::vector<Shape*>::iterator end = _shapes.end();
-  while ( i != end ) {
-    (*i++)->scaleAll( s );
-  }
+  std::vector<Shape*> & shapes = _shapes;
+  ThreadPool::parallelFor( shapes.size(), ParallelTransformGrain,
+                           [&shapes,s]( std::size_t, std::size_t first, std::size_t last ) {
+                             for ( std::size_t k = first; k < last; ++k ) {
+                               shapes[k]->scaleAll( s );
+                             }
+                           } );
 }
 
 void
 ShapeList::flushPostscript( std::ostream & stream,
                             const TransformEPS & transform ) const
 {
-  std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
-  std::vector< Shape* >::const_iterator i = shapes.begin();
-  std::vector< Shape* >::const_iterator end = shapes.end();
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::flushPostscript", _shapes.size() );
+  std::vector< const Shape* > shapes;
+  ShapeList pieces;
+  drawingOrder( shapes, pieces, false );
+  std::vector< const Shape* >::const_iterator i = shapes.begin();
+  std::vector< const Shape* >::const_iterator end = shapes.end();
   stream << "%%% Begin ShapeList\n";
   while ( i != end ) {
+    if ( LevelOfDetail::flushReduced( **i, stream, transform ) ) {
+      ++i;
+      continue;
+    }
+    ShapeStatsScope scope( transform.context(), **i );
+    BOARD_TRACE_SCOPE( (*i)->name().c_str() );
     (*i++)->flushPostscript( stream, transform );
   }
   stream << "%%% End ShapeList\n";
@@ -467,11 +546,15 @@ ShapeList::flushFIG( std::ostream & stream,
                      const TransformFIG & transform,
                      std::map<Color,int> & colormap ) const
 {
-  std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
-  std::vector< Shape* >::const_iterator i = shapes.begin();
-  std::vector< Shape* >::const_iterator end = shapes.end();
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::flushFIG", _shapes.size() );
+  std::vector< const Shape* > shapes;
+  ShapeList pieces;
+  drawingOrder( shapes, pieces, true );
+  std::vector< const Shape* >::const_iterator i = shapes.begin();
+  std::vector< const Shape* >::const_iterator end = shapes.end();
   while ( i != end ) {
+    ShapeStatsScope scope( transform.context(), **i );
+    BOARD_TRACE_SCOPE( (*i)->name().c_str() );
     (*i)->flushFIG( stream, transform, colormap );
     ++i;
   }
@@ -481,12 +564,20 @@ void
 ShapeList::flushSVG( std::ostream & stream,
                      const TransformSVG & transform ) const
 {
-  std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
-  std::vector< Shape* >::const_iterator i = shapes.begin();
-  std::vector< Shape* >::const_iterator end = shapes.end();
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::flushSVG", _shapes.size() );
+  std::vector< const Shape* > shapes;
+  ShapeList pieces;
+  drawingOrder( shapes, pieces, false );
+  std::vector< const Shape* >::const_iterator i = shapes.begin();
+  std::vector< const Shape* >::const_iterator end = shapes.end();
   //stream << "<g>\n";
   while ( i != end ) {
+    if ( LevelOfDetail::flushReduced( **i, stream, transform ) ) {
+      ++i;
+      continue;
+    }
+    ShapeStatsScope scope( transform.context(), **i );
+    BOARD_TRACE_SCOPE( (*i)->name().c_str() );
     (*i)->flushSVG( stream, transform );
     ++i;
   }
@@ -497,32 +588,159 @@ void
 ShapeList::flushTikZ( std::ostream & stream,
                       const TransformTikZ & transform ) const
 {
-  std::vector< Shape* > shapes = _shapes;
-  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
-  std::vector< Shape* >::const_iterator i = shapes.begin();
-  std::vector< Shape* >::const_iterator end = shapes.end();
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::flushTikZ", _shapes.size() );
+  std::vector< const Shape* > shapes;
+  ShapeList pieces;
+  drawingOrder( shapes, pieces, false );
+  std::vector< const Shape* >::const_iterator i = shapes.begin();
+  std::vector< const Shape* >::const_iterator end = shapes.end();
   stream << "\\begin{scope}\n";
   while ( i != end ) {
+    ShapeStatsScope scope( transform.context(), **i );
+    BOARD_TRACE_SCOPE( (*i)->name().c_str() );
     (*i)->flushTikZ( stream, transform );
     ++i;
   }
   stream << "\\end{scope}\n";
 }
 
-Rect
-ShapeList::boundingBox(LineWidthFlag flag) const
+void
+ShapeList::flushDXF( std::ostream & stream,
+                     const TransformDXF & transform ) const
 {
-  Rect r;
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::flushDXF", _shapes.size() );
+  std::vector< const Shape* > shapes;
+  ShapeList pieces;
+  // Clipped groups are only cut into pieces when written, so that the
+  // groups collected are the ones of the list.
+  drawingOrder( shapes, pieces, transform.tables().pass() == DXFTables::Write );
+  std::vector< const Shape* >::const_iterator i = shapes.begin();
+  std::vector< const Shape* >::const_iterator end = shapes.end();
+  while ( i != end ) {
+    ShapeStatsScope scope( transform.context(), **i );
+    BOARD_TRACE_SCOPE( (*i)->name().c_str() );
+    (*i)->flushDXF( stream, transform );
+    ++i;
+  }
+}
+
+Shape::ClipResult
+ShapeList::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  const Rect box = boundingBox( UseLineWidth );
+  if ( ! region.meets( box ) )
+    return ClippedOut;
+  if ( region.surrounds( box ) )
+    return Unclipped;
+  ShapeList * list = new ShapeList( _depth );
+  if ( ! clipChildren( region, *list ) ) {
+    delete list;
+    return Unclipped;
+  }
+  if ( list->_shapes.empty() ) {
+    delete list;
+    return ClippedOut;
+  }
+  pieces.insertShape( list );
+  return Clipped;
+}
+
+bool
+ShapeList::clipChildren( const ClipRegion & region, ShapeList & list ) const
+{
+  bool clipped = false;
   std::vector< Shape* >::const_iterator i = _shapes.begin();
   std::vector< Shape* >::const_iterator end = _shapes.end();
-  if ( i == end ) return r;
-  r = (*i)->boundingBox(flag);
-  ++i;
   while ( i != end ) {
-    r = r || (*i)->boundingBox(flag);
+    switch ( (*i)->clip( region, list ) ) {
+    case Unclipped:
+      list.insertShape( (*i)->clone() );
+      break;
+    case ClippedOut:
+    case Clipped:
+      clipped = true;
+      break;
+    }
     ++i;
   }
-  return r;
+  return clipped;
+}
+
+void
+ShapeList::drawingOrder( std::vector<const Shape*> & shapes,
+                         ShapeList &,
+                         bool ) const
+{
+  shapes.assign( _shapes.begin(), _shapes.end() );
+  stable_sort( shapes.begin(), shapes.end(), shapeGreaterDepth );
+}
+
+void
+ShapeList::clipShapes( std::vector<const Shape*> & shapes,
+                       const ClipRegion & region,
+                       bool geometric,
+                       ShapeList & pieces )
+{
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::clipShapes", shapes.size() );
+  // Each chunk of the vector is clipped into its own list of pieces, so
+  // that the chunks may be processed in parallel, then put back in order.
+  const std::size_t chunks = geometric ? ThreadPool::ranges( shapes.size(), ParallelClippingGrain ) : 1;
+  std::vector< std::vector<const Shape*> > kept( chunks );
+  std::vector< ShapeList > chunkPieces( chunks );
+  ThreadPool::parallelRanges( shapes.size(), chunks,
+                              [&]( std::size_t chunk, std::size_t first, std::size_t last ) {
+    std::vector<const Shape*> & result = kept[chunk];
+    ShapeList & list = chunkPieces[chunk];
+    for ( std::size_t k = first; k < last; ++k ) {
+      const Shape * shape = shapes[k];
+      if ( ! geometric ) {
+        if ( region.meets( shape->boundingBox( UseLineWidth ) ) )
+          result.push_back( shape );
+        continue;
+      }
+      const std::size_t before = list._shapes.size();
+      switch ( shape->clip( region, list ) ) {
+      case Unclipped:
+        result.push_back( shape );
+        break;
+      case Clipped:
+        result.insert( result.end(), list._shapes.begin() + before, list._shapes.end() );
+        break;
+      case ClippedOut:
+        break;
+      }
+    }
+  } );
+  shapes.clear();
+  for ( std::size_t chunk = 0; chunk < chunks; ++chunk ) {
+    shapes.insert( shapes.end(), kept[chunk].begin(), kept[chunk].end() );
+    pieces._shapes.insert( pieces._shapes.end(), chunkPieces[chunk]._shapes.begin(), chunkPieces[chunk]._shapes.end() );
+    chunkPieces[chunk]._shapes.clear();
+  }
+}
+
+Rect
+ShapeList::boundingBox(LineWidthFlag flag) const
+{
+  if ( _shapes.empty() ) return Rect();
+  // Each range of shapes is bounded on its own, then the ranges are joined.
+  const std::vector<Shape*> & shapes = _shapes;
+  const std::size_t ranges = ThreadPool::ranges( shapes.size(), ParallelTransformGrain );
+  Edges single;
+  std::vector<Edges> edges( ranges > 1 ? ranges : 0 );
+  Edges * const out = ( ranges > 1 ) ? &edges[0] : &single;
+  ThreadPool::parallelFor( shapes.size(), ParallelTransformGrain,
+                           [&shapes,out,flag]( std::size_t range, std::size_t first, std::size_t last ) {
+                             Edges & e = out[range] = Edges( shapes[first]->boundingBox( flag ) );
+                             for ( std::size_t k = first + 1; k < last; ++k ) {
+                               e.add( Edges( shapes[k]->boundingBox( flag ) ) );
+                             }
+                           } );
+  for ( std::size_t range = 1; range < ranges; ++range ) {
+    out[0].add( out[range] );
+  }
+  const Edges & e = out[0];
+  return Rect( e.left, e.top, e.right - e.left, e.top - e.bottom );
 }
 
 int
@@ -583,6 +801,43 @@ ShapeList::clone() const
   return new ShapeList( *this );
 }
 
+void
+ShapeList::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( ShapeList ) );
+  accountShapes( usage, name() );
+}
+
+void
+ShapeList::shrinkToFit()
+{
+  shrinkShapes();
+}
+
+void
+ShapeList::accountShapes( MemoryUsage & usage, const std::string & type ) const
+{
+  usage.addContainer( type, _shapes.size(), _shapes.capacity(), sizeof( Shape * ) );
+  std::vector< Shape* >::const_iterator i = _shapes.begin();
+  std::vector< Shape* >::const_iterator end = _shapes.end();
+  while ( i != end ) {
+    (*i++)->accountMemory( usage );
+  }
+}
+
+void
+ShapeList::shrinkShapes()
+{
+  if ( _shapes.capacity() > _shapes.size() ) {
+    std::vector< Shape* >( _shapes ).swap( _shapes );
+  }
+  std::vector< Shape* >::iterator i = _shapes.begin();
+  std::vector< Shape* >::iterator end = _shapes.end();
+  while ( i != end ) {
+    (*i++)->shrinkToFit();
+  }
+}
+
 Shape &
 ShapeList::last( const std::size_t position )
 {
@@ -615,6 +870,60 @@ ShapeList::accept(const ShapeVisitor & visitor)
   }
 }
 
+void
+ShapeList::accept(TypedShapeVisitor & visitor) const
+{
+  std::vector< Shape* >::const_iterator i = _shapes.begin();
+  std::vector< Shape* >::const_iterator end = _shapes.end();
+  while ( i != end ) {
+    (*i++)->accept( visitor );
+  }
+}
+
+void
+ShapeList::parallelAccept( TypedShapeVisitor & visitor, std::size_t threads ) const
+{
+  BOARD_TRACE_SCOPE_ARG( "ShapeList::parallelAccept", _shapes.size() );
+  if ( ! threads ) {
+    threads = ThreadPool::hardwareThreads();
+  }
+  std::vector< std::unique_ptr<TypedShapeVisitor> > parts;
+  if ( threads > 1 ) {
+    parts.push_back( std::unique_ptr<TypedShapeVisitor>( visitor.split() ) );
+  }
+  if ( parts.empty() || ! parts.front() ) {
+    accept( visitor );
+    return;
+  }
+
+  // The shapes are listed first, so that the parts are balanced whatever
+  // the nesting of the lists.
+  ShapeCollector collector;
+  accept( collector );
+  const std::vector<const Shape*> & shapes = collector.shapes;
+  const std::size_t chunks = ( shapes.size() >= ParallelVisitThreshold )
+      ? std::min<std::size_t>( threads * 4, shapes.size() / ( ParallelVisitThreshold / 4 ) )
+      : 1;
+  while ( parts.size() < chunks && parts.back() ) {
+    parts.push_back( std::unique_ptr<TypedShapeVisitor>( visitor.split() ) );
+  }
+  if ( chunks == 1 || ! parts.back() ) {
+    accept( visitor );
+    return;
+  }
+
+  ThreadPool::parallelRanges( shapes.size(), chunks,
+                              [&shapes,&parts]( std::size_t chunk, std::size_t first, std::size_t last ) {
+                                TypedShapeVisitor & part = *parts[chunk];
+                                for ( std::size_t k = first; k < last; ++k ) {
+                                  shapes[k]->accept( part );
+                                }
+                              } );
+  for ( std::size_t chunk = 0; chunk < chunks; ++chunk ) {
+    visitor.merge( *parts[chunk] );
+  }
+}
+
 //
 // Definition of the Group methods.
 //
@@ -638,8 +947,9 @@ Group::rotate( double angle, const Point & center )
 Group &
 Group::rotate( double angle )
 {
-  ShapeList::rotate( angle );
-  _clippingPath.rotate( angle, center() );
+  const Point c = center();
+  ShapeList::rotate( angle, c );
+  _clippingPath.rotate( angle, c );
   return (*this);
 }
 
@@ -654,12 +964,13 @@ Group::translate( double dx, double dy )
 Group &
 Group::scale( double sx, double sy )
 {
-  Point delta = _clippingPath.center() - center();
+  const Point c = center();
+  Point delta = _clippingPath.center() - c;
   delta.x *= sx;
   delta.y *= sy;
   _clippingPath.scale( sx, sy );
-  ShapeList::scale( sx, sy );
-  delta = ( center() + delta ) - _clippingPath.center();
+  scaleShapes( sx, sy, c );
+  delta = ( c + delta ) - _clippingPath.center();
   _clippingPath.translate( delta.x, delta.y );
   return (*this);
 }
@@ -667,13 +978,7 @@ Group::scale( double sx, double sy )
 Group &
 Group::scale( double s )
 {
-  Point delta = _clippingPath.center() - center();
-  delta *= s;
-  _clippingPath.scale( s );
-  ShapeList::scale( s );
-  delta = ( center() + delta ) - _clippingPath.center();
-  _clippingPath.translate( delta.x, delta.y );
-  return (*this);
+  return Group::scale( s, s );
 }
 
 Group
@@ -743,15 +1048,18 @@ void
 Group::flushPostscript( std::ostream & stream,
                         const TransformEPS & transform ) const
 {
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->groups;
+  }
   if ( _clippingPath.size() > 2 ) {
-    stream << "%%% Begin Clipped Group " << _clippingCount << "\n";
+    const std::size_t clippingId = transform.context().nextClippingId();
+    stream << "%%% Begin Clipped Group " << clippingId << "\n";
     stream << " gsave n ";
     _clippingPath.flushPostscript( stream, transform );
     stream << " 0 slw clip " << std::endl;
     ShapeList::flushPostscript( stream, transform );
     stream << " grestore\n";
-    stream << "%%% End Clipped Group " << _clippingCount << "\n";
-    ++ _clippingCount;
+    stream << "%%% End Clipped Group " << clippingId << "\n";
   } else {
     stream << "%%% Begin Group\n";
     ShapeList::flushPostscript( stream, transform );
@@ -764,6 +1072,9 @@ Group::flushFIG( std::ostream & stream,
                  const TransformFIG & transform,
                  std::map<Color,int> & colormap ) const
 {
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->groups;
+  }
   Rect bbox = boundingBox(UseLineWidth);
   stream << "# Begin group\n";
   stream << "6 "
@@ -780,15 +1091,18 @@ void
 Group::flushSVG( std::ostream & stream,
                  const TransformSVG & transform ) const
 {
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->groups;
+  }
   if ( _clippingPath.size() > 2 ) {
+    const std::size_t clippingId = transform.context().nextClippingId();
     stream << "<g clip-rule=\"nonzero\">\n"
-           << " <clipPath id=\"LocalClipPath" << _clippingCount << "\">\n"
+           << " <clipPath id=\"LocalClipPath" << clippingId << "\">\n"
            << "  <path clip-rule=\"evenodd\"  d=\"";
     _clippingPath.flushSVGCommands( stream, transform );
     stream << "\" />\n";
     stream << " </clipPath>\n";
-    stream << "<g clip-path=\"url(#LocalClipPath" << _clippingCount <<")\">\n";
-    ++ _clippingCount;
+    stream << "<g clip-path=\"url(#LocalClipPath" << clippingId <<")\">\n";
     ShapeList::flushSVG( stream, transform );
     stream << "</g>\n";
     stream << "</g>\n";
@@ -803,12 +1117,87 @@ void
 Group::flushTikZ( std::ostream & stream,
                   const TransformTikZ & transform ) const
 {
-  // FIXME: implement clipping
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->groups;
+  }
   stream << "\\begin{scope}\n";
+  if ( _clippingPath.size() > 2 ) {
+    stream << "\\clip ";
+    _clippingPath.flushTikZPoints( stream, transform );
+    stream << " -- cycle;\n";
+  }
   ShapeList::flushTikZ( stream, transform );
   stream << "\\end{scope}\n";
 }
 
+void
+Group::flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const
+{
+  DXFTables & tables = transform.tables();
+  const Point origin = DXFTables::origin( *this );
+  if ( tables.pass() == DXFTables::Collect ) {
+    // The key of a group identifies its drawing relative to the lower
+    // left corner of its bounding box. The enclosing list hashes the
+    // key, not the entities, so each group is drawn once.
+    const DXFTables::Key * key = tables.key( *this );
+    if ( ! key ) {
+      HashingStreamBuffer hashing;
+      std::ostream hash( &hashing );
+      hash.precision( stream.precision() );
+      const TransformDXF relative = transform.relativeTo( origin );
+      ShapeList::flushDXF( hash, relative );
+      if ( _clippingPath.size() > 2 ) {
+        for ( std::size_t n = 0; n < _clippingPath.size(); ++n ) {
+          DXFTables::point( hash, 10, relative.map( _clippingPath[n] ), false );
+        }
+      }
+      key = &tables.addGroup( *this, hashing.key() );
+    }
+    stream << "0\nINSERT\n" << key->hash << "\n" << key->check << "\n" << key->length << "\n";
+    DXFTables::point( stream, 10, transform.map( origin ) );
+    stream << "8\n" << DXFTables::layer( _depth ) << "\n";
+    return;
+  }
+  if ( ExportStats * stats = transform.context().stats() ) {
+    ++stats->groups;
+  }
+  if ( const DXFTables::Block * block = tables.block( *this ) ) {
+    tables.insert( stream, *block, transform.map( origin ), _depth );
+  } else {
+    ShapeList::flushDXF( stream, transform );
+  }
+}
+
+Shape::ClipResult
+Group::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  const Rect box = boundingBox( UseLineWidth );
+  if ( ! region.meets( box ) )
+    return ClippedOut;
+  if ( region.surrounds( box ) )
+    return Unclipped;
+  Group group( _depth );
+  group._clippingPath = _clippingPath;
+  if ( ! clipChildren( region, group ) )
+    return Unclipped;
+  if ( group._shapes.empty() )
+    return ClippedOut;
+  pieces << std::move( group );
+  return Clipped;
+}
+
+void
+Group::drawingOrder( std::vector<const Shape*> & shapes,
+                     ShapeList & pieces,
+                     bool geometric ) const
+{
+  ShapeList::drawingOrder( shapes, pieces, geometric );
+  if ( _clippingPath.size() > 2 ) {
+    clipShapes( shapes, ClipRegion( _clippingPath ), geometric, pieces );
+  }
+}
+
 Rect
 Group::boundingBox(LineWidthFlag lineWidthFlag) const
 {
@@ -825,6 +1214,21 @@ Group::clone() const
   return new Group( *this );
 }
 
+void
+Group::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Group ) );
+  usage.addPath( name(), _clippingPath );
+  accountShapes( usage, name() );
+}
+
+void
+Group::shrinkToFit()
+{
+  _clippingPath.shrinkToFit();
+  shrinkShapes();
+}
+
 Group &
 Group::operator=( const Group & other )
 {
@@ -832,6 +1236,4 @@ Group::operator=( const Group & other )
   return *this;
 }
 
-std::size_t Group::_clippingCount = 0;
-
 } // namespace PlaneDraw
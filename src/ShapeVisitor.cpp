@@ -30,14 +30,91 @@
 
 namespace PlaneDraw {
 
+TypedShapeVisitor::~TypedShapeVisitor()
+{
+}
+
+void TypedShapeVisitor::visit(const Shape &)
+{
+}
+
+void TypedShapeVisitor::visit(const Dot & dot)
+{
+  visit(static_cast<const Shape &>(dot));
+}
+
+void TypedShapeVisitor::visit(const Line & line)
+{
+  visit(static_cast<const Shape &>(line));
+}
+
+void TypedShapeVisitor::visit(const Arrow & arrow)
+{
+  visit(static_cast<const Line &>(arrow));
+}
+
+void TypedShapeVisitor::visit(const Polyline & polyline)
+{
+  visit(static_cast<const Shape &>(polyline));
+}
+
+void TypedShapeVisitor::visit(const Rectangle & rectangle)
+{
+  visit(static_cast<const Polyline &>(rectangle));
+}
+
+void TypedShapeVisitor::visit(const Triangle & triangle)
+{
+  visit(static_cast<const Polyline &>(triangle));
+}
+
+void TypedShapeVisitor::visit(const GouraudTriangle & triangle)
+{
+  visit(static_cast<const Polyline &>(triangle));
+}
+
+void TypedShapeVisitor::visit(const Ellipse & ellipse)
+{
+  visit(static_cast<const Shape &>(ellipse));
+}
+
+void TypedShapeVisitor::visit(const Circle & circle)
+{
+  visit(static_cast<const Ellipse &>(circle));
+}
+
+void TypedShapeVisitor::visit(const Text & text)
+{
+  visit(static_cast<const Shape &>(text));
+}
+
+void TypedShapeVisitor::visit(const Image & image)
+{
+  visit(static_cast<const Shape &>(image));
+}
+
+TypedShapeVisitor * TypedShapeVisitor::split() const
+{
+  return 0;
+}
+
+void TypedShapeVisitor::merge(TypedShapeVisitor &)
+{
+}
+
 BoundingBoxExtractor::BoundingBoxExtractor( PlaneDraw::ShapeList & shapeList )
-  :_shapeList(shapeList)
+  :_shapeList(&shapeList)
+{
+}
+
+BoundingBoxExtractor::BoundingBoxExtractor()
+  :_shapeList(0)
 {
 }
 
 void BoundingBoxExtractor::visit(Shape & shape)
 {
-  _shapeList << Rectangle(shape.boundingBox(Board::UseLineWidth),Color::Black,Color::Null);
+  visit(static_cast<const Shape &>(shape));
 }
 
 void BoundingBoxExtractor::visit(Shape &) const
@@ -45,9 +122,36 @@ void BoundingBoxExtractor::visit(Shape &) const
   Tools::warning << "BoundingBoxExtractor(): Visiting using the const method does not make sense.\n";
 }
 
+void BoundingBoxExtractor::visit(const Shape & shape)
+{
+  if ( _shapeList ) {
+    (*_shapeList) << Rectangle(shape.boundingBox(Board::UseLineWidth),Color::Black,Color::Null);
+  } else {
+    _boxes.push_back(shape.boundingBox(Board::UseLineWidth));
+  }
+}
+
+TypedShapeVisitor * BoundingBoxExtractor::split() const
+{
+  return new BoundingBoxExtractor;
+}
+
+void BoundingBoxExtractor::merge(TypedShapeVisitor & part)
+{
+  std::vector<Rect> & boxes = static_cast<BoundingBoxExtractor &>(part)._boxes;
+  for ( std::vector<Rect>::const_iterator it = boxes.begin(); it != boxes.end(); ++it ) {
+    if ( _shapeList ) {
+      (*_shapeList) << Rectangle(*it,Color::Black,Color::Null);
+    } else {
+      _boxes.push_back(*it);
+    }
+  }
+  boxes.clear();
+}
+
 const ShapeList & BoundingBoxExtractor::shapeList() const
 {
-  return _shapeList;
+  return *_shapeList;
 }
 
 void BoundingBoxViewer::visit(Shape & shape)
@@ -30,12 +30,17 @@
 #include "board/PathBoundaries.h"
 #include "board/PSFonts.h"
 #include "board/Transforms.h"
+#include "board/DXF.h"
 #include "board/ShapeVisitor.h"
+#include "board/MemoryUsage.h"
+#include "board/Clipping.h"
+#include "board/ShapeList.h"
 #include <cmath>
 #include <cstring>
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
 #include <limits>
 
 #ifndef M_PI
@@ -69,6 +74,27 @@ const char * xFigDashStylesTikZ[] = {
   "dashdotdotted,",                             // DashDotDotStyle
   "dash pattern=on 2pt off 3pt on 4pt off 4pt," // DashDotDotDotStyle
 };
+
+std::atomic<unsigned long long> revisionCounter( 0 );
+
+// The character data of an SVG element, with the markup characters replaced
+// by their entities.
+std::string
+xmlEscaped( const std::string & text )
+{
+  if ( text.find_first_of( "<>&" ) == std::string::npos ) return text;
+  std::string result;
+  result.reserve( text.size() + 16 );
+  for ( char c : text ) {
+    switch ( c ) {
+    case '<': result += "&lt;"; break;
+    case '>': result += "&gt;"; break;
+    case '&': result += "&amp;"; break;
+    default: result += c;
+    }
+  }
+  return result;
+}
 }
 
 namespace PlaneDraw {
@@ -91,6 +117,12 @@ shapeGreaterDepth( const Shape *s1, const Shape *s2 )
 
 const std::string Shape::_name("AbstractShape");
 
+unsigned long long
+Shape::nextRevision()
+{
+  return ++revisionCounter;
+}
+
 const std::string &
 Shape::name() const
 {
@@ -163,12 +195,19 @@ void Shape::setLineWidthScaling(bool on)
 
 std::string
 Shape::svgProperties( const TransformSVG & transform ) const
+{
+  return svgProperties( transform, std::string() );
+}
+
+std::string
+Shape::svgProperties( const TransformSVG & transform, const std::string & fill ) const
 {
   static const char * capStrings[3] = { "butt", "round", "square" };
   static const char * joinStrings[3] = { "miter", "round", "bevel" };
+  const bool pattern = ! fill.empty();
   std::stringstream str;
   if ( _penColor != Color::Null ) {
-    str << " fill=\"" << _fillColor.svg() << '"'
+    str << " fill=\"" << ( pattern ? fill : _fillColor.svg() ) << '"'
         << " stroke=\"" << _penColor.svg() << '"'
         << " stroke-width=\"" << transform.mapWidth( _lineWidth ) << "mm\""
         << " style=\"stroke-linecap:" << capStrings[ _lineCap ]
@@ -176,18 +215,20 @@ Shape::svgProperties( const TransformSVG & transform ) const
     if ( _lineStyle != SolidStyle )
       str << ";" << xFigDashStylesSVG[ _lineStyle ];
     str << '"'
-        << _fillColor.svgAlpha( " fill" )
+        << ( pattern ? std::string() : _fillColor.svgAlpha( " fill" ) )
         << _penColor.svgAlpha( " stroke" );
   } else  {
-    str << " fill=\"" << _fillColor.svg() << '"'
+    str << " fill=\"" << ( pattern ? fill : _fillColor.svg() ) << '"'
            // 	<< " stroke=\"" << _fillColor.svg() << '"'
            // 	<< " stroke-width=\"0.5px\""
         << " stroke=\"none\""
         << " stroke-width=\"0\""
         << " style=\"stroke-linecap:round;stroke-linejoin:round;"
-        << '"'
-        << _fillColor.svgAlpha( " fill" )
-        << _fillColor.svgAlpha( " stroke" );
+        << '"';
+    if ( ! pattern ) {
+      str << _fillColor.svgAlpha( " fill" )
+          << _fillColor.svgAlpha( " stroke" );
+    }
   }
   return str.str();
 }
@@ -221,15 +262,23 @@ Shape::tikzProperties( const TransformTikZ & transform ) const
   return str.str();
 }
 
+Shape::ClipResult
+Shape::clip( const ClipRegion & region, ShapeList & ) const
+{
+  return region.meets( boundingBox( UseLineWidth ) ) ? Unclipped : ClippedOut;
+}
+
 void
 Shape::depth( int d )
 {
+  changed();
   _depth = d;
 }
 
 void
 Shape::shiftDepth( int shift )
 {
+  changed();
   _depth += shift;
 }
 
@@ -293,6 +342,23 @@ Shape::accept(const ShapeVisitor & visitor)
   visitor.visit(*this);
 }
 
+void
+Shape::accept(TypedShapeVisitor & visitor) const
+{
+  visitor.visit(*this);
+}
+
+void
+Shape::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Shape ) );
+}
+
+void
+Shape::shrinkToFit()
+{
+}
+
 /*
  * Dot
  */
@@ -313,6 +379,7 @@ Dot::center(LineWidthFlag) const {
 Dot &
 Dot::rotate( double angle, const Point & center )
 {
+  changed();
   Point( _x, _y ).rotate( angle, center ).get( _x, _y );
   return *this;
 }
@@ -326,6 +393,7 @@ Dot::rotated( double angle, const Point & center ) const
 Dot &
 Dot::rotate( double )
 {
+  changed();
   return *this;
 }
 
@@ -338,6 +406,7 @@ Dot::rotated( double ) const
 Dot &
 Dot::translate( double dx, double dy )
 {
+  changed();
   _x += dx;
   _y += dy;
   return *this;
@@ -352,12 +421,14 @@ Dot::translated( double dx, double dy ) const
 Dot &
 Dot::scale( double , double )
 {
+  changed();
   return *this;
 }
 
 Dot &
 Dot::scale( double )
 {
+  changed();
   return *this;
 }
 
@@ -376,6 +447,7 @@ Dot::scaled( double ) const
 void
 Dot::scaleAll( double s )
 {
+  changed();
   _x *= s;
   _y *= s;
 }
@@ -443,6 +515,15 @@ Dot::flushTikZ( std::ostream & stream,
   stream << "% FIXME: Dot::flushTikZ unimplemented" << std::endl;
 }
 
+void
+Dot::flushDXF( std::ostream & stream,
+               const TransformDXF & transform ) const
+{
+  transform.tables().entity( stream, "POINT", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+  stream << "100\nAcDbPoint\n";
+  DXFTables::point( stream, 10, transform.map( Point( _x, _y ) ) );
+}
+
 Rect
 Dot::boundingBox(LineWidthFlag lineWidthFlag) const
 {
@@ -465,6 +546,18 @@ Dot::clone() const {
   return new Dot(*this);
 }
 
+void
+Dot::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Dot::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Dot ) );
+}
+
 /*
    * Line
    */
@@ -480,6 +573,7 @@ Line::name() const
 Line &
 Line::rotate( double angle, const Point & center )
 {
+  changed();
   Point( _x1, _y1 ).rotate( angle, center ).get( _x1, _y1 );
   Point( _x2, _y2 ).rotate( angle, center ).get( _x2, _y2 );
   return *this;
@@ -488,6 +582,7 @@ Line::rotate( double angle, const Point & center )
 Line &
 Line::rotate( double angle )
 {
+  changed();
   return Line::rotate( angle, center() );
 }
 
@@ -513,6 +608,7 @@ Line::rotated( double angle ) const
 Line &
 Line::translate( double dx, double dy )
 {
+  changed();
   _x1 += dx; _x2 += dx;
   _y1 += dy; _y2 += dy;
   return *this;
@@ -530,6 +626,7 @@ Line::translated( double dx, double dy ) const
 Line &
 Line::scale( double sx, double sy )
 {
+  changed();
   Point c = center();
   _x1 *= sx;
   _x2 *= sx;
@@ -544,6 +641,7 @@ Line::scale( double sx, double sy )
 Line &
 Line::scale( double s )
 {
+  changed();
   scale( s, s );
   return (*this);
 }
@@ -563,6 +661,7 @@ Line::scaled( double s ) const
 void
 Line::scaleAll( double s )
 {
+  changed();
   _x1 *= s;
   _y1 *= s;
   _x2 *= s;
@@ -580,6 +679,18 @@ Line::clone() const {
   return new Line(*this);
 }
 
+void
+Line::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Line::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Line ) );
+}
+
 void
 Line::flushPostscript( std::ostream & stream,
                        const TransformEPS & transform ) const
@@ -647,17 +758,47 @@ Line::flushTikZ( std::ostream & stream,
          << ");" << std::endl;
 }
 
+void
+Line::flushDXF( std::ostream & stream,
+                const TransformDXF & transform ) const
+{
+  if ( ! _penColor.valid() )
+    return;
+  transform.tables().entity( stream, "LINE", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+  stream << "100\nAcDbLine\n";
+  DXFTables::point( stream, 10, transform.map( Point( _x1, _y1 ) ) );
+  DXFTables::point( stream, 11, transform.map( Point( _x2, _y2 ) ) );
+}
+
+Shape::ClipResult
+Line::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  if ( ! region.meets( boundingBox( UseLineWidth ) ) )
+    return ClippedOut;
+  Path path;
+  path << Point( _x1, _y1 ) << Point( _x2, _y2 );
+  std::vector<Path> lines;
+  if ( Tools::clipPolyline( path, region, lines ) )
+    return Unclipped;
+  if ( lines.empty() )
+    return ClippedOut;
+  for ( std::size_t i = 0; i < lines.size(); ++i ) {
+    pieces.emplace<Line>( lines[i][0], lines[i][1], _penColor, _lineWidth,
+                          _lineStyle, _lineCap, _lineJoin, _depth );
+  }
+  return Clipped;
+}
+
 Rect
 Line::boundingBox(LineWidthFlag lineWidthFlag) const
 {
-  Path p;
-  p << Point(_x1,_y1) << Point(_x2,_y2);
+  const Point p[2] = { Point(_x1,_y1), Point(_x2,_y2) };
   switch (lineWidthFlag) {
   case UseLineWidth:
-    return Tools::pathBoundingBox(p,_lineWidth,_lineCap,_lineJoin);
+    return Tools::pathBoundingBox(p,2,false,_lineWidth,_lineCap,_lineJoin);
     break;
   case IgnoreLineWidth:
-    return p.boundingBox();
+    return Tools::pathBoundingBox(p,2,false,0.0,_lineCap,_lineJoin);
     break;
   default:
     Tools::error << "LineWidthFlag incorrect value (" << lineWidthFlag << ")\n";
@@ -737,16 +878,11 @@ Arrow::boundingBox(Shape::LineWidthFlag) const
   double ndx2 = dx*cos(-0.3)-dy*sin(-0.3);
   double ndy2 = dx*sin(-0.3)+dy*cos(-0.3);
 
-  Path pLine;
-  pLine << Point(_x1,_y1);
-  pLine << Point(_x2+(dx*cos(0.3)), _y2+(dy*cos(0.3)));
+  const Point pLine[2] = { Point(_x1,_y1), Point(_x2+(dx*cos(0.3)), _y2+(dy*cos(0.3))) };
+  const Point pArrow[3] = { Point(_x2+ndx1,_y2+ndy1), Point(_x2,_y2), Point(_x2+ndx2,_y2+ndy2) };
 
-  Path pArrow;
-  pArrow << Point(_x2+ndx1,_y2+ndy1)
-         << Point(_x2,_y2 )
-         << Point(_x2+ndx2,_y2+ndy2);
-
-  return Tools::pathBoundingBox(pLine,_lineWidth,_lineCap,_lineJoin) || pArrow.boundingBox();
+  return Tools::pathBoundingBox(pLine,2,false,_lineWidth,_lineCap,_lineJoin)
+      || Tools::pathBoundingBox(pArrow,3,false,0.0,_lineCap,_lineJoin);
 }
 
 Arrow *
@@ -754,6 +890,18 @@ Arrow::clone() const {
   return new Arrow(*this);
 }
 
+void
+Arrow::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Arrow::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Arrow ) );
+}
+
 void
 Arrow::flushPostscript( std::ostream & stream,
                         const TransformEPS & transform ) const
@@ -888,6 +1036,48 @@ Arrow::flushTikZ( std::ostream & stream,
          << ");" << std::endl;
 }
 
+void
+Arrow::flushDXF( std::ostream & stream,
+                 const TransformDXF & transform ) const
+{
+  double dx = _x1 - _x2;
+  double dy = _y1 - _y2;
+  double norm = sqrt( dx*dx + dy*dy );
+  dx /= norm;
+  dy /= norm;
+  dx *= 10 * _lineWidth;
+  dy *= 10 * _lineWidth;
+  double ndx1 = dx*cos(0.3)-dy*sin(0.3);
+  double ndy1 = dx*sin(0.3)+dy*cos(0.3);
+  double ndx2 = dx*cos(-0.3)-dy*sin(-0.3);
+  double ndy2 = dx*sin(-0.3)+dy*cos(-0.3);
+  DXFTables & tables = transform.tables();
+
+  // The line
+  if ( _penColor.valid() ) {
+    tables.entity( stream, "LINE", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+    stream << "100\nAcDbLine\n";
+    DXFTables::point( stream, 10, transform.map( Point( _x1, _y1 ) ) );
+    DXFTables::point( stream, 11, transform.map( Point( _x2 + dx * cos(0.3), _y2 + dy * cos(0.3) ) ) );
+  }
+
+  // The arrow
+  if ( filled() ) {
+    std::vector<Point> head;
+    head.push_back( transform.map( Point( _x2 + ndx1, _y2 + ndy1 ) ) );
+    head.push_back( transform.map( Point( _x2, _y2 ) ) );
+    head.push_back( transform.map( Point( _x2 + ndx2, _y2 + ndy2 ) ) );
+    tables.hatch( stream, head, _depth, _fillColor, Hatch::None, transform );
+  }
+}
+
+Shape::ClipResult
+Arrow::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  // A piece of an arrow would lose its head, or get a wrong one.
+  return Shape::clip( region, pieces );
+}
+
 
 /*
    * Ellipse
@@ -906,9 +1096,18 @@ Ellipse::center(LineWidthFlag ) const {
   return _center;
 }
 
+Ellipse &
+Ellipse::setHatch( const Hatch & hatch )
+{
+  changed();
+  _hatch = hatch;
+  return *this;
+}
+
 Ellipse &
 Ellipse::rotate( double angle, const Point & center )
 {
+  changed();
   Point c( _center );
   Point e = (c + Point( _xRadius, 0 )).rotate( _angle, c );
   Point rc = c.rotated( angle, center );
@@ -916,6 +1115,7 @@ Ellipse::rotate( double angle, const Point & center )
   Point axis = re - rc;
   _angle = atan( axis.y / axis.x );
   _center = rc;
+  _hatch.rotate( angle );
   return *this;
 }
 
@@ -928,6 +1128,7 @@ Ellipse::rotated( double angle, const Point & center ) const
 Ellipse &
 Ellipse::rotate( double angle )
 {
+  changed();
   return Ellipse::rotate( angle, center() );
 }
 
@@ -940,6 +1141,7 @@ Ellipse::rotated( double angle ) const
 Ellipse &
 Ellipse::translate( double dx, double dy )
 {
+  changed();
   _center += Point( dx, dy );
   return *this;
 }
@@ -953,6 +1155,7 @@ Ellipse::translated( double dx, double dy ) const
 Ellipse &
 Ellipse::scale( double sx, double sy )
 {
+  changed();
   // Thanks to Freddie Exall for pointing an error with the first version
   // of this function, and for pointing to a fix as well!
   if ( _angle != 0 ) {
@@ -997,6 +1200,7 @@ Ellipse::scale( double sx, double sy )
     _xRadius = _xRadius * sx;
     _yRadius = _yRadius * sy;
   }
+  _hatch.scale( sx, sy );
   updateLineWidth(std::max(sx,sy));
   return *this;
 }
@@ -1004,6 +1208,7 @@ Ellipse::scale( double sx, double sy )
 Ellipse &
 Ellipse::scale( double s )
 {
+  changed();
   return Ellipse::scale( s, s );
 }
 
@@ -1022,9 +1227,11 @@ Ellipse::scaled( double s ) const
 void
 Ellipse::scaleAll( double s )
 {
+  changed();
   _xRadius *= s;
   _yRadius *= s;
   _center *= s;
+  _hatch.spacing *= s;
 }
 
 Ellipse
@@ -1038,6 +1245,18 @@ Ellipse::clone() const {
   return new Ellipse(*this);
 }
 
+void
+Ellipse::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Ellipse::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Ellipse ) );
+}
+
 void
 Ellipse::flushPostscript( std::ostream & stream,
                           const TransformEPS & transform ) const
@@ -1055,6 +1274,18 @@ Ellipse::flushPostscript( std::ostream & stream,
     stream << " fill gr" << std::endl;
   }
 
+  if ( _hatch.valid() ) {
+    const std::string pattern = _hatch.flushPostscriptDefinition( stream, transform );
+    stream << "gs "
+           << transform.mapX( _center.x ) << " " << transform.mapY( _center.y ) << " tr";
+    if ( _angle != 0.0 ) stream << " " << (_angle*180/M_PI) << " rot ";
+    if ( ! _circle ) stream << " " << 1.0 << " " << yScale << " sc";
+    stream << " n " << transform.scale( _xRadius ) << " 0 m "
+           << " 0 0 " << transform.scale( _xRadius ) << " 0.0 360.0 arc ";
+    stream << " " << pattern << " setpattern";
+    stream << " fill gr" << std::endl;
+  }
+
   if ( _penColor != Color::Null ) {
     stream << postscriptProperties(transform) << "\n";
     stream << "gs " << transform.mapX( _center.x ) << " " << transform.mapY( _center.y ) << " tr";
@@ -1078,10 +1309,12 @@ Ellipse::flushFIG( std::ostream & stream,
   else
     stream << "1 1 " << _lineStyle << " ";
   stream << ( _penColor.valid()?transform.mapWidth( _lineWidth ):0 ) << " ";
-  // Pen color, Fill color
-  stream << colormap[ _penColor ] << " " << colormap[ _fillColor ] << " ";
+  // Pen color, Fill color (the background of a pattern, white by default)
+  stream << colormap[ _penColor ] << " " << ( _hatch.valid() && ! filled() ? 7 : colormap[ _fillColor ] ) << " ";
   // Depth, Pen style, Area fill, Style val, Direction, angle
-  if ( filled() )
+  if ( _hatch.valid() )
+    stream << transform.mapDepth( _depth ) << " -1 " << _hatch.figAreaFill() << " " << (_lineStyle?"4.000 ":"0.000 ") << "  1 " << _angle << " ";
+  else if ( filled() )
     stream << transform.mapDepth( _depth ) << " -1 20 " << (_lineStyle?"4.000 ":"0.000 ") << "  1 " << _angle << " ";
   else
     stream << transform.mapDepth( _depth ) << " -1 -1 " << (_lineStyle?"4.000 ":"0.000 ") << " 1 " << _angle << " ";
@@ -1099,11 +1332,13 @@ void
 Ellipse::flushSVG( std::ostream & stream,
                    const TransformSVG & transform ) const
 {
+  // The pattern is in the (rotated) coordinates of the element.
+  const std::string fill = _hatch.valid() ? _hatch.rotated( -_angle ).flushSVGDefinition( stream, transform, _fillColor ) : std::string();
   stream << "<ellipse cx=\"" << transform.mapX( _center.x ) << '"'
          << " cy=\"" << transform.mapY( _center.y ) << '"'
          << " rx=\"" << transform.scale( _xRadius ) << '"'
          << " ry=\"" << transform.scale( _yRadius ) << '"'
-         << svgProperties( transform ) ;
+         << svgProperties( transform, fill ) ;
   if ( _angle != 0.0 ) {
     stream << " transform=\"rotate( "
            << -(_angle*180/M_PI) << ", "
@@ -1119,7 +1354,7 @@ Ellipse::flushTikZ( std::ostream & stream,
 {
   // FIXME: unimplemented
   stream << "% FIXME: Ellipse::flushTikZ unimplemented" << std::endl;
-  stream << "\\path[" << tikzProperties(transform) << "] ("
+  stream << "\\path[" << tikzProperties(transform) << ( _hatch.valid() ? _hatch.tikz( transform, _fillColor ) : std::string() ) << "] ("
          << transform.mapX( _center.x ) << ','
          << transform.mapY( _center.y ) << ')'
          << " circle [x radius=" << transform.scale( _xRadius ) << ','
@@ -1129,6 +1364,58 @@ Ellipse::flushTikZ( std::ostream & stream,
                            << std::endl;
 }
 
+void
+Ellipse::flushDXF( std::ostream & stream,
+                   const TransformDXF & transform ) const
+{
+  DXFTables & tables = transform.tables();
+  const Point center = transform.map( _center );
+  const double xRadius = transform.scale( _xRadius );
+  const double yRadius = transform.scale( _yRadius );
+  const bool circle = ( xRadius == yRadius );
+  // The major axis, relative to the center, and the ratio of the minor one.
+  const Point major = ( xRadius >= yRadius )
+      ? Point( xRadius * cos( _angle ), xRadius * sin( _angle ) )
+      : Point( -yRadius * sin( _angle ), yRadius * cos( _angle ) );
+  const double ratio = ( xRadius >= yRadius ) ? yRadius / xRadius : xRadius / yRadius;
+
+  for ( int layer = 0; layer < 2; ++layer ) {
+    const Hatch & hatch = layer ? _hatch : Hatch::None;
+    if ( layer ? ! _hatch.valid() : ! filled() )
+      continue;
+    tables.beginHatch( stream, _depth, layer ? _hatch.color : _fillColor, hatch, transform );
+    // One external path of a single edge.
+    stream << "92\n1\n93\n1\n";
+    if ( circle ) {
+      stream << "72\n2\n";
+      DXFTables::point( stream, 10, center, false );
+      stream << "40\n" << xRadius << "\n";
+    } else {
+      stream << "72\n3\n";
+      DXFTables::point( stream, 10, center, false );
+      DXFTables::point( stream, 11, major, false );
+      stream << "40\n" << ratio << "\n";
+    }
+    stream << "50\n0\n51\n360\n73\n1\n97\n0\n";
+    tables.endHatch( stream, hatch, transform );
+  }
+
+  if ( ! _penColor.valid() )
+    return;
+  if ( circle ) {
+    tables.entity( stream, "CIRCLE", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+    stream << "100\nAcDbCircle\n";
+    DXFTables::point( stream, 10, center );
+    stream << "40\n" << xRadius << "\n";
+  } else {
+    tables.entity( stream, "ELLIPSE", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+    stream << "100\nAcDbEllipse\n";
+    DXFTables::point( stream, 10, center );
+    DXFTables::point( stream, 11, major );
+    stream << "40\n" << ratio << "\n41\n0\n42\n" << 2 * M_PI << "\n";
+  }
+}
+
 Rect
 Ellipse::boundingBox( LineWidthFlag lineWidthFlag ) const
 {
@@ -1177,6 +1464,7 @@ Circle::center(LineWidthFlag ) const {
 Circle &
 Circle::rotate( double angle, const Point & center )
 {
+  changed();
   if ( _circle ) {
     if ( center == _center ) return *this;
     _center.rotate( angle, center );
@@ -1195,6 +1483,7 @@ Circle::rotated( double angle, const Point & center ) const
 Circle &
 Circle::rotate( double angle )
 {
+  changed();
   if ( !_circle )
     Ellipse::rotate( angle );
   return *this;
@@ -1209,6 +1498,7 @@ Circle::rotated( double angle ) const
 Circle &
 Circle::translate( double dx, double dy )
 {
+  changed();
   _center += Point( dx, dy );
   return *this;
 }
@@ -1222,6 +1512,7 @@ Circle::translated( double dx, double dy ) const
 Circle &
 Circle::scale( double sx, double sy )
 {
+  changed();
   _circle = false;
   Ellipse::scale( sx, sy );
   return *this;
@@ -1230,6 +1521,7 @@ Circle::scale( double sx, double sy )
 Circle &
 Circle::scale( double s )
 {
+  changed();
   Ellipse::scale( s );
   return *this;
 }
@@ -1255,6 +1547,7 @@ Circle::resized(double w, double h, Shape::LineWidthFlag lineWidthFlag) const
 void
 Circle::scaleAll( double s )
 {
+  changed();
   _center *= s;
   _xRadius *= s;
   _yRadius *= s;
@@ -1265,6 +1558,18 @@ Circle::clone() const {
   return new Circle(*this);
 }
 
+void
+Circle::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Circle::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Circle ) );
+}
+
 void
 Circle::flushSVG( std::ostream & stream,
                   const TransformSVG & transform ) const
@@ -1272,10 +1577,11 @@ Circle::flushSVG( std::ostream & stream,
   if ( ! _circle ) {
     Ellipse::flushSVG( stream, transform );
   } else {
+    const std::string fill = _hatch.valid() ? _hatch.flushSVGDefinition( stream, transform, _fillColor ) : std::string();
     stream << "<circle cx=\"" << transform.mapX( _center.x ) << '"'
            << " cy=\"" << transform.mapY( _center.y ) << '"'
            << " r=\"" << transform.scale( _xRadius ) << '"'
-           << svgProperties( transform )
+           << svgProperties( transform, fill )
            << " />" << std::endl;
   }
 }
@@ -1287,7 +1593,7 @@ Circle::flushTikZ( std::ostream & stream,
   if ( ! _circle ) {
     Ellipse::flushTikZ( stream, transform );
   } else {
-    stream << "\\path[" << tikzProperties(transform) << "] ("
+    stream << "\\path[" << tikzProperties(transform) << ( _hatch.valid() ? _hatch.tikz( transform, _fillColor ) : std::string() ) << "] ("
            << transform.mapX( _center.x ) << ','
            << transform.mapY( _center.y ) << ')'
            << " circle (" << transform.scale( _xRadius ) << ");"
@@ -1310,14 +1616,25 @@ Polyline::name() const
 Polyline &
 Polyline::operator<<( const Point & p )
 {
+  changed();
   _path << p;
   return *this;
 }
 
+Polyline &
+Polyline::setHatch( const Hatch & hatch )
+{
+  changed();
+  _hatch = hatch;
+  return *this;
+}
+
 Polyline &
 Polyline::rotate( double angle, const Point & center )
 {
+  changed();
   _path.rotate( angle, center );
+  _hatch.rotate( angle );
   return *this;
 }
 
@@ -1330,7 +1647,9 @@ Polyline::rotated( double angle, const Point & center ) const
 Polyline &
 Polyline::rotate( double angle )
 {
+  changed();
   _path.rotate( angle, center() );
+  _hatch.rotate( angle );
   return *this;
 }
 
@@ -1343,6 +1662,7 @@ Polyline::rotated( double angle ) const
 Polyline &
 Polyline::translate( double dx, double dy )
 {
+  changed();
   _path.translate( dx, dy );
   return *this;
 }
@@ -1356,7 +1676,9 @@ Polyline::translated( double dx, double dy ) const
 Polyline &
 Polyline::scale( double sx, double sy )
 {
+  changed();
   _path.scale( sx, sy );
+  _hatch.scale( sx, sy );
   updateLineWidth(std::max(sx,sy));
   return *this;
 }
@@ -1364,6 +1686,7 @@ Polyline::scale( double sx, double sy )
 Polyline &
 Polyline::scale( double s )
 {
+  changed();
   Polyline::scale( s, s );
   return *this;
 }
@@ -1383,7 +1706,9 @@ Polyline::scaled( double s) const
 void
 Polyline::scaleAll( double s )
 {
+  changed();
   _path.scaleAll( s );
+  _hatch.spacing *= s;
 }
 
 Polyline
@@ -1397,6 +1722,25 @@ Polyline::clone() const {
   return new Polyline(*this);
 }
 
+void
+Polyline::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Polyline::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Polyline ) );
+  usage.addPath( name(), _path );
+}
+
+void
+Polyline::shrinkToFit()
+{
+  _path.shrinkToFit();
+}
+
 void
 Polyline::flushPostscript( std::ostream & stream,
                            const TransformEPS & transform ) const
@@ -1411,6 +1755,12 @@ Polyline::flushPostscript( std::ostream & stream,
     stream << " " << postscriptProperties(transform);
     stream << " fill" << std::endl;
   }
+  if ( _hatch.valid() ) {
+    const std::string pattern = _hatch.flushPostscriptDefinition( stream, transform );
+    stream << "n ";
+    _path.flushPostscript( stream, transform );
+    stream << " " << pattern << " setpattern fill" << std::endl;
+  }
   if ( _penColor != Color::Null ) {
     stream << " " << postscriptProperties(transform) << "\n";
     stream << "n ";
@@ -1436,14 +1786,16 @@ Polyline::flushFIG( std::ostream & stream,
   stream << ( _penColor.valid()?transform.mapWidth( _lineWidth ):0 ) << " ";
   // Pen color
   stream << colormap[ _penColor ] << " ";
-  // Fill color
-  stream << colormap[ _fillColor ] << " ";
+  // Fill color (the background of a pattern, white by default)
+  stream << ( _hatch.valid() && ! filled() ? 7 : colormap[ _fillColor ] ) << " ";
   // Depth
   stream << transform.mapDepth( _depth ) << " ";
   // Pen style
   stream <<  "-1 ";
   // Area fill, style val, join style, cap style, radius, f_arrow, b_arrow
-  if ( filled() )
+  if ( _hatch.valid() )
+    stream << _hatch.figAreaFill() << " " << (_lineStyle?"4.000 ":"0.000 ") << _lineJoin << " " << _lineCap << " -1 0 0 ";
+  else if ( filled() )
     stream << "20 " << (_lineStyle?"4.000 ":"0.000 ") << _lineJoin << " " << _lineCap << " -1 0 0 ";
   else
     stream << "-1 " << (_lineStyle?"4.000 ":"0.000 ")  << _lineJoin << " " << _lineCap << " -1 0 0 ";
@@ -1459,11 +1811,12 @@ Polyline::flushSVG( std::ostream & stream,
 {
   if ( _path.empty() )
     return;
+  const std::string fill = _hatch.valid() ? _hatch.flushSVGDefinition( stream, transform, _fillColor ) : std::string();
   if ( _path.closed() )
     stream << "<polygon";
   else
     stream << "<polyline";
-  stream << svgProperties( transform ) << std::endl;
+  stream << svgProperties( transform, fill ) << std::endl;
   stream << "          points=\"";
   _path.flushSVGPoints( stream, transform );
   stream << "\" />" << std::endl;
@@ -1476,13 +1829,75 @@ Polyline::flushTikZ( std::ostream & stream,
   if ( _path.empty() )
     return;
 
-  stream << "\\path[" << tikzProperties(transform) << "] ";
+  stream << "\\path[" << tikzProperties(transform) << ( _hatch.valid() ? _hatch.tikz( transform, _fillColor ) : std::string() ) << "] ";
   _path.flushTikZPoints( stream, transform );
   if ( _path.closed() )
     stream << " -- cycle";
   stream << ";" << std::endl;
 }
 
+void
+Polyline::flushDXF( std::ostream & stream,
+                    const TransformDXF & transform ) const
+{
+  if ( _path.empty() )
+    return;
+  DXFTables & tables = transform.tables();
+  std::vector<Point> points( _path.size() );
+  for ( std::size_t i = 0; i < _path.size(); ++i )
+    points[i] = transform.map( _path[i] );
+
+  if ( points.size() > 2 ) {
+    if ( filled() )
+      tables.hatch( stream, points, _depth, _fillColor, Hatch::None, transform );
+    if ( _hatch.valid() )
+      tables.hatch( stream, points, _depth, _hatch.color, _hatch, transform );
+  }
+  if ( ! _penColor.valid() )
+    return;
+  tables.entity( stream, "LWPOLYLINE", _depth, _penColor, transform.mapWidth( _lineWidth ), _lineStyle );
+  stream << "100\nAcDbPolyline\n90\n" << points.size()
+         << "\n70\n" << ( _path.closed() ? 1 : 0 ) << "\n";
+  for ( std::vector<Point>::const_iterator it = points.begin(); it != points.end(); ++it )
+    DXFTables::point( stream, 10, *it, false );
+}
+
+Shape::ClipResult
+Polyline::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  const Rect box = boundingBox( UseLineWidth );
+  if ( ! region.meets( box ) )
+    return ClippedOut;
+  const bool filled = _fillColor.valid() || _hatch.valid();
+  const bool stroked = _penColor.valid();
+  if ( region.surrounds( box ) || ! ( filled || stroked ) )
+    return Unclipped;
+
+  // The area and the line are clipped apart: the line of a piece of the
+  // area would otherwise follow the edges of the region.
+  std::vector<Path> areas;
+  std::vector<Path> lines;
+  const bool areaInside = filled && Tools::clipPolygon( _path, region, areas );
+  const bool lineInside = stroked && Tools::clipPolyline( _path, region, lines );
+  if ( ( areaInside || ! filled ) && ( lineInside || ! stroked ) )
+    return Unclipped;
+  if ( areaInside )
+    areas.push_back( Path( _path.points(), true ) );
+  if ( lineInside )
+    lines.push_back( _path );
+  if ( areas.empty() && lines.empty() )
+    return ClippedOut;
+  for ( std::size_t i = 0; i < areas.size(); ++i ) {
+    pieces.emplace<Polyline>( areas[i], Color::Null, _fillColor, _lineWidth,
+                              _lineStyle, _lineCap, _lineJoin, _depth ).setHatch( _hatch );
+  }
+  for ( std::size_t i = 0; i < lines.size(); ++i ) {
+    pieces.emplace<Polyline>( lines[i], _penColor, Color::Null, _lineWidth,
+                              _lineStyle, _lineCap, _lineJoin, _depth );
+  }
+  return Clipped;
+}
+
 Rect
 Polyline::boundingBox(LineWidthFlag lineWidthFlag) const
 {
@@ -1545,6 +1960,7 @@ Rectangle::scaled( double s ) const
 void
 Rectangle::scaleAll( double s )
 {
+  changed();
   _path.scaleAll( s );
 }
 
@@ -1559,6 +1975,19 @@ Rectangle::clone() const {
   return new Rectangle(*this);
 }
 
+void
+Rectangle::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Rectangle::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Rectangle ) );
+  usage.addPath( name(), _path );
+}
+
 void
 Rectangle::flushFIG( std::ostream & stream,
                      const TransformFIG & transform,
@@ -1587,14 +2016,16 @@ Rectangle::flushFIG( std::ostream & stream,
   stream << ( _penColor.valid()?transform.mapWidth( _lineWidth ):0 ) << " ";
   // Pen color
   stream << colormap[ _penColor ] << " ";
-  // Fill color
-  stream << colormap[ _fillColor ] << " ";
+  // Fill color (the background of a pattern, white by default)
+  stream << ( _hatch.valid() && ! filled() ? 7 : colormap[ _fillColor ] ) << " ";
   // Depth
   stream << transform.mapDepth( _depth ) << " ";
   // Pen style
   stream <<  "-1 ";
   // Area fill, style val, join style, cap style, radius, f_arrow, b_arrow, number of points
-  if ( filled() )
+  if ( _hatch.valid() )
+    stream << _hatch.figAreaFill() << " " << (_lineStyle?"4.000 ":"0.000 ") << _lineJoin << " " << _lineCap << " -1 0 0 5\n";
+  else if ( filled() )
     stream << "20 " << (_lineStyle?"4.000 ":"0.000 ") << _lineJoin << " " << _lineCap << " -1 0 0 5\n";
   else
     stream << "-1 " << (_lineStyle?"4.000 ":"0.000 ") << _lineJoin << " " << _lineCap << " -1 0 0 5\n";
@@ -1619,6 +2050,7 @@ Rectangle::flushSVG( std::ostream & stream,
   }
 
   if ( _path[0].y == _path[1].y ) {
+    const std::string fill = _hatch.valid() ? _hatch.flushSVGDefinition( stream, transform, _fillColor ) : std::string();
     stream << "<rect x=\""
            << transform.mapX( _path[0].x )
         << '"'
@@ -1628,12 +2060,14 @@ Rectangle::flushSVG( std::ostream & stream,
         << '"'
         << " height=\"" << transform.scale( _path[0].y - _path[3].y )
         << '"'
-        << svgProperties( transform )
+        << svgProperties( transform, fill )
         << " />" << std::endl;
   } else {
     Point v = _path[1] - _path[0];
     v /= v.norm();
     double angle = ( _path[1].y > _path[0].y ) ? acos( v * Point(1,0) ) : -acos( v * Point( 1, 0 ) );
+    // The pattern is in the (rotated) coordinates of the element.
+    const std::string fill = _hatch.valid() ? _hatch.rotated( -angle ).flushSVGDefinition( stream, transform, _fillColor ) : std::string();
     angle = ( angle * 180 ) / M_PI;
     stream << "<rect x=\""
            << transform.mapX( _path[0].x )
@@ -1647,7 +2081,7 @@ Rectangle::flushSVG( std::ostream & stream,
         << " height=\""
         << transform.scale( (_path[0] - _path[3]).norm() )
         << '"'
-        << svgProperties( transform )
+        << svgProperties( transform, fill )
         << ' '
         << " transform=\"rotate(" << -angle << ", "
         << transform.mapX( _path[0].x )
@@ -1727,6 +2161,7 @@ GouraudTriangle::GouraudTriangle( const Point & p0, float brightness0,
 GouraudTriangle &
 GouraudTriangle::rotate( double angle, const Point & center )
 {
+  changed();
   _path.rotate( angle, center );
   return *this;
 }
@@ -1740,6 +2175,7 @@ GouraudTriangle::rotated( double angle, const Point & center ) const
 GouraudTriangle &
 GouraudTriangle::rotate( double angle )
 {
+  changed();
   return GouraudTriangle::rotate( angle, center() );
 }
 
@@ -1770,6 +2206,7 @@ GouraudTriangle::scaled( double s ) const
 void
 GouraudTriangle::scaleAll( double s )
 {
+  changed();
   _path.scaleAll( s );
 }
 
@@ -1784,6 +2221,19 @@ GouraudTriangle::clone() const {
   return new GouraudTriangle(*this);
 }
 
+void
+GouraudTriangle::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+GouraudTriangle::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( GouraudTriangle ) );
+  usage.addPath( name(), _path );
+}
+
 void
 GouraudTriangle::flushPostscript( std::ostream & stream,
                                   const TransformEPS & transform ) const
@@ -1891,6 +2341,23 @@ GouraudTriangle::flushTikZ( std::ostream & stream,
   stream << "% FIXME: GouraudTriangle::flushTikZ unimplemented" << std::endl;
 }
 
+void
+GouraudTriangle::flushDXF( std::ostream & stream,
+                           const TransformDXF & transform ) const
+{
+  Color c( static_cast<unsigned char>((_color0.red() + _color1.red() + _color2.red() )/3.0),
+           static_cast<unsigned char>((_color0.green() + _color1.green() + _color2.green())/3.0),
+           static_cast<unsigned char>((_color0.blue() + _color1.blue() + _color2.blue())/3.0 ));
+  Polyline( _path, Color::Null, c, 0.0f, SolidStyle, ButtCap, MiterJoin, _depth ).flushDXF( stream, transform );
+}
+
+Shape::ClipResult
+GouraudTriangle::clip( const ClipRegion & region, ShapeList & pieces ) const
+{
+  // The shading does not survive a cut.
+  return Shape::clip( region, pieces );
+}
+
 /*
  * Triangle
  */
@@ -1938,6 +2405,19 @@ Triangle::clone() const {
   return new Triangle(*this);
 }
 
+void
+Triangle::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Triangle::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Triangle ) );
+  usage.addPath( name(), _path );
+}
+
 /*
  * Text
  */
@@ -2037,6 +2517,7 @@ Text::center(LineWidthFlag ) const {
 Text &
 Text::rotate( double angle, const Point & center )
 {
+  changed();
   _box.rotate(angle,center);
   //  Point endPos = _position + Point( 10000 * cos( _angle ), 10000 * sin( _angle ) );
   //  _position.rotate( angle, center );
@@ -2058,6 +2539,7 @@ Text::rotated( double angle, const Point & center ) const
 Text &
 Text::rotate( double angle )
 {
+  changed();
   _box.rotate(angle);
   //  _angle += angle;
   //  while ( _angle < -M_PI ) {
@@ -2078,6 +2560,7 @@ Text::rotated( double angle ) const
 Text &
 Text::translate( double dx, double dy )
 {
+  changed();
   _box.translate(dx,dy);
   return *this;
 }
@@ -2091,6 +2574,7 @@ Text::translated( double dx, double dy ) const
 Text &
 Text::scale( double sx, double sy )
 {
+  changed();
   // TODO Actually handle scaling.
   _xScale *= sx;
   _yScale *= sy;
@@ -2101,6 +2585,7 @@ Text::scale( double sx, double sy )
 Text &
 Text::scale( double s )
 {
+  changed();
   _xScale *= s;
   _yScale *= s;
   _box.scale(s);
@@ -2122,6 +2607,7 @@ Text::scaled( double s ) const
 void
 Text::scaleAll( double s )
 {
+  changed();
   _box.scaleAll(s);
 }
 
@@ -2130,6 +2616,29 @@ Text::clone() const {
   return new Text(*this);
 }
 
+void
+Text::accept( TypedShapeVisitor & visitor ) const
+{
+  visitor.visit( *this );
+}
+
+void
+Text::accountMemory( MemoryUsage & usage ) const
+{
+  usage.addObject( name(), sizeof( Text ) );
+  usage.addString( name(), _text );
+  usage.addString( name(), _svgFont );
+  usage.addPath( name(), _box );
+}
+
+void
+Text::shrinkToFit()
+{
+  _text.shrink_to_fit();
+  _svgFont.shrink_to_fit();
+  _box.shrinkToFit();
+}
+
 double Text::boxHeight(const Transform & transform) const
 {
   Point baseline = (_box[1] - _box[0]);
@@ -2216,7 +2725,7 @@ Text::flushSVG( std::ostream & stream,
            << _fillColor.svgAlpha( " fill" )
            << _penColor.svgAlpha( " stroke" )
            << ">"
-           << _text
+           << xmlEscaped( _text )
            << "</text></g></g>" << std::endl;
   } else {
     stream << "<text x=\"" << transform.mapX( position().x )
@@ -2227,7 +2736,7 @@ Text::flushSVG( std::ostream & stream,
            << _fillColor.svgAlpha( " fill" )
            << _penColor.svgAlpha( " stroke" )
            << ">"
-           << _text
+           << xmlEscaped( _text )
            << "</text>" << std::endl;
   }
   // DEBUG
@@ -2292,6 +2801,25 @@ Text::flushTikZ( std::ostream & stream,
          << "};" << std::endl;
 }
 
+void
+Text::flushDXF( std::ostream & stream,
+                const TransformDXF & transform ) const
+{
+  DXFTables & tables = transform.tables();
+  const char * style = tables.style( _font );
+  tables.entity( stream, "TEXT", _depth, _penColor, -1.0, SolidStyle );
+  stream << "100\nAcDbText\n";
+  DXFTables::point( stream, 10, transform.map( position() ) );
+  stream << "40\n" << boxHeight( transform ) << "\n";
+  // A TEXT entity holds a single line.
+  std::string text( _text );
+  std::replace( text.begin(), text.end(), '\n', ' ' );
+  stream << "1\n" << text << "\n";
+  if ( angle() != 0.0 )
+    stream << "50\n" << angle() * 180.0 / M_PI << "\n";
+  stream << "7\n" << style << "\n100\nAcDbText\n";
+}
+
 Rect
 Text::boundingBox( LineWidthFlag ) const
 {
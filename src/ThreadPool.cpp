@@ -0,0 +1,230 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   ThreadPool.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  A fixed-size pool of worker threads with work stealing.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/ThreadPool.h"
+#include "board/Tools.h"
+#include <exception>
+
+namespace {
+
+// The pool and the queue index of the calling thread, if it is a worker.
+thread_local const PlaneDraw::ThreadPool * currentPool = 0;
+thread_local std::size_t currentWorker = 0;
+
+}
+
+namespace PlaneDraw {
+
+ThreadPool::ThreadPool( std::size_t threads )
+  : _queued( 0 ), _unfinished( 0 ), _stop( false ), _next( 0 ), _steals( 0 )
+{
+  if ( ! threads ) {
+    threads = std::thread::hardware_concurrency();
+  }
+  if ( ! threads ) {
+    threads = 1;
+  }
+  for ( std::size_t i = 0; i < threads; ++i ) {
+    _workers.push_back( std::unique_ptr<Worker>( new Worker ) );
+  }
+  for ( std::size_t i = 0; i < threads; ++i ) {
+    _threads.push_back( std::thread( &ThreadPool::run, this, i ) );
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  wait();
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _stop = true;
+  }
+  _wakeup.notify_all();
+  for ( std::size_t i = 0; i < _threads.size(); ++i ) {
+    _threads[i].join();
+  }
+}
+
+void
+ThreadPool::submit( const Task & task )
+{
+  const std::size_t index = ( currentPool == this )
+      ? currentWorker
+      : ( _next++ % _workers.size() );
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    {
+      std::lock_guard<std::mutex> queueLock( _workers[index]->mutex );
+      _workers[index]->tasks.push_back( task );
+    }
+    ++_queued;
+    ++_unfinished;
+  }
+  _wakeup.notify_one();
+}
+
+void
+ThreadPool::wait()
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+  _idle.wait( lock, [this]() { return _unfinished == 0; } );
+}
+
+std::size_t
+ThreadPool::threadCount() const
+{
+  return _threads.size();
+}
+
+std::size_t
+ThreadPool::steals() const
+{
+  return _steals;
+}
+
+std::size_t
+ThreadPool::hardwareThreads()
+{
+  static const std::size_t threads = std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+  return threads;
+}
+
+ThreadPool &
+ThreadPool::shared()
+{
+  static ThreadPool pool( hardwareThreads() );
+  return pool;
+}
+
+void
+ThreadPool::parallelRanges( std::size_t count, std::size_t ranges,
+                            const std::function<void( std::size_t, std::size_t, std::size_t )> & task )
+{
+  if ( ranges < 2 || currentPool ) {
+    for ( std::size_t range = 0; range < ranges; ++range ) {
+      task( range, range * count / ranges, ( range + 1 ) * count / ranges );
+    }
+    return;
+  }
+  // The loop waits for its own ranges only, so that loops of several
+  // threads may share the pool.
+  std::mutex mutex;
+  std::condition_variable done;
+  std::size_t pending = ranges - 1;
+  std::exception_ptr failure;
+  ThreadPool & pool = shared();
+  for ( std::size_t range = 1; range < ranges; ++range ) {
+    pool.submit( [&,range]() {
+        std::exception_ptr error;
+        try {
+          task( range, range * count / ranges, ( range + 1 ) * count / ranges );
+        } catch ( ... ) {
+          error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( error && ! failure ) {
+          failure = error;
+        }
+        if ( --pending == 0 ) {
+          done.notify_all();
+        }
+      } );
+  }
+  std::exception_ptr error;
+  try {
+    task( 0, 0, count / ranges );
+  } catch ( ... ) {
+    error = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lock( mutex );
+  done.wait( lock, [&pending]() { return pending == 0; } );
+  if ( error ) {
+    std::rethrow_exception( error );
+  }
+  if ( failure ) {
+    std::rethrow_exception( failure );
+  }
+}
+
+bool
+ThreadPool::pop( std::size_t index, Task & task )
+{
+  {
+    Worker & own = *_workers[index];
+    std::lock_guard<std::mutex> lock( own.mutex );
+    if ( ! own.tasks.empty() ) {
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  for ( std::size_t i = 1; i < _workers.size(); ++i ) {
+    Worker & victim = *_workers[( index + i ) % _workers.size()];
+    std::lock_guard<std::mutex> lock( victim.mutex );
+    if ( ! victim.tasks.empty() ) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      ++_steals;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+ThreadPool::run( std::size_t index )
+{
+  currentPool = this;
+  currentWorker = index;
+  for ( ;; ) {
+    Task task;
+    if ( pop( index, task ) ) {
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        --_queued;
+      }
+      try {
+        task();
+      } catch ( std::exception & e ) {
+        Tools::error << "ThreadPool: uncaught exception in task (" << e.what() << ").\n";
+      } catch ( ... ) {
+        Tools::error << "ThreadPool: uncaught exception in task.\n";
+      }
+      std::lock_guard<std::mutex> lock( _mutex );
+      if ( --_unfinished == 0 ) {
+        _idle.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock( _mutex );
+    _wakeup.wait( lock, [this]() { return _stop || _queued > 0; } );
+    if ( _stop && ! _queued ) {
+      return;
+    }
+  }
+}
+
+} // namespace PlaneDraw
@@ -32,6 +32,14 @@
 #include <ctime>
 #include <cstdlib>
 #include <cstdio>
+#include <functional>
+#include <thread>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if ( _BOARD_WIN32_ == 1 )
+#include <direct.h>
+#endif
 
 PlaneDraw::Tools::MessageStream PlaneDraw::Tools::notice( std::cerr, "Information: " );
 
@@ -40,49 +48,24 @@ PlaneDraw::Tools::MessageStream PlaneDraw::Tools::warning( std::cerr, "Warning:
 PlaneDraw::Tools::MessageStream PlaneDraw::Tools::error( std::cerr, "Error: " );
 
 namespace {
-unsigned long boardRandNext = time(0);
+
+// Each thread has its own sequence, seeded differently so that concurrent
+// exports do not pick the same temporary filenames.
+unsigned long
+boardRandSeed()
+{
+  return static_cast<unsigned long>( time(0) )
+      ^ static_cast<unsigned long>( std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+}
+
+thread_local unsigned long boardRandNext = boardRandSeed();
+
 }
 
 namespace PlaneDraw {
 
 namespace Tools {
 
-bool
-base64encode( std::istream & in, std::ostream & out, int linesize )
-{
-  static const char b64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  unsigned char input[3];
-  char output[4];
-  int nbBlocks = 0;
-
-  *input = (unsigned char) 0;
-  *output = (unsigned char) 0;
-  while( in ) {
-    int len = 0;
-    for( int i = 0; i < 3; i++ ) {
-      input[i] = (unsigned char) in.get();
-      if( in ) {
-        len++;
-      } else {
-        input[i] = (unsigned char) 0;
-      }
-    }
-    if( len > 0 ) {
-      output[0] = (unsigned char) b64[ (int)(input[0] >> 2) ];
-      output[1] = (unsigned char) b64[ (int)(((input[0] & 0x03) << 4) | ((input[1] & 0xf0) >> 4)) ];
-      output[2] = (unsigned char) (len > 1 ? b64[ (int)(((input[1] & 0x0f) << 2) | ((input[2] & 0xc0) >> 6)) ] : '=');
-      output[3] = (unsigned char) (len > 2 ? b64[ (int)(input[2] & 0x3f) ] : '=');
-      if ( ! out.write(output,4) ) return false;
-      ++nbBlocks;
-    }
-    if( nbBlocks >= (linesize/4) || ! in ) {
-      if( nbBlocks > 0 ) out << "\r\n";
-      nbBlocks = 0;
-    }
-  }
-  return true;
-}
-
 bool stringEndsWith(const char * str, const char * end, CaseSensitivity sensitivity )
 {
   size_t nstr = strlen(str);
@@ -166,6 +149,22 @@ canReadFile(const char * filename)
   return ok;
 }
 
+bool
+makeDirectory(const char * path)
+{
+#if ( _BOARD_WIN32_ == 1 )
+  if ( _mkdir(path) == 0 ) {
+    return true;
+  }
+#else
+  if ( mkdir(path,0777) == 0 ) {
+    return true;
+  }
+#endif
+  struct stat st;
+  return errno == EEXIST && stat(path,&st) == 0 && ( st.st_mode & S_IFDIR );
+}
+
 const char *
 temporaryFilename(const char * extension)
 {
@@ -186,7 +185,7 @@ temporaryFilename(const char * extension)
     getenv("TMP"), "/tmp", "/var/tmp"
   };
 #endif
-  static char buffer[1024];
+  thread_local static char buffer[1024];
   const char * path = 0;
   for ( int i=0; i < nbPaths && !path; ++i ) {
     if ( paths[i] ) {
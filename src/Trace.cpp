@@ -0,0 +1,203 @@
+/* -*- mode: c++ -*- */
+/**
+ * @file   Trace.cpp
+ * @author PlaneDraw contributors
+ * @date   Oct. 2026
+ *
+ * @brief  Optional recording of trace events, in the Chrome trace format.
+ * \@copyright
+ * This source code is part of the Board project, a C++ library whose
+ * purpose is to allow simple drawings in EPS, FIG or SVG files.
+ * Copyright (C) 2026 PlaneDraw contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BoardConfig.h"
+#include "board/Trace.h"
+#include "board/Tools.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Event {
+  const char * name;
+  long count;
+  Clock::time_point start;
+  Clock::time_point end;
+};
+
+/*
+ * The ring buffer of a thread. Only its thread writes in it, the mutex
+ * is there for dump() and clear().
+ */
+struct Buffer {
+  std::mutex mutex;
+  std::vector<Event> events;
+  std::size_t capacity;
+  std::size_t next;         // Oldest event, once the buffer is full.
+  unsigned int thread;
+};
+
+std::atomic<std::size_t> defaultCapacity( 65536 );
+
+// Buffers outlive their threads, so that events of joined threads are kept.
+std::mutex registryMutex;
+std::vector< std::shared_ptr<Buffer> > & registry()
+{
+  static std::vector< std::shared_ptr<Buffer> > buffers;
+  return buffers;
+}
+
+Clock::time_point epoch()
+{
+  static const Clock::time_point start = Clock::now();
+  return start;
+}
+
+thread_local std::shared_ptr<Buffer> threadBuffer;
+
+Buffer & buffer()
+{
+  if ( ! threadBuffer ) {
+    std::shared_ptr<Buffer> created( new Buffer );
+    created->capacity = std::max<std::size_t>( 1, defaultCapacity );
+    created->next = 0;
+    std::lock_guard<std::mutex> lock( registryMutex );
+    created->thread = static_cast<unsigned int>( registry().size() + 1 );
+    registry().push_back( created );
+    threadBuffer = created;
+  }
+  return *threadBuffer;
+}
+
+double microseconds( Clock::time_point t )
+{
+  return std::chrono::duration<double,std::micro>( t - epoch() ).count();
+}
+
+void writeName( std::ostream & out, const char * name )
+{
+  out << '"';
+  for ( const char * c = name; *c; ++c ) {
+    if ( *c == '"' || *c == '\\' ) {
+      out << '\\';
+    }
+    if ( static_cast<unsigned char>( *c ) >= 32 ) {
+      out << *c;
+    }
+  }
+  out << '"';
+}
+
+}
+
+namespace PlaneDraw {
+
+namespace Trace {
+
+std::atomic<bool> recording( false );
+
+void
+setEnabled( bool enabled )
+{
+  epoch();
+  recording = enabled;
+}
+
+void
+setCapacity( std::size_t events )
+{
+  defaultCapacity = events;
+}
+
+void
+clear()
+{
+  std::lock_guard<std::mutex> lock( registryMutex );
+  std::vector< std::shared_ptr<Buffer> > & buffers = registry();
+  for ( std::size_t i = 0; i < buffers.size(); ++i ) {
+    std::lock_guard<std::mutex> bufferLock( buffers[i]->mutex );
+    std::vector<Event>().swap( buffers[i]->events );
+    buffers[i]->capacity = std::max<std::size_t>( 1, defaultCapacity );
+    buffers[i]->next = 0;
+  }
+}
+
+void
+record( const char * name, Clock::time_point start, Clock::time_point end, long count )
+{
+  Buffer & b = buffer();
+  const Event event = { name, count, start, end };
+  std::lock_guard<std::mutex> lock( b.mutex );
+  if ( b.events.size() < b.capacity ) {
+    b.events.push_back( event );
+  } else {
+    b.events[ b.next ] = event;
+    b.next = ( b.next + 1 ) % b.capacity;
+  }
+}
+
+void
+dump( std::ostream & out )
+{
+  char number[64];
+  bool first = true;
+  out << "{\"traceEvents\":[";
+  std::lock_guard<std::mutex> lock( registryMutex );
+  std::vector< std::shared_ptr<Buffer> > & buffers = registry();
+  for ( std::size_t i = 0; i < buffers.size(); ++i ) {
+    Buffer & b = *buffers[i];
+    std::lock_guard<std::mutex> bufferLock( b.mutex );
+    const std::size_t size = b.events.size();
+    for ( std::size_t n = 0; n < size; ++n ) {
+      const Event & event = b.events[ ( b.next + n ) % size ];
+      out << ( first ? "\n" : ",\n" ) << "{\"name\":";
+      first = false;
+      writeName( out, event.name );
+      secured_sprintf( number, 64, "%.3f", microseconds( event.start ) );
+      out << ",\"cat\":\"board\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b.thread
+          << ",\"ts\":" << number;
+      secured_sprintf( number, 64, "%.3f", microseconds( event.end ) - microseconds( event.start ) );
+      out << ",\"dur\":" << number;
+      if ( event.count >= 0 ) {
+        out << ",\"args\":{\"count\":" << event.count << "}";
+      }
+      out << "}";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool
+save( const char * filename )
+{
+  std::ofstream out( filename );
+  if ( ! out ) {
+    Tools::error << "Trace::save(): cannot write " << filename << ".\n";
+    return false;
+  }
+  dump( out );
+  return static_cast<bool>( out );
+}
+
+} // namespace Trace
+
+} // namespace PlaneDraw
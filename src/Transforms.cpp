@@ -29,6 +29,7 @@
 #include "board/Shapes.h"
 #include "board/ShapeList.h"
 #include "board/Transforms.h"
+#include "board/ExportStats.h"
 #include <cmath>
 
 namespace {
@@ -77,16 +78,17 @@ Transform::apply( double & x, double & y ) const
   y = mapY( y );
 }
 
+std::string
+Transform::fingerprint() const
+{
+  const double parameters[4] = { _scale, _deltaX, _deltaY, _height };
+  return std::string( reinterpret_cast<const char*>( parameters ), sizeof( parameters ) );
+}
+
 //
 // TransformEPS
 //
 
-double
-TransformEPS::mapY( double y ) const
-{
-  return rounded( y * _scale + _deltaY );
-}
-
 double
 TransformEPS::mapWidth( double w ) const
 {
@@ -148,18 +150,6 @@ TransformEPS::pageBoundingBox() const
 // TransformFIG
 //
 
-double
-TransformFIG::rounded( double x ) const
-{
-  return Transform::round( x );
-}
-
-double
-TransformFIG::mapY( double y ) const
-{
-  return rounded( _height - ( y * _scale + _deltaY ) );
-}
-
 int
 TransformFIG::mapWidth( double width ) const
 {
@@ -215,9 +205,19 @@ TransformFIG::setDepthRange( const ShapeList & shapes )
   _minDepth = shapes.minDepth();
 }
 
+std::string
+TransformFIG::fingerprint() const
+{
+  const int depths[3] = { _minDepth, _maxDepth, _fixedDepth };
+  return Transform::fingerprint()
+      + std::string( reinterpret_cast<const char*>( depths ), sizeof( depths ) )
+      + std::string( reinterpret_cast<const char*>( &_postscriptScale ), sizeof( _postscriptScale ) );
+}
+
 int
 TransformFIG::mapDepth( int depth ) const
 {
+  if ( _fixedDepth != -1 ) return _fixedDepth;
   if ( depth > _maxDepth ) return 999;
   if ( _maxDepth - _minDepth > 998 ) {
     double range = _maxDepth - _minDepth;
@@ -229,22 +229,63 @@ TransformFIG::mapDepth( int depth ) const
   }
 }
 
+TransformFIG
+TransformFIG::atDepth( int depth ) const
+{
+  TransformFIG transform( *this );
+  transform._fixedDepth = mapDepth( depth );
+  return transform;
+}
+
 //
-// TransformSVG
+// TransformDXF
 //
 
 double
-TransformSVG::rounded( double x ) const
+TransformDXF::mapWidth( double width ) const
 {
-  return Transform::round( 100*x ) / 100.0f;
+  return Transform::round( _scale * 1000 * width ) / 1000.0;
 }
 
-double
-TransformSVG::mapY( double y ) const
+void
+TransformDXF::setBoundingBox( const Rect & rect,
+                              const double pageWidth,
+                              const double pageHeight,
+                              const double margin )
 {
-  return rounded( _height - ( y * _scale + _deltaY ) );
+  // As for EPS, with millimeters as units.
+  Point c = rect.center();
+  const double w = ( margin < 0.0 ) ? pageWidth : pageWidth - 2 * margin;
+  const double h = ( margin < 0.0 ) ? pageHeight : pageHeight - 2 * margin;
+  if ( ( rect.height / rect.width ) > ( h / w ) ) {
+    _scale = h / rect.height;
+  } else {
+    _scale = w / rect.width;
+  }
+  if ( margin < 0.0 ) {
+    _deltaX = 0.5 * pageWidth + (-margin) - _scale * c.x;
+    _deltaY = 0.5 * pageHeight + (-margin) - _scale * c.y;
+    _height = pageHeight + 2 * (-margin);
+  } else {
+    _deltaX = 0.5 * pageWidth - _scale * c.x;
+    _deltaY = 0.5 * pageHeight - _scale * c.y;
+    _height = pageHeight;
+  }
+}
+
+TransformDXF
+TransformDXF::relativeTo( const Point & origin ) const
+{
+  TransformDXF transform( *this );
+  transform._deltaX = -origin.x * _scale;
+  transform._deltaY = -origin.y * _scale;
+  return transform;
 }
 
+//
+// TransformSVG
+//
+
 double
 TransformSVG::mapWidth( double width ) const
 {
@@ -300,6 +341,52 @@ TransformSVG::translation() const
   return Point(_deltaX,(_height-_deltaY));
 }
 
+void
+ExportContext::setImageDefinitions( const std::map<std::string,unsigned int> * ids )
+{
+  _imageDefinitions = ids;
+  _imageCount = ids ? ids->size() : 0;
+}
+
+int
+ExportContext::imageDefinition( const std::string & filename ) const
+{
+  if ( ! _imageDefinitions ) {
+    return -1;
+  }
+  std::map<std::string,unsigned int>::const_iterator it = _imageDefinitions->find( filename );
+  if ( it == _imageDefinitions->end() ) {
+    return -1;
+  }
+  return static_cast<int>( it->second );
+}
+
+void
+ExportContext::setStats( ExportStats * stats, const CountingStreamBuffer * counter )
+{
+  _stats = stats;
+  _counter = counter;
+}
+
+std::size_t
+ExportContext::bytesWritten() const
+{
+  return _counter ? _counter->count() : 0;
+}
+
+bool
+ExportContext::definePattern( const std::string & definition, std::size_t & id )
+{
+  std::map<std::string,std::size_t>::const_iterator it = _patterns.find( definition );
+  if ( it != _patterns.end() ) {
+    id = it->second;
+    return false;
+  }
+  id = _patterns.size();
+  _patterns[ definition ] = id;
+  return true;
+}
+
 double TransformSVG::deltaX() const
 {
   return _deltaX;